@@ -0,0 +1,19 @@
+#
+# Copyright (C) 2026 Codership Oy <info@codership.com>
+#
+
+#
+# zlib is used for optional write set payload compression. Without it
+# compression is compiled out and replication protocol is limited to 10.
+#
+
+find_package(ZLIB)
+
+if (ZLIB_FOUND)
+  add_definitions(-DHAVE_ZLIB)
+  include_directories(SYSTEM ${ZLIB_INCLUDE_DIRS})
+  set(GALERA_ZLIB_LIBS ${ZLIB_LIBRARIES})
+else()
+  message(STATUS "zlib not found, write set compression is disabled")
+  set(GALERA_ZLIB_LIBS "")
+endif()
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2013 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #ifndef GALERA_ACTION_SOURCE_HPP
@@ -12,7 +12,9 @@ namespace galera
     public:
         ActionSource() { }
         virtual ~ActionSource() { }
-        virtual ssize_t process(void* ctx, bool& exit_loop) = 0;
+        /*! Processes up to max_batch actions received at once */
+        virtual ssize_t process(void* ctx, bool& exit_loop,
+                                long max_batch) = 0;
     };
 }
 
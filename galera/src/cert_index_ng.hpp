@@ -0,0 +1,236 @@
+//
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+//
+
+#ifndef GALERA_CERT_INDEX_NG_HPP
+#define GALERA_CERT_INDEX_NG_HPP
+
+#include "key_entry_ng.hpp"
+
+#include "gu_flat_hash.hpp"
+#include "gu_atomic.hpp"
+#include "gu_mutex.hpp"
+#include "gu_lock.hpp"
+
+#include <vector>
+#include <algorithm> // std::for_each
+
+namespace galera
+{
+    /*!
+     * Certification index for write sets of version 3 and above.
+     *
+     * The index is partitioned into a power of two number of shards, shard
+     * being selected by the key part hash. Each shard has its own mutex, so
+     * certification of one write set and purging keys of another contend
+     * only when they hit the same shard. Key entry lookup and modification
+     * must be done while holding the lock of the shard the entry belongs to.
+     * Certification of a write set holds the locks of all its shards at
+     * once (see KeySetLock), so purging can't remove an entry between the
+     * certification test and referencing the entry.
+     *
+     * Shard mutexes are not instrumented: wsrep-API has no PFS tag for
+     * them and CERT_MUTEX would mix their waits with those of
+     * Certification::mutex_.
+     *
+     * Shards are open addressing hash tables which keep the key part hash
+     * next to the entry pointer, so that probing does not have to
+     * dereference entries and their key parts unless hashes match.
+     * Any insertion or erasure in a shard invalidates its iterators.
+     *
+     * The index does not own the entries, except for clear() which deletes
+     * all of them.
+     */
+    class CertIndexNG
+    {
+    public:
+
+        typedef gu::FlatHashSet<KeyEntryNG*,
+                                KeyEntryPtrHashNG, KeyEntryPtrEqualNG> Index;
+
+        typedef Index::iterator iterator;
+
+        static size_t const MAX_SHARDS = 1024;
+
+        class Shard
+        {
+        public:
+
+            Shard(gu::Atomic<long>& total_size)
+                :
+                mutex_     (),
+                index_     (),
+                total_size_(total_size)
+            {}
+
+            gu::Mutex& mutex() const { return mutex_; }
+
+            iterator end()                       { return index_.end();    }
+            iterator find(KeyEntryNG* const ke)  { return index_.find(ke); }
+
+            iterator insert(KeyEntryNG* const ke)
+            {
+                iterator const ret(index_.insert_unique(ke));
+                ++total_size_;
+                return ret;
+            }
+
+            void erase(iterator const i)
+            {
+                index_.erase(i);
+                --total_size_;
+            }
+
+            size_t size()         const { return index_.size();         }
+            size_t bucket_count()       { return index_.bucket_count(); }
+
+            void clear()
+            {
+                total_size_ += -static_cast<long>(index_.size());
+                std::for_each(index_.begin(), index_.end(), gu::DeleteObject());
+                index_.clear();
+            }
+
+        private:
+
+            Shard(const Shard&);
+            Shard& operator=(const Shard&);
+
+            mutable gu::Mutex        mutex_;
+            Index                    index_;
+            gu::Atomic<long>&        total_size_;
+        };
+
+        /*!
+         * Locks the shards of all key parts of a write set, in shard order,
+         * for the lifetime of the object. Locks of individual shards are
+         * never held while acquiring one, so the order prevents deadlocks.
+         */
+        class KeySetLock
+        {
+        public:
+
+            KeySetLock(const CertIndexNG& index, const WriteSetIn& ws)
+                :
+                index_(index),
+                mask_ ()
+            {
+                for (long i(0); i < ws.key_count(); ++i)
+                {
+                    size_t const s(index_.shard_index(ws.key_part(i).hash()));
+                    mask_[s >> 6] |= (uint64_t(1) << (s & 63));
+                }
+
+                for (size_t s(0); s < index_.shards(); ++s)
+                {
+                    if (locked(s)) index_.shard(s).mutex().lock();
+                }
+            }
+
+            ~KeySetLock()
+            {
+                for (size_t s(index_.shards()); s > 0; --s)
+                {
+                    if (locked(s - 1)) index_.shard(s - 1).mutex().unlock();
+                }
+            }
+
+        private:
+
+            KeySetLock(const KeySetLock&);
+            KeySetLock& operator=(const KeySetLock&);
+
+            static size_t const MASK_WORDS = MAX_SHARDS / 64;
+
+            bool locked(size_t const s) const
+            {
+                return (mask_[s >> 6] & (uint64_t(1) << (s & 63))) != 0;
+            }
+
+            const CertIndexNG& index_;
+            uint64_t           mask_[MASK_WORDS];
+        };
+
+        /*! @param shards requested number of shards, rounded up to
+         *                the nearest power of 2 not exceeding MAX_SHARDS */
+        explicit CertIndexNG(size_t shards)
+            :
+            size_  (0),
+            shards_(),
+            shift_ (64)
+        {
+            size_t n(1);
+            while (n < shards && n < MAX_SHARDS) { n <<= 1; --shift_; }
+
+            shards_.reserve(n);
+            for (size_t i(0); i < n; ++i) shards_.push_back(new Shard(size_));
+        }
+
+        ~CertIndexNG()
+        {
+            std::for_each(shards_.begin(), shards_.end(), gu::DeleteObject());
+        }
+
+        /*! Shard which the key part belongs to */
+        Shard& shard(const KeySet::KeyPart& kp) const
+        {
+            return *shards_[shard_index(kp.hash())];
+        }
+
+        Shard& shard(size_t const i) const { return *shards_[i]; }
+
+        size_t shards() const { return shards_.size(); }
+
+        /*! Total number of entries in the index */
+        size_t size() const { return size_(); }
+
+        bool empty() const { return (0 == size()); }
+
+        size_t bucket_count() const
+        {
+            size_t ret(0);
+
+            for (size_t i(0); i < shards_.size(); ++i)
+            {
+                gu::Lock lock(shards_[i]->mutex());
+                ret += shards_[i]->bucket_count();
+            }
+
+            return ret;
+        }
+
+        /*! Deletes all entries from all shards */
+        void clear()
+        {
+            for (size_t i(0); i < shards_.size(); ++i)
+            {
+                gu::Lock lock(shards_[i]->mutex());
+                shards_[i]->clear();
+            }
+        }
+
+    private:
+
+        friend class KeySetLock;
+
+        CertIndexNG(const CertIndexNG&);
+        CertIndexNG& operator=(const CertIndexNG&);
+
+        /* Shard is selected by the upper bits of the multiplicative hash of
+         * the key part hash, so that it does not correlate with the bucket
+         * selection inside the shard. */
+        size_t shard_index(size_t const hash) const
+        {
+            if (gu_unlikely(64 == shift_)) return 0;
+
+            return ((uint64_t(hash) * GU_ULONG_LONG(0x9E3779B97F4A7C15))
+                    >> shift_);
+        }
+
+        mutable gu::Atomic<long> size_;
+        std::vector<Shard*>      shards_;
+        unsigned int             shift_;
+    };
+}
+
+#endif // GALERA_CERT_INDEX_NG_HPP
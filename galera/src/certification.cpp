@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2018 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #include "certification.hpp"
@@ -20,11 +20,21 @@ static const bool cert_debug_on(false);
 
 #define CERT_PARAM_LOG_CONFLICTS galera::Certification::PARAM_LOG_CONFLICTS
 #define CERT_PARAM_OPTIMISTIC_PA galera::Certification::PARAM_OPTIMISTIC_PA
+#define CERT_PARAM_INDEX_SHARDS  galera::Certification::PARAM_INDEX_SHARDS
+#define CERT_PARAM_PURGE_SLICE_KEYS \
+    galera::Certification::PARAM_PURGE_SLICE_KEYS
+#define CERT_PARAM_PURGE_SLICE_TIME \
+    galera::Certification::PARAM_PURGE_SLICE_TIME
 
 static std::string const CERT_PARAM_PREFIX("cert.");
 
 std::string const CERT_PARAM_LOG_CONFLICTS(CERT_PARAM_PREFIX + "log_conflicts");
 std::string const CERT_PARAM_OPTIMISTIC_PA(CERT_PARAM_PREFIX + "optimistic_pa");
+std::string const CERT_PARAM_INDEX_SHARDS (CERT_PARAM_PREFIX + "index_shards");
+std::string const CERT_PARAM_PURGE_SLICE_KEYS(CERT_PARAM_PREFIX +
+                                              "purge_slice_keys");
+std::string const CERT_PARAM_PURGE_SLICE_TIME(CERT_PARAM_PREFIX +
+                                              "purge_slice_time");
 
 static std::string const CERT_PARAM_MAX_LENGTH   (CERT_PARAM_PREFIX +
                                                   "max_length");
@@ -33,6 +43,9 @@ static std::string const CERT_PARAM_LENGTH_CHECK (CERT_PARAM_PREFIX +
 
 static std::string const CERT_PARAM_LOG_CONFLICTS_DEFAULT("no");
 static std::string const CERT_PARAM_OPTIMISTIC_PA_DEFAULT("yes");
+static std::string const CERT_PARAM_INDEX_SHARDS_DEFAULT ("16");
+static std::string const CERT_PARAM_PURGE_SLICE_KEYS_DEFAULT("4096");
+static std::string const CERT_PARAM_PURGE_SLICE_TIME_DEFAULT("PT0.001S");
 
 /*** It is EXTREMELY important that these constants are the same on all nodes.
  *** Don't change them ever!!! ***/
@@ -44,6 +57,9 @@ galera::Certification::register_params(gu::Config& cnf)
 {
     cnf.add(CERT_PARAM_LOG_CONFLICTS, CERT_PARAM_LOG_CONFLICTS_DEFAULT);
     cnf.add(CERT_PARAM_OPTIMISTIC_PA, CERT_PARAM_OPTIMISTIC_PA_DEFAULT);
+    cnf.add(CERT_PARAM_INDEX_SHARDS,  CERT_PARAM_INDEX_SHARDS_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_SLICE_KEYS, CERT_PARAM_PURGE_SLICE_KEYS_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_SLICE_TIME, CERT_PARAM_PURGE_SLICE_TIME_DEFAULT);
     /* The defaults below are deliberately not reflected in conf: people
      * should not know about these dangerous setting unless they read RTFM. */
     cnf.add(CERT_PARAM_MAX_LENGTH);
@@ -115,19 +131,20 @@ galera::Certification::purge_for_trx_v1to2(TrxHandle* trx)
 void
 galera::Certification::purge_for_trx_v3(TrxHandle* trx)
 {
-    const KeySetIn& keys(trx->write_set_in().keyset());
-    keys.rewind();
+    const WriteSetIn& ws(trx->write_set_in());
 
     // Unref all referenced and remove if was referenced only by us
-    for (long i = 0; i < keys.count(); ++i)
+    for (long i = 0; i < ws.key_count(); ++i)
     {
-        const KeySet::KeyPart& kp(keys.next());
+        const KeySet::KeyPart& kp(ws.key_part(i));
 
         KeyEntryNG ke(kp);
-        CertIndexNG::iterator const ci(cert_index_ng_.find(&ke));
+        CertIndexNG::Shard& shard(cert_index_ng_.shard(kp));
+        gu::Lock lock(shard.mutex());
+        CertIndexNG::iterator const ci(shard.find(&ke));
 
-//        assert(ci != cert_index_ng_.end());
-        if (gu_unlikely(cert_index_ng_.end() == ci))
+//        assert(ci != shard.end());
+        if (gu_unlikely(shard.end() == ci))
         {
             log_warn << "Missing key";
             continue;
@@ -144,7 +161,7 @@ galera::Certification::purge_for_trx_v3(TrxHandle* trx)
 
             if (kep->referenced() == false)
             {
-                cert_index_ng_.erase(ci);
+                shard.erase(ci);
                 delete kep;
             }
         }
@@ -486,9 +503,14 @@ check_against(const galera::KeyEntryNG*   const found,
               wsrep_key_type_t            const key_type,
               galera::TrxHandle*          const trx,
               bool                        const log_conflict,
+              wsrep_seqno_t               const purged,
               wsrep_seqno_t&                    depends_seqno)
 {
-    const galera::TrxHandle* const ref_trx(found->ref_trx(REF_KEY_TYPE));
+    const galera::TrxHandle* ref_trx(found->ref_trx(REF_KEY_TYPE));
+
+    /* references to purged trxs may still be in the index, they must be
+     * treated as absent */
+    if (ref_trx && ref_trx->global_seqno() <= purged) ref_trx = 0;
 
     // trx should not have any references in index at this point
     assert(ref_trx != trx);
@@ -549,7 +571,8 @@ static inline bool
 certify_and_depend_v3to4(const galera::KeyEntryNG*   const found,
                          const galera::KeySet::KeyPart&    key,
                          galera::TrxHandle*          const trx,
-                         bool                        const log_conflict)
+                         bool                        const log_conflict,
+                         wsrep_seqno_t               const purged)
 {
     wsrep_seqno_t depends_seqno(trx->depends_seqno());
     wsrep_key_type_t const key_type(key.wsrep_type(trx->version()));
@@ -570,13 +593,13 @@ certify_and_depend_v3to4(const galera::KeyEntryNG*   const found,
      * step.
      */
     if (check_against<WSREP_KEY_EXCLUSIVE>
-        (found, key, key_type, trx, log_conflict, depends_seqno) ||
+        (found, key, key_type, trx, log_conflict, purged, depends_seqno) ||
         (key_type == WSREP_KEY_EXCLUSIVE &&
          /* exclusive keys must be checked against shared */
          (check_against<WSREP_KEY_SEMI>
-          (found, key, key_type, trx, log_conflict, depends_seqno) ||
+          (found, key, key_type, trx, log_conflict, purged, depends_seqno) ||
           check_against<WSREP_KEY_SHARED>
-          (found, key, key_type, trx, log_conflict, depends_seqno))))
+          (found, key, key_type, trx, log_conflict, purged, depends_seqno))))
     {
         return true;
     }
@@ -588,23 +611,26 @@ certify_and_depend_v3to4(const galera::KeyEntryNG*   const found,
     }
 }
 
-/* returns true on collision, false otherwise */
+/* returns true on collision, false otherwise,
+ * must be called with the key shard locked */
 static bool
-certify_v3to4(galera::Certification::CertIndexNG& cert_index_ng,
+certify_v3to4(galera::CertIndexNG&                cert_index_ng,
               const galera::KeySet::KeyPart&      key,
               galera::TrxHandle*                  trx,
               bool const                          store_keys,
-              bool const                          log_conflicts)
+              bool const                          log_conflicts,
+              wsrep_seqno_t const                 purged)
 {
     galera::KeyEntryNG ke(key);
-    galera::Certification::CertIndexNG::iterator ci(cert_index_ng.find(&ke));
+    galera::CertIndexNG::Shard& shard(cert_index_ng.shard(key));
+    galera::CertIndexNG::iterator ci(shard.find(&ke));
 
-    if (cert_index_ng.end() == ci)
+    if (shard.end() == ci)
     {
         if (store_keys)
         {
             galera::KeyEntryNG* const kep(new galera::KeyEntryNG(ke));
-            ci = cert_index_ng.insert(kep).first;
+            ci = shard.insert(kep);
 
             cert_debug << "created new entry";
         }
@@ -618,51 +644,54 @@ certify_v3to4(galera::Certification::CertIndexNG& cert_index_ng,
         // Note: For we skip certification for isolated trxs, only
         // cert index and key_list is populated.
         return (!trx->is_toi() &&
-                certify_and_depend_v3to4(kep, key, trx, log_conflicts));
+                certify_and_depend_v3to4(kep, key, trx, log_conflicts,
+                                         purged));
     }
 }
 
+/* Unlike do_test_v1to2() this is called without holding mutex_: the index
+ * is protected by shard locks and certification order is guaranteed by the
+ * caller. Counters and last_pa_unsafe_ are updated in do_test().
+ * Shards of all trx keys stay locked for the whole test, so that purge
+ * does not remove entries found by the test before they are referenced
+ * and the test does not see partially purged trxs. */
 galera::Certification::TestResult
-galera::Certification::do_test_v3to4(TrxHandle* trx, bool store_keys)
+galera::Certification::do_test_v3to4(TrxHandle*          trx,
+                                     bool                store_keys,
+                                     wsrep_seqno_t const purged)
 {
     cert_debug << "BEGIN CERTIFICATION v" << trx->version() << ": " << *trx;
 
-#ifndef NDEBUG
-    // to check that cleanup after cert failure returns cert_index_
-    // to original size
-    size_t prev_cert_index_size(cert_index_.size());
-#endif // NDEBUG
-
-    const KeySetIn& key_set(trx->write_set_in().keyset());
-    long const      key_count(key_set.count());
-    long            processed(0);
+    /* key set was parsed when the write set was received */
+    const WriteSetIn& ws(trx->write_set_in());
+    long const        key_count(ws.key_count());
+    long              processed(0);
 
-    key_set.rewind();
+    CertIndexNG::KeySetLock const lock(cert_index_ng_, ws);
 
     for (; processed < key_count; ++processed)
     {
-        const KeySet::KeyPart& key(key_set.next());
+        const KeySet::KeyPart& key(ws.key_part(processed));
 
-        if (certify_v3to4(cert_index_ng_, key, trx, store_keys, log_conflicts_))
+        if (certify_v3to4(cert_index_ng_, key, trx, store_keys, log_conflicts_,
+                          purged))
         {
             goto cert_fail;
         }
     }
 
-    trx->set_depends_seqno(std::max(trx->depends_seqno(), last_pa_unsafe_));
-
     if (store_keys == true)
     {
         assert (key_count == processed);
 
-        key_set.rewind();
         for (long i(0); i < key_count; ++i)
         {
-            const KeySet::KeyPart& k(key_set.next());
+            const KeySet::KeyPart& k(ws.key_part(i));
             KeyEntryNG ke(k);
-            CertIndexNG::const_iterator ci(cert_index_ng_.find(&ke));
+            CertIndexNG::Shard& shard(cert_index_ng_.shard(k));
+            CertIndexNG::iterator ci(shard.find(&ke));
 
-            if (ci == cert_index_ng_.end())
+            if (ci == shard.end())
             {
                 gu_throw_fatal << "could not find key '" << k
                                << "' from cert index";
@@ -673,10 +702,6 @@ galera::Certification::do_test_v3to4(TrxHandle* trx, bool store_keys)
             kep->ref(k.wsrep_type(trx->version()), k, trx);
 
         }
-
-        if (trx->pa_unsafe()) last_pa_unsafe_ = trx->global_seqno();
-
-        key_count_ += key_count;
     }
     cert_debug << "END CERTIFICATION (success): " << *trx;
     return TEST_OK;
@@ -690,18 +715,17 @@ cert_fail:
     if (store_keys == true)
     {
         /* Clean up key entries allocated for this trx */
-        key_set.rewind();
-
         /* 'strictly less' comparison is essential in the following loop:
          * processed key failed cert and was not added to index */
         for (long i(0); i < processed; ++i)
         {
-            KeyEntryNG ke(key_set.next());
+            KeyEntryNG ke(ws.key_part(i));
 
             // Clean up cert_index_ from entries which were added by this trx
-            CertIndexNG::iterator ci(cert_index_ng_.find(&ke));
+            CertIndexNG::Shard& shard(cert_index_ng_.shard(ke.key()));
+            CertIndexNG::iterator ci(shard.find(&ke));
 
-            if (gu_likely(ci != cert_index_ng_.end()))
+            if (gu_likely(ci != shard.end()))
             {
                 KeyEntryNG* kep(*ci);
 
@@ -709,7 +733,7 @@ cert_fail:
                 {
                     // kel was added to cert_index_ by this trx -
                     // remove from cert_index_ and fall through to delete
-                    cert_index_ng_.erase(ci);
+                    shard.erase(ci);
                 }
                 else continue;
 
@@ -727,7 +751,6 @@ cert_fail:
             }
             else { /* non-shared keys can duplicate shared in the key set */ }
         }
-        assert(cert_index_.size() == prev_cert_index_size);
     }
 
     return TEST_FAILED;
@@ -751,6 +774,26 @@ trx_cert_version_match(int const trx_version, int const cert_version)
     }
 }
 
+/* must be called with mutex_ locked */
+void
+galera::Certification::init_depends_seqno(TrxHandle* trx)
+{
+    if ((trx->flags() & (TrxHandle::F_ISOLATION | TrxHandle::F_PA_UNSAFE))
+        || trx_map_.empty())
+    {
+        trx->set_depends_seqno(trx->global_seqno() - 1);
+    }
+    else
+    {
+        trx->set_depends_seqno(
+            trx_map_.begin()->second->global_seqno() - 1);
+
+        if (optimistic_pa_ == false &&
+            trx->last_seen_seqno() > trx->depends_seqno())
+            trx->set_depends_seqno(trx->last_seen_seqno());
+    }
+}
+
 galera::Certification::TestResult
 galera::Certification::do_test(TrxHandle* trx, bool store_keys)
 {
@@ -790,34 +833,49 @@ galera::Certification::do_test(TrxHandle* trx, bool store_keys)
     }
 
     TestResult res(TEST_FAILED);
+    wsrep_seqno_t last_pa_unsafe(WSREP_SEQNO_UNDEFINED);
 
-    gu::Lock lock(mutex_); // why do we need that? - e.g. set_trx_committed()
-
-    /* initialize parent seqno */
-    if ((trx->flags() & (TrxHandle::F_ISOLATION | TrxHandle::F_PA_UNSAFE))
-        || trx_map_.empty())
+    if (version_ >= 3)
     {
-        trx->set_depends_seqno(trx->global_seqno() - 1);
-    }
-    else
-    {
-        trx->set_depends_seqno(
-            trx_map_.begin()->second->global_seqno() - 1);
+        /* v3+ index is protected by shard locks, so mutex_ is not held
+         * during the key set scan and purging or committing other trxs
+         * can proceed concurrently. */
+        wsrep_seqno_t purged;
+        {
+            gu::Lock lock(mutex_);
+            init_depends_seqno(trx);
+            last_pa_unsafe = last_pa_unsafe_;
+            purged = purged_seqno_;
+        }
 
-        if (optimistic_pa_ == false &&
-            trx->last_seen_seqno() > trx->depends_seqno())
-            trx->set_depends_seqno(trx->last_seen_seqno());
+        res = do_test_v3to4(trx, store_keys, purged);
     }
 
+    gu::Lock lock(mutex_); // why do we need that? - e.g. set_trx_committed()
+
     switch (version_)
     {
     case 1:
     case 2:
+        init_depends_seqno(trx);
         res = do_test_v1to2(trx, store_keys);
         break;
     case 3:
     case 4:
-        res = do_test_v3to4(trx, store_keys);
+    case 5:
+    case 6:
+        if (TEST_OK == res)
+        {
+            trx->set_depends_seqno(std::max(trx->depends_seqno(),
+                                            last_pa_unsafe));
+
+            if (store_keys == true)
+            {
+                if (trx->pa_unsafe()) last_pa_unsafe_ = trx->global_seqno();
+
+                key_count_ += trx->write_set_in().keyset().count();
+            }
+        }
         break;
     default:
         gu_throw_fatal << "certification test for version "
@@ -885,8 +943,9 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     version_               (-1),
     conf_                  (conf),
     trx_map_               (),
+    purge_queue_           (),
     cert_index_            (),
-    cert_index_ng_         (),
+    cert_index_ng_         (conf.get<size_t>(CERT_PARAM_INDEX_SHARDS)),
     deps_set_              (),
     service_thd_           (thd),
     gcache_                (gcache),
@@ -895,10 +954,13 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
 #else
     mutex_                 (),
 #endif /* HAVE_PSI_INTERFACE */
+    purge_task_            (*this),
     trx_size_warn_count_   (0),
     initial_position_      (-1),
     position_              (-1),
     safe_to_discard_seqno_ (-1),
+    purge_release_seqno_   (-1),
+    purged_seqno_          (-1),
     last_pa_unsafe_        (-1),
     last_preordered_seqno_ (position_),
     last_preordered_id_    (0),
@@ -911,6 +973,10 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     deps_dist_             (0),
     cert_interval_         (0),
     index_size_            (0),
+    purge_backlog_         (0),
+    purge_slices_          (0),
+    purge_slice_total_     (0),
+    purge_slice_max_       (0),
     key_count_             (0),
     byte_count_            (0),
     trx_count_             (0),
@@ -918,7 +984,9 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     max_length_            (max_length(conf)),
     max_length_check_      (length_check(conf)),
     log_conflicts_         (conf.get<bool>(CERT_PARAM_LOG_CONFLICTS)),
-    optimistic_pa_         (conf.get<bool>(CERT_PARAM_OPTIMISTIC_PA))
+    optimistic_pa_         (conf.get<bool>(CERT_PARAM_OPTIMISTIC_PA)),
+    purge_slice_keys_      (conf.get<long>(CERT_PARAM_PURGE_SLICE_KEYS)),
+    purge_slice_time_      (conf.get(CERT_PARAM_PURGE_SLICE_TIME))
 {}
 
 
@@ -936,6 +1004,10 @@ galera::Certification::~Certification()
     log_debug << "avg cert interval "          << avg_cert_interval;
     log_debug << "cert index size "            << index_size;
 
+    /* wait for the purge task to complete, then nobody else purges */
+    service_thd_.flush();
+    purge_slice(false);
+
     gu::Lock lock(mutex_);
 
     for_each(trx_map_.begin(), trx_map_.end(), PurgeAndDiscard(*this));
@@ -956,12 +1028,18 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
     case 2:
     case 3:
     case 4:
+    case 5:
+    case 6:
         break;
     default:
         gu_throw_fatal << "certification/trx version "
                        << version << " not supported";
     }
 
+    /* wait for the purge task to complete, then nobody else purges */
+    service_thd_.flush();
+    purge_slice(false);
+
     gu::Lock lock(mutex_);
 
     if (seqno >= position_)
@@ -976,8 +1054,6 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
                  << seqno;
         std::for_each(cert_index_.begin(), cert_index_.end(),
                       gu::DeleteObject());
-        std::for_each(cert_index_ng_.begin(), cert_index_ng_.end(),
-                      gu::DeleteObject());
         std::for_each(trx_map_.begin(), trx_map_.end(),
                       Unref2nd<TrxMap::value_type>());
         cert_index_.clear();
@@ -992,6 +1068,8 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
     initial_position_      = seqno;
     position_              = seqno;
     safe_to_discard_seqno_ = seqno;
+    purge_release_seqno_   = seqno;
+    purged_seqno_          = seqno;
     last_pa_unsafe_        = seqno;
     last_preordered_seqno_ = position_;
     last_preordered_id_    = 0;
@@ -1043,15 +1121,43 @@ galera::Certification::purge_trxs_upto_(wsrep_seqno_t const seqno,
 
     log_debug << "purging index up to " << seqno;
 
-    for_each(trx_map_.begin(), purge_bound, PurgeAndDiscard(*this));
+    /* v3+ index purge is done by the service thread in slices, so that
+     * index shard locks are not held for long at a time. The index is
+     * purged logically right here though: certification ignores
+     * references to trxs up to purged_seqno_, so its outcome does not
+     * depend on how far the service thread has got and stays the same
+     * on all nodes. Write sets can be released from gcache only after
+     * their keys have been removed from the index.
+     * v1-2 index is purged inline, as certification of v1-2 trxs does not
+     * filter references. */
+    for (TrxMap::iterator i(trx_map_.begin()); i != purge_bound; ++i)
+    {
+        if (i->second->new_version())
+        {
+            purge_queue_.insert(purge_queue_.end(), *i);
+        }
+        else
+        {
+            PurgeAndDiscard(*this)(*i);
+        }
+    }
+
     trx_map_.erase(trx_map_.begin(), purge_bound);
 
-    if (handle_gcache)
+    if (seqno > purged_seqno_) purged_seqno_ = seqno;
+
+    if (handle_gcache && seqno > purge_release_seqno_)
     {
-        log_debug << "releasing seqno from gcache " << seqno;
-        service_thd_.release_seqno(seqno);
+        purge_release_seqno_ = seqno;
     }
 
+    {
+        gu::Lock lock(stats_mutex_);
+        purge_backlog_ = purge_queue_.size();
+    }
+
+    service_thd_.schedule(purge_task_);
+
     if (0 == ((trx_map_.size() + 1) % 10000))
     {
         log_debug << "trx map after purge: length: " << trx_map_.size()
@@ -1063,6 +1169,75 @@ galera::Certification::purge_trxs_upto_(wsrep_seqno_t const seqno,
 }
 
 
+bool
+galera::Certification::purge_slice(bool const bounded)
+{
+    gu::datetime::Date const start(gu::datetime::Date::monotonic());
+    gu::datetime::Date const deadline(start + purge_slice_time_);
+    long          keys(0);
+    size_t        backlog(0);
+    wsrep_seqno_t release(WSREP_SEQNO_UNDEFINED);
+
+    while (true)
+    {
+        TrxMap::iterator i;
+        TrxHandle*       trx;
+
+        {
+            gu::Lock lock(mutex_);
+
+            i = purge_queue_.begin();
+
+            if (i == purge_queue_.end() ||
+                (bounded == true &&
+                 (keys >= purge_slice_keys_ ||
+                  deadline < gu::datetime::Date::monotonic())))
+            {
+                backlog = purge_queue_.size();
+                release = purge_queue_.empty() ? purge_release_seqno_ :
+                    std::min(purge_release_seqno_, i->first - 1);
+                break;
+            }
+
+            trx = i->second;
+            assert(trx->new_version());
+
+            keys += trx->write_set_in().keyset().count();
+        }
+
+        /* v3+ index is protected by shard locks. Only purge slices remove
+         * elements from purge_queue_ and they do not run concurrently,
+         * so the iterator stays valid. */
+        TrxMap::value_type vt(trx->global_seqno(), trx);
+        PurgeAndDiscard(*this)(vt);
+
+        gu::Lock lock(mutex_);
+        purge_queue_.erase(i);
+    }
+
+    if (release > 0)
+    {
+        log_debug << "releasing seqno from gcache " << release;
+        service_thd_.release_seqno(release);
+    }
+
+    long long const duration((gu::datetime::Date::monotonic() - start)
+                             .get_nsecs());
+    {
+        gu::Lock lock(stats_mutex_);
+        purge_backlog_ = backlog;
+        if (keys > 0)
+        {
+            ++purge_slices_;
+            purge_slice_total_ += duration;
+            purge_slice_max_ = std::max(purge_slice_max_, duration);
+        }
+    }
+
+    return (backlog > 0);
+}
+
+
 galera::Certification::TestResult
 galera::Certification::append_trx(TrxHandle* trx)
 {
@@ -1215,6 +1390,19 @@ galera::Certification::param_set(const std::string& key,
         set_boolean_parameter(optimistic_pa_, value, CERT_PARAM_OPTIMISTIC_PA,
                               "\"optimistic\" parallel applying.");
     }
+    else if (key == Certification::PARAM_PURGE_SLICE_KEYS)
+    {
+        purge_slice_keys_ = gu::Config::from_config<long>(value);
+    }
+    else if (key == Certification::PARAM_PURGE_SLICE_TIME)
+    {
+        purge_slice_time_ = gu::datetime::Period(value);
+    }
+    else if (key == Certification::PARAM_INDEX_SHARDS)
+    {
+        gu_throw_error(EPERM) << "can't change '" << key
+                              << "' during runtime";
+    }
     else
     {
         throw gu::NotFound();
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2018 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #ifndef GALERA_CERTIFICATION_HPP
@@ -7,11 +7,13 @@
 
 #include "trx_handle.hpp"
 #include "key_entry_ng.hpp"
+#include "cert_index_ng.hpp"
 #include "galera_service_thd.hpp"
 
 #include "gu_unordered.hpp"
 #include "gu_lock.hpp"
 #include "gu_config.hpp"
+#include "gu_datetime.hpp"
 
 #include <map>
 #include <set>
@@ -25,16 +27,15 @@ namespace galera
 
         static std::string const PARAM_LOG_CONFLICTS;
         static std::string const PARAM_OPTIMISTIC_PA;
+        static std::string const PARAM_INDEX_SHARDS;
+        static std::string const PARAM_PURGE_SLICE_KEYS;
+        static std::string const PARAM_PURGE_SLICE_TIME;
 
         static void register_params(gu::Config&);
 
         typedef gu::UnorderedSet<KeyEntryOS*,
                                  KeyEntryPtrHash, KeyEntryPtrEqual> CertIndex;
 
-        typedef gu::UnorderedSet<KeyEntryNG*,
-                                 KeyEntryPtrHashNG, KeyEntryPtrEqualNG>
-        CertIndexNG;
-
     private:
 
         typedef std::multiset<wsrep_seqno_t>        DepsSet;
@@ -97,6 +98,20 @@ namespace galera
             index_size = index_size_;
         }
 
+        void purge_stats_get(size_t&    backlog,
+                             double&    avg_slice_ns,
+                             long long& max_slice_ns) const
+        {
+            gu::Lock lock(stats_mutex_);
+            backlog = purge_backlog_;
+            avg_slice_ns = 0;
+            if (purge_slices_)
+            {
+                avg_slice_ns = double(purge_slice_total_) / purge_slices_;
+            }
+            max_slice_ns = purge_slice_max_;
+        }
+
         void stats_reset()
         {
             gu::Lock lock(stats_mutex_);
@@ -104,6 +119,9 @@ namespace galera
             deps_dist_ = 0;
             n_certified_ = 0;
             index_size_ = 0;
+            purge_slices_ = 0;
+            purge_slice_total_ = 0;
+            purge_slice_max_ = 0;
         }
 
         size_t bucket_count ()
@@ -118,7 +136,8 @@ namespace galera
 
         TestResult do_test(TrxHandle*, bool);
         TestResult do_test_v1to2(TrxHandle*, bool);
-        TestResult do_test_v3to4(TrxHandle*, bool);
+        TestResult do_test_v3to4(TrxHandle*, bool, wsrep_seqno_t purged);
+        void       init_depends_seqno(TrxHandle*);
         TestResult do_test_preordered(TrxHandle*);
         void purge_for_trx(TrxHandle*);
         void purge_for_trx_v1to2(TrxHandle*);
@@ -128,6 +147,28 @@ namespace galera
         wsrep_seqno_t get_safe_to_discard_seqno_() const;
         wsrep_seqno_t purge_trxs_upto_(wsrep_seqno_t, bool sync);
 
+        /* Purges index for trxs queued by purge_trxs_upto_(). If bounded,
+         * stops after purge slice key or time limit is reached.
+         * Returns true if purge queue is not empty. Must be called without
+         * mutex_ locked, only by the service thread or when the purge task
+         * is not scheduled. */
+        bool purge_slice(bool bounded);
+
+        class PurgeTask : public ServiceThd::Task
+        {
+        public:
+
+            PurgeTask(Certification& cert) : cert_(cert) { }
+
+            bool run() { return cert_.purge_slice(true); }
+
+        private:
+
+            PurgeTask(const PurgeTask&);
+            void operator=(const PurgeTask&);
+            Certification& cert_;
+        };
+
         bool index_purge_required()
         {
             static unsigned int const KEYS_THRESHOLD (1   << 10); // 1K
@@ -187,6 +228,7 @@ namespace galera
         int           version_;
         gu::Config&   conf_;
         TrxMap        trx_map_;
+        TrxMap        purge_queue_; // trxs removed from trx_map_ pending purge
         CertIndex     cert_index_;
         CertIndexNG   cert_index_ng_;
         DepsSet       deps_set_;
@@ -198,10 +240,13 @@ namespace galera
 #else
         gu::Mutex     mutex_;
 #endif /* HAVE_PSI_INTERFACE */
+        PurgeTask     purge_task_;
         size_t        trx_size_warn_count_;
         wsrep_seqno_t initial_position_;
         wsrep_seqno_t position_;
         wsrep_seqno_t safe_to_discard_seqno_;
+        wsrep_seqno_t purge_release_seqno_; // release from gcache when purged
+        wsrep_seqno_t purged_seqno_; // index refs up to it are ignored
         wsrep_seqno_t last_pa_unsafe_;
         wsrep_seqno_t last_preordered_seqno_;
         wsrep_trx_id_t last_preordered_id_;
@@ -215,6 +260,10 @@ namespace galera
         wsrep_seqno_t deps_dist_;
         wsrep_seqno_t cert_interval_;
         size_t        index_size_;
+        size_t        purge_backlog_;
+        long long     purge_slices_;
+        long long     purge_slice_total_;
+        long long     purge_slice_max_;
 
         size_t        key_count_;
         size_t        byte_count_;
@@ -231,6 +280,9 @@ namespace galera
 
         bool               log_conflicts_;
         bool               optimistic_pa_;
+
+        long                 purge_slice_keys_; /* max keys per purge slice */
+        gu::datetime::Period purge_slice_time_; /* max purge slice duration */
     };
 }
 
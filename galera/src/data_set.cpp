@@ -1,6 +1,178 @@
 //
-// Copyright (C) 2013 Codership Oy <info@codership.com>
+// Copyright (C) 2013-2026 Codership Oy <info@codership.com>
 //
 
 #include "data_set.hpp"
 
+#include "gu_datetime.hpp"
+#include "gu_logger.hpp"
+#include "gu_throw.hpp"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <cstring> // memset()
+
+namespace galera
+{
+
+bool
+DataSetOut::compress (int const                level,
+                      size_t const             threshold,
+                      DataSet::CompressStats&  stats)
+{
+    if (DataSet::VER2 != version_ || NULL != zset_ || level <= 0) return false;
+
+    size_t raw_size(0);
+    for (size_t i(0); i < parts_->size(); ++i) raw_size += parts_[i].size;
+
+    if (raw_size < threshold) return false;
+
+#ifdef HAVE_ZLIB
+    gu::byte_t hdr[1 + 10]; /* codec + uleb128 encoded raw size */
+    hdr[0] = DataSet::C_ZLIB;
+    size_t const hdr_size(gu::uleb128_encode(raw_size, hdr, sizeof(hdr), 1));
+
+    if (raw_size <= hdr_size) return false;
+
+    gu::datetime::Date const start(gu::datetime::Date::monotonic());
+
+    /* compressed payload is of no use unless it is smaller than original */
+    zbuf_.resize(raw_size - hdr_size);
+
+    z_stream zs;
+    ::memset(&zs, 0, sizeof(zs));
+
+    if (deflateInit(&zs, level) != Z_OK)
+    {
+        log_warn << "Failed to initialize zlib stream: "
+                 << (zs.msg ? zs.msg : "(null)");
+        zbuf_.clear();
+        return false;
+    }
+
+    zs.next_out  = &zbuf_[0];
+    zs.avail_out = zbuf_.size();
+
+    int ret(Z_OK);
+
+    for (size_t i(0); i < parts_->size() && Z_OK == ret; ++i)
+    {
+        zs.next_in  = const_cast<Bytef*>
+            (static_cast<const Bytef*>(parts_[i].ptr));
+        zs.avail_in = parts_[i].size;
+
+        bool const last(i + 1 == parts_->size());
+
+        ret = deflate(&zs, last ? Z_FINISH : Z_NO_FLUSH);
+
+        /* out of output space before the input is consumed: not worth it */
+        if (Z_OK == ret && zs.avail_in > 0) ret = Z_BUF_ERROR;
+    }
+
+    size_t const zsize(zs.total_out);
+    deflateEnd(&zs);
+
+    stats.bytes_in  += raw_size;
+    stats.nsecs     += (gu::datetime::Date::monotonic() - start).get_nsecs();
+
+    if (Z_STREAM_END != ret)
+    {
+        stats.bytes_out += raw_size;
+        zbuf_.clear();
+        return false;
+    }
+
+    zset_ = new gu::RecordSetOut<DataSet::RecordOut>(
+        NULL, 0, *base_name_, gu::RecordSet::check_type(),
+        gu::RecordSet::version());
+
+    zset_->append(hdr, hdr_size, true, false);
+    zset_->append(&zbuf_[0], zsize, false, false);
+
+    stats.bytes_out += hdr_size + zsize;
+
+    return true;
+#else
+    (void)stats;
+    return false;
+#endif /* HAVE_ZLIB */
+}
+
+gu::Buf
+DataSetIn::decode (const gu::Buf& rec) const
+{
+    const gu::byte_t* const ptr(static_cast<const gu::byte_t*>(rec.ptr));
+
+    if (gu_unlikely(rec.size < 1))
+    {
+        gu_throw_error(EPROTO) << "Empty DataSet payload";
+    }
+
+    switch (ptr[0])
+    {
+    case DataSet::C_NONE:
+    {
+        gu::Buf const ret = { ptr + 1, rec.size - 1 };
+        return ret;
+    }
+    case DataSet::C_ZLIB:
+        break;
+    default:
+        gu_throw_error(EPROTO) << "Unsupported DataSet codec: " << int(ptr[0]);
+    }
+
+#ifdef HAVE_ZLIB
+    size_t raw_size;
+    size_t const off(gu::uleb128_decode(ptr, rec.size, 1, raw_size));
+
+    if (plain_.empty())
+    {
+        if (gu_unlikely(raw_size == 0 || raw_size > size_t(ssize_t(-1) >> 1)))
+        {
+            gu_throw_error(EPROTO) << "Bogus DataSet uncompressed size: "
+                                   << raw_size;
+        }
+
+        plain_.resize(raw_size);
+
+        z_stream zs;
+        ::memset(&zs, 0, sizeof(zs));
+
+        if (inflateInit(&zs) != Z_OK)
+        {
+            plain_.clear();
+            gu_throw_error(ENOMEM) << "Failed to initialize zlib stream: "
+                                   << (zs.msg ? zs.msg : "(null)");
+        }
+
+        zs.next_in   = const_cast<Bytef*>(ptr + off);
+        zs.avail_in  = rec.size - off;
+        zs.next_out  = &plain_[0];
+        zs.avail_out = raw_size;
+
+        int const ret(inflate(&zs, Z_FINISH));
+        size_t const total(zs.total_out);
+        inflateEnd(&zs);
+
+        if (gu_unlikely(Z_STREAM_END != ret || total != raw_size))
+        {
+            plain_.clear();
+            gu_throw_error(EPROTO) << "Failed to decompress DataSet payload: "
+                                   << ret << ", " << total << " of "
+                                   << raw_size << " bytes";
+        }
+    }
+
+    assert(plain_.size() == raw_size);
+
+    gu::Buf const ret = { &plain_[0], ssize_t(plain_.size()) };
+    return ret;
+#else
+    gu_throw_error(EPROTO) << "Compressed DataSet payload, but compression "
+                           << "support is not compiled in";
+#endif /* HAVE_ZLIB */
+}
+
+} /* namespace galera */
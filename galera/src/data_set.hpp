@@ -9,6 +9,8 @@
 #include "gu_rset.hpp"
 #include "gu_vlq.hpp"
 
+#include <vector>
+
 
 namespace galera
 {
@@ -19,10 +21,34 @@ namespace galera
         enum Version
         {
             EMPTY = 0,
-            VER1
+            VER1,
+            VER2  /* payload is prefixed with Codec byte */
         };
 
-        static Version const MAX_VERSION = VER1;
+        static Version const MAX_VERSION = VER2;
+
+        /*! Max DataSet version that can be used with a given writeset
+         *  version */
+        static Version max_version (int const ws_ver)
+        {
+            return (ws_ver < 6 ? VER1 : VER2);
+        }
+
+        /*! VER2 payload encoding. C_ZLIB payload is followed by uleb128
+         *  encoded uncompressed size and zlib stream */
+        enum Codec
+        {
+            C_NONE = 0,
+            C_ZLIB
+        };
+
+        /*! Compression counters */
+        struct CompressStats
+        {
+            long long bytes_in;   /* payload bytes offered for compression */
+            long long bytes_out;  /* the same after compression (if any) */
+            long long nsecs;      /* time spent in compression */
+        };
 
         static Version version (unsigned int ver)
         {
@@ -79,55 +105,119 @@ namespace galera
 
         DataSetOut () // empty ctor for slave TrxHandle
             :
-            gu::RecordSetOut<DataSet::RecordOut>(), version_()
+            gu::RecordSetOut<DataSet::RecordOut>(), version_(), base_name_(),
+            parts_(), zbuf_(), zset_(NULL)
         {}
 
         DataSetOut (gu::byte_t*             reserved,
                     size_t                  reserved_size,
                     const BaseName&         base_name,
                     DataSet::Version        version,
-                    gu::RecordSet::Version  rsv)
+                    gu::RecordSet::Version  rsv,
+                    int                     ws_ver)
             :
             gu::RecordSetOut<DataSet::RecordOut> (
                 reserved,
                 reserved_size,
                 base_name,
-                check_type(version),
+                check_type(version, ws_ver),
                 rsv
                 ),
-            version_(version)
+            version_(version),
+            base_name_(&base_name),
+            parts_(),
+            zbuf_(),
+            zset_(NULL)
         {
             assert((uintptr_t(reserved) % GU_WORD_BYTES) == 0);
         }
 
+        ~DataSetOut() { delete zset_; }
+
         size_t
         append (const void* const src, size_t const size, bool const store)
         {
+            typedef gu::RecordSetOut<DataSet::RecordOut> Base;
+
+            assert (NULL == zset_);
+
+            size_t ret(size);
+
+            if (DataSet::VER2 == version_ && 0 == count())
+            {
+                static gu::byte_t const codec(DataSet::C_NONE);
+                Base::append (&codec, sizeof(codec), true, false);
+                ret += sizeof(codec);
+            }
+
             /* append data as is, don't count as a new record */
-            gu::RecordSetOut<DataSet::RecordOut>::append (src, size, store,
-                                                          false);
+            std::pair<const gu::byte_t*, size_t> const
+                rec(Base::append (src, size, store, false));
             /* this will be deserialized using DataSet::RecordIn in DataSetIn */
 
-            return size;
+            if (DataSet::VER2 == version_)
+            {
+                gu::Buf const part = { rec.first, ssize_t(rec.second) };
+                parts_->push_back(part);
+            }
+
+            return ret;
         }
 
+        /*! Replaces VER2 payload with its compressed form if it is at least
+         *  threshold bytes long and compression actually reduces it.
+         *  Must be called after the last append().
+         *  @return true if payload was compressed */
+        bool
+        compress (int level, size_t threshold, DataSet::CompressStats& stats);
+
         DataSet::Version
         version () const { return count() ? version_ : DataSet::EMPTY; }
 
+        /*! version the set was created with, even if it is empty */
+        DataSet::Version format () const { return version_; }
+
+        /* these hide RecordSetOut methods to account for compression */
+
+        size_t size() const
+        {
+            return zset_ ? zset_->size() : gu::RecordSet::size();
+        }
+
+        ssize_t page_count() const
+        {
+            return zset_ ? zset_->page_count() :
+                gu::RecordSetOut<DataSet::RecordOut>::page_count();
+        }
+
         typedef gu::RecordSet::GatherVector GatherVector;
 
+        ssize_t gather (GatherVector& out)
+        {
+            return zset_ ? zset_->gather(out) :
+                gu::RecordSetOut<DataSet::RecordOut>::gather(out);
+        }
+
     private:
 
         // depending on version we may pack data differently
         DataSet::Version const version_;
 
+        const BaseName*          base_name_;
+        gu::Vector<gu::Buf, 4>   parts_; /* VER2 payload pieces */
+        std::vector<gu::byte_t>  zbuf_;  /* compressed payload  */
+        gu::RecordSetOut<DataSet::RecordOut>* zset_; /* compressed set */
+
         static gu::RecordSet::CheckType
-        check_type (DataSet::Version ver)
+        check_type (DataSet::Version ver, int const ws_ver)
         {
             switch (ver)
             {
             case DataSet::EMPTY: break; /* Can't create EMPTY DataSetOut */
-            case DataSet::VER1:  return gu::RecordSet::CHECK_MMH128;
+            case DataSet::VER1:
+            case DataSet::VER2:
+                return ws_ver < 5 ? gu::RecordSet::CHECK_MMH128 :
+                                    gu::RecordSet::CHECK_VHASH64;
             }
             throw;
         }
@@ -142,28 +232,39 @@ namespace galera
         DataSetIn (DataSet::Version ver, const gu::byte_t* buf, size_t size)
             :
             gu::RecordSetIn<DataSet::RecordIn>(buf, size, false),
-            version_(ver)
+            version_(ver),
+            plain_()
         {}
 
         DataSetIn () : gu::RecordSetIn<DataSet::RecordIn>(),
-                       version_(DataSet::EMPTY)
+                       version_(DataSet::EMPTY),
+                       plain_()
         {}
 
         void init (DataSet::Version ver, const gu::byte_t* buf, size_t size)
         {
             gu::RecordSetIn<DataSet::RecordIn>::init(buf, size, false);
             version_ = ver;
+            plain_.clear();
         }
 
+        /* returns decompressed payload, which stays valid for the lifetime
+         * of the object */
         gu::Buf next () const
         {
-            return gu::RecordSetIn<DataSet::RecordIn>::next().buf();
+            gu::Buf const ret(gu::RecordSetIn<DataSet::RecordIn>::next().buf());
+            return (DataSet::VER2 == version_ ? decode(ret) : ret);
         }
 
     private:
 
         DataSet::Version version_;
 
+        /* decompressed payload, filled on first access */
+        mutable std::vector<gu::byte_t> plain_;
+
+        gu::Buf decode (const gu::Buf& rec) const;
+
     }; /* class DataSetIn */
 
 #if defined(__GNUG__)
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2014 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #ifndef GALERA_GCS_HPP
@@ -34,6 +34,8 @@ namespace galera
                                              gcs_seqno_t seqno) = 0;
         virtual void    close() = 0;
         virtual ssize_t recv(gcs_action& act) = 0;
+        /*! @return number of actions received or recv() error code */
+        virtual ssize_t recv_batch(gcs_action* acts, long max) = 0;
 
         typedef WriteSetNG::GatherVector WriteSetVector;
 
@@ -119,6 +121,11 @@ namespace galera
             return gcs_recv(conn_, &act);
         }
 
+        ssize_t recv_batch(struct gcs_action* acts, long max)
+        {
+            return gcs_recv_batch(conn_, acts, max);
+        }
+
         ssize_t sendv(const WriteSetVector& actv, size_t act_len,
                       gcs_act_type_t act_type, bool scheduled)
         {
@@ -294,6 +301,12 @@ namespace galera
 
         ssize_t recv(gcs_action& act);
 
+        ssize_t recv_batch(gcs_action* acts, long)
+        {
+            ssize_t const ret(recv(acts[0]));
+            return (ret > 0 ? 1 : ret);
+        }
+
         ssize_t sendv(const WriteSetVector&, size_t, gcs_act_type_t, bool)
         { return -ENOSYS; }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2013 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * Using broadcasts instead of signals below to wake flush callers due to
  * theoretical possibility of more than 2 threads involved.
@@ -7,13 +7,52 @@
 
 #include "galera_service_thd.hpp"
 
+#include <gu_time.h>
+
+#include <algorithm>
+
 const uint32_t galera::ServiceThd::A_NONE = 0;
 
 static const uint32_t A_LAST_COMMITTED = 1U <<  0;
 static const uint32_t A_RELEASE_SEQNO  = 1U <<  1;
+static const uint32_t A_TASK           = 1U <<  2;
 static const uint32_t A_FLUSH          = 1U << 30;
 static const uint32_t A_EXIT           = 1U << 31;
 
+size_t const galera::ServiceThd::RELEASE_SLICE = 1024;
+
+bool
+galera::ServiceThd::release_slice (gcs_seqno_t const seqno)
+{
+    long long const start(gu_time_monotonic());
+    bool more(false);
+
+    try
+    {
+        more = gcache_.seqno_release(seqno, RELEASE_SLICE);
+    }
+    catch (std::exception& e)
+    {
+        log_warn << "Exception releasing seqno " << seqno << ": " << e.what();
+    }
+
+    long long const duration(gu_time_monotonic() - start);
+    gcs_seqno_t const released(gcache_.seqno_last_released());
+
+    gu::Lock lock(mtx_);
+
+    release_backlog_ = more ? seqno - released : 0;
+    release_slices_++;
+    release_slice_total_ += duration;
+    release_slice_max_ = std::max(release_slice_max_, duration);
+
+    /* more slices are run in the following iterations, interleaved with
+     * other requests */
+    if (more) data_.act_ |= A_RELEASE_SEQNO;
+
+    return more;
+}
+
 void*
 galera::ServiceThd::thd_func (void* arg)
 {
@@ -78,15 +117,23 @@ galera::ServiceThd::thd_func (void* arg)
 
             if (data.act_ & A_RELEASE_SEQNO)
             {
+                st->release_slice(data.release_seqno_);
+            }
+
+            if (data.act_ & A_TASK)
+            {
+                bool more(false);
+
                 try
                 {
-                    st->gcache_.seqno_release(data.release_seqno_);
+                    more = data.task_->run();
                 }
                 catch (std::exception& e)
                 {
-                    log_warn << "Exception releasing seqno "
-                             << data.release_seqno_ << ": " << e.what();
+                    log_warn << "Exception in service task: " << e.what();
                 }
+
+                if (more) st->schedule(*data.task_);
             }
         }
     }
@@ -114,7 +161,11 @@ galera::ServiceThd::ServiceThd (GcsI& gcs, gcache::GCache& gcache) :
     cond_   (),
     flush_  (),
 #endif /* HAVE_PSI_INTERFACE */
-    data_   ()
+    data_   (),
+    release_backlog_    (0),
+    release_slices_     (0),
+    release_slice_total_(0),
+    release_slice_max_  (0)
 {
     gu_thread_create (&thd_, NULL, thd_func, this);
 }
@@ -148,7 +199,7 @@ void
 galera::ServiceThd::reset()
 {
     gu::Lock lock(mtx_);
-    data_.act_ = A_NONE;
+    data_.act_ &= A_TASK; // scheduled task is not bound to the connection
     data_.last_committed_ = 0;
 }
 
@@ -174,6 +225,7 @@ galera::ServiceThd::release_seqno(gcs_seqno_t seqno)
 
     if (data_.release_seqno_ < seqno)
     {
+        release_backlog_ += seqno - data_.release_seqno_;
         data_.release_seqno_ = seqno;
 
         if (data_.act_ == A_NONE) cond_.signal();
@@ -181,3 +233,43 @@ galera::ServiceThd::release_seqno(gcs_seqno_t seqno)
         data_.act_ |= A_RELEASE_SEQNO;
     }
 }
+
+void
+galera::ServiceThd::schedule(Task& task)
+{
+    gu::Lock lock(mtx_);
+
+    assert(NULL == data_.task_ || &task == data_.task_);
+
+    data_.task_ = &task;
+
+    if (data_.act_ == A_NONE) cond_.signal();
+
+    data_.act_ |= A_TASK;
+}
+
+void
+galera::ServiceThd::release_stats_get(long long& backlog,
+                                      double&    avg_slice_ns,
+                                      long long& max_slice_ns) const
+{
+    gu::Lock lock(mtx_);
+
+    backlog = release_backlog_;
+    avg_slice_ns = 0;
+    if (release_slices_)
+    {
+        avg_slice_ns = double(release_slice_total_) / release_slices_;
+    }
+    max_slice_ns = release_slice_max_;
+}
+
+void
+galera::ServiceThd::stats_reset()
+{
+    gu::Lock lock(mtx_);
+
+    release_slices_ = 0;
+    release_slice_total_ = 0;
+    release_slice_max_ = 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2013 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef GALERA_SERVICE_THD_HPP
@@ -16,6 +16,17 @@ namespace galera
     {
     public:
 
+        /*! Incremental background job which is run in slices interleaved
+         *  with other service requests. */
+        class Task
+        {
+        public:
+            virtual ~Task() {}
+
+            /*! do one slice of work, return true if there is more to do */
+            virtual bool run() = 0;
+        };
+
         ServiceThd (GcsI& gcs, gcache::GCache& gcache);
 
         ~ServiceThd ();
@@ -35,9 +46,24 @@ namespace galera
         /*! schedule seqno to be reported as last committed */
         void report_last_committed (gcs_seqno_t seqno);
 
-        /*! release write sets up to and including seqno */
+        /*! release write sets up to and including seqno, done in slices of
+         *  at most RELEASE_SLICE write sets */
         void release_seqno (gcs_seqno_t seqno);
 
+        /*! schedule task to be run until it reports completion,
+         *  only one task object can be scheduled at a time */
+        void schedule (Task& task);
+
+        /*! gcache release statistics: seqnos scheduled for release but not
+         *  released yet, average and maximum release slice duration */
+        void release_stats_get (long long& backlog,
+                                double&    avg_slice_ns,
+                                long long& max_slice_ns) const;
+
+        void stats_reset ();
+
+        static size_t const RELEASE_SLICE; // max write sets released at once
+
     private:
 
         static const uint32_t A_NONE;
@@ -46,11 +72,13 @@ namespace galera
         {
             gcs_seqno_t last_committed_;
             gcs_seqno_t release_seqno_;
+            Task*       task_;
             uint32_t    act_;
 
             Data() :
                 last_committed_(0),
                 release_seqno_ (0),
+                task_          (NULL),
                 act_           (A_NONE)
             {}
         };
@@ -69,6 +97,13 @@ namespace galera
         gu::Cond        flush_; // flush condition
 #endif /* HAVE_PSI_INTERFACE */
         Data            data_;
+        gcs_seqno_t     release_backlog_;
+        long long       release_slices_;
+        long long       release_slice_total_;
+        long long       release_slice_max_;
+
+        /* releases one slice, returns true if there is more to release */
+        bool release_slice (gcs_seqno_t seqno);
 
         static void* thd_func (void*);
 
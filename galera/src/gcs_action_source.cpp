@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #include "replicator.hpp"
@@ -10,37 +10,51 @@
 
 #include "galera_info.hpp"
 
+#include <algorithm>
+#include <vector>
 #include <cassert>
 
-// Exception-safe way to release action pointer when it goes out
+// Exception-safe way to release action pointers when they go out
 // of scope
 class Release
 {
 public:
-    Release(struct gcs_action& act, gcache::GCache& gcache)
+    Release(const struct gcs_action* acts, ssize_t num,
+            gcache::GCache& gcache)
         :
-        act_(act),
+        acts_(acts),
+        num_(num),
         gcache_(gcache)
     {}
 
+    /* actions from n on are left unreleased */
+    void truncate(ssize_t const n) { assert(n <= num_); num_ = n; }
+
     ~Release()
     {
-        switch (act_.type)
+        for (ssize_t i(0); i < num_; ++i)
         {
-        case GCS_ACT_TORDERED:
-            break;
-        case GCS_ACT_STATE_REQ:
-            gcache_.free(const_cast<void*>(act_.buf));
-            break;
-        default:
-            ::free(const_cast<void*>(act_.buf));
-            break;
+            switch (acts_[i].type)
+            {
+            case GCS_ACT_TORDERED:
+                break;
+            case GCS_ACT_STATE_REQ:
+                gcache_.free(const_cast<void*>(acts_[i].buf));
+                break;
+            default:
+                ::free(const_cast<void*>(acts_[i].buf));
+                break;
+            }
         }
     }
 
 private:
-    struct gcs_action& act_;
-    gcache::GCache&    gcache_;
+    Release(const Release&);
+    void operator=(const Release&);
+
+    const struct gcs_action* const acts_;
+    ssize_t                        num_;
+    gcache::GCache&                gcache_;
 };
 
 
@@ -69,37 +83,63 @@ static galera::Replicator::State state2repl(const gcs_act_conf_t& conf)
 }
 
 
-galera::GcsActionTrx::GcsActionTrx(TrxHandle::SlavePool&    pool,
-                                   const struct gcs_action& act)
-    :
-    trx_(TrxHandle::New(pool))
-    // TODO: this dynamic allocation should be unnecessary
+void galera::GcsActionTrx::init(TrxHandle::SlavePool&    pool,
+                                const struct gcs_action& act,
+                                WriteSetChecker&         checker)
 {
+    assert(NULL == trx_);
     assert(act.seqno_l != GCS_SEQNO_ILL);
     assert(act.seqno_g != GCS_SEQNO_ILL);
 
     const gu::byte_t* const buf = static_cast<const gu::byte_t*>(act.buf);
 
-//    size_t offset(trx_->unserialize(buf, act.size, 0));
-    gu_trace(trx_->unserialize(buf, act.size, 0));
+    TrxHandle* const trx(TrxHandle::New(pool));
+    // TODO: this dynamic allocation should be unnecessary
+
+    try
+    {
+        gu_trace(trx->unserialize(buf, act.size, 0, &checker));
+    }
+    catch (...)
+    {
+        trx->unref();
+        throw;
+    }
 
-    //trx_->append_write_set(buf + offset, act.size - offset);
-    // moved to unserialize trx_->set_write_set_buffer(buf + offset, act.size - offset);
-    trx_->set_received(act.buf, act.seqno_l, act.seqno_g);
-    trx_->lock();
+    trx->set_received(act.buf, act.seqno_l, act.seqno_g);
+    trx->lock();
+    trx_ = trx;
 }
 
 
 galera::GcsActionTrx::~GcsActionTrx()
 {
+    if (NULL == trx_) return;
+
     assert(trx_->refcnt() >= 1);
     trx_->unlock();
     trx_->unref();
 }
 
 
+long const galera::GcsActionSource::MAX_BATCH;
+
+galera::GcsActionSource::~GcsActionSource()
+{
+    if (!pending_.empty())
+    {
+        log_warn << "Discarding " << pending_.size()
+                 << " unprocessed actions";
+        std::vector<gcs_action> const acts(pending_.begin(), pending_.end());
+        Release release(&acts[0], acts.size(), gcache_);
+    }
+
+    log_info << trx_pool_;
+}
+
 void galera::GcsActionSource::dispatch(void* const              recv_ctx,
                                        const struct gcs_action& act,
+                                       GcsActionTrx&            trx,
                                        bool&                    exit_loop)
 {
     assert(act.buf != 0);
@@ -110,7 +150,7 @@ void galera::GcsActionSource::dispatch(void* const              recv_ctx,
     case GCS_ACT_TORDERED:
     {
         assert(act.seqno_g > 0);
-        GcsActionTrx trx(trx_pool_, act);
+        assert(trx.trx() != NULL);
         trx.trx()->set_state(TrxHandle::S_REPLICATING);
         gu_trace(replicator_.process_trx(recv_ctx, trx.trx()));
         exit_loop = trx.trx()->exit_loop(); // this is the end of trx lifespan
@@ -167,19 +207,71 @@ void galera::GcsActionSource::dispatch(void* const              recv_ctx,
 }
 
 
-ssize_t galera::GcsActionSource::process(void* recv_ctx, bool& exit_loop)
+ssize_t galera::GcsActionSource::process(void* const recv_ctx,
+                                         bool&       exit_loop,
+                                         long const  max_batch)
 {
-    struct gcs_action act;
+    struct gcs_action acts[MAX_BATCH];
+    long const max(std::max(1L, std::min(max_batch, MAX_BATCH)));
+    ssize_t rc;
+
+    if (gu_likely(pending_.empty()))
+    {
+        rc = gcs_.recv_batch(acts, max);
+    }
+    else
+    {
+        rc = std::min<ssize_t>(max, pending_.size());
+        std::copy(pending_.begin(), pending_.begin() + rc, acts);
+        pending_.erase(pending_.begin(), pending_.begin() + rc);
+    }
 
-    ssize_t rc(gcs_.recv(act));
     if (rc > 0)
     {
-        Release release(act, gcache_);
-        ++received_;
-        received_bytes_ += rc;
-        gu_trace(dispatch(recv_ctx, act, exit_loop));
+        Release release(acts, rc, gcache_);
+        GcsActionTrx trxs[MAX_BATCH];
+
+        /* unserialize write sets of the whole batch before processing any,
+         * so that the checker pool works on the following write sets while
+         * the preceding ones are being certified and applied. Failure is
+         * reported when the action's turn comes. */
+        for (ssize_t i(0); i < rc; ++i)
+        {
+            if (GCS_ACT_TORDERED == acts[i].type)
+            {
+                try { trxs[i].init(trx_pool_, acts[i], checker_); }
+                catch (...) {}
+            }
+        }
+
+        for (ssize_t i(0); i < rc; ++i)
+        {
+            bool exit_act(false);
+            ++received_;
+            received_bytes_ += acts[i].size;
+
+            try
+            {
+                if (GCS_ACT_TORDERED == acts[i].type && !trxs[i].trx())
+                {
+                    gu_trace(trxs[i].init(trx_pool_, acts[i], checker_));
+                }
+
+                gu_trace(dispatch(recv_ctx, acts[i], trxs[i], exit_act));
+            }
+            catch (...)
+            {
+                /* the failed action is consumed as it would be alone, the
+                 * rest are kept for the next call */
+                pending_.insert(pending_.begin(), acts + i + 1, acts + rc);
+                release.truncate(i + 1);
+                throw;
+            }
+
+            exit_loop = exit_loop || exit_act;
+        }
     }
-    else if (GCS_ACT_INCONSISTENCY == act.type)
+    else if (GCS_ACT_INCONSISTENCY == acts[0].type)
     {
         assert(0 == rc);
         rc = INCONSISTENCY_CODE;
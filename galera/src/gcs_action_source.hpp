@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #ifndef GALERA_GCS_ACTION_SOURCE_HPP
@@ -9,13 +9,18 @@
 #include "galera_gcs.hpp"
 #include "replicator.hpp"
 #include "trx_handle.hpp"
+#include "write_set_checker.hpp"
 
 #include "GCache.hpp"
 
+#include <deque>
+
 #include "gu_atomic.hpp"
 
 namespace galera
 {
+    class GcsActionTrx;
+
     class GcsActionSource : public galera::ActionSource
     {
     public:
@@ -26,42 +31,54 @@ namespace galera
         GcsActionSource(TrxHandle::SlavePool& sp,
                         GCS_IMPL&             gcs,
                         Replicator&           replicator,
-                        gcache::GCache&       gcache)
+                        gcache::GCache&       gcache,
+                        WriteSetChecker&      checker)
             :
             trx_pool_      (sp        ),
             gcs_           (gcs       ),
             replicator_    (replicator),
             gcache_        (gcache    ),
+            checker_       (checker   ),
             received_      (0         ),
-            received_bytes_(0         )
+            received_bytes_(0         ),
+            pending_       (          )
         { }
 
-        ~GcsActionSource()
-        {
-            log_info << trx_pool_;
-        }
+        ~GcsActionSource();
+
+        /* maximum number of actions to process in one call */
+        static long const MAX_BATCH = 16;
 
-        ssize_t   process(void*, bool& exit_loop);
+        ssize_t   process(void*, bool& exit_loop, long max_batch);
         long long received()       const { return received_(); }
         long long received_bytes() const { return received_bytes_(); }
 
     private:
 
-        void dispatch(void*, const gcs_action&, bool& exit_loop);
+        void dispatch(void*, const gcs_action&, GcsActionTrx&,
+                      bool& exit_loop);
 
         TrxHandle::SlavePool& trx_pool_;
         GCS_IMPL&             gcs_;
         Replicator&           replicator_;
         gcache::GCache&       gcache_;
+        WriteSetChecker&      checker_;
         gu::Atomic<long long> received_;
         gu::Atomic<long long> received_bytes_;
+        /* actions of a batch left unprocessed when processing of a preceding
+         * one failed. They are ordered already, so they must be processed
+         * before anything else is received. */
+        std::deque<gcs_action> pending_;
     };
 
     class GcsActionTrx
     {
     public:
-        GcsActionTrx(TrxHandle::SlavePool& sp, const struct gcs_action& act);
+        GcsActionTrx() : trx_(NULL) {}
         ~GcsActionTrx();
+        /* unserializes write set from the action */
+        void init(TrxHandle::SlavePool& sp, const struct gcs_action& act,
+                  WriteSetChecker& checker);
         TrxHandle* trx() const { return trx_; }
     private:
         GcsActionTrx(const GcsActionTrx&);
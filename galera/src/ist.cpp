@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2011-2017 Codership Oy <info@codership.com>
+// Copyright (C) 2011-2026 Codership Oy <info@codership.com>
 //
 
 #include "ist.hpp"
@@ -16,11 +16,18 @@
 #include <boost/bind.hpp>
 #include <fstream>
 #include <algorithm>
+#include <deque>
+#include <cstring> // strerror()
 
 namespace
 {
     static std::string const CONF_KEEP_KEYS     ("ist.keep_keys");
     static bool        const CONF_KEEP_KEYS_DEFAULT (true);
+    /* number of GCache buffer batches read ahead of the sending thread,
+     * 0 disables the read-ahead thread */
+    static std::string const CONF_PREFETCH_BATCHES ("ist.prefetch_batches");
+    static int         const CONF_PREFETCH_BATCHES_DEFAULT (2);
+    static size_t      const PREFETCH_BATCH_SIZE (1024);
 }
 
 
@@ -72,6 +79,60 @@ namespace galera
             AsyncSender(const AsyncSender&);
             AsyncSender& operator=(const AsyncSender&);
         };
+
+        /*
+         * Reads batches of buffers for seqno range [first, last] from GCache
+         * in a separate thread, so that reading (and possibly paging in) the
+         * next batch overlaps with sending the current one. With zero depth
+         * batches are read by the caller on demand.
+         */
+        class Prefetcher
+        {
+        public:
+
+            typedef std::vector<gcache::GCache::Buffer> Batch;
+
+            Prefetcher(gcache::GCache& gcache,
+                       wsrep_seqno_t   first,
+                       wsrep_seqno_t   last,
+                       int             depth);
+            ~Prefetcher();
+
+            /* returns next batch of buffers, empty batch when there is no
+             * more buffers, valid until the next call */
+            const Batch& next();
+
+            void run();
+
+        private:
+
+            /* fills b with buffers starting at first_, returns false
+             * when nothing could be read */
+            bool read(Batch& b);
+
+            gcache::GCache&     gcache_;
+            wsrep_seqno_t       first_;
+            wsrep_seqno_t const last_;
+#ifdef HAVE_PSI_INTERFACE
+            gu::MutexWithPFS    mutex_;
+            gu::CondWithPFS     cond_;
+#else
+            gu::Mutex           mutex_;
+            gu::Cond            cond_;
+#endif /* HAVE_PSI_INTERFACE */
+            std::vector<Batch>  batches_;
+            std::deque<Batch*>  free_;
+            std::deque<Batch*>  full_;
+            Batch*              current_;
+            gu_thread_t         thread_;
+            int                 error_;
+            bool                thread_running_;
+            bool                eof_;
+            bool                stop_;
+
+            Prefetcher(const Prefetcher&);
+            Prefetcher& operator=(const Prefetcher&);
+        };
     }
 }
 
@@ -87,6 +148,7 @@ galera::ist::register_params(gu::Config& conf)
     conf.add(Receiver::RECV_ADDR);
     conf.add(Receiver::RECV_BIND);
     conf.add(CONF_KEEP_KEYS);
+    conf.add(CONF_PREFETCH_BATCHES);
 }
 
 galera::ist::Receiver::Receiver(gu::Config&           conf,
@@ -768,6 +830,202 @@ galera::ist::Sender::~Sender()
     gcache_.seqno_unlock();
 }
 
+extern "C" void* run_prefetcher_thread(void* arg)
+{
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_INIT,
+                       WSREP_PFS_INSTR_TAG_IST_ASYNC_SENDER_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    galera::ist::Prefetcher* pf(static_cast<galera::ist::Prefetcher*>(arg));
+    pf->run();
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_IST_ASYNC_SENDER_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+    return 0;
+}
+
+
+galera::ist::Prefetcher::Prefetcher(gcache::GCache& gcache,
+                                    wsrep_seqno_t   first,
+                                    wsrep_seqno_t   last,
+                                    int             depth)
+    :
+    gcache_        (gcache),
+    first_         (first),
+    last_          (last),
+#ifdef HAVE_PSI_INTERFACE
+    mutex_         (WSREP_PFS_INSTR_TAG_ASYNC_SENDER_MONITOR_MUTEX),
+    cond_          (WSREP_PFS_INSTR_TAG_ASYNC_SENDER_MONITOR_CONDVAR),
+#else
+    mutex_         (),
+    cond_          (),
+#endif /* HAVE_PSI_INTERFACE */
+    batches_       (std::max(depth, 0) + 1),
+    free_          (),
+    full_          (),
+    current_       (0),
+    thread_        (),
+    error_         (0),
+    thread_running_(false),
+    eof_           (false),
+    stop_          (false)
+{
+    if (depth <= 0) return;
+
+    for (size_t i(0); i < batches_.size(); ++i)
+    {
+        free_.push_back(&batches_[i]);
+    }
+
+    int const err(gu_thread_create(&thread_, 0, &run_prefetcher_thread, this));
+
+    if (err != 0)
+    {
+        log_warn << "Failed to start IST prefetch thread: " << err
+                 << " (" << ::strerror(err) << "), reading GCache inline";
+        free_.clear();
+        return;
+    }
+
+    thread_running_ = true;
+}
+
+
+galera::ist::Prefetcher::~Prefetcher()
+{
+    if (thread_running_)
+    {
+        {
+            gu::Lock lock(mutex_);
+            stop_ = true;
+            cond_.broadcast();
+        }
+
+        int err;
+        if ((err = gu_thread_join(thread_, 0)) != 0)
+        {
+            log_warn << "Failed to join IST prefetch thread: " << err;
+        }
+    }
+}
+
+
+bool galera::ist::Prefetcher::read(Batch& b)
+{
+    if (first_ > last_) return false;
+
+    // limit batch size to avoid scanning gcache past last
+    b.resize(std::min(static_cast<size_t>(last_ - first_ + 1),
+                      PREFETCH_BATCH_SIZE));
+
+    size_t const n(gcache_.seqno_get_buffers(b, first_));
+    b.resize(n);
+
+    if (0 == n) return false;
+
+    gcache_.seqno_prefetch(b, n);
+    first_ += n;
+
+    return true;
+}
+
+
+void galera::ist::Prefetcher::run()
+{
+    while (true)
+    {
+        Batch* b;
+
+        {
+            gu::Lock lock(mutex_);
+            while (free_.empty() && !stop_) lock.wait(cond_);
+            if (stop_) return;
+            b = free_.front();
+            free_.pop_front();
+        }
+
+        bool ret;
+        int  err(0);
+
+        try
+        {
+            ret = read(*b);
+        }
+        catch (gu::Exception& e)
+        {
+            log_error << "IST prefetch thread failed to read GCache: "
+                      << e.what();
+            b->clear();
+            ret = false;
+            err = e.get_errno() ? e.get_errno() : EIO;
+        }
+
+        gu::Lock lock(mutex_);
+
+        if (ret)
+        {
+            full_.push_back(b);
+        }
+        else
+        {
+            free_.push_back(b);
+            error_ = err;
+            eof_   = true;
+        }
+
+        cond_.broadcast();
+
+        if (!ret) return;
+    }
+}
+
+
+const galera::ist::Prefetcher::Batch& galera::ist::Prefetcher::next()
+{
+    if (!thread_running_)
+    {
+        Batch& b(batches_[0]);
+        if (!read(b)) b.clear();
+        return b;
+    }
+
+    gu::Lock lock(mutex_);
+
+    if (current_)
+    {
+        current_->clear();
+        free_.push_back(current_);
+        current_ = 0;
+        cond_.broadcast();
+    }
+
+    while (full_.empty() && !eof_) lock.wait(cond_);
+
+    if (full_.empty())
+    {
+        if (error_ != 0)
+        {
+            gu_throw_error(error_) << "IST prefetch failed";
+        }
+
+        /* free batches are cleared */
+        return *free_.front();
+    }
+
+    current_ = full_.front();
+    full_.pop_front();
+
+    return *current_;
+}
+
+
 void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
 {
     if (first > last)
@@ -800,15 +1058,16 @@ void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
                 << "ist send failed, peer reported error: " << ctrl;
         }
 
-        std::vector<gcache::GCache::Buffer> buf_vec(
-            std::min(static_cast<size_t>(last - first + 1),
-                     static_cast<size_t>(1024)));
-        ssize_t n_read;
-        while ((n_read = gcache_.seqno_get_buffers(buf_vec, first)) > 0)
+        Prefetcher prefetcher(gcache_, first, last,
+                              conf_.get(CONF_PREFETCH_BATCHES,
+                                        CONF_PREFETCH_BATCHES_DEFAULT));
+        while (true)
         {
+            const Prefetcher::Batch& buf_vec(prefetcher.next());
+            if (buf_vec.empty()) break;
+
             GU_DBUG_SYNC_WAIT("ist_sender_send_after_get_buffers")
-            //log_info << "read " << first << " + " << n_read << " from gcache";
-            for (wsrep_seqno_t i(0); i < n_read; ++i)
+            for (size_t i(0); i < buf_vec.size(); ++i)
             {
                 // log_info << "sending " << buf_vec[i].seqno_g();
                 if (use_ssl_ == true)
@@ -854,15 +1113,6 @@ void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
                     return;
                 }
             }
-            first += n_read;
-            // resize buf_vec to avoid scanning gcache past last
-            size_t next_size(std::min(static_cast<size_t>(last - first + 1),
-                                      static_cast<size_t>(1024)));
-
-            if (buf_vec.size() != next_size)
-            {
-                buf_vec.resize(next_size);
-            }
         }
     }
     catch (asio::system_error& e)
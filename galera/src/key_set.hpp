@@ -134,7 +134,7 @@ public:
          * version */
         static int prefix(wsrep_key_type_t const ws_type, int const ws_ver)
         {
-            if (ws_ver >= 0 && ws_ver <= 4)
+            if (ws_ver >= 0 && ws_ver <= 6)
             {
                 switch (ws_type)
                 {
@@ -159,7 +159,7 @@ public:
 
         wsrep_key_type_t wsrep_type(int const ws_ver) const
         {
-            assert(ws_ver >= 0 && ws_ver <= 4);
+            assert(ws_ver >= 0 && ws_ver <= 6);
 
             wsrep_key_type_t ret;
 
@@ -169,10 +169,10 @@ public:
                 ret = WSREP_KEY_SHARED;
                 break;
             case 1:
-                ret = ws_ver == 4 ? WSREP_KEY_SEMI : WSREP_KEY_EXCLUSIVE;
+                ret = ws_ver >= 4 ? WSREP_KEY_SEMI : WSREP_KEY_EXCLUSIVE;
                 break;
             case 2:
-                assert(ws_ver == 4);
+                assert(ws_ver >= 4);
                 ret = WSREP_KEY_EXCLUSIVE;
                 break;
             default:
@@ -681,7 +681,7 @@ public:
             reserved,
             reserved_size,
             base_name,
-            check_type(version),
+            check_type(version, ws_ver),
             rsv
             ),
         added_(),
@@ -692,7 +692,7 @@ public:
     {
         assert (version_ != KeySet::EMPTY);
         assert ((uintptr_t(reserved) % GU_WORD_BYTES) == 0);
-        assert (ws_ver <= 4);
+        assert (ws_ver <= 6);
         KeyPart zero(version_);
         prev_().push_back(zero);
     }
@@ -715,12 +715,13 @@ private:
     int                   ws_ver_;
 
     static gu::RecordSet::CheckType
-    check_type (KeySet::Version ver)
+    check_type (KeySet::Version ver, int const ws_ver)
     {
         switch (ver)
         {
         case KeySet::EMPTY: break; /* Can't create EMPTY KeySetOut */
-        default: return gu::RecordSet::CHECK_MMH128;
+        default: return ws_ver < 5 ? gu::RecordSet::CHECK_MMH128 :
+                                     gu::RecordSet::CHECK_VHASH64;
         }
 
         KeySet::throw_version(ver);
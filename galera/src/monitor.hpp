@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2013 Codership Oy
+// Copyright (C) 2010-2026 Codership Oy
 //
 
 #ifndef GALERA_MONITOR_HPP
@@ -7,13 +7,47 @@
 
 #include "trx_handle.hpp"
 #include <gu_lock.hpp> // for gu::Mutex and gu::Cond
+#include <gu_atomic.hpp>
+#include <gu_throw.hpp>
 #include <gu_limits.h>
 #include <gu_dbug.h>
 
 #include <vector>
+#include <string>
+#include <unistd.h> // sysconf()
 
 namespace galera
 {
+    /*!
+     * Monitor implementation.
+     *
+     * MONITOR_MUTEX keeps all monitor state under a single mutex.
+     *
+     * MONITOR_RING keeps slot states and window boundaries in atomic
+     * variables, so that enter() and leave() of non-conflicting objects
+     * don't serialize on the mutex. A thread which can't enter right away
+     * spins for a while and only then parks on the slot condition. The mutex
+     * is used only for parking and for rare operations like drain().
+     */
+    enum MonitorMode
+    {
+        MONITOR_MUTEX,
+        MONITOR_RING
+    };
+
+    inline MonitorMode monitor_mode_from_string(const std::string& str)
+    {
+        if (str == "ring") return MONITOR_RING;
+
+        if (str != "mutex")
+        {
+            gu_throw_error(EINVAL) << "invalid value '" << str
+                                   << "' for monitor implementation";
+        }
+
+        return MONITOR_MUTEX;
+    }
+
     template <class C>
     class Monitor
     {
@@ -21,7 +55,8 @@ namespace galera
 
         struct Process
         {
-            Process() : obj_(0), cond_(), wait_cond_(), state_(S_IDLE) { }
+            Process() : obj_(0), cond_(), wait_cond_(), state_(S_IDLE),
+                        word_(0), parked_(false) { }
 
             const C* obj_;
             gu::Cond cond_;
@@ -35,6 +70,13 @@ namespace galera
                 S_FINISHED  // Finished
             } state_;
 
+            // ring mode: seqno of the slot owner and its state packed
+            // together, so that slot reuse can't be mistaken for the
+            // previous owner state
+            gu::Atomic<long long> word_;
+            // ring mode: owner sleeps on cond_, protected by mutex_
+            bool                  parked_;
+
         private:
 
             // non-copyable
@@ -45,22 +87,33 @@ namespace galera
         static const ssize_t process_size_ = (1ULL << 16);
         static const size_t  process_mask_ = process_size_ - 1;
 
+        // ring mode: number of spins before parking on multiprocessor
+        static const int     spin_max_     = 128;
+
     public:
 
 #ifdef HAVE_PSI_INTERFACE
-        Monitor(wsrep_pfs_instr_tag mtag, wsrep_pfs_instr_tag ctag)
+        Monitor(wsrep_pfs_instr_tag mtag, wsrep_pfs_instr_tag ctag,
+                MonitorMode mode = MONITOR_MUTEX)
             :
             mutex_(mtag),
             cond_(ctag),
 #else
-        Monitor()
+        explicit Monitor(MonitorMode mode = MONITOR_MUTEX)
             :
             mutex_(),
             cond_(),
 #endif /* HAVE_PSI_INTERFACE */
+            mode_(mode),
+            // spinning on uniprocessor only delays the thread we wait for
+            spin_limit_(sysconf(_SC_NPROCESSORS_ONLN) > 1 ? spin_max_ : 0),
             last_entered_(-1),
             last_left_(-1),
             drain_seqno_(GU_LLONG_MAX),
+            r_last_entered_(-1),
+            r_last_left_(-1),
+            r_drain_seqno_(GU_LLONG_MAX),
+            r_parked_(0),
             process_(new Process[process_size_]),
             entered_(0),
             oooe_(0),
@@ -72,11 +125,11 @@ namespace galera
         ~Monitor()
         {
             delete[] process_;
-            if (entered_ > 0)
+            if (entered_() > 0)
             {
-                log_debug << "mon: entered " << entered_
-                         << " oooe fraction " << double(oooe_)/entered_
-                         << " oool fraction " << double(oool_)/entered_;
+                log_debug << "mon: entered " << entered_()
+                         << " oooe fraction " << double(oooe_())/entered_()
+                         << " oool fraction " << double(oool_())/entered_();
             }
             else
             {
@@ -84,8 +137,16 @@ namespace galera
             }
         }
 
+        MonitorMode mode() const { return mode_; }
+
         void set_initial_position(wsrep_seqno_t seqno)
         {
+            if (MONITOR_RING == mode_)
+            {
+                ring_set_initial_position(seqno);
+                return;
+            }
+
             gu::Lock lock(mutex_);
             if (last_entered_ == -1 || seqno == -1)
             {
@@ -108,6 +169,8 @@ namespace galera
 
         void enter(C& obj)
         {
+            if (MONITOR_RING == mode_) { ring_enter(obj); return; }
+
             const wsrep_seqno_t obj_seqno(obj.seqno());
             const size_t        idx(indexof(obj_seqno));
             gu::Lock            lock(mutex_);
@@ -144,7 +207,7 @@ namespace galera
 
                     ++entered_;
                     oooe_     += ((last_left_ + 1) < obj_seqno);
-                    win_size_ += (last_entered_ - last_left_);
+                    win_size_ += long(last_entered_ - last_left_);
                     return;
                 }
             }
@@ -157,6 +220,8 @@ namespace galera
 
         void leave(const C& obj)
         {
+            if (MONITOR_RING == mode_) { ring_leave(obj); return; }
+
 #ifndef NDEBUG
             size_t   idx(indexof(obj.seqno()));
 #endif /* NDEBUG */
@@ -172,6 +237,8 @@ namespace galera
 
         void self_cancel(C& obj)
         {
+            if (MONITOR_RING == mode_) { ring_self_cancel(obj); return; }
+
             wsrep_seqno_t const obj_seqno(obj.seqno());
             size_t   idx(indexof(obj_seqno));
             gu::Lock lock(mutex_);
@@ -210,6 +277,7 @@ namespace galera
 
         void interrupt(const C& obj)
         {
+            if (MONITOR_RING == mode_) { ring_interrupt(obj); return; }
 
             size_t   idx (indexof(obj.seqno()));
             gu::Lock lock(mutex_);
@@ -240,6 +308,8 @@ namespace galera
 
         wsrep_seqno_t last_left()   const
         {
+            if (MONITOR_RING == mode_) return r_last_left_();
+
             gu::Lock lock(mutex_);
             return last_left_;
         }
@@ -247,12 +317,16 @@ namespace galera
 
         bool would_block (wsrep_seqno_t seqno) const
         {
+            if (MONITOR_RING == mode_) return ring_would_block(seqno);
+
             return (seqno - last_left_ >= process_size_ ||
                     seqno > drain_seqno_);
         }
 
         void drain(wsrep_seqno_t seqno)
         {
+            if (MONITOR_RING == mode_) { ring_drain(seqno); return; }
+
             gu::Lock lock(mutex_);
 
             while (drain_seqno_ != GU_LLONG_MAX)
@@ -272,7 +346,8 @@ namespace galera
         void wait(wsrep_seqno_t seqno)
         {
             gu::Lock lock(mutex_);
-            if (last_left_ < seqno)
+            Parked   parked(*this);
+            if (current_last_left() < seqno)
             {
                 size_t idx(indexof(seqno));
                 lock.wait(process_[idx].wait_cond_);
@@ -282,7 +357,8 @@ namespace galera
         void wait(wsrep_seqno_t seqno, const gu::datetime::Date& wait_until)
         {
             gu::Lock lock(mutex_);
-            if (last_left_ < seqno)
+            Parked   parked(*this);
+            if (current_last_left() < seqno)
             {
                 size_t idx(indexof(seqno));
                 lock.wait(process_[idx].wait_cond_, wait_until);
@@ -294,17 +370,22 @@ namespace galera
         {
             gu::Lock lock(mutex_);
 
-            if (entered_ > 0)
+            long const entered(entered_());
+
+            if (entered > 0)
             {
-                *oooe = (oooe_ > 0 ? double(oooe_)/entered_ : .0);
-                *oool = (oool_ > 0 ? double(oool_)/entered_ : .0);
-                *win_size = (win_size_ > 0 ? double(win_size_)/entered_ : .0);
+                long const ooe(oooe_());
+                long const ool(oool_());
+                long const win(win_size_());
+                *oooe = (ooe > 0 ? double(ooe)/entered : .0);
+                *oool = (ool > 0 ? double(ool)/entered : .0);
+                *win_size = (win > 0 ? double(win)/entered : .0);
             }
             else
             {
                 *oooe = .0; *oool = .0; *win_size = .0;
             }
-            *waits = waits_;
+            *waits = waits_();
         }
 
         void flush_stats()
@@ -315,11 +396,16 @@ namespace galera
 
     private:
 
-        size_t indexof(wsrep_seqno_t seqno)
+        size_t indexof(wsrep_seqno_t seqno) const
         {
             return (seqno & process_mask_);
         }
 
+        wsrep_seqno_t current_last_left() const
+        {
+            return (MONITOR_RING == mode_ ? r_last_left_() : last_left_);
+        }
+
         bool may_enter(const C& obj) const
         {
             return obj.condition(last_entered_, last_left_);
@@ -440,6 +526,406 @@ namespace galera
             while (last_left_ < drain_seqno_) lock.wait(cond_);
         }
 
+        /*
+         * Ring mode.
+         *
+         * Slot word holds seqno of the slot owner together with its state.
+         * Only the thread which switches the word of slot last_left + 1 from
+         * S_FINISHED to S_IDLE may advance last left, so it moves forward
+         * monotonically without a lock.
+         *
+         * Threads sleeping on any monitor condition are counted in r_parked_.
+         * Leaving thread first publishes new last left and then checks
+         * r_parked_, while parking thread first increments r_parked_ and then
+         * checks last left, so at least one of them sees the change made by
+         * the other. Both sleeping and waking up are done under mutex_, so
+         * wakeups can't be lost.
+         */
+
+        class Parked
+        {
+        public:
+            explicit Parked(Monitor& mon) : parked_(mon.r_parked_)
+            {
+                ++parked_;
+            }
+
+            ~Parked() { --parked_; }
+
+        private:
+            Parked(const Parked&);
+            void operator=(const Parked&);
+
+            gu::Atomic<long>& parked_;
+        };
+
+        static long long make_word(wsrep_seqno_t const          seqno,
+                                   typename Process::State const state)
+        {
+            return ((seqno << 3) | state);
+        }
+
+        static typename Process::State word_state(long long const word)
+        {
+            return static_cast<typename Process::State>(word & 7);
+        }
+
+        static wsrep_seqno_t word_seqno(long long const word)
+        {
+            return (word >> 3);
+        }
+
+        static void cpu_relax()
+        {
+#if defined(__i386__) || defined(__x86_64__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        }
+
+        bool ring_would_block(wsrep_seqno_t const seqno) const
+        {
+            return (seqno - r_last_left_() >= process_size_ ||
+                    seqno > r_drain_seqno_());
+        }
+
+        bool ring_may_enter(const C& obj) const
+        {
+            return obj.condition(r_last_entered_(), r_last_left_());
+        }
+
+        void ring_update_last_entered(wsrep_seqno_t const seqno)
+        {
+            wsrep_seqno_t le(r_last_entered_());
+
+            while (le < seqno && !r_last_entered_.compare_and_swap(le, seqno))
+            {
+                le = r_last_entered_();
+            }
+        }
+
+        // advances last left over consecutive finished slots starting from
+        // seqno, which must be last left + 1 as seen by the caller,
+        // returns the new last left or seqno - 1 if seqno was not finished
+        // or was taken by another thread
+        wsrep_seqno_t ring_update_last_left(wsrep_seqno_t seqno)
+        {
+            while (process_[indexof(seqno)].word_.compare_and_swap(
+                       make_word(seqno, Process::S_FINISHED),
+                       make_word(seqno, Process::S_IDLE)))
+            {
+                r_last_left_ = seqno;
+                ++seqno;
+            }
+
+            return seqno - 1;
+        }
+
+        // wakes up waiters after last left was advanced over [from, to],
+        // must be called under mutex_
+        void ring_wake_up(wsrep_seqno_t const from, wsrep_seqno_t const to)
+        {
+            for (wsrep_seqno_t i(from); i <= to; ++i)
+            {
+                process_[indexof(i)].wait_cond_.broadcast();
+            }
+
+            wsrep_seqno_t const last_entered(r_last_entered_());
+
+            for (wsrep_seqno_t i(r_last_left_() + 1); i <= last_entered; ++i)
+            {
+                Process& a(process_[indexof(i)]);
+
+                // parked flag guarantees that the object is still there
+                if (a.parked_ && ring_may_enter(*a.obj_)) a.cond_.signal();
+            }
+
+            cond_.broadcast();
+        }
+
+        // advances last left if seqno is next to it and wakes up waiters
+        void ring_release(wsrep_seqno_t const seqno)
+        {
+            if (r_last_left_() + 1 != seqno) return; // not shrinking window
+
+            wsrep_seqno_t const last_left(ring_update_last_left(seqno));
+
+            if (last_left < seqno) return; // taken by another thread
+
+            oool_ += (last_left > seqno);
+
+            if (r_parked_() > 0)
+            {
+                gu::Lock lock(mutex_);
+                ring_wake_up(seqno, last_left);
+            }
+        }
+
+        void ring_set_initial_position(wsrep_seqno_t const seqno)
+        {
+            gu::Lock lock(mutex_);
+
+            if (r_last_entered_() == -1 || seqno == -1)
+            {
+                // first call or reset
+                for (ssize_t i(0); i < process_size_; ++i)
+                {
+                    process_[i].word_ = 0;
+                }
+                r_last_entered_ = seqno;
+                r_last_left_    = seqno;
+            }
+            else
+            {
+                // drain monitor up to seqno but don't reset last entered
+                // or last left
+                Parked parked(*this);
+                ring_drain_common(seqno, lock);
+                ring_drain_end();
+            }
+
+            if (seqno != -1)
+            {
+                process_[indexof(seqno)].wait_cond_.broadcast();
+            }
+        }
+
+        // wait until it is possible to grab slot in monitor,
+        // update last entered
+        void ring_pre_enter(C& obj)
+        {
+            const wsrep_seqno_t obj_seqno(obj.seqno());
+
+            if (gu_unlikely(ring_would_block(obj_seqno)))
+            {
+                gu::Lock lock(mutex_);
+                Parked   parked(*this);
+
+                while (ring_would_block(obj_seqno)) // TODO: exit on error
+                {
+                    obj.unlock();
+                    lock.wait(cond_);
+                    obj.lock();
+                }
+            }
+
+            ring_update_last_entered(obj_seqno);
+        }
+
+        // spins and then sleeps until obj may enter or its slot is canceled
+        void ring_wait(C& obj, Process& p, long long const waiting)
+        {
+            obj.unlock();
+
+            for (int i(0); i < spin_limit_; ++i)
+            {
+                if (p.word_() != waiting || ring_may_enter(obj))
+                {
+                    obj.lock();
+                    return;
+                }
+                cpu_relax();
+            }
+
+            {
+                gu::Lock lock(mutex_);
+                Parked   parked(*this);
+
+                p.parked_ = true;
+
+                while (p.word_() == waiting && ring_may_enter(obj) == false)
+                {
+                    ++waits_;
+                    lock.wait(p.cond_);
+                }
+
+                p.parked_ = false;
+            }
+
+            obj.lock();
+        }
+
+        void ring_enter(C& obj)
+        {
+            const wsrep_seqno_t obj_seqno(obj.seqno());
+            Process&            p(process_[indexof(obj_seqno)]);
+
+            assert(obj_seqno > r_last_left_());
+
+            ring_pre_enter(obj);
+
+            long long const waiting(make_word(obj_seqno, Process::S_WAITING));
+            long long       w(p.word_());
+
+            p.obj_ = &obj;
+
+            while (Process::S_IDLE == word_state(w) &&
+                   !p.word_.compare_and_swap(w, waiting))
+            {
+                w = p.word_();
+            }
+
+            if (gu_likely(Process::S_IDLE == word_state(w)))
+            {
+#ifdef GU_DBUG_ON
+                {
+                    gu::Lock lock(mutex_);
+                    obj.debug_sync(mutex_);
+                }
+#endif // GU_DBUG_ON
+                if (ring_may_enter(obj) == false) ring_wait(obj, p, waiting);
+
+                if (p.word_.compare_and_swap(
+                        waiting, make_word(obj_seqno, Process::S_APPLYING)))
+                {
+                    wsrep_seqno_t const last_left(r_last_left_());
+
+                    ++entered_;
+                    oooe_     += ((last_left + 1) < obj_seqno);
+                    win_size_ += long(r_last_entered_() - last_left);
+                    return;
+                }
+            }
+
+            assert(p.word_() == make_word(obj_seqno, Process::S_CANCELED));
+            p.obj_  = 0;
+            p.word_ = make_word(obj_seqno, Process::S_IDLE);
+
+            gu_throw_error(EINTR);
+        }
+
+        void ring_leave(const C& obj)
+        {
+            wsrep_seqno_t const obj_seqno(obj.seqno());
+            Process&            p(process_[indexof(obj_seqno)]);
+
+            assert(p.word_() == make_word(obj_seqno, Process::S_APPLYING) ||
+                   word_state(p.word_()) == Process::S_CANCELED);
+
+            p.obj_  = 0;
+            p.word_ = make_word(obj_seqno, Process::S_FINISHED);
+
+            ring_release(obj_seqno);
+        }
+
+        void ring_self_cancel(C& obj)
+        {
+            wsrep_seqno_t const obj_seqno(obj.seqno());
+            Process&            p(process_[indexof(obj_seqno)]);
+
+            assert(obj_seqno > r_last_left_());
+
+            if (gu_unlikely(obj_seqno - r_last_left_() >= process_size_))
+            {
+                gu::Lock lock(mutex_);
+                Parked   parked(*this);
+
+                while (obj_seqno - r_last_left_() >= process_size_)
+                    // TODO: exit on error
+                {
+                    log_warn << "Trying to self-cancel seqno out of process "
+                             << "space: obj_seqno - last_left_ = " << obj_seqno
+                             << " - " << r_last_left_() << " = "
+                             << (obj_seqno - r_last_left_())
+                             << ", process_size_: "  << process_size_
+                             << ". Deadlock is very likely.";
+                    obj.unlock();
+                    lock.wait(cond_);
+                    obj.lock();
+                }
+            }
+
+            assert(word_state(p.word_()) == Process::S_IDLE ||
+                   word_state(p.word_()) == Process::S_CANCELED);
+
+            ring_update_last_entered(obj_seqno);
+
+            p.obj_  = 0;
+            p.word_ = make_word(obj_seqno, Process::S_FINISHED);
+
+            // slots above drain seqno are released by drain end, unless it
+            // has already passed
+            if (obj_seqno <= r_drain_seqno_()) ring_release(obj_seqno);
+        }
+
+        void ring_interrupt(const C& obj)
+        {
+            wsrep_seqno_t const obj_seqno(obj.seqno());
+            Process&            p(process_[indexof(obj_seqno)]);
+            gu::Lock            lock(mutex_);
+
+            {
+                Parked parked(*this);
+
+                while (obj_seqno - r_last_left_() >= process_size_)
+                    // TODO: exit on error
+                {
+                    lock.wait(cond_);
+                }
+            }
+
+            long long const waiting(make_word(obj_seqno, Process::S_WAITING));
+            long long       w(p.word_());
+
+            // idle slot which was already used by this seqno is not canceled
+            while ((Process::S_IDLE == word_state(w) &&
+                    word_seqno(w)   <  obj_seqno     &&
+                    obj_seqno       >  r_last_left_()) || waiting == w)
+            {
+                if (p.word_.compare_and_swap(
+                        w, make_word(obj_seqno, Process::S_CANCELED)))
+                {
+                    // waiter may be parked, mutex_ is locked so the signal
+                    // can't be lost
+                    p.cond_.signal();
+                    return;
+                }
+
+                w = p.word_();
+            }
+
+            log_debug << "interrupting " << obj_seqno
+                      << " state " << word_state(w)
+                      << " le " << r_last_entered_()
+                      << " ll " << r_last_left_();
+        }
+
+        void ring_drain_common(wsrep_seqno_t const seqno, gu::Lock& lock)
+        {
+            log_debug << "draining up to " << seqno;
+
+            r_drain_seqno_ = seqno;
+
+            while (r_last_left_() < seqno) lock.wait(cond_);
+        }
+
+        // must be called under mutex_
+        void ring_drain_end()
+        {
+            r_drain_seqno_ = GU_LLONG_MAX;
+
+            // there can be some finished entries above drain seqno
+            wsrep_seqno_t const from(r_last_left_() + 1);
+            wsrep_seqno_t const to(ring_update_last_left(from));
+
+            ring_wake_up(from, to);
+        }
+
+        void ring_drain(wsrep_seqno_t const seqno)
+        {
+            gu::Lock lock(mutex_);
+            Parked   parked(*this);
+
+            while (r_drain_seqno_() != GU_LLONG_MAX)
+            {
+                lock.wait(cond_);
+            }
+
+            ring_drain_common(seqno, lock);
+            ring_drain_end();
+        }
+
         Monitor(const Monitor&);
         void operator=(const Monitor&);
 
@@ -450,17 +936,26 @@ namespace galera
         gu::Mutex mutex_;
         gu::Cond  cond_;
 #endif /* HAVE_PSI_INTERFACE */
+        MonitorMode const mode_;
+        int const         spin_limit_;
         wsrep_seqno_t last_entered_;
         wsrep_seqno_t last_left_;
         wsrep_seqno_t drain_seqno_;
+        // ring mode counterparts of the above, modified without mutex_
+        gu::Atomic<wsrep_seqno_t> r_last_entered_;
+        gu::Atomic<wsrep_seqno_t> r_last_left_;
+        gu::Atomic<wsrep_seqno_t> r_drain_seqno_;
+        // ring mode: number of threads waiting on monitor conditions,
+        // leaving threads take mutex_ to wake them only if it is not 0
+        gu::Atomic<long>          r_parked_;
         Process*      process_;
-        long entered_;  // entered
-        long oooe_;     // out of order entered
-        long oool_;     // out of order left
-        long win_size_; // window between last_left_ and last_entered_
+        gu::Atomic<long> entered_;  // entered
+        gu::Atomic<long> oooe_;     // out of order entered
+        gu::Atomic<long> oool_;     // out of order left
+        gu::Atomic<long> win_size_; // window between last left and last entered
         // Total number of waits in the monitor. Incremented before
         // entering into waiting state.
-        long long waits_;
+        gu::Atomic<long long> waits_;
     };
 }
 
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2021 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #include "galera_common.hpp"
@@ -134,6 +134,8 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     sst_state_          (SST_NONE),
     co_mode_            (CommitOrder::from_string(
                              config_.get(Param::commit_order))),
+    mon_mode_           (monitor_mode_from_string(
+                             config_.get(Param::monitor_impl))),
     state_file_         (config_.get(BASE_DIR)+'/'+GALERA_STATE_FILE),
     st_                 (state_file_),
     safe_to_bootstrap_  (true),
@@ -171,9 +173,11 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     gcs_                (config_, gcache_, proto_max_, args->proto_ver,
                          args->node_name, args->node_incoming),
     service_thd_        (gcs_, gcache_),
+    ws_checker_         (config_.get<int>(Param::checksum_threads),
+                         config_.get<ssize_t>(Param::checksum_threshold)),
     slave_pool_         (sizeof(TrxHandle), 1024, "SlaveTrxHandle"),
     as_                 (0),
-    gcs_as_             (slave_pool_, gcs_, *this, gcache_),
+    gcs_as_             (slave_pool_, gcs_, *this, gcache_, ws_checker_),
     ist_receiver_       (config_, slave_pool_, args->node_address),
     ist_prepared_       (false),
     ist_senders_        (gcs_, gcache_),
@@ -181,17 +185,22 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     cert_               (config_, service_thd_, gcache_),
 #ifdef HAVE_PSI_INTERFACE
     local_monitor_      (WSREP_PFS_INSTR_TAG_LOCAL_MONITOR_MUTEX,
-                         WSREP_PFS_INSTR_TAG_LOCAL_MONITOR_CONDVAR),
+                         WSREP_PFS_INSTR_TAG_LOCAL_MONITOR_CONDVAR,
+                         mon_mode_),
     apply_monitor_      (WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
-                         WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR),
+                         WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR,
+                         mon_mode_),
     commit_monitor_     (WSREP_PFS_INSTR_TAG_COMMIT_MONITOR_MUTEX,
-                         WSREP_PFS_INSTR_TAG_COMMIT_MONITOR_CONDVAR),
+                         WSREP_PFS_INSTR_TAG_COMMIT_MONITOR_CONDVAR,
+                         mon_mode_),
 #else
-    local_monitor_      (),
-    apply_monitor_      (),
-    commit_monitor_     (),
+    local_monitor_      (mon_mode_),
+    apply_monitor_      (mon_mode_),
+    commit_monitor_     (mon_mode_),
 #endif /* HAVE_PSI_INTERFACE */
     causal_read_timeout_(config_.get(Param::causal_read_timeout)),
+    compression_level_  (config_.get<int>(Param::compression_level)),
+    compression_threshold_(config_.get<size_t>(Param::compression_threshold)),
     receivers_          (),
     replicated_         (),
     replicated_bytes_   (),
@@ -199,6 +208,9 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     keys_bytes_         (),
     data_bytes_         (),
     unrd_bytes_         (),
+    compress_in_bytes_  (),
+    compress_out_bytes_ (),
+    compress_ns_        (),
     local_commits_      (),
     local_rollbacks_    (),
     local_cert_failures_(),
@@ -406,7 +418,13 @@ wsrep_status_t galera::ReplicatorSMM::async_recv(void* recv_ctx)
 
         ssize_t rc;
 
-        while (gu_unlikely((rc = as_->process(recv_ctx, exit_loop))
+        /* actions received in a batch are certified, applied and committed
+         * one after another by this thread, so with several slave threads
+         * batching would serialize them */
+        long const max_batch(receivers_() > 1 ?
+                             1 : GcsActionSource::MAX_BATCH);
+
+        while (gu_unlikely((rc = as_->process(recv_ctx, exit_loop, max_batch))
                            == -ECANCELED))
         {
             recv_IST(recv_ctx);
@@ -589,6 +607,19 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
 
     if (trx->new_version())
     {
+        if (compression_level_ > 0)
+        {
+            DataSet::CompressStats cs = { 0, 0, 0 };
+            trx->write_set_out().compress(compression_level_,
+                                          compression_threshold_, cs);
+            if (cs.bytes_in > 0)
+            {
+                compress_in_bytes_  += cs.bytes_in;
+                compress_out_bytes_ += cs.bytes_out;
+                compress_ns_        += cs.nsecs;
+            }
+        }
+
         act.buf  = NULL;
         act.size = trx->write_set_out().gather(trx->source_id(),
                                                trx->conn_id(),
@@ -1519,6 +1550,18 @@ void galera::ReplicatorSMM::establish_protocol_versions (int proto_ver)
         trx_params_.record_set_ver_ = gu::RecordSet::VER2;
         str_proto_ver_ = 2;
         break;
+    case 10:
+        // Protocol upgrade to vectorizable payload checksums (VHash).
+        trx_params_.version_ = 5;
+        trx_params_.record_set_ver_ = gu::RecordSet::VER2;
+        str_proto_ver_ = 2;
+        break;
+    case 11:
+        // Protocol upgrade to optionally compressed data sets.
+        trx_params_.version_ = 6;
+        trx_params_.record_set_ver_ = gu::RecordSet::VER2;
+        str_proto_ver_ = 2;
+        break;
     default:
         log_fatal << "Configuration change resulted in an unsupported protocol "
             "version: " << proto_ver << ". Can't continue.";
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2021 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 //! @file replicator_smm.hpp
@@ -206,6 +206,11 @@ namespace galera
             static const std::string commit_order;
             static const std::string causal_read_timeout;
             static const std::string max_write_set_size;
+            static const std::string monitor_impl;
+            static const std::string checksum_threads;
+            static const std::string checksum_threshold;
+            static const std::string compression_level;
+            static const std::string compression_threshold;
         };
 
         typedef std::pair<std::string, std::string> Default;
@@ -581,6 +586,7 @@ namespace galera
 
         // configurable params
         const CommitOrder::Mode co_mode_; // commit order mode
+        const MonitorMode       mon_mode_; // monitor implementation
 
         // persistent data location
         std::string           state_file_;
@@ -633,6 +639,7 @@ namespace galera
         gcache::GCache gcache_;
         GCS_IMPL       gcs_;
         ServiceThd     service_thd_;
+        WriteSetChecker ws_checker_;
 
         // action sources
         TrxHandle::SlavePool slave_pool_;
@@ -652,6 +659,10 @@ namespace galera
         Monitor<CommitOrder> commit_monitor_;
         gu::datetime::Period causal_read_timeout_;
 
+        // data set compression
+        int                  compression_level_;
+        size_t               compression_threshold_;
+
         // counters
         gu::Atomic<size_t>    receivers_;
         gu::Atomic<long long> replicated_;
@@ -660,6 +671,9 @@ namespace galera
         gu::Atomic<long long> keys_bytes_;
         gu::Atomic<long long> data_bytes_;
         gu::Atomic<long long> unrd_bytes_;
+        gu::Atomic<long long> compress_in_bytes_;
+        gu::Atomic<long long> compress_out_bytes_;
+        gu::Atomic<long long> compress_ns_;
         gu::Atomic<long long> local_commits_;
         gu::Atomic<long long> local_rollbacks_;
         gu::Atomic<long long> local_cert_failures_;
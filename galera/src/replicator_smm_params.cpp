@@ -1,4 +1,4 @@
-/* Copyright (C) 2012-2018 Codership Oy <info@codersip.com> */
+/* Copyright (C) 2012-2026 Codership Oy <info@codersip.com> */
 
 #include "replicator_smm.hpp"
 #include "gcs.hpp"
@@ -24,8 +24,23 @@ const std::string galera::ReplicatorSMM::Param::key_format =
     common_prefix + "key_format";
 const std::string galera::ReplicatorSMM::Param::max_write_set_size =
     common_prefix + "max_ws_size";
-
-int const galera::ReplicatorSMM::MAX_PROTO_VER(9);
+const std::string galera::ReplicatorSMM::Param::monitor_impl =
+    common_prefix + "monitor_impl";
+const std::string galera::ReplicatorSMM::Param::checksum_threads =
+    common_prefix + "checksum_threads";
+const std::string galera::ReplicatorSMM::Param::checksum_threshold =
+    common_prefix + "checksum_threshold";
+const std::string galera::ReplicatorSMM::Param::compression_level =
+    common_prefix + "compression_level";
+const std::string galera::ReplicatorSMM::Param::compression_threshold =
+    common_prefix + "compression_threshold";
+
+#ifdef HAVE_ZLIB
+int const galera::ReplicatorSMM::MAX_PROTO_VER(11);
+#else
+/* protocol 11 allows peers to send compressed write sets */
+int const galera::ReplicatorSMM::MAX_PROTO_VER(10);
+#endif /* HAVE_ZLIB */
 
 galera::ReplicatorSMM::Defaults::Defaults() : map_()
 {
@@ -35,6 +50,11 @@ galera::ReplicatorSMM::Defaults::Defaults() : map_()
     map_.insert(Default(Param::key_format, "FLAT8"));
     map_.insert(Default(Param::commit_order, "3"));
     map_.insert(Default(Param::causal_read_timeout, "PT30S"));
+    map_.insert(Default(Param::monitor_impl, "mutex"));
+    map_.insert(Default(Param::checksum_threads, "2"));
+    map_.insert(Default(Param::checksum_threshold, "65536"));
+    map_.insert(Default(Param::compression_level, "0"));
+    map_.insert(Default(Param::compression_threshold, "4096"));
     const int max_write_set_size(galera::WriteSetNG::MAX_SIZE);
     map_.insert(Default(Param::max_write_set_size,
                         gu::to_string(max_write_set_size)));
@@ -130,6 +150,15 @@ galera::ReplicatorSMM::ParseOptions::ParseOptions(Replicator&       repl,
     }
     catch (gu::NotFound) {}
 
+#ifndef HAVE_ZLIB
+    if (conf.get<int>(Param::compression_level) != 0)
+    {
+        log_warn << "Can't set '" << Param::compression_level
+                 << "': compression support is not compiled in";
+        conf.set(Param::compression_level, "0");
+    }
+#endif /* HAVE_ZLIB */
+
     if (conf.get<bool>(Replicator::Param::debug_log))
     {
         gu_conf_debug_on();
@@ -161,7 +190,10 @@ void
 galera::ReplicatorSMM::set_param (const std::string& key,
                                   const std::string& value)
 {
-    if (key == Param::commit_order)
+    if (key == Param::commit_order ||
+        key == Param::monitor_impl ||
+        key == Param::checksum_threads ||
+        key == Param::checksum_threshold)
     {
         log_error << "setting '" << key << "' during runtime not allowed";
         gu_throw_error(EPERM)
@@ -187,6 +219,30 @@ galera::ReplicatorSMM::set_param (const std::string& key,
     {
         trx_params_.max_write_set_size_ = gu::from_string<int>(value);
     }
+    else if (key == Param::compression_level)
+    {
+        int const level(gu::from_string<int>(value));
+
+        if (level < 0 || level > 9)
+        {
+            gu_throw_error(EINVAL) << "'" << key << "' must be in [0, 9]: "
+                                   << value;
+        }
+#ifndef HAVE_ZLIB
+        if (level != 0)
+        {
+            gu_throw_error(EINVAL) << "Can't set '" << key
+                                   << "': compression support is not "
+                                   << "compiled in";
+        }
+#endif /* HAVE_ZLIB */
+
+        compression_level_ = level;
+    }
+    else if (key == Param::compression_threshold)
+    {
+        compression_threshold_ = gu::from_string<size_t>(value);
+    }
     else
     {
         log_warn << "parameter '" << key << "' not found";
@@ -84,6 +84,10 @@ typedef enum status_vars
     STATS_KEYS_BYTES,
     STATS_DATA_BYTES,
     STATS_UNRD_BYTES,
+    STATS_COMPRESS_IN_BYTES,
+    STATS_COMPRESS_OUT_BYTES,
+    STATS_COMPRESS_RATIO,
+    STATS_COMPRESS_NS,
     STATS_RECEIVED,
     STATS_RECEIVED_BYTES,
     STATS_LOCAL_COMMITS,
@@ -97,6 +101,7 @@ typedef enum status_vars
     STATS_LOCAL_RECV_QUEUE_MAX,
     STATS_LOCAL_RECV_QUEUE_MIN,
     STATS_LOCAL_RECV_QUEUE_AVG,
+    STATS_LOCAL_RECV_QUEUE_BYTES,
     STATS_LOCAL_CACHED_DOWNTO,
     STATS_FC_PAUSED_NS,
     STATS_FC_PAUSED_AVG,
@@ -109,6 +114,9 @@ typedef enum status_vars
     STATS_FC_STATUS,
     STATS_FC_ACTIVE,
     STATS_FC_REQUESTED,
+    STATS_FC_PACED_NS,
+    STATS_FC_PACING_RATE,
+    STATS_FC_REASON,
     STATS_CERT_DEPS_DISTANCE,
     STATS_APPLY_OOOE,
     STATS_APPLY_OOOL,
@@ -121,7 +129,17 @@ typedef enum status_vars
     STATS_LOCAL_STATE_COMMENT,
     STATS_CERT_INDEX_SIZE,
     STATS_CERT_BUCKET_COUNT,
+    STATS_CERT_PURGE_BACKLOG,
+    STATS_CERT_PURGE_SLICE_AVG_NS,
+    STATS_CERT_PURGE_SLICE_MAX_NS,
     STATS_GCACHE_POOL_SIZE,
+    STATS_GCACHE_RELEASE_BACKLOG,
+    STATS_GCACHE_RELEASE_SLICE_AVG_NS,
+    STATS_GCACHE_RELEASE_SLICE_MAX_NS,
+    STATS_GCACHE_PAGE_ALLOCS,
+    STATS_GCACHE_PAGE_ALLOCS_SPARE,
+    STATS_GCACHE_PAGE_ALLOC_AVG_NS,
+    STATS_GCACHE_PAGE_ALLOC_MAX_NS,
     STATS_CAUSAL_READS,
     STATS_CERT_INTERVAL,
     STATS_OPEN_TRX,
@@ -146,6 +164,10 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "repl_keys_bytes",          WSREP_VAR_INT64,  { 0 }  },
     { "repl_data_bytes",          WSREP_VAR_INT64,  { 0 }  },
     { "repl_other_bytes",         WSREP_VAR_INT64,  { 0 }  },
+    { "repl_compress_in_bytes",   WSREP_VAR_INT64,  { 0 }  },
+    { "repl_compress_out_bytes",  WSREP_VAR_INT64,  { 0 }  },
+    { "repl_compress_ratio",      WSREP_VAR_DOUBLE, { 0 }  },
+    { "repl_compress_ns",         WSREP_VAR_INT64,  { 0 }  },
     { "received",                 WSREP_VAR_INT64,  { 0 }  },
     { "received_bytes",           WSREP_VAR_INT64,  { 0 }  },
     { "local_commits",            WSREP_VAR_INT64,  { 0 }  },
@@ -159,6 +181,7 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "local_recv_queue_max",     WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_min",     WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_avg",     WSREP_VAR_DOUBLE, { 0 }  },
+    { "local_recv_queue_bytes",   WSREP_VAR_INT64,  { 0 }  },
     { "local_cached_downto",      WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_paused_ns",   WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_paused",      WSREP_VAR_DOUBLE, { 0 }  },
@@ -171,6 +194,9 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "flow_control_status",      WSREP_VAR_STRING, { 0 }  },
     { "flow_control_active",      WSREP_VAR_STRING, { 0 }  },
     { "flow_control_requested",   WSREP_VAR_STRING, { 0 }  },
+    { "flow_control_paced_ns",    WSREP_VAR_INT64,  { 0 }  },
+    { "flow_control_pacing_rate", WSREP_VAR_DOUBLE, { 0 }  },
+    { "flow_control_reason",      WSREP_VAR_STRING, { 0 }  },
     { "cert_deps_distance",       WSREP_VAR_DOUBLE, { 0 }  },
     { "apply_oooe",               WSREP_VAR_DOUBLE, { 0 }  },
     { "apply_oool",               WSREP_VAR_DOUBLE, { 0 }  },
@@ -183,7 +209,17 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "local_state_comment",      WSREP_VAR_STRING, { 0 }  },
     { "cert_index_size",          WSREP_VAR_INT64,  { 0 }  },
     { "cert_bucket_count",        WSREP_VAR_INT64,  { 0 }  },
+    { "cert_purge_backlog",       WSREP_VAR_INT64,  { 0 }  },
+    { "cert_purge_slice_avg_ns",  WSREP_VAR_DOUBLE, { 0 }  },
+    { "cert_purge_slice_max_ns",  WSREP_VAR_INT64,  { 0 }  },
     { "gcache_pool_size",         WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_release_backlog",   WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_release_slice_avg_ns", WSREP_VAR_DOUBLE, { 0 }  },
+    { "gcache_release_slice_max_ns", WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_page_allocs",       WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_page_allocs_spare", WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_page_alloc_avg_ns", WSREP_VAR_DOUBLE, { 0 }  },
+    { "gcache_page_alloc_max_ns", WSREP_VAR_INT64,  { 0 }  },
     { "causal_reads",             WSREP_VAR_INT64,  { 0 }  },
     { "cert_interval",            WSREP_VAR_DOUBLE, { 0 }  },
     { "open_transactions",        WSREP_VAR_INT64,  { 0 }  },
@@ -227,6 +263,14 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_KEYS_BYTES         ].value._int64  = keys_bytes_();
     sv[STATS_DATA_BYTES         ].value._int64  = data_bytes_();
     sv[STATS_UNRD_BYTES         ].value._int64  = unrd_bytes_();
+
+    long long const compress_in(compress_in_bytes_());
+    long long const compress_out(compress_out_bytes_());
+    sv[STATS_COMPRESS_IN_BYTES  ].value._int64  = compress_in;
+    sv[STATS_COMPRESS_OUT_BYTES ].value._int64  = compress_out;
+    sv[STATS_COMPRESS_RATIO     ].value._double =
+        compress_in > 0 ? double(compress_out)/compress_in : 1.0;
+    sv[STATS_COMPRESS_NS        ].value._int64  = compress_ns_();
     sv[STATS_RECEIVED           ].value._int64  = gcs_as_.received();
     sv[STATS_RECEIVED_BYTES     ].value._int64  = gcs_as_.received_bytes();
     sv[STATS_LOCAL_COMMITS      ].value._int64  = local_commits_();
@@ -246,6 +290,7 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_LOCAL_RECV_QUEUE_MAX].value._int64  = stats.recv_q_len_max;
     sv[STATS_LOCAL_RECV_QUEUE_MIN].value._int64  = stats.recv_q_len_min;
     sv[STATS_LOCAL_RECV_QUEUE_AVG].value._double = stats.recv_q_len_avg;
+    sv[STATS_LOCAL_RECV_QUEUE_BYTES].value._int64 = stats.recv_q_size;
     sv[STATS_LOCAL_CACHED_DOWNTO ].value._int64  =
         seqno_min != GCS_SEQNO_ILL ? seqno_min : GCS_SEQNO_NIL;
     sv[STATS_FC_PAUSED_NS        ].value._int64  = stats.fc_paused_ns;
@@ -266,6 +311,10 @@ galera::ReplicatorSMM::stats_get()
         "true" : "false";
     sv[STATS_FC_REQUESTED        ].value._string = stats.fc_requested ?
         "true" : "false";
+    sv[STATS_FC_PACED_NS         ].value._int64  = stats.fc_paced_ns;
+    sv[STATS_FC_PACING_RATE      ].value._double = stats.fc_pacing_rate;
+    sv[STATS_FC_REASON           ].value._string = stats.fc_reason ?
+        stats.fc_reason : "none";
 
     double avg_cert_interval(0);
     double avg_deps_dist(0);
@@ -277,8 +326,39 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_CERT_INDEX_SIZE     ].value._int64 = index_size;
     sv[STATS_CERT_BUCKET_COUNT   ].value._int64 = cert_.bucket_count();
 
+    size_t    purge_backlog(0);
+    double    purge_slice_avg(0);
+    long long purge_slice_max(0);
+    cert_.purge_stats_get(purge_backlog, purge_slice_avg, purge_slice_max);
+
+    sv[STATS_CERT_PURGE_BACKLOG  ].value._int64  = purge_backlog;
+    sv[STATS_CERT_PURGE_SLICE_AVG_NS].value._double = purge_slice_avg;
+    sv[STATS_CERT_PURGE_SLICE_MAX_NS].value._int64  = purge_slice_max;
+
     sv[STATS_GCACHE_POOL_SIZE    ].value._int64 = gcache_.allocated_pool_size();
 
+    long long release_backlog(0);
+    double    release_slice_avg(0);
+    long long release_slice_max(0);
+    service_thd_.release_stats_get(release_backlog, release_slice_avg,
+                                   release_slice_max);
+
+    sv[STATS_GCACHE_RELEASE_BACKLOG ].value._int64  = release_backlog;
+    sv[STATS_GCACHE_RELEASE_SLICE_AVG_NS].value._double = release_slice_avg;
+    sv[STATS_GCACHE_RELEASE_SLICE_MAX_NS].value._int64  = release_slice_max;
+
+    long long page_allocs(0);
+    long long page_allocs_spare(0);
+    double    page_alloc_avg(0);
+    long long page_alloc_max(0);
+    gcache_.page_stats_get(page_allocs, page_allocs_spare, page_alloc_avg,
+                           page_alloc_max);
+
+    sv[STATS_GCACHE_PAGE_ALLOCS      ].value._int64  = page_allocs;
+    sv[STATS_GCACHE_PAGE_ALLOCS_SPARE].value._int64  = page_allocs_spare;
+    sv[STATS_GCACHE_PAGE_ALLOC_AVG_NS].value._double = page_alloc_avg;
+    sv[STATS_GCACHE_PAGE_ALLOC_MAX_NS].value._int64  = page_alloc_max;
+
     double oooe;
     double oool;
     double win;
@@ -429,6 +509,10 @@ galera::ReplicatorSMM::stats_reset()
     commit_monitor_.flush_stats();
 
     cert_.stats_reset();
+
+    service_thd_.stats_reset();
+
+    gcache_.page_stats_reset();
 }
 
 void
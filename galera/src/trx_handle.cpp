@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2017 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 #include "trx_handle.hpp"
@@ -194,7 +194,7 @@ galera::TrxHandle::serialize(gu::byte_t* buf, size_t buflen, size_t offset)const
 
 size_t
 galera::TrxHandle::unserialize(const gu::byte_t* const buf, size_t const buflen,
-                               size_t offset)
+                               size_t offset, WriteSetChecker* const checker)
 {
     try
     {
@@ -231,7 +231,9 @@ galera::TrxHandle::unserialize(const gu::byte_t* const buf, size_t const buflen,
             break;
         case 3:
         case 4:
-            write_set_in_.read_buf (buf, buflen);
+        case 5:
+        case 6:
+            write_set_in_.read_buf (buf, buflen, checker);
             write_set_flags_ = wsng_flags_to_trx_flags(write_set_in_.flags());
             source_id_       = write_set_in_.source_id();
             conn_id_         = write_set_in_.conn_id();
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2017 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 
@@ -630,7 +630,9 @@ namespace galera
 
         size_t serial_size() const;
         size_t serialize  (gu::byte_t* buf, size_t buflen, size_t offset) const;
-        size_t unserialize(const gu::byte_t* buf, size_t buflen, size_t offset);
+        /* checker, if given, may verify write set checksum in background */
+        size_t unserialize(const gu::byte_t* buf, size_t buflen, size_t offset,
+                           WriteSetChecker* checker = NULL);
 
         void release_write_set_out()
         {
@@ -756,8 +758,8 @@ namespace galera
                                        0,
                                        params.record_set_ver_,
                                        WriteSetNG::Version(params.version_),
-                                       DataSet::MAX_VERSION,
-                                       DataSet::MAX_VERSION,
+                                       DataSet::max_version(params.version_),
+                                       DataSet::max_version(params.version_),
                                        params.max_write_set_size_);
             }
         }
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "write_set_checker.hpp"
+#include "write_set_ng.hpp"
+
+#include <algorithm> // std::find()
+
+void*
+galera::WriteSetChecker::thd_func(void* arg)
+{
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_INIT,
+                       WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    WriteSetChecker* const wc(static_cast<WriteSetChecker*>(arg));
+    WriteSetIn* ws;
+    bool keys;
+
+    while ((ws = wc->next_job(keys)) != NULL)
+    {
+        if (keys) wc->parse_keys(*ws);
+        ws->checksum(); // does not throw
+        wc->job_done(*ws);
+    }
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    return NULL;
+}
+
+galera::WriteSetChecker::WriteSetChecker(int const     threads,
+                                         ssize_t const threshold)
+    :
+#ifdef HAVE_PSI_INTERFACE
+    mtx_      (WSREP_PFS_INSTR_TAG_SERVICE_THD_MUTEX),
+    cond_     (WSREP_PFS_INSTR_TAG_SERVICE_THD_CONDVAR),
+    done_     (WSREP_PFS_INSTR_TAG_SERVICE_THD_FLUSH_CONDVAR),
+#else
+    mtx_      (),
+    cond_     (),
+    done_     (),
+#endif /* HAVE_PSI_INTERFACE */
+    queue_    (),
+    threads_  (),
+    threshold_(threshold),
+    exit_     (false)
+{
+    threads_.reserve(std::max(threads, 0));
+
+    for (int i(0); i < threads; ++i)
+    {
+        gu_thread_t thd;
+        int const err(gu_thread_create(&thd, NULL, thd_func, this));
+
+        if (gu_unlikely(err != 0))
+        {
+            log_warn << "Starting write set checksum thread failed: " << err
+                     << " (" << ::strerror(err) << "), continuing with "
+                     << threads_.size() << " threads";
+            break;
+        }
+
+        threads_.push_back(thd);
+    }
+}
+
+galera::WriteSetChecker::~WriteSetChecker()
+{
+    {
+        gu::Lock lock(mtx_);
+        assert(queue_.empty());
+        exit_ = true;
+        cond_.broadcast();
+    }
+
+    for (size_t i(0); i < threads_.size(); ++i)
+    {
+        gu_thread_join(threads_[i], NULL);
+    }
+}
+
+void
+galera::WriteSetChecker::submit(WriteSetIn& ws, bool const keys)
+{
+    assert(!threads_.empty());
+
+    gu::Lock lock(mtx_);
+
+    assert(J_NONE == ws.check_job_);
+    assert(J_NONE == ws.keys_job_);
+
+    ws.check_job_ = J_QUEUED;
+    ws.keys_job_  = keys ? J_QUEUED : J_NONE;
+    queue_.push_back(&ws);
+    cond_.signal();
+}
+
+bool
+galera::WriteSetChecker::withdraw(WriteSetIn& ws)
+{
+    gu::Lock lock(mtx_);
+
+    if (J_QUEUED == ws.check_job_)
+    {
+        std::deque<WriteSetIn*>::iterator const i
+            (std::find(queue_.begin(), queue_.end(), &ws));
+        assert(i != queue_.end());
+        queue_.erase(i);
+        ws.check_job_ = J_NONE;
+        return true;
+    }
+
+    while (J_RUNNING == ws.check_job_) lock.wait(done_);
+
+    assert(J_DONE == ws.check_job_);
+    ws.check_job_ = J_NONE;
+    return false;
+}
+
+void
+galera::WriteSetChecker::wait(WriteSetIn& ws)
+{
+    /* not picked up by workers yet, checksumming it here is faster than
+     * waiting for the queue to move */
+    if (withdraw(ws)) ws.checksum();
+}
+
+void
+galera::WriteSetChecker::wait_keys(WriteSetIn& ws)
+{
+    bool parsed;
+    {
+        gu::Lock lock(mtx_);
+
+        while (J_RUNNING == ws.keys_job_) lock.wait(done_);
+
+        /* if still queued, this takes the job away from the workers */
+        parsed = (J_DONE == ws.keys_job_);
+        ws.keys_job_ = J_NONE;
+    }
+
+    /* KeySetIn iteration does not interfere with a concurrent checksum */
+    if (!parsed) gu_trace(ws.parse_keys());
+}
+
+void
+galera::WriteSetChecker::cancel(WriteSetIn& ws)
+{
+    withdraw(ws);
+}
+
+galera::WriteSetIn*
+galera::WriteSetChecker::next_job(bool& keys)
+{
+    gu::Lock lock(mtx_);
+
+    while (queue_.empty() && !exit_) lock.wait(cond_);
+
+    if (exit_) return NULL;
+
+    WriteSetIn* const ws(queue_.front());
+    queue_.pop_front();
+    ws->check_job_ = J_RUNNING;
+
+    keys = (J_QUEUED == ws->keys_job_);
+    if (keys) ws->keys_job_ = J_RUNNING;
+
+    return ws;
+}
+
+void
+galera::WriteSetChecker::parse_keys(WriteSetIn& ws)
+{
+    JobState result(J_DONE);
+
+    try
+    {
+        ws.parse_keys();
+    }
+    catch (...)
+    {
+        /* leave it to wait_keys() to parse again and throw in the receiving
+         * thread */
+        ws.key_parts_().clear();
+        ws.keys_.rewind();
+        result = J_NONE;
+    }
+
+    gu::Lock lock(mtx_);
+
+    assert(J_RUNNING == ws.keys_job_);
+    ws.keys_job_ = result;
+    done_.broadcast();
+}
+
+void
+galera::WriteSetChecker::job_done(WriteSetIn& ws)
+{
+    gu::Lock lock(mtx_);
+
+    assert(J_RUNNING == ws.check_job_);
+    ws.check_job_ = J_DONE;
+    done_.broadcast();
+}
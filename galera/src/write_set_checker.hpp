@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#ifndef GALERA_WRITE_SET_CHECKER_HPP
+#define GALERA_WRITE_SET_CHECKER_HPP
+
+#include <gu_lock.hpp> // gu::Mutex and gu::Cond
+#include <gu_threads.h>
+
+#include <deque>
+#include <vector>
+
+namespace galera
+{
+    class WriteSetIn;
+
+    /*!
+     * Pool of threads which parse key sets and verify checksums of received
+     * write sets while the receiving thread processes preceding actions.
+     *
+     * Parsed keys are collected by WriteSetIn::key_count() before
+     * certification and the checksum by WriteSetIn::verify_checksum() after
+     * the certification verdict. A job which is still in the queue by that
+     * time is taken back and done by the caller, so waiting never takes
+     * longer than doing it in place would.
+     */
+    class WriteSetChecker
+    {
+    public:
+
+        /*!
+         * @param threads   number of worker threads, 0 disables the pool
+         * @param threshold minimum write set size to be checksummed
+         *                  in the pool
+         */
+        WriteSetChecker(int threads, ssize_t threshold);
+
+        ~WriteSetChecker();
+
+        /*! whether write set of a given size should be submitted */
+        bool accepts(ssize_t const size) const
+        {
+            return (!threads_.empty() && size >= threshold_);
+        }
+
+        /*! queues write set for checksumming and, if keys is true, for
+         *  key set parsing */
+        void submit(WriteSetIn& ws, bool keys);
+
+        /*! waits until write set key set is parsed */
+        void wait_keys(WriteSetIn& ws);
+
+        /*! waits until write set is checksummed */
+        void wait(WriteSetIn& ws);
+
+        /*! withdraws write set, the result is not needed */
+        void cancel(WriteSetIn& ws);
+
+    private:
+
+        enum JobState
+        {
+            J_NONE,
+            J_QUEUED,
+            J_RUNNING,
+            J_DONE
+        };
+
+        /* removes write set from the queue or waits for the worker to finish
+         * with it, returns true if it was removed */
+        bool withdraw(WriteSetIn& ws);
+
+        WriteSetIn* next_job(bool& keys);
+        void        parse_keys(WriteSetIn& ws);
+        void        job_done(WriteSetIn& ws);
+
+        static void* thd_func(void*);
+
+        WriteSetChecker(const WriteSetChecker&);
+        WriteSetChecker& operator=(const WriteSetChecker&);
+
+#ifdef HAVE_PSI_INTERFACE
+        gu::MutexWithPFS         mtx_;
+        gu::CondWithPFS          cond_; // job queued
+        gu::CondWithPFS          done_; // job done
+#else
+        gu::Mutex                mtx_;
+        gu::Cond                 cond_; // job queued
+        gu::Cond                 done_; // job done
+#endif /* HAVE_PSI_INTERFACE */
+        std::deque<WriteSetIn*>  queue_;
+        std::vector<gu_thread_t> threads_;
+        ssize_t const            threshold_;
+        bool                     exit_;
+    };
+}
+
+#endif /* GALERA_WRITE_SET_CHECKER_HPP */
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2013-2017 Codership Oy <info@codership.com>
+// Copyright (C) 2013-2026 Codership Oy <info@codership.com>
 //
 
 
@@ -71,7 +71,9 @@ WriteSetNG::Header::gather (KeySet::Version const  kver,
     assert (uint(dver) <= DataSet::MAX_VERSION);
 
     local_[V3_MAGIC_OFF]       = MAGIC_BYTE;
-    local_[V3_HEADER_VERS_OFF] = (version() << 4) | VER3;
+    /* VER5+ payload can't be parsed by earlier versions */
+    local_[V3_HEADER_VERS_OFF] = (version() << 4) | (version() < VER5 ? VER3 :
+                                                     version());
     local_[V3_HEADER_SIZE_OFF] = size();
 
     local_[V3_SETS_OFF] = (kver << 4) | (dver << 2) |
@@ -191,9 +193,10 @@ const char WriteSetOut::annt_suffix[] = "_annt";
 
 
 void
-WriteSetIn::init (ssize_t const st)
+WriteSetIn::init (ssize_t const st, WriteSetChecker* const checker)
 {
     assert(false == check_thr_);
+    assert(NULL == checker_);
 
     const gu::byte_t* const pptr (header_.payload());
     ssize_t           const psize(size_ - header_.size());
@@ -201,12 +204,27 @@ WriteSetIn::init (ssize_t const st)
     assert (psize >= 0);
 
     KeySet::Version const kver(header_.keyset_ver());
+    bool const pool(st > 0 && checker != NULL && checker->accepts(size_));
 
-    if (kver != KeySet::EMPTY) gu_trace(keys_.init (kver, pptr, psize));
+    if (kver != KeySet::EMPTY)
+    {
+        gu_trace(keys_.init (kver, pptr, psize));
+        if (!pool) gu_trace(parse_keys());
+    }
 
     assert (false == check_);
     assert (false == check_thr_);
 
+    if (pool)
+    {
+        /* key set parsing and checksum in the pool, key_count() and
+         * verify_checksum() collect the results */
+        keys_ready_ = (kver == KeySet::EMPTY);
+        checker->submit(*this, !keys_ready_);
+        checker_ = checker;
+        return;
+    }
+
     if (gu_likely(st > 0)) /* checksum enforced */
     {
         if (size_ >= st)
@@ -237,6 +255,22 @@ WriteSetIn::init (ssize_t const st)
 }
 
 
+void
+WriteSetIn::parse_keys()
+{
+    long const count(keys_.count());
+
+    key_parts_.reserve(count);
+
+    for (long i(0); i < count; ++i)
+    {
+        key_parts_().push_back(keys_.next());
+    }
+
+    keys_.rewind();
+}
+
+
 void
 WriteSetIn::checksum()
 {
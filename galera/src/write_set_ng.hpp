@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2013-2017 Codership Oy <info@codership.com>
+// Copyright (C) 2013-2026 Codership Oy <info@codership.com>
 //
 
 /*
@@ -17,6 +17,7 @@
 #include "wsrep_api.h"
 #include "key_set.hpp"
 #include "data_set.hpp"
+#include "write_set_checker.hpp"
 
 #include "gu_serialize.hpp"
 #include "gu_vector.hpp"
@@ -38,11 +39,13 @@ namespace galera
         enum Version
         {
             VER3 = 3,
-            VER4
+            VER4,
+            VER5, /* VHash payload checksums */
+            VER6  /* DataSet::VER2 (compressed payload) */
         };
 
         /* Max header version that we can understand */
-        static Version const MAX_VERSION = VER4;
+        static Version const MAX_VERSION = VER6;
 
         /* Parses beginning of the header to detect writeset version and
          * returns it as raw integer for backward compatibility
@@ -89,6 +92,8 @@ namespace galera
             {
             case VER3: return VER3;
             case VER4: return VER4;
+            case VER5: return VER5;
+            case VER6: return VER6;
             }
 
             gu_throw_error (EPROTO) << "Unrecognized writeset version: " << v;
@@ -134,6 +139,8 @@ namespace galera
                 {
                 case VER3:
                 case VER4:
+                case VER5:
+                case VER6:
                 {
                     GU_COMPILE_ASSERT(0 == (V3_SIZE % GU_MIN_ALIGNMENT),
                                       unaligned_header_size);
@@ -503,10 +510,12 @@ namespace galera
                     kbn_, kver, rsv, ver),
             /* 5/8 of reserved goes to data set  */
             dbn_   (base_name_),
-            data_  (reserved + reserved_size, reserved_size*5, dbn_, dver, rsv),
+            data_  (reserved + reserved_size, reserved_size*5, dbn_, dver, rsv,
+                    ver),
             /* 2/8 of reserved goes to unordered set  */
             ubn_   (base_name_),
-            unrd_  (reserved + reserved_size*6, reserved_size*2, ubn_, uver,rsv),
+            unrd_  (reserved + reserved_size*6, reserved_size*2, ubn_, uver,rsv,
+                    ver),
             /* annotation set is not allocated unless requested */
             abn_   (base_name_),
             annt_  (NULL),
@@ -538,9 +547,10 @@ namespace galera
         {
             if (NULL == annt_)
             {
-                annt_ = new DataSetOut(NULL, 0, abn_, DataSet::MAX_VERSION,
-                                       // use the same version as the dataset
-                                       data_.gu::RecordSet::version());
+                // use the same versions as the dataset
+                annt_ = new DataSetOut(NULL, 0, abn_, data_.format(),
+                                       data_.gu::RecordSet::version(),
+                                       header_.version());
                 left_ -= annt_->size();
             }
 
@@ -552,6 +562,14 @@ namespace galera
         void mark_toi()                { flags_ |= WriteSetNG::F_TOI; }
         void mark_pa_unsafe()          { flags_ |= WriteSetNG::F_PA_UNSAFE; }
 
+        /* compresses data set payload if it is large enough,
+         * must be called after the last append_data() */
+        void compress(int const level, size_t const threshold,
+                      DataSet::CompressStats& stats)
+        {
+            data_.compress(level, threshold, stats);
+        }
+
         bool is_empty() const
         {
             return ((data_.count() + keys_.count() + unrd_.count() +
@@ -674,49 +692,62 @@ namespace galera
     {
     public:
 
-        WriteSetIn (const gu::Buf& buf, ssize_t const st = SIZE_THRESHOLD)
+        WriteSetIn (const gu::Buf& buf, ssize_t const st = SIZE_THRESHOLD,
+                    WriteSetChecker* const checker = NULL)
             : header_(buf),
               size_  (buf.size),
               keys_  (),
+              key_parts_(),
               data_  (),
               unrd_  (),
               annt_  (NULL),
               check_thr_id_(),
               check_thr_(false),
-              check_ (false)
+              keys_ready_(true),
+              check_ (false),
+              checker_(NULL),
+              check_job_(0),
+              keys_job_(0)
         {
-            gu_trace(init(st));
+            gu_trace(init(st, checker));
         }
 
         WriteSetIn ()
             : header_(),
               size_  (0),
               keys_  (),
+              key_parts_(),
               data_  (),
               unrd_  (),
               annt_  (NULL),
               check_thr_id_(),
               check_thr_(false),
-              check_ (false)
+              keys_ready_(true),
+              check_ (false),
+              checker_(NULL),
+              check_job_(0),
+              keys_job_(0)
         {}
 
         /* WriteSetIn(buf) == WriteSetIn() + read_buf(buf) */
-        void read_buf (const gu::Buf& buf, ssize_t const st = SIZE_THRESHOLD)
+        void read_buf (const gu::Buf& buf, ssize_t const st = SIZE_THRESHOLD,
+                       WriteSetChecker* const checker = NULL)
         {
             assert (0 == size_);
             assert (false == check_);
 
             header_.read_buf (buf);
             size_ = buf.size;
-            gu_trace(init(st));
+            gu_trace(init(st, checker));
         }
 
-        void read_buf (const gu::byte_t* const ptr, ssize_t const len)
+        void read_buf (const gu::byte_t* const ptr, ssize_t const len,
+                       WriteSetChecker* const checker = NULL)
         {
             assert (ptr != NULL);
             assert (len >= 0);
             gu::Buf tmp = { ptr, len };
-            read_buf (tmp);
+            read_buf (tmp, SIZE_THRESHOLD, checker);
         }
 
         ~WriteSetIn ()
@@ -727,6 +758,8 @@ namespace galera
                 gu_thread_join (check_thr_id_, NULL);
             }
 
+            if (gu_unlikely(checker_ != NULL)) checker_->cancel(*this);
+
             delete annt_;
         }
 
@@ -747,6 +780,18 @@ namespace galera
         wsrep_trx_id_t      trx_id()    const { return header_.trx_id();    }
 
         const KeySetIn&  keyset()  const { return keys_; }
+
+        /* key set parsed in advance, to spare certification from it */
+        long key_count() const /* throws */
+        {
+            if (gu_unlikely(!keys_ready_)) gu_trace(wait_keys());
+            return key_parts_.size();
+        }
+        const KeySet::KeyPart& key_part(long const i) const
+        {
+            assert(keys_ready_);
+            return key_parts_[i];
+        }
         const DataSetIn& dataset() const { return data_; }
         const DataSetIn& unrdset() const { return unrd_; }
 
@@ -764,6 +809,14 @@ namespace galera
                 check_thr_ = false;
                 gu_trace(checksum_fin());
             }
+            else if (gu_unlikely(checker_ != NULL))
+            {
+                /* checksum was submitted to the checker pool */
+                if (!keys_ready_) gu_trace(wait_keys());
+                checker_->wait(*const_cast<WriteSetIn*>(this));
+                checker_ = NULL;
+                gu_trace(checksum_fin());
+            }
         }
 
         uint64_t get_checksum() const
@@ -794,15 +847,25 @@ namespace galera
 
     private:
 
+        friend class WriteSetChecker;
+
+        typedef gu::Vector<KeySet::KeyPart, 16> KeyParts;
+
         WriteSetNG::Header header_;
         ssize_t            size_;
         KeySetIn           keys_;
+        KeyParts           key_parts_;
         DataSetIn          data_;
         DataSetIn          unrd_;
         DataSetIn*         annt_;
         gu_thread_t        check_thr_id_;
         bool mutable       check_thr_;
+        bool mutable       keys_ready_;
         bool               check_;
+        mutable WriteSetChecker*
+                           checker_;
+        int                check_job_; /* protected by checker_ mutex */
+        int                keys_job_;  /* protected by checker_ mutex */
 
         static size_t const SIZE_THRESHOLD = 1 << 22; /* 4Mb */
 
@@ -838,7 +901,16 @@ namespace galera
         }
 
         /* late initialization after default constructor */
-        void init (ssize_t size_threshold);
+        void init (ssize_t size_threshold, WriteSetChecker* checker);
+
+        void parse_keys();
+
+        void wait_keys() const
+        {
+            assert(checker_ != NULL);
+            checker_->wait_keys(*const_cast<WriteSetIn*>(this));
+            keys_ready_ = true;
+        }
 
         WriteSetIn (const WriteSetIn&);
         WriteSetIn& operator=(WriteSetIn);
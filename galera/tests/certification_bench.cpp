@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Certification micro benchmark.
+ *
+ * Certifies a stream of synthetic version 3 write sets in total order, while
+ * purging the index from a separate thread (like ServiceThd-triggered purge
+ * does) and optionally running concurrent non-storing certification tests
+ * (like certification of BF-aborted transactions does).
+ *
+ * Usage: certification_bench [write sets] [keys per ws] [key space]
+ *                            [sources] [prober threads] [index shards]
+ *
+ * If index shard count is not given, the benchmark is run for 1, 16 and 64
+ * shards.
+ */
+
+#include "certification.hpp"
+#include "replicator_smm.hpp"
+#include "galera_service_thd.hpp"
+#include "galera_gcs.hpp"
+
+#include "gu_atomic.hpp"
+#include "gu_threads.h"
+#include "gu_uuid.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/time.h>
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+using namespace galera;
+
+namespace
+{
+    class TestEnv
+    {
+        class GCache_setup
+        {
+        public:
+            GCache_setup(gu::Config& conf)
+                : name_("certification_bench.gcache")
+            {
+                conf.set("gcache.name", name_);
+                conf.set("gcache.size", "1M");
+            }
+
+            ~GCache_setup()
+            {
+                unlink(name_.c_str());
+            }
+        private:
+            std::string const name_;
+        };
+
+    public:
+
+        TestEnv(size_t const shards) :
+            conf_   (),
+            init_   (conf_, NULL, NULL),
+            gcache_setup_(conf_),
+            gcache_ (conf_, "."),
+            gcs_    (conf_, gcache_),
+            thd_    (gcs_,  gcache_)
+        {
+            std::ostringstream os;
+            os << shards;
+            conf_.set(Certification::PARAM_INDEX_SHARDS, os.str());
+        }
+
+        gu::Config&         conf()   { return conf_;   }
+        galera::ServiceThd& thd()    { return thd_;    }
+        gcache::GCache&     gcache() { return gcache_; }
+
+    private:
+
+        gu::Config         conf_;
+        galera::ReplicatorSMM::InitConfig init_;
+        GCache_setup       gcache_setup_;
+        gcache::GCache     gcache_;
+        galera::DummyGcs   gcs_;
+        galera::ServiceThd thd_;
+    };
+
+    struct Params
+    {
+        size_t ws_count;
+        size_t keys;
+        size_t key_space;
+        size_t sources;
+        size_t probers;
+    };
+
+    static TrxHandle::LocalPool
+    lp(TrxHandle::LOCAL_STORAGE_SIZE(), 4, "bench_local_pool");
+
+    static TrxHandle::SlavePool
+    sp(sizeof(TrxHandle), 1024, "bench_slave_pool");
+
+    int const version(3);
+
+    /* produces serialized write set with random keys */
+    void
+    make_ws(std::vector<gu::byte_t>& ws,
+            const wsrep_uuid_t&      source,
+            wsrep_trx_id_t const     trx_id,
+            wsrep_seqno_t const      last_seen,
+            const Params&            p,
+            unsigned int&            seed)
+    {
+        TrxHandle::Params const trx_params("", version, KeySet::MAX_VERSION);
+        TrxHandle* const trx(TrxHandle::New(lp, trx_params, source, 1,
+                                            trx_id));
+
+        for (size_t k(0); k < p.keys; ++k)
+        {
+            uint64_t const key(rand_r(&seed) % p.key_space);
+            wsrep_buf_t const part = { &key, sizeof(key) };
+            trx->append_key(KeyData(version, &part, 1, WSREP_KEY_EXCLUSIVE,
+                                    true));
+        }
+
+        WriteSetNG::GatherVector out;
+        size_t const size(trx->write_set_out().gather(trx->source_id(),
+                                                      trx->conn_id(),
+                                                      trx->trx_id(),
+                                                      out));
+        trx->set_last_seen_seqno(last_seen);
+
+        ws.clear();
+        ws.reserve(size);
+        for (size_t i(0); i < out->size(); ++i)
+        {
+            const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[i].ptr));
+            ws.insert(ws.end(), ptr, ptr + out[i].size);
+        }
+
+        trx->unref();
+    }
+
+    TrxHandle*
+    make_slave_trx(const std::vector<gu::byte_t>& ws, wsrep_seqno_t const seqno)
+    {
+        TrxHandle* const trx(TrxHandle::New(sp));
+        trx->unserialize(&ws[0], ws.size(), 0);
+        trx->set_received(0, seqno, seqno);
+        return trx;
+    }
+
+    struct ThreadCtx
+    {
+        Certification*           cert;
+        gu::Atomic<long>*        stop;
+        gu::Atomic<long>*        purge_seqno;
+        std::vector<TrxHandle*>  trxs;
+        size_t                   ops;
+    };
+
+    /* runs non-storing certification tests until stopped */
+    void*
+    prober_func(void* arg)
+    {
+        ThreadCtx& ctx(*static_cast<ThreadCtx*>(arg));
+
+        while (0 == (*ctx.stop)())
+        {
+            for (size_t i(0); i < ctx.trxs.size(); ++i)
+            {
+                ctx.cert->test(ctx.trxs[i], false);
+            }
+
+            ctx.ops += ctx.trxs.size();
+        }
+
+        return NULL;
+    }
+
+    /* purges the index up to the last reported seqno until stopped */
+    void*
+    purger_func(void* arg)
+    {
+        ThreadCtx& ctx(*static_cast<ThreadCtx*>(arg));
+        long purged(0);
+
+        while (0 == (*ctx.stop)())
+        {
+            long const seqno((*ctx.purge_seqno)());
+
+            if (seqno > purged)
+            {
+                ctx.cert->purge_trxs_upto(seqno, false);
+                purged = seqno;
+                ++ctx.ops;
+            }
+            else
+            {
+                usleep(100);
+            }
+        }
+
+        return NULL;
+    }
+
+    void
+    run_bench(const Params& p, size_t const shards)
+    {
+        TestEnv env(shards);
+        Certification cert(env.conf(), env.thd(), env.gcache());
+        cert.assign_initial_position(0, 4);
+
+        std::vector<wsrep_uuid_t> sources(p.sources);
+        for (size_t i(0); i < sources.size(); ++i)
+        {
+            gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&sources[i]),
+                             NULL, 0);
+        }
+
+        unsigned int seed(1);
+
+        /* write sets must outlive trx handles, so generate all of them
+         * upfront, this also keeps generation out of the measurement */
+        std::vector<std::vector<gu::byte_t> > wss(p.ws_count);
+        for (size_t i(0); i < wss.size(); ++i)
+        {
+            wsrep_seqno_t const seqno(i + 1);
+            /* each source lags behind by the number of sources */
+            wsrep_seqno_t const lag(p.sources);
+            wsrep_seqno_t const last_seen(seqno > lag ? seqno - lag : 0);
+            make_ws(wss[i], sources[i % p.sources], i, last_seen, p, seed);
+        }
+
+        gu::Atomic<long> stop(0);
+        gu::Atomic<long> purge_seqno(0);
+
+        /* prober write sets see all of the stream, so they never conflict
+         * and scan all of their keys */
+        wsrep_seqno_t const probe_seqno(p.ws_count + 1);
+        std::vector<std::vector<gu::byte_t> > pws(p.probers * 64);
+        std::vector<ThreadCtx> probers(p.probers);
+        for (size_t t(0); t < probers.size(); ++t)
+        {
+            ThreadCtx& ctx(probers[t]);
+            ctx.cert = &cert;
+            ctx.stop = &stop;
+            ctx.purge_seqno = &purge_seqno;
+            ctx.ops  = 0;
+
+            for (size_t i(0); i < 64; ++i)
+            {
+                std::vector<gu::byte_t>& ws(pws[t * 64 + i]);
+                make_ws(ws, sources[0], probe_seqno + i, probe_seqno - 1, p,
+                        seed);
+                ctx.trxs.push_back(make_slave_trx(ws, probe_seqno));
+            }
+        }
+
+        ThreadCtx purger;
+        purger.cert = &cert;
+        purger.stop = &stop;
+        purger.purge_seqno = &purge_seqno;
+        purger.ops  = 0;
+
+        struct timeval start, stop_time;
+        gettimeofday(&start, NULL);
+
+        std::vector<gu_thread_t> threads(probers.size() + 1);
+        gu_thread_create(&threads[0], NULL, purger_func, &purger);
+        for (size_t t(0); t < probers.size(); ++t)
+        {
+            gu_thread_create(&threads[t + 1], NULL, prober_func, &probers[t]);
+        }
+
+        size_t conflicts(0);
+
+        for (size_t i(0); i < wss.size(); ++i)
+        {
+            TrxHandle* const trx(make_slave_trx(wss[i], i + 1));
+
+            if (cert.append_trx(trx) != Certification::TEST_OK) ++conflicts;
+
+            wsrep_seqno_t const purge(cert.set_trx_committed(trx));
+            if (purge > 0) purge_seqno = purge;
+
+            trx->unref();
+        }
+
+        gettimeofday(&stop_time, NULL);
+
+        stop = 1;
+        for (size_t t(0); t < threads.size(); ++t)
+        {
+            gu_thread_join(threads[t], NULL);
+        }
+
+        double const duration(time_diff(stop_time, start));
+
+        size_t probes(0);
+        for (size_t t(0); t < probers.size(); ++t)
+        {
+            probes += probers[t].ops;
+            for (size_t i(0); i < probers[t].trxs.size(); ++i)
+            {
+                probers[t].trxs[i]->unref();
+            }
+        }
+
+        std::cout << shards << '\t' << std::fixed << duration << '\t'
+                  << size_t(p.ws_count / duration) << '\t'
+                  << conflicts << '\t'
+                  << size_t(probes / duration) << '\t'
+                  << purger.ops << '\n';
+    }
+
+    template <typename T>
+    void
+    read_arg(char* argv[], int position, T& var)
+    {
+        std::istringstream is(argv[position]);
+        is >> var;
+        if (is.fail() || var == 0)
+        {
+            std::cerr << "Invalid argument " << position << ": '"
+                      << argv[position] << "'" << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p;
+    p.ws_count  = 200000;
+    p.keys      = 8;
+    p.key_space = 1 << 20;
+    p.sources   = 4;
+    p.probers   = 2;
+    size_t shards(0);
+
+    if (argc >= 2) read_arg(argv, 1, p.ws_count);
+    if (argc >= 3) read_arg(argv, 2, p.keys);
+    if (argc >= 4) read_arg(argv, 3, p.key_space);
+    if (argc >= 5) read_arg(argv, 4, p.sources);
+    if (argc >= 6)
+    {
+        std::istringstream is(argv[5]);
+        is >> p.probers;
+    }
+    if (argc >= 7) read_arg(argv, 6, shards);
+
+    std::cout << "Write sets: " << p.ws_count << ", keys: " << p.keys
+              << ", key space: " << p.key_space << ", sources: " << p.sources
+              << ", probers: " << p.probers << "\n\n"
+              << "Shards:\tDuration:\tWS/sec:\tConflicts:\tProbes/sec:\tPurges:\n";
+
+    if (shards)
+    {
+        run_bench(p, shards);
+    }
+    else
+    {
+        run_bench(p, 1);
+        run_bench(p, 16);
+        run_bench(p, 64);
+    }
+
+    return 0;
+}
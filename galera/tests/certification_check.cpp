@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "../src/certification.hpp"
+#include "../src/replicator_smm.hpp"
+#include "../src/galera_service_thd.hpp"
+#include "../src/galera_gcs.hpp"
+
+#include "gu_uuid.h"
+
+#include <check.h>
+#include <vector>
+#include <unistd.h>
+
+using namespace galera;
+
+namespace
+{
+    class TestEnv
+    {
+        class GCache_setup
+        {
+        public:
+            GCache_setup(gu::Config& conf)
+                : name_("certification_check.gcache")
+            {
+                conf.set("gcache.name", name_);
+                conf.set("gcache.size", "1M");
+            }
+
+            ~GCache_setup()
+            {
+                unlink(name_.c_str());
+            }
+        private:
+            std::string const name_;
+        };
+
+    public:
+
+        TestEnv() :
+            conf_   (),
+            init_   (conf_, NULL, NULL),
+            gcache_setup_(conf_),
+            gcache_ (conf_, "."),
+            gcs_    (conf_, gcache_),
+            thd_    (gcs_,  gcache_)
+        {}
+
+        gu::Config&         conf()   { return conf_;   }
+        galera::ServiceThd& thd()    { return thd_;    }
+        gcache::GCache&     gcache() { return gcache_; }
+
+    private:
+
+        gu::Config         conf_;
+        galera::ReplicatorSMM::InitConfig init_;
+        GCache_setup       gcache_setup_;
+        gcache::GCache     gcache_;
+        galera::DummyGcs   gcs_;
+        galera::ServiceThd thd_;
+    };
+
+    TrxHandle::LocalPool
+    lp(TrxHandle::LOCAL_STORAGE_SIZE(), 4, "certification_check_local_pool");
+
+    TrxHandle::SlavePool
+    sp(sizeof(TrxHandle), 4, "certification_check_slave_pool");
+
+    /* serializes a write set with exclusive keys and some data */
+    void
+    make_ws(std::vector<gu::byte_t>& ws, int const version,
+            const wsrep_uuid_t& source, wsrep_trx_id_t const trx_id,
+            const std::vector<uint64_t>& keys, wsrep_seqno_t const last_seen)
+    {
+        TrxHandle::Params const trx_params("", version, KeySet::MAX_VERSION);
+        TrxHandle* const trx(TrxHandle::New(lp, trx_params, source, 1,
+                                            trx_id));
+
+        for (size_t i(0); i < keys.size(); ++i)
+        {
+            wsrep_buf_t const part = { &keys[i], sizeof(keys[i]) };
+            trx->append_key(KeyData(version, &part, 1, WSREP_KEY_EXCLUSIVE,
+                                    true));
+        }
+
+        std::vector<char> const data(1024, 'd');
+        trx->append_data(&data[0], data.size(), WSREP_DATA_ORDERED, true);
+
+        WriteSetNG::GatherVector out;
+        trx->write_set_out().gather(trx->source_id(), trx->conn_id(),
+                                    trx->trx_id(), out);
+        trx->set_last_seen_seqno(last_seen);
+
+        ws.clear();
+        for (size_t i(0); i < out->size(); ++i)
+        {
+            const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[i].ptr));
+            ws.insert(ws.end(), ptr, ptr + out[i].size);
+        }
+
+        trx->unref();
+    }
+
+    /* serializes a write set with a single exclusive key and some data */
+    void
+    make_ws(std::vector<gu::byte_t>& ws, int const version,
+            const wsrep_uuid_t& source, wsrep_trx_id_t const trx_id,
+            uint64_t const key)
+    {
+        make_ws(ws, version, source, trx_id, std::vector<uint64_t>(1, key), 0);
+    }
+
+    /* keys [begin, end) */
+    std::vector<uint64_t>
+    key_range(uint64_t const begin, uint64_t const end)
+    {
+        std::vector<uint64_t> ret;
+        for (uint64_t k(begin); k < end; ++k) ret.push_back(k);
+        return ret;
+    }
+
+    TrxHandle*
+    make_slave_trx(const std::vector<gu::byte_t>& ws, wsrep_seqno_t const seqno)
+    {
+        TrxHandle* const trx(TrxHandle::New(sp));
+        trx->unserialize(&ws[0], ws.size(), 0);
+        trx->set_received(0, seqno, seqno);
+        return trx;
+    }
+
+    /* certifies two non-conflicting and one conflicting trx at the given
+     * certification protocol version */
+    void
+    certify(int const version)
+    {
+        TestEnv env;
+        Certification cert(env.conf(), env.thd(), env.gcache());
+        cert.assign_initial_position(0, version);
+
+        wsrep_uuid_t source1, source2;
+        gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&source1), NULL, 0);
+        gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&source2), NULL, 0);
+
+        std::vector<gu::byte_t> ws1, ws2, ws3;
+        make_ws(ws1, version, source1, 1, 1);
+        make_ws(ws2, version, source2, 2, 2);
+        make_ws(ws3, version, source2, 3, 1); // conflicts with ws1
+
+        TrxHandle* const trx1(make_slave_trx(ws1, 1));
+        TrxHandle* const trx2(make_slave_trx(ws2, 2));
+        TrxHandle* const trx3(make_slave_trx(ws3, 3));
+
+        ck_assert_int_eq(trx1->version(), version);
+
+        Certification::TestResult res(cert.append_trx(trx1));
+        ck_assert_msg(Certification::TEST_OK == res,
+                      "v%d trx1 certification failed", version);
+
+        res = cert.append_trx(trx2);
+        ck_assert_msg(Certification::TEST_OK == res,
+                      "v%d trx2 certification failed", version);
+
+        res = cert.append_trx(trx3);
+        ck_assert_msg(Certification::TEST_FAILED == res,
+                      "v%d trx3 certification did not detect conflict",
+                      version);
+
+        cert.set_trx_committed(trx1);
+        cert.set_trx_committed(trx2);
+        cert.set_trx_committed(trx3);
+
+        trx1->unref();
+        trx2->unref();
+        trx3->unref();
+    }
+}
+
+/* conflict detection, failed certification cleanup and purge with write
+ * sets spanning several index shards */
+START_TEST(certification_shards)
+{
+    int const version(WriteSetNG::VER5);
+
+    TestEnv env;
+    env.conf().set("cert.index_shards", "4");
+    /* small purge slices keep the background purge behind for a while */
+    env.conf().set("cert.purge_slice_keys", "16");
+    Certification cert(env.conf(), env.thd(), env.gcache());
+    cert.assign_initial_position(0, version);
+
+    wsrep_uuid_t source1, source2;
+    gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&source1), NULL, 0);
+    gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&source2), NULL, 0);
+
+    std::vector<uint64_t> keys3(key_range(3000, 3032));
+    keys3.push_back(100017); // conflicts with trx1
+
+    std::vector<uint64_t> keys6;
+    keys6.push_back(2010); // trx4 key, purged last
+    keys6.push_back(1010); // trx2 key
+
+    std::vector<gu::byte_t> ws[7];
+    make_ws(ws[0], version, source1, 1, key_range(100000, 200000), 0);
+    make_ws(ws[1], version, source1, 2, key_range(1000, 2000),     0);
+    make_ws(ws[2], version, source2, 3, keys3,                 0);
+    make_ws(ws[3], version, source2, 4, key_range(2000, 2032), 0);
+    make_ws(ws[4], version, source2, 5, key_range(5000, 5032), 4);
+    make_ws(ws[5], version, source1, 6, keys6,                 0);
+    make_ws(ws[6], version, source1, 7, std::vector<uint64_t>(1, 9000), 6);
+
+    TrxHandle* trx[7];
+    for (int i(0); i < 7; ++i) trx[i] = make_slave_trx(ws[i], i + 1);
+
+    Certification::TestResult const expected[5] =
+    {
+        Certification::TEST_OK,
+        Certification::TEST_OK,
+        Certification::TEST_FAILED,
+        Certification::TEST_OK,
+        Certification::TEST_OK
+    };
+
+    for (int i(0); i < 5; ++i)
+    {
+        ck_assert_msg(expected[i] == cert.append_trx(trx[i]),
+                      "unexpected trx%d certification result", i + 1);
+    }
+
+    double avg_cert_interval, avg_deps_dist;
+    size_t index_size;
+    cert.stats_get(avg_cert_interval, avg_deps_dist, index_size);
+    /* entries created by failed trx3 must have been removed */
+    ck_assert_int_eq(index_size, 100000 + 1000 + 32 + 32);
+
+    for (int i(0); i < 5; ++i) cert.set_trx_committed(trx[i]);
+
+    /* trxs 1-4 are purged in the background, but certification must ignore
+     * them right away, however far the purge has got */
+    ck_assert_int_eq(cert.purge_trxs_upto(4, true), 4);
+
+    ck_assert_msg(Certification::TEST_OK == cert.append_trx(trx[5]),
+                  "trx6 conflicts with purged trx4");
+    cert.set_trx_committed(trx[5]);
+
+    env.thd().flush(); // purge complete
+
+    ck_assert(Certification::TEST_OK == cert.append_trx(trx[6]));
+    cert.set_trx_committed(trx[6]);
+
+    cert.stats_get(avg_cert_interval, avg_deps_dist, index_size);
+    /* trx5, trx6 and trx7 keys */
+    ck_assert_int_eq(index_size, 32 + 2 + 1);
+
+    for (int i(0); i < 7; ++i) trx[i]->unref();
+}
+END_TEST
+
+START_TEST(certification_v5)
+{
+    certify(WriteSetNG::VER5);
+}
+END_TEST
+
+START_TEST(certification_v6)
+{
+    certify(WriteSetNG::VER6);
+}
+END_TEST
+
+Suite* certification_suite()
+{
+    Suite* s = suite_create("certification");
+    TCase* tc;
+
+    tc = tcase_create("certification");
+    tcase_add_test(tc, certification_v5);
+    tcase_add_test(tc, certification_v6);
+    tcase_add_test(tc, certification_shards);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -1,4 +1,4 @@
-/* Copyright (C) 2013-2020 Codership Oy <info@codership.com>
+/* Copyright (C) 2013-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -104,7 +104,7 @@ private:
 };
 
 
-static void test_ver(gu::RecordSet::Version const rsv)
+static void test_ver(gu::RecordSet::Version const rsv, int const ws_ver)
 {
     int const alignment
         (rsv >= gu::RecordSet::VER2 ? gu::RecordSet::VER2_ALIGNMENT : 1);
@@ -129,7 +129,12 @@ static void test_ver(gu::RecordSet::Version const rsv)
     union { gu::byte_t buf[1024]; gu_word_t align; } reserved;
     TestBaseName str("data_set_test");
     DataSetOut dset_out(reserved.buf, sizeof(reserved.buf), str, DataSet::VER1,
-                        rsv);
+                        rsv, ws_ver);
+
+    gu::RecordSet::CheckType const ct(ws_ver < 5 ?
+                                      gu::RecordSet::CHECK_MMH128 :
+                                      gu::RecordSet::CHECK_VHASH64);
+    ck_assert(dset_out.gu::RecordSet::check_type() == ct);
 
     size_t offset(dset_out.size());
 
@@ -245,14 +250,104 @@ static void test_ver(gu::RecordSet::Version const rsv)
 #ifndef GALERA_ONLY_ALIGNED
 START_TEST (ver1)
 {
-    test_ver(gu::RecordSet::VER1);
+    test_ver(gu::RecordSet::VER1, 3);
 }
 END_TEST
 #endif /* GALERA_ONLY_ALIGNED */
 
 START_TEST (ver2)
 {
-    test_ver(gu::RecordSet::VER2);
+    test_ver(gu::RecordSet::VER2, 4);
+}
+END_TEST
+
+START_TEST (ver2_vhash)
+{
+    test_ver(gu::RecordSet::VER2, 5);
+}
+END_TEST
+
+static void test_compression(size_t const threshold)
+{
+    size_t const rec_size(1 << 16);
+
+    /* compressible data */
+    std::vector<gu::byte_t> src(3 * rec_size);
+    for (size_t i(0); i < src.size(); ++i) src[i] = 'a' + (i % 7);
+
+    union { gu::byte_t buf[1024]; gu_word_t align; } reserved;
+    TestBaseName str("data_set_test");
+    DataSetOut dset_out(reserved.buf, sizeof(reserved.buf), str, DataSet::VER2,
+                        gu::RecordSet::VER2, 6);
+
+    for (size_t i(0); i < 3; ++i)
+    {
+        dset_out.append(&src[i * rec_size], rec_size, i != 1);
+    }
+
+    ck_assert(1 == dset_out.count());
+    ck_assert(DataSet::VER2 == dset_out.version());
+
+    size_t const raw_size(dset_out.size());
+
+    DataSet::CompressStats stats = { 0, 0, 0 };
+    bool const compressed(dset_out.compress(1, threshold, stats));
+
+    ck_assert(compressed == (threshold <= src.size()));
+    if (compressed)
+    {
+        ck_assert_msg(dset_out.size() < raw_size / 10,
+                      "compressed %zu, raw %zu", dset_out.size(), raw_size);
+        ck_assert(stats.bytes_in == static_cast<long long>(src.size()));
+        ck_assert(stats.bytes_out < stats.bytes_in);
+    }
+    else
+    {
+        ck_assert(dset_out.size() == raw_size);
+        ck_assert(0 == stats.bytes_in);
+    }
+
+    DataSetOut::GatherVector out_bufs;
+    size_t const out_size(dset_out.gather(out_bufs));
+    ck_assert(out_size >= dset_out.size() &&
+              out_size <  dset_out.size() + gu::RecordSet::VER2_ALIGNMENT);
+
+    std::vector<gu::byte_t> in_buf;
+    for (size_t i = 0; i < out_bufs->size(); ++i)
+    {
+        const gu::byte_t* ptr
+            (reinterpret_cast<const gu::byte_t*>(out_bufs[i].ptr));
+        in_buf.insert (in_buf.end(), ptr, ptr + out_bufs[i].size);
+    }
+    ck_assert(in_buf.size() == out_size);
+
+    galera::DataSetIn const dset_in(dset_out.version(),
+                                    in_buf.data(), in_buf.size());
+    ck_assert(1 == dset_in.count());
+    try { dset_in.checksum(); }
+    catch(gu::Exception& e) { ck_abort_msg("%s", e.what()); }
+
+    for (int i(0); i < 2; ++i) // second pass is served from the cache
+    {
+        dset_in.rewind();
+        gu::Buf const data(dset_in.next());
+        ck_assert_msg(size_t(data.size) == src.size(),
+                      "expected %zu bytes, got %zd", src.size(), data.size);
+        ck_assert(0 == ::memcmp(data.ptr, src.data(), src.size()));
+    }
+}
+
+#ifdef HAVE_ZLIB
+START_TEST (ver2_compressed)
+{
+    test_compression(4096);
+}
+END_TEST
+#endif /* HAVE_ZLIB */
+
+START_TEST (ver2_uncompressed)
+{
+    test_compression(1 << 20);
 }
 END_TEST
 
@@ -263,6 +358,11 @@ Suite* data_set_suite ()
     tcase_add_test (t, ver1);
 #endif
     tcase_add_test (t, ver2);
+    tcase_add_test (t, ver2_vhash);
+#ifdef HAVE_ZLIB
+    tcase_add_test (t, ver2_compressed);
+#endif
+    tcase_add_test (t, ver2_uncompressed);
     tcase_set_timeout(t, 60);
 
     Suite* s = suite_create ("DataSet");
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2018-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2018-2026 Codership Oy <info@codership.com>
 //
 
 #include <wsrep_api.h>
@@ -28,12 +28,16 @@ static const char* Defaults[] =
 {
     "base_dir",                    ".",
     "base_port",                   "4567",
+    "cert.index_shards",           "16",
     "cert.log_conflicts",          "no",
     "cert.optimistic_pa",          "yes",
+    "cert.purge_slice_keys",       "4096",
+    "cert.purge_slice_time",       "PT0.001S",
     "debug",                       "no",
 #ifdef GU_DBUG_ON
     "dbug",                        "",
 #endif
+    "evs.adaptive_send_window",    "false",
     "evs.auto_evict",              "0",
     "evs.causal_keepalive_period", "PT1S",
     "evs.debug_log_mask",          "0x1",
@@ -58,18 +62,26 @@ static const char* Defaults[] =
 #endif
     "gcache.dir",                  ".",
     "gcache.freeze_purge_at_seqno","-1",
+    "gcache.huge_pages",           "no",
     "gcache.keep_pages_size",      "0",
     "gcache.keep_pages_count",     "0",
     "gcache.mem_size",             "0",
     "gcache.name",                 "./galera.cache",
+    "gcache.numa_node",            "-1",
     "gcache.page_size",            "128M",
     "gcache.recover",              "no",
+    "gcache.recover_threads",      "0",
     "gcache.size",                 "128M",
+    "gcache.spare_pages",          "0",
     "gcomm.thread_prio",           "",
+    "gcs.batch_size",              "0",
+    "gcs.batch_window",            "1000",
     "gcs.fc_debug",                "0",
     "gcs.fc_factor",               "1",
     "gcs.fc_limit",                "100",
     "gcs.fc_master_slave",         "no",
+    "gcs.fc_pacing",               "no",
+    "gcs.fc_size_limit",           "0",
     "gcs.max_packet_size",         "64500",
     "gcs.max_throttle",            "0.25",
 #if (GU_WORDSIZE == 32)
@@ -101,14 +113,25 @@ static const char* Defaults[] =
     "protonet.backend",            "asio",
     "protonet.version",            "0",
     "repl.causal_read_timeout",    "PT30S",
+    "repl.checksum_threads",       "2",
+    "repl.checksum_threshold",     "65536",
+    "repl.compression_level",      "0",
+    "repl.compression_threshold",  "4096",
     "repl.commit_order",           "3",
     "repl.key_format",             "FLAT8",
     "repl.max_ws_size",            "2147483647",
-    "repl.proto_max",              "9",
+    "repl.monitor_impl",           "mutex",
+#ifdef HAVE_ZLIB
+    "repl.proto_max",              "11",
+#else
+    "repl.proto_max",              "10",
+#endif
 #ifdef GU_DBUG_ON
     "signal",                      "",
 #endif
     "socket.checksum",             "2",
+    "socket.io_pending_max",       "4M",
+    "socket.io_threads",           "0",
     "socket.recv_buf_size",        "auto",
     "socket.send_buf_size",        "auto",
 //  "socket.ssl",                  no default,
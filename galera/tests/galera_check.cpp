@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2012-2018 Codership Oy <info@codership.com>
+ * Copyright (C) 2012-2026 Codership Oy <info@codership.com>
  */
 
 #include <cstdlib>
@@ -17,7 +17,9 @@ extern Suite* key_set_suite();
 extern Suite* write_set_ng_suite();
 extern Suite* write_set_suite();
 extern Suite* trx_handle_suite();
+extern Suite* certification_suite();
 extern Suite* service_thd_suite();
+extern Suite* monitor_suite();
 extern Suite* ist_suite();
 extern Suite* saved_state_suite();
 extern Suite* defaults_suite();
@@ -29,7 +31,9 @@ static suite_creator_t suites[] =
     write_set_ng_suite,
     write_set_suite,
     trx_handle_suite,
+    certification_suite,
     service_thd_suite,
+    monitor_suite,
     ist_suite,
     saved_state_suite,
     defaults_suite,
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * IST throughput benchmark.
+ *
+ * Populates GCache with a range of write sets and streams them from
+ * ist::Sender to ist::Receiver over a loopback TCP connection, once for
+ * each GCache prefetch depth (ist.prefetch_batches). With a GCache ring
+ * buffer smaller than the range most of the write sets end up in the page
+ * store, like on a donor which has been serving a long running IST.
+ *
+ * Usage: ist_bench [write sets] [data bytes] [gcache size] [prefetch batches]
+ *                  [cold]
+ *
+ * If prefetch batch count is not given, the benchmark is run with 0
+ * (GCache is read by the sending thread) and 1, 2 and 4 batches.
+ * If cold is 1, GCache buffers are written back and evicted from memory
+ * before each run, like on a donor which has not touched them for a while.
+ */
+
+#include "../src/ist.hpp"
+#include "../src/write_set_ng.hpp"
+#include "../src/replicator_smm.hpp"
+
+#include "GCache.hpp"
+#include "gu_uuid.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+
+using namespace galera;
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+namespace
+{
+    int const IST_VERSION = 9;
+
+    struct Params
+    {
+        long   write_sets;
+        size_t data_size;
+        size_t gcache_size;
+        int    cold;
+    };
+
+    typedef std::vector<gu::Buf> Buffers;
+
+    size_t
+    populate(gcache::GCache& gcache, const Params& p, Buffers& bufs)
+    {
+        wsrep_uuid_t source;
+        gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&source), NULL, 0);
+
+        std::vector<gu::byte_t> data(p.data_size);
+        size_t total(0);
+
+        for (long n(1); n <= p.write_sets; ++n)
+        {
+            WriteSetOut wso(".", n, KeySet::FLAT8, 0, 0, WriteSetNG::F_COMMIT);
+
+            for (size_t i(0); i < data.size(); ++i) data[i] = (n + i) * 31;
+            wso.append_data(data.data(), data.size(), true);
+
+            WriteSetNG::GatherVector out;
+            size_t const size(wso.gather(source, 1, n, out));
+            wso.set_last_seen(n - 1);
+
+            gu::byte_t* const ptr(static_cast<gu::byte_t*>(gcache.malloc(size)));
+            gu::byte_t* dst(ptr);
+            for (size_t i(0); i < out->size(); ++i)
+            {
+                ::memcpy(dst, out[i].ptr, out[i].size);
+                dst += out[i].size;
+            }
+
+            gu::Buf const ws_buf = { ptr, static_cast<ssize_t>(size) };
+            WriteSetIn wsi(ws_buf);
+            wsi.set_seqno(n, 1);
+
+            gcache.seqno_assign(ptr, n, n - 1);
+            total += size;
+
+            gu::Buf const b = { ptr, static_cast<ssize_t>(size) };
+            bufs.push_back(b);
+        }
+
+        return total;
+    }
+
+    /* writes back and drops resident pages of GCache buffers */
+    void
+    evict(const Buffers& bufs)
+    {
+        uintptr_t const page_mask(~(uintptr_t(::sysconf(_SC_PAGESIZE)) - 1));
+
+        for (size_t i(0); i < bufs.size(); ++i)
+        {
+            uintptr_t const b(uintptr_t(bufs[i].ptr) & page_mask);
+            size_t const len(uintptr_t(bufs[i].ptr) + bufs[i].size - b);
+
+            ::msync(reinterpret_cast<void*>(b), len, MS_SYNC);
+#ifdef MADV_PAGEOUT
+            ::madvise(reinterpret_cast<void*>(b), len, MADV_PAGEOUT);
+#else
+            ::madvise(reinterpret_cast<void*>(b), len, MADV_DONTNEED);
+#endif
+        }
+    }
+
+    extern "C" void*
+    consumer_thd(void* arg)
+    {
+        ist::Receiver* const receiver(static_cast<ist::Receiver*>(arg));
+        receiver->ready();
+
+        TrxHandle* trx;
+        while (receiver->recv(&trx) == 0)
+        {
+            trx->unref();
+        }
+
+        return 0;
+    }
+
+    void
+    run_bench(gcache::GCache& gcache, const Params& p, const Buffers& bufs,
+              size_t const bytes, int const batches)
+    {
+        if (p.cold) evict(bufs);
+
+        gu::Config conf;
+        ReplicatorSMM::InitConfig(conf, NULL, NULL);
+        conf.set(ist::Receiver::RECV_ADDR, "tcp://127.0.0.1:0");
+        conf.set("ist.prefetch_batches", gu::to_string(batches));
+
+        TrxHandle::SlavePool sp(sizeof(TrxHandle), 16, "ist_bench");
+        ist::Receiver receiver(conf, sp, 0);
+        std::string const addr(receiver.prepare(1, p.write_sets, IST_VERSION));
+
+        gu_thread_t consumer;
+        gu_thread_create(&consumer, 0, &consumer_thd, &receiver);
+
+        struct timeval start, stop;
+        gettimeofday(&start, NULL);
+
+        gcache.seqno_lock(1); // unlocked in sender dtor
+        {
+            ist::Sender sender(conf, gcache, addr, IST_VERSION);
+            sender.send(1, p.write_sets);
+        }
+
+        gettimeofday(&stop, NULL);
+
+        gu_thread_join(consumer, 0);
+        wsrep_seqno_t const last(receiver.finished());
+
+        double const duration(time_diff(stop, start));
+
+        std::cout << batches << '\t'
+                  << std::fixed << std::setprecision(3) << duration << '\t'
+                  << long(p.write_sets / duration) << '\t'
+                  << std::setprecision(1) << bytes / duration / (1 << 20)
+                  << '\t' << last << '\n';
+    }
+
+    template <typename T>
+    void
+    read_arg(char* argv[], int position, T& var)
+    {
+        std::istringstream is(argv[position]);
+        is >> var;
+        if (is.fail() || var < 0)
+        {
+            std::cerr << "Invalid argument " << position << ": '"
+                      << argv[position] << "'" << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p;
+    p.write_sets  = 20000;
+    p.data_size   = 16 << 10;
+    p.gcache_size = 16 << 20;
+    p.cold        = 0;
+    int batches(-1);
+
+    if (argc >= 2) read_arg(argv, 1, p.write_sets);
+    if (argc >= 3) read_arg(argv, 2, p.data_size);
+    if (argc >= 4) read_arg(argv, 3, p.gcache_size);
+    if (argc >= 5) read_arg(argv, 4, batches);
+    if (argc >= 6) read_arg(argv, 5, p.cold);
+
+    if (p.write_sets < 1)
+    {
+        std::cerr << "At least one write set is required" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    gu::Config conf;
+    ReplicatorSMM::InitConfig(conf, NULL, NULL);
+    std::string const gcache_file("ist_bench.cache");
+    conf.set("gcache.name", gcache_file);
+    conf.set("gcache.size", gu::to_string(p.gcache_size));
+
+    size_t bytes;
+    {
+        gcache::GCache gcache(conf, ".");
+        Buffers bufs;
+        bytes = populate(gcache, p, bufs);
+
+        std::cout << "Write sets: " << p.write_sets << ", bytes: " << bytes
+                  << ", gcache size: " << p.gcache_size
+                  << (p.cold ? ", cold" : "") << "\n\n"
+                  << "Batches:\tDuration:\tWS/sec:\tMB/sec:\tLast:\n";
+
+        if (batches >= 0)
+        {
+            run_bench(gcache, p, bufs, bytes, batches);
+        }
+        else
+        {
+            run_bench(gcache, p, bufs, bytes, 0);
+            run_bench(gcache, p, bufs, bytes, 1);
+            run_bench(gcache, p, bufs, bytes, 2);
+            run_bench(gcache, p, bufs, bytes, 4);
+        }
+
+        gcache.seqno_release(p.write_sets);
+    }
+
+    ::unlink(gcache_file.c_str());
+
+    return 0;
+}
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2011-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2011-2026 Codership Oy <info@codership.com>
 //
 
 
@@ -95,16 +95,18 @@ struct sender_args
     wsrep_seqno_t first_;
     wsrep_seqno_t last_;
     int version_;
+    int prefetch_batches_;
     sender_args(gcache::GCache& gcache,
                 const std::string& peer,
                 wsrep_seqno_t first, wsrep_seqno_t last,
-                int version)
+                int version, int prefetch_batches)
         :
         gcache_(gcache),
         peer_  (peer),
         first_ (first),
         last_  (last),
-        version_(version)
+        version_(version),
+        prefetch_batches_(prefetch_batches)
     { }
 };
 
@@ -155,6 +157,7 @@ extern "C" void* sender_thd(void* arg)
 
     gu::Config conf;
     galera::ReplicatorSMM::InitConfig(conf, NULL, NULL);
+    conf.set("ist.prefetch_batches", gu::to_string(sargs->prefetch_batches_));
     gu_barrier_wait(&start_barrier);
     sargs->gcache_.seqno_lock(sargs->first_); // unlocked in sender dtor
     galera::ist::Sender sender(conf, sargs->gcache_, sargs->peer_,
@@ -248,7 +251,8 @@ static int select_trx_version(int protocol_version)
 }
 
 
-static void test_ist_common(int const version)
+static void test_ist_common(int const version,
+                            int const prefetch_batches = 2)
 {
     using galera::KeyData;
     using galera::TrxHandle;
@@ -333,7 +337,8 @@ static void test_ist_common(int const version)
     mark_point();
 
     receiver_args rargs(receiver_addr, 1, 10, 1, sp, version);
-    sender_args sargs(*gcache, rargs.listen_addr_, 1, 10, version);
+    sender_args sargs(*gcache, rargs.listen_addr_, 1, 10, version,
+                      prefetch_batches);
 
     gu_barrier_init(&start_barrier, 0, 1 + 1 + rargs.n_receivers_);
 
@@ -390,6 +395,12 @@ START_TEST(test_ist_v5)
 }
 END_TEST
 
+START_TEST(test_ist_v5_no_prefetch)
+{
+    test_ist_common(5, 0);
+}
+END_TEST
+
 Suite* ist_suite()
 {
     Suite* s  = suite_create("ist");
@@ -424,5 +435,10 @@ Suite* ist_suite()
     tcase_add_test(tc, test_ist_v5);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_ist_v5_no_prefetch");
+    tcase_set_timeout(tc, 60);
+    tcase_add_test(tc, test_ist_v5_no_prefetch);
+    suite_add_tcase(s, tc);
+
     return s;
 }
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Monitor micro benchmark.
+ *
+ * A number of threads take consecutive seqnos from a shared counter and pass
+ * them through the monitor, like appliers do with the apply monitor. Each
+ * seqno depends on a pseudo-random preceding seqno not further than the
+ * given out-of-order depth: depth 1 means strictly ordered execution, larger
+ * depths allow more seqnos to be inside the monitor concurrently.
+ *
+ * Usage: monitor_bench [seqnos] [threads] [ooo depth] [work]
+ *
+ * If thread count or depth are not given, the benchmark is run for 4, 16,
+ * 32 and 64 threads and depths 1, 8 and 64 respectively. Work is the number
+ * of loop iterations done inside the monitor.
+ */
+
+#include "monitor.hpp"
+
+#include "gu_atomic.hpp"
+#include "gu_threads.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <stdint.h>
+#include <sys/time.h>
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+namespace
+{
+    class BenchOrder
+    {
+    public:
+        BenchOrder(wsrep_seqno_t seqno, wsrep_seqno_t depends)
+            : seqno_(seqno), depends_(depends) { }
+        void lock() { }
+        void unlock() { }
+        wsrep_seqno_t seqno() const { return seqno_; }
+        wsrep_seqno_t depends() const { return depends_; }
+        bool condition(wsrep_seqno_t last_entered,
+                       wsrep_seqno_t last_left) const
+        {
+            return (last_left >= depends_);
+        }
+#ifdef GU_DBUG_ON
+        void debug_sync(gu::Mutex&) { }
+#ifdef HAVE_PSI_INTERFACE
+        void debug_sync(gu::MutexWithPFS&) { }
+#endif // HAVE_PSI_INTERFACE
+#endif // GU_DBUG_ON
+    private:
+        wsrep_seqno_t const seqno_;
+        wsrep_seqno_t const depends_;
+    };
+
+    typedef galera::Monitor<BenchOrder> BenchMonitor;
+
+    struct Params
+    {
+        long   seqnos;
+        size_t threads;
+        long   depth;
+        long   work;
+    };
+
+    struct ThreadCtx
+    {
+        BenchMonitor*     mon;
+        gu::Atomic<long>* next;
+        std::vector<gu::Atomic<long> >* left;
+        const Params*     p;
+        long              violations;
+    };
+
+    uint64_t
+    mix(uint64_t x)
+    {
+        x += GU_ULONG_LONG(0x9E3779B97F4A7C15);
+        x = (x ^ (x >> 30)) * GU_ULONG_LONG(0xBF58476D1CE4E5B9);
+        x = (x ^ (x >> 27)) * GU_ULONG_LONG(0x94D049BB133111EB);
+        return x ^ (x >> 31);
+    }
+
+    volatile long sink(0);
+
+    void*
+    applier_func(void* arg)
+    {
+        ThreadCtx& ctx(*static_cast<ThreadCtx*>(arg));
+        std::vector<gu::Atomic<long> >& left(*ctx.left);
+        long seqno;
+
+        while ((seqno = ctx.next->add_and_fetch(1)) <= ctx.p->seqnos)
+        {
+            long const dist(1 + mix(seqno) % ctx.p->depth);
+            BenchOrder o(seqno, seqno > dist ? seqno - dist : 0);
+
+            ctx.mon->enter(o);
+
+            /* the seqno this one depends on must have left already */
+            if (o.depends() > 0 && 0 == left[o.depends()]()) ++ctx.violations;
+
+            long x(seqno);
+            for (long i(0); i < ctx.p->work; ++i) x += i * x;
+            sink = x;
+
+            left[seqno] = 1;
+
+            ctx.mon->leave(o);
+        }
+
+        return NULL;
+    }
+
+    void
+    run_bench(const Params& p, galera::MonitorMode const mode)
+    {
+#ifdef HAVE_PSI_INTERFACE
+        BenchMonitor mon(WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
+                         WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR, mode);
+#else
+        BenchMonitor mon(mode);
+#endif /* HAVE_PSI_INTERFACE */
+        mon.set_initial_position(0);
+
+        gu::Atomic<long> next(0);
+        std::vector<gu::Atomic<long> > left(p.seqnos + 1);
+        std::vector<ThreadCtx> ctxs(p.threads);
+        std::vector<gu_thread_t> threads(p.threads);
+
+        struct timeval start, stop;
+        gettimeofday(&start, NULL);
+
+        for (size_t t(0); t < threads.size(); ++t)
+        {
+            ThreadCtx& ctx(ctxs[t]);
+            ctx.mon  = &mon;
+            ctx.next = &next;
+            ctx.left = &left;
+            ctx.p    = &p;
+            ctx.violations = 0;
+            gu_thread_create(&threads[t], NULL, applier_func, &ctx);
+        }
+
+        long violations(0);
+        for (size_t t(0); t < threads.size(); ++t)
+        {
+            gu_thread_join(threads[t], NULL);
+            violations += ctxs[t].violations;
+        }
+
+        gettimeofday(&stop, NULL);
+
+        if (violations > 0 || mon.last_left() != p.seqnos)
+        {
+            std::cerr << "Order violations: " << violations << ", last left: "
+                      << mon.last_left() << std::endl;
+            ::abort();
+        }
+
+        double const duration(time_diff(stop, start));
+        double oooe, oool, win_size;
+        long long waits;
+        mon.get_stats(&oooe, &oool, &win_size, &waits);
+
+        std::cout << (galera::MONITOR_RING == mode ? "ring" : "mutex") << '\t'
+                  << p.threads << '\t' << p.depth << '\t'
+                  << std::fixed << std::setprecision(3) << duration << '\t'
+                  << long(p.seqnos / duration) << '\t'
+                  << oooe << '\t' << oool << '\t'
+                  << std::setprecision(1) << win_size << '\t'
+                  << waits << '\n';
+    }
+
+    template <typename T>
+    void
+    read_arg(char* argv[], int position, T& var)
+    {
+        std::istringstream is(argv[position]);
+        is >> var;
+        if (is.fail() || var <= 0)
+        {
+            std::cerr << "Invalid argument " << position << ": '"
+                      << argv[position] << "'" << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p;
+    p.seqnos = 1000000;
+    p.work   = 200;
+    size_t threads(0);
+    long   depth(0);
+
+    if (argc >= 2) read_arg(argv, 1, p.seqnos);
+    if (argc >= 3) read_arg(argv, 2, threads);
+    if (argc >= 4) read_arg(argv, 3, depth);
+    if (argc >= 5)
+    {
+        std::istringstream is(argv[4]);
+        is >> p.work;
+    }
+
+    std::vector<size_t> thread_counts;
+    if (threads)
+    {
+        thread_counts.push_back(threads);
+    }
+    else
+    {
+        thread_counts.push_back(4);
+        thread_counts.push_back(16);
+        thread_counts.push_back(32);
+        thread_counts.push_back(64);
+    }
+
+    std::vector<long> depths;
+    if (depth)
+    {
+        depths.push_back(depth);
+    }
+    else
+    {
+        depths.push_back(1);
+        depths.push_back(8);
+        depths.push_back(64);
+    }
+
+    std::cout << "Seqnos: " << p.seqnos << ", work: " << p.work << "\n\n"
+              << "Impl:\tThreads:\tDepth:\tDuration:\tSeqnos/sec:\t"
+              << "OOOE:\tOOOL:\tWindow:\tWaits:\n";
+
+    for (size_t d(0); d < depths.size(); ++d)
+    {
+        for (size_t t(0); t < thread_counts.size(); ++t)
+        {
+            p.depth   = depths[d];
+            p.threads = thread_counts[t];
+            run_bench(p, galera::MONITOR_MUTEX);
+            run_bench(p, galera::MONITOR_RING);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "monitor.hpp"
+
+#include "gu_threads.h"
+
+#include <check.h>
+#include <unistd.h>
+
+using namespace galera;
+
+namespace
+{
+    class TestOrder
+    {
+    public:
+        TestOrder(wsrep_seqno_t seqno, wsrep_seqno_t depends)
+            : seqno_(seqno), depends_(depends) { }
+        void lock() { }
+        void unlock() { }
+        wsrep_seqno_t seqno() const { return seqno_; }
+        bool condition(wsrep_seqno_t last_entered,
+                       wsrep_seqno_t last_left) const
+        {
+            return (last_left >= depends_);
+        }
+#ifdef GU_DBUG_ON
+        void debug_sync(gu::Mutex&) { }
+#ifdef HAVE_PSI_INTERFACE
+        void debug_sync(gu::MutexWithPFS&) { }
+#endif // HAVE_PSI_INTERFACE
+#endif // GU_DBUG_ON
+    private:
+        wsrep_seqno_t const seqno_;
+        wsrep_seqno_t const depends_;
+    };
+
+    class TestMonitor : public Monitor<TestOrder>
+    {
+    public:
+        explicit TestMonitor(MonitorMode const mode)
+            :
+#ifdef HAVE_PSI_INTERFACE
+            Monitor<TestOrder>(WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
+                               WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR, mode)
+#else
+            Monitor<TestOrder>(mode)
+#endif /* HAVE_PSI_INTERFACE */
+        { }
+    };
+
+    struct ThreadArgs
+    {
+        TestMonitor&  mon;
+        TestOrder&    obj;
+        wsrep_seqno_t seqno;
+        int volatile  ret; // 0 - running, 1 - entered, or -errno
+
+        ThreadArgs(TestMonitor& m, TestOrder& o, wsrep_seqno_t s = 0)
+            : mon(m), obj(o), seqno(s), ret(0) { }
+    };
+
+    void* enter_thread(void* arg)
+    {
+        ThreadArgs& a(*static_cast<ThreadArgs*>(arg));
+
+        try
+        {
+            a.mon.enter(a.obj);
+            a.ret = 1;
+        }
+        catch (gu::Exception& e)
+        {
+            a.ret = -e.get_errno();
+        }
+
+        return NULL;
+    }
+
+    void* drain_thread(void* arg)
+    {
+        ThreadArgs& a(*static_cast<ThreadArgs*>(arg));
+        a.mon.drain(a.seqno);
+        a.ret = 1;
+        return NULL;
+    }
+
+    void* wait_thread(void* arg)
+    {
+        ThreadArgs& a(*static_cast<ThreadArgs*>(arg));
+        a.mon.wait(a.seqno);
+        a.ret = 1;
+        return NULL;
+    }
+
+    // gives other threads a chance to proceed
+    void settle() { usleep(100000); }
+
+    void test_monitor(MonitorMode const mode)
+    {
+        TestMonitor mon(mode);
+        mon.set_initial_position(0);
+
+        // interrupt before entering
+        TestOrder o1(1, 0);
+        mon.interrupt(o1);
+        try
+        {
+            mon.enter(o1);
+            ck_abort_msg("interrupted enter did not throw");
+        }
+        catch (gu::Exception& e)
+        {
+            ck_assert_int_eq(e.get_errno(), EINTR);
+        }
+        mon.self_cancel(o1);
+        ck_assert_int_eq(mon.last_left(), 1);
+
+        // interrupt waiter, wait for seqno
+        TestOrder  o3(3, 2);
+        ThreadArgs a3(mon, o3);
+        gu_thread_t t3;
+        gu_thread_create(&t3, NULL, enter_thread, &a3);
+
+        TestOrder  ow(0, 0);
+        ThreadArgs aw(mon, ow, 3);
+        gu_thread_t tw;
+        gu_thread_create(&tw, NULL, wait_thread, &aw);
+
+        settle();
+        ck_assert_int_eq(a3.ret, 0);
+        mon.interrupt(o3);
+        gu_thread_join(t3, NULL);
+        ck_assert_int_eq(a3.ret, -EINTR);
+
+        mon.self_cancel(o3);
+        ck_assert_int_eq(mon.last_left(), 1);
+        ck_assert_int_eq(aw.ret, 0);
+
+        TestOrder o2(2, 1);
+        mon.enter(o2);
+        mon.leave(o2);
+        ck_assert_int_eq(mon.last_left(), 3);
+        gu_thread_join(tw, NULL);
+        ck_assert_int_eq(aw.ret, 1);
+
+        // drain while seqnos are in the monitor
+        TestOrder o4(4, 3), o5(5, 3);
+        mon.enter(o5);
+        mon.enter(o4);
+
+        TestOrder  od(0, 0);
+        ThreadArgs ad(mon, od, 5);
+        gu_thread_t td;
+        gu_thread_create(&td, NULL, drain_thread, &ad);
+        settle();
+
+        // above drain seqno, must not be released until drain is over
+        TestOrder o7(7, 0);
+        mon.self_cancel(o7);
+
+        TestOrder  o6(6, 0);
+        ThreadArgs a6(mon, o6);
+        gu_thread_t t6;
+        gu_thread_create(&t6, NULL, enter_thread, &a6);
+        settle();
+        ck_assert_int_eq(a6.ret, 0);
+        ck_assert_int_eq(ad.ret, 0);
+
+        mon.leave(o5);
+        mon.leave(o4);
+        gu_thread_join(td, NULL);
+        gu_thread_join(t6, NULL);
+        ck_assert_int_eq(a6.ret, 1);
+        ck_assert_int_eq(mon.last_left(), 5);
+
+        mon.leave(o6);
+        ck_assert_int_eq(mon.last_left(), 7);
+
+        // waiter is woken up by the seqno it depends on
+        TestOrder  o9(9, 8);
+        ThreadArgs a9(mon, o9);
+        gu_thread_t t9;
+        gu_thread_create(&t9, NULL, enter_thread, &a9);
+        settle();
+        ck_assert_int_eq(a9.ret, 0);
+
+        TestOrder o8(8, 7);
+        mon.enter(o8);
+        mon.leave(o8);
+        gu_thread_join(t9, NULL);
+        ck_assert_int_eq(a9.ret, 1);
+        mon.leave(o9);
+        ck_assert_int_eq(mon.last_left(), 9);
+
+        double oooe, oool, win;
+        long long waits;
+        mon.get_stats(&oooe, &oool, &win, &waits);
+        ck_assert(oooe > 0);  // 5 entered before 4
+        ck_assert(waits > 0);
+
+        // reset
+        mon.set_initial_position(9);
+        mon.set_initial_position(-1);
+        mon.set_initial_position(100);
+
+        TestOrder o101(101, 100);
+        mon.enter(o101);
+        mon.leave(o101);
+        ck_assert_int_eq(mon.last_left(), 101);
+    }
+}
+
+START_TEST(test_monitor_mutex)
+{
+    test_monitor(MONITOR_MUTEX);
+}
+END_TEST
+
+START_TEST(test_monitor_ring)
+{
+    test_monitor(MONITOR_RING);
+}
+END_TEST
+
+Suite* monitor_suite()
+{
+    Suite* s = suite_create ("monitor");
+    TCase* tc;
+
+    tc = tcase_create ("monitor");
+    tcase_add_test  (tc, test_monitor_mutex);
+    tcase_add_test  (tc, test_monitor_ring);
+    tcase_set_timeout(tc, 60);
+    suite_add_tcase (s, tc);
+
+    return s;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #include "../src/galera_service_thd.hpp"
@@ -129,6 +129,143 @@ START_TEST(service_thd3)
 }
 END_TEST
 
+namespace
+{
+    class CountdownTask : public ServiceThd::Task
+    {
+    public:
+        CountdownTask(int slices) : slices_(slices), runs_(0) {}
+
+        bool run() { ++runs_; return (--slices_ > 0); }
+
+        int slices() const { return slices_; }
+        int runs()   const { return runs_;   }
+
+    private:
+        int slices_;
+        int runs_;
+    };
+}
+
+START_TEST(service_thd4)
+{
+    TestEnv env;
+    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache());
+    ck_assert(thd != 0);
+
+    CountdownTask task(10);
+    thd->schedule(task);
+    // flush must wait for the task to complete all its slices
+    thd->flush();
+    ck_assert_msg(task.slices() == 0, "slices left: %d", task.slices());
+    ck_assert_msg(task.runs() == 10, "runs: %d", task.runs());
+
+    // completed task should not be run again until rescheduled
+    thd->flush();
+    ck_assert_msg(task.runs() == 10, "runs: %d", task.runs());
+
+    thd->schedule(task);
+    thd->flush();
+    ck_assert_msg(task.runs() == 11, "runs: %d", task.runs());
+
+    delete thd;
+}
+END_TEST
+
+namespace
+{
+    // blocks in the first run until unblock() is called
+    class BlockingTask : public ServiceThd::Task
+    {
+    public:
+        BlockingTask() : mtx_(), cond_(), blocked_(true), runs_(0) {}
+
+        bool run()
+        {
+            gu::Lock lock(mtx_);
+            ++runs_;
+            cond_.broadcast();
+            while (blocked_) lock.wait(cond_);
+            return false;
+        }
+
+        void wait_running()
+        {
+            gu::Lock lock(mtx_);
+            while (runs_ == 0) lock.wait(cond_);
+        }
+
+        void unblock()
+        {
+            gu::Lock lock(mtx_);
+            blocked_ = false;
+            cond_.broadcast();
+        }
+
+        int runs() const { gu::Lock lock(mtx_); return runs_; }
+
+    private:
+        gu::Mutex mtx_;
+        gu::Cond  cond_;
+        bool      blocked_;
+        int       runs_;
+    };
+}
+
+START_TEST(service_thd6)
+{
+    TestEnv env;
+    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache());
+    ck_assert(thd != 0);
+
+    BlockingTask task;
+    thd->schedule(task);
+    task.wait_running();
+
+    // task is scheduled again while it runs, reset must not drop it
+    thd->schedule(task);
+    thd->reset();
+    task.unblock();
+
+    thd->flush();
+    ck_assert_msg(task.runs() == 2, "runs: %d", task.runs());
+
+    delete thd;
+}
+END_TEST
+
+START_TEST(service_thd5)
+{
+    TestEnv env;
+    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache());
+    ck_assert(thd != 0);
+
+    gcs_seqno_t const seqno(3 * ServiceThd::RELEASE_SLICE + 10);
+
+    for (gcs_seqno_t i(1); i <= seqno; ++i)
+    {
+        void* const ptr(env.gcache().malloc(64));
+        ck_assert(ptr != 0);
+        env.gcache().seqno_assign(ptr, i, i - 1);
+    }
+
+    // release is done in slices, flush must wait for all of them
+    thd->release_seqno(seqno);
+    thd->flush();
+    ck_assert_msg(env.gcache().seqno_last_released() == seqno,
+                  "released: %" PRId64 ", expected %" PRId64,
+                  env.gcache().seqno_last_released(), seqno);
+
+    long long backlog, max_slice;
+    double    avg_slice;
+    thd->release_stats_get(backlog, avg_slice, max_slice);
+    ck_assert_msg(backlog == 0, "backlog: %lld", backlog);
+    ck_assert(avg_slice > 0 && max_slice >= avg_slice);
+
+    delete thd;
+}
+END_TEST
+
 Suite* service_thd_suite()
 {
     Suite* s = suite_create ("service_thd");
@@ -138,6 +275,9 @@ Suite* service_thd_suite()
     tcase_add_test  (tc, service_thd1);
     tcase_add_test  (tc, service_thd2);
     tcase_add_test  (tc, service_thd3);
+    tcase_add_test  (tc, service_thd4);
+    tcase_add_test  (tc, service_thd5);
+    tcase_add_test  (tc, service_thd6);
     tcase_set_timeout(tc, 60);
     suite_add_tcase (s, tc);
 
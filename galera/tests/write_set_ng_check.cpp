@@ -1,4 +1,4 @@
-/* Copyright (C) 2013-2020 Codership Oy <info@codership.com>
+/* Copyright (C) 2013-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -7,6 +7,7 @@
 
 #include "test_key.hpp"
 #include "../src/write_set_ng.hpp"
+#include "../src/write_set_checker.hpp"
 
 #include "gu_uuid.h"
 #include "gu_logger.hpp"
@@ -111,6 +112,9 @@ static void ver3_basic(gu::RecordSet::Version const rsv,
         }
         ck_assert(shared > 0);
 
+        ck_assert(wsi.key_count() == ksi.count());
+        ck_assert(wsi.key_part(0).prefix() == P_SHARED);
+
         wsi.verify_checksum();
 
         wsi.set_seqno (seqno, pa_range);
@@ -186,6 +190,26 @@ static void ver3_basic(gu::RecordSet::Version const rsv,
 
     mark_point();
 
+    /* this is to test checksumming in the pool */
+    {
+        WriteSetChecker checker(2, 1);
+        WriteSetIn wsi(in_buf, 2, &checker);
+        ck_assert(wsi.key_count() == 1);
+        wsi.verify_checksum();
+        ck_assert(wsi.certified());
+        ck_assert(wsi.seqno() == seqno);
+
+        /* keys collected along with the checksum */
+        WriteSetIn wsi_keys(in_buf, 2, &checker);
+        wsi_keys.verify_checksum();
+        ck_assert(wsi_keys.key_count() == 1);
+
+        /* result not collected */
+        WriteSetIn wsi_cancel(in_buf, 2, &checker);
+    }
+
+    mark_point();
+
     /* this is to test reassembly without keys and unordered data after gather()
      * + late initialization */
     try
@@ -262,6 +286,27 @@ static void ver3_basic(gu::RecordSet::Version const rsv,
         ck_abort_msg("%s", e.what());
     }
 
+    try /* this is to test checksumming in the pool + corruption */
+    {
+        WriteSetChecker checker(2, 1);
+        WriteSetIn wsi(in_buf, 2, &checker);
+
+        mark_point();
+
+        try {
+            wsi.verify_checksum();
+            ck_abort_msg("payload corruption slipped through 3");
+        }
+        catch (gu::Exception& e)
+        {
+            ck_assert(e.get_errno() == EINVAL);
+        }
+    }
+    catch (std::exception& e)
+    {
+        ck_abort_msg("%s", e.what());
+    }
+
     in[2] ^= 1; // corrupted 3rd byte of header
 
     try /* this is to test header corruption */
@@ -296,6 +341,77 @@ START_TEST (ver3_basic_rsv2_wsv4)
 }
 END_TEST
 
+START_TEST (ver3_basic_rsv2_wsv5)
+{
+    ver3_basic(gu::RecordSet::VER2, WriteSetNG::VER5);
+}
+END_TEST
+
+START_TEST (ver3_basic_rsv2_wsv6)
+{
+    ver3_basic(gu::RecordSet::VER2, WriteSetNG::VER6);
+}
+END_TEST
+
+#ifdef HAVE_ZLIB
+START_TEST (ver6_compression)
+{
+    wsrep_uuid_t source;
+    gu_uuid_generate (reinterpret_cast<gu_uuid_t*>(&source), NULL, 0);
+
+    std::string const dir(".");
+    wsrep_trx_id_t trx_id(1);
+    WriteSetOut wso (dir, trx_id, KeySet::FLAT8A, 0, 0, 0,
+                     gu::RecordSet::VER2, WriteSetNG::VER6,
+                     DataSet::VER2, DataSet::VER2);
+
+    TestKey tk0(KeySet::MAX_VERSION, WSREP_KEY_EXCLUSIVE, true, "a0");
+    wso.append_key(tk0());
+
+    std::vector<gu::byte_t> data(1 << 16);
+    for (size_t i(0); i < data.size(); ++i) data[i] = 'a' + (i % 13);
+
+    wso.append_data (&data[0], data.size() / 2, true);
+    wso.append_data (&data[data.size() / 2], data.size() / 2, false);
+
+    DataSet::CompressStats stats = { 0, 0, 0 };
+    wso.compress(1, 4096, stats);
+    ck_assert(stats.bytes_in > 0);
+    ck_assert_msg(stats.bytes_out < stats.bytes_in / 10,
+                  "in: %lld, out: %lld", stats.bytes_in, stats.bytes_out);
+
+    WriteSetNG::GatherVector out;
+    size_t const out_size(wso.gather(source, 1, 1, out));
+    ck_assert(out_size < data.size() / 10);
+
+    wso.set_last_seen(1);
+
+    std::vector<gu::byte_t> in;
+    for (size_t i(0); i < out->size(); ++i)
+    {
+        const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[i].ptr));
+        in.insert (in.end(), ptr, ptr + out[i].size);
+    }
+    ck_assert(in.size() == out_size);
+
+    gu::Buf const in_buf = { in.data(), static_cast<ssize_t>(in.size()) };
+
+    WriteSetIn wsi(in_buf);
+    wsi.verify_checksum();
+    ck_assert(wsi.keyset().count() == 1);
+
+    const DataSetIn& dsi(wsi.dataset());
+    ck_assert(dsi.count() == 1);
+
+    gu::Buf const d(dsi.next());
+    ck_assert(size_t(d.size) == data.size());
+    ck_assert(0 == ::memcmp(d.ptr, data.data(), data.size()));
+
+    ck_assert(wsi.unrdset().count() == 0);
+}
+END_TEST
+#endif /* HAVE_ZLIB */
+
 static void ver3_annotation(gu::RecordSet::Version const rsv)
 {
     union {
@@ -405,6 +521,11 @@ Suite* write_set_ng_suite ()
 #endif
     tcase_add_test (t, ver3_basic_rsv2_wsv3);
     tcase_add_test (t, ver3_basic_rsv2_wsv4);
+    tcase_add_test (t, ver3_basic_rsv2_wsv5);
+    tcase_add_test (t, ver3_basic_rsv2_wsv6);
+#ifdef HAVE_ZLIB
+    tcase_add_test (t, ver6_compression);
+#endif
     tcase_set_timeout(t, 60);
     suite_add_tcase (s, t);
 
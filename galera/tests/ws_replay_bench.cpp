@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Write set receive path replay benchmark.
+ *
+ * A set of write sets is built once, as if captured from the group, and then
+ * replayed by a single thread the way the slave receive path processes them:
+ * a batch of write sets is initialized (key set parsing, checksum), then each
+ * goes through a certification-like pass over the key parts and checksum
+ * verification after the verdict. With checksum threads key sets and
+ * checksums of the batch are handled by WriteSetChecker concurrently with
+ * the certification passes.
+ *
+ * Usage: ws_replay_bench [replays] [data bytes] [keys] [checksum threads]
+ *
+ * If checksum thread count is not given, the benchmark is run without the
+ * pool and with 1, 2 and 4 threads.
+ */
+
+#include "test_key.hpp"
+#include "../src/write_set_ng.hpp"
+#include "../src/write_set_checker.hpp"
+
+#include "gu_uuid.h"
+#include "gu_unordered.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <stdint.h>
+#include <sys/time.h>
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+namespace
+{
+    /* number of distinct write sets replayed round robin */
+    size_t const CAPTURED = 64;
+
+    /* actions received at once, as GcsActionSource::MAX_BATCH */
+    long const BATCH = 16;
+
+    struct Params
+    {
+        long   replays;
+        size_t data_size;
+        long   keys;
+    };
+
+    typedef std::vector<gu::byte_t> Buffer;
+
+    void
+    build_write_set(const Params& p, long const n, Buffer& buf)
+    {
+        wsrep_uuid_t source;
+        gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&source), NULL, 0);
+
+        WriteSetOut wso(".", n, KeySet::FLAT8, 0, 0, WriteSetNG::F_COMMIT);
+
+        for (long k(0); k < p.keys; ++k)
+        {
+            std::ostringstream row;
+            row << n << ':' << k;
+            std::string const r(row.str());
+            TestKey key(KeySet::MAX_VERSION, WSREP_KEY_EXCLUSIVE, true,
+                        "bench", r.c_str());
+            wso.append_key(key());
+        }
+
+        std::vector<gu::byte_t> data(p.data_size);
+        for (size_t i(0); i < data.size(); ++i) data[i] = (n + i) * 31;
+        wso.append_data(data.data(), data.size(), true);
+
+        WriteSetNG::GatherVector out;
+        size_t const size(wso.gather(source, 1, n, out));
+        wso.set_last_seen(n);
+
+        buf.clear();
+        buf.reserve(size);
+        for (size_t i(0); i < out->size(); ++i)
+        {
+            const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[i].ptr));
+            buf.insert(buf.end(), ptr, ptr + out[i].size);
+        }
+    }
+
+    typedef gu::UnorderedMap<size_t, long> Index;
+
+    void
+    run_bench(const Params& p, const std::vector<Buffer>& captured,
+              int const threads)
+    {
+        WriteSetChecker checker(threads, 0);
+        WriteSetChecker* const wc(threads > 0 ? &checker : NULL);
+        Index index;
+        long conflicts(0);
+        size_t bytes(0);
+
+        struct timeval start, stop;
+        gettimeofday(&start, NULL);
+
+        for (long b(0); b < p.replays; b += BATCH)
+        {
+            long const batch(std::min(BATCH, p.replays - b));
+            WriteSetIn* const ws(new WriteSetIn[batch]);
+
+            /* the whole batch is received before any of it is processed */
+            for (long i(0); i < batch; ++i)
+            {
+                const Buffer& c(captured[(b + i) % captured.size()]);
+                gu::Buf const buf = { c.data(), ssize_t(c.size()) };
+                ws[i].read_buf(buf, 1, wc);
+                bytes += c.size();
+            }
+
+            for (long i(0); i < batch; ++i)
+            {
+                long const n(b + i);
+
+                /* certification: index work on pre-parsed key parts */
+                for (long k(0); k < ws[i].key_count(); ++k)
+                {
+                    std::pair<Index::iterator, bool> const ret
+                        (index.insert(std::make_pair(ws[i].key_part(k).hash(),
+                                                     n)));
+
+                    if (!ret.second)
+                    {
+                        conflicts += (ret.first->second >= n - 16);
+                        ret.first->second = n;
+                    }
+                }
+
+                ws[i].verify_checksum();
+            }
+
+            delete[] ws;
+        }
+
+        gettimeofday(&stop, NULL);
+
+        double const duration(time_diff(stop, start));
+
+        std::cout << threads << '\t'
+                  << std::fixed << std::setprecision(3) << duration << '\t'
+                  << long(p.replays / duration) << '\t'
+                  << std::setprecision(1) << bytes / duration / (1 << 20)
+                  << '\t' << conflicts << '\n';
+    }
+
+    template <typename T>
+    void
+    read_arg(char* argv[], int position, T& var)
+    {
+        std::istringstream is(argv[position]);
+        is >> var;
+        if (is.fail() || var < 0)
+        {
+            std::cerr << "Invalid argument " << position << ": '"
+                      << argv[position] << "'" << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p;
+    p.replays   = 20000;
+    p.data_size = 256 << 10;
+    p.keys      = 64;
+    int threads(-1);
+
+    if (argc >= 2) read_arg(argv, 1, p.replays);
+    if (argc >= 3) read_arg(argv, 2, p.data_size);
+    if (argc >= 4) read_arg(argv, 3, p.keys);
+    if (argc >= 5) read_arg(argv, 4, threads);
+
+    std::vector<Buffer> captured(CAPTURED);
+    for (size_t i(0); i < captured.size(); ++i)
+    {
+        build_write_set(p, i + 1, captured[i]);
+    }
+
+    std::cout << "Replays: " << p.replays << ", write set size: "
+              << captured[0].size() << ", keys: " << p.keys << "\n\n"
+              << "Threads:\tDuration:\tWS/sec:\tMB/sec:\tConflicts:\n";
+
+    if (threads >= 0)
+    {
+        run_bench(p, captured, threads);
+    }
+    else
+    {
+        run_bench(p, captured, 0);
+        run_bench(p, captured, 1);
+        run_bench(p, captured, 2);
+        run_bench(p, captured, 4);
+    }
+
+    return 0;
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2014 Codership Oy <info@codership.com>
+// Copyright (C) 2013-2026 Codership Oy <info@codership.com>
 
 /**
  * @file Atomic memory access functions. At the moment these follow
@@ -64,6 +64,10 @@ extern "C" {
 #define gu_atomic_get_n(ptr)                            \
     __atomic_load_n(ptr, GU_ATOMIC_SYNC_DEFAULT)
 
+// stores val into ptr if it contains oldval, returns true on success
+#define gu_atomic_bool_cas(ptr, oldval, val)                            \
+    __sync_bool_compare_and_swap(ptr, oldval, val)
+
 #elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8) // use __sync_XXX builtins
 
 #define GU_ATOMIC_SYNC_NONE    0
@@ -89,6 +93,8 @@ extern "C" {
 
 #define gu_atomic_get(ptr, vptr) *vptr = __sync_fetch_and_or(ptr, 0)
 
+#define gu_atomic_bool_cas __sync_bool_compare_and_swap
+
 #else
 #error "This GCC version does not support 8-byte atomics on this platform. Use GCC >= 4.7.x."
 #endif /* __ATOMIC_RELAXED */
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 //
 
 //
@@ -54,6 +54,13 @@ namespace gu
             return gu_atomic_sub_and_fetch(&i_, i);
         }
 
+        // sets value to i only if it is equal to expected,
+        // returns true on success
+        bool compare_and_swap(I expected, I i)
+        {
+            return gu_atomic_bool_cas(&i_, expected, i);
+        }
+
         Atomic<I>& operator++()
         {
             gu_atomic_fetch_and_add(&i_, 1);
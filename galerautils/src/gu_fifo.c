@@ -373,6 +373,54 @@ void gu_fifo_pop_head (gu_fifo_t* q)
     }
 }
 
+/*! If FIFO is not empty, stores pointers to up to max head items and locks
+ *  FIFO, otherwise blocks. Or returns 0 if FIFO is closed. */
+long gu_fifo_get_head_n (gu_fifo_t* q, void** const items, long const max,
+                         int* err)
+{
+    assert (max > 0);
+
+    *err = fifo_lock_get (q);
+
+    if (gu_likely(-ECANCELED != *err && q->used)) {
+        long const n   = q->used < (ulong)max ? (long)q->used : max;
+        ulong      pos = q->head;
+        long       i;
+
+        for (i = 0; i < n; i++) {
+            items[i] = FIFO_PTR(q, pos);
+            pos      = FIFO_INC(q, pos);
+        }
+
+        return n;
+    }
+    else {
+        assert (q->get_err);
+        fifo_unlock (q);
+        return 0;
+    }
+}
+
+/*! Advances FIFO head by n items and unlocks FIFO. */
+void gu_fifo_pop_head_n (gu_fifo_t* q, long n)
+{
+    assert (n > 0 && (ulong)n <= q->used);
+
+    while (n--) fifo_advance_head(q);
+
+    /* the items left might have been pushed with a single waiting getter
+     * signalled, let another one take them */
+    if (q->used > 0 && q->get_wait > 0) {
+        q->get_wait--;
+        gu_cond_signal (&q->get_cond);
+    }
+
+    if (fifo_unlock_get(q)) {
+        gu_fatal ("Failed to unlock queue to get items.");
+        abort();
+    }
+}
+
 /*! If FIFO is not full, returns pointer to the tail item and locks FIFO,
  *  otherwise blocks. Or returns NULL if FIFO is closed. */
 void* gu_fifo_get_tail (gu_fifo_t* q)
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * Queue (FIFO) class definition
  *
@@ -45,6 +45,14 @@ extern void  gu_fifo_release   (gu_fifo_t *q);
 extern void* gu_fifo_get_head  (gu_fifo_t* q, int* err);
 /*! Advance FIFO head pointer and release FIFO. */
 extern void  gu_fifo_pop_head  (gu_fifo_t* q);
+/*! Lock FIFO and get pointers to up to max head items, blocks if FIFO is empty
+ * @param items array of at least max pointers to store item pointers in
+ * @param err contains error code if retval is 0, as in gu_fifo_get_head()
+ * @retval number of items available, FIFO stays locked if it is not 0 */
+extern long  gu_fifo_get_head_n(gu_fifo_t* q, void** items, long max,
+                                int* err);
+/*! Advance FIFO head pointer by n items and release FIFO. */
+extern void  gu_fifo_pop_head_n(gu_fifo_t* q, long n);
 /*! Lock FIFO and get pointer to tail item */
 extern void* gu_fifo_get_tail  (gu_fifo_t* q);
 /*! Advance FIFO tail pointer and release FIFO. */
@@ -0,0 +1,316 @@
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+
+/**
+ * @file Open addressing hash set with elements stored inline.
+ *
+ * Uses linear probing with Robin Hood displacement and backward shift
+ * deletion. Each slot holds the element together with its full hash value,
+ * so that probing compares hashes first and calls equality predicate only on
+ * hash match. Rehashing does not need to recompute hashes.
+ *
+ * Intended for pointer-like elements: value_type() is the null value which
+ * marks an empty slot and can't be stored in the set.
+ *
+ * Unlike node-based unordered containers, any insertion or erasure may move
+ * elements and invalidates all iterators.
+ */
+
+#ifndef GU_FLAT_HASH_HPP
+#define GU_FLAT_HASH_HPP
+
+#include "gu_throw.hpp"
+
+#include <vector>
+#include <memory>     // std::allocator<>, std::allocator_traits<>
+#include <algorithm>  // std::fill(), std::swap()
+#include <utility>    // std::pair<>
+#include <cstddef>    // ptrdiff_t
+#include <functional> // std::equal_to<>
+#include <iterator>   // std::forward_iterator_tag
+#include <cassert>
+
+namespace gu
+{
+
+template <typename K, typename H, class P = std::equal_to<K>,
+          class A = std::allocator<K> >
+class FlatHashSet
+{
+    struct Slot
+    {
+        size_t hash;
+        K      key;
+
+        Slot() : hash(0), key() {}
+        Slot(size_t h, const K& k) : hash(h), key(k) {}
+    };
+
+#if __cplusplus >= 201103L
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Slot>
+                                                     slot_allocator;
+#else
+    typedef typename A::template rebind<Slot>::other slot_allocator;
+#endif
+    typedef std::vector<Slot, slot_allocator>        slots_type;
+
+public:
+
+    typedef K      key_type;
+    typedef K      value_type;
+    typedef size_t size_type;
+
+    static size_type const MIN_BUCKETS = 16;
+
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef K                         value_type;
+        typedef ptrdiff_t                 difference_type;
+        typedef const K*                  pointer;
+        typedef const K&                  reference;
+
+        iterator() : ptr_(NULL), end_(NULL) {}
+
+        reference operator*()  const { return  ptr_->key; }
+        pointer   operator->() const { return &ptr_->key; }
+
+        iterator& operator++() { ++ptr_; skip_empty(); return *this; }
+        iterator  operator++(int) { iterator i(*this); ++(*this); return i; }
+
+        bool operator==(const iterator& o) const { return ptr_ == o.ptr_; }
+        bool operator!=(const iterator& o) const { return ptr_ != o.ptr_; }
+
+    private:
+
+        friend class FlatHashSet;
+
+        iterator(const Slot* p, const Slot* e) : ptr_(p), end_(e) {}
+
+        void skip_empty() { while (ptr_ != end_ && null(*ptr_)) ++ptr_; }
+
+        const Slot* ptr_;
+        const Slot* end_;
+    };
+
+    /* elements are immutable anyway */
+    typedef iterator const_iterator;
+
+    explicit
+    FlatHashSet(const H& h = H(), const P& p = P(), const A& a = A())
+        :
+        slots_(slot_allocator(a)),
+        mask_ (0),
+        size_ (0),
+        hash_ (h),
+        equal_(p)
+    {}
+
+    iterator begin() const
+    {
+        iterator i(data(), data() + slots_.size());
+        i.skip_empty();
+        return i;
+    }
+
+    iterator end() const
+    {
+        return iterator(data() + slots_.size(), data() + slots_.size());
+    }
+
+    iterator find(const K& key) const
+    {
+        if (gu_unlikely(0 == size_)) return end();
+
+        size_t const hash(hash_(key));
+        size_t pos(hash & mask_);
+
+        for (size_t dist(0); ; ++dist, pos = (pos + 1) & mask_)
+        {
+            const Slot& s(slots_[pos]);
+
+            /* Robin Hood invariant: key can't be further than an element
+             * which is closer to its home bucket than key would be */
+            if (null(s) || distance(s.hash, pos) < dist) return end();
+
+            if (s.hash == hash && equal_(s.key, key)) return make_iter(pos);
+        }
+    }
+
+    std::pair<iterator, bool> insert(const K& key)
+    {
+        assert(!(key == K()));
+
+        if (gu_unlikely(size_ + 1 > max_load(slots_.size())))
+        {
+            /* don't grow the table for a key which is already there */
+            iterator const i(find(key));
+            if (i != end()) return std::make_pair(i, false);
+
+            reserve(size_ + 1);
+        }
+
+        size_t const hash(hash_(key));
+        size_t pos(hash & mask_);
+
+        for (size_t dist(0); ; ++dist, pos = (pos + 1) & mask_)
+        {
+            Slot& s(slots_[pos]);
+
+            if (null(s))
+            {
+                s = Slot(hash, key);
+                ++size_;
+                return std::make_pair(make_iter(pos), true);
+            }
+
+            if (s.hash == hash && equal_(s.key, key))
+            {
+                return std::make_pair(make_iter(pos), false);
+            }
+
+            size_t const sdist(distance(s.hash, pos));
+
+            if (sdist < dist)
+            {
+                /* key is not in the set, take the slot from the "richer"
+                 * element and push it further */
+                Slot displaced(s);
+                s = Slot(hash, key);
+                place(displaced, (pos + 1) & mask_, sdist + 1);
+                ++size_;
+                return std::make_pair(make_iter(pos), true);
+            }
+        }
+    }
+
+    iterator insert_unique(const K& key)
+    {
+        std::pair<iterator, bool> ret(insert(key));
+        if (ret.second == false) gu_throw_fatal << "insert unique failed";
+        return ret.first;
+    }
+
+    /*! Erases element pointed by iterator. Invalidates all iterators. */
+    void erase(iterator i)
+    {
+        assert(i != end());
+        assert(size_ > 0);
+
+        size_t pos(i.ptr_ - data());
+
+        /* backward shift: move following displaced elements one slot
+         * closer to their home buckets */
+        while (true)
+        {
+            size_t const next((pos + 1) & mask_);
+            Slot& n(slots_[next]);
+
+            if (null(n) || 0 == distance(n.hash, next)) break;
+
+            slots_[pos] = n;
+            pos = next;
+        }
+
+        slots_[pos] = Slot();
+        --size_;
+    }
+
+    size_type size()  const { return size_; }
+    bool      empty() const { return 0 == size_; }
+
+    /*! Removes all elements, keeps allocated buckets */
+    void clear()
+    {
+        std::fill(slots_.begin(), slots_.end(), Slot());
+        size_ = 0;
+    }
+
+    size_type bucket_count() const { return slots_.size(); }
+
+    /*! Memory used by buckets */
+    size_type bucket_bytes() const { return slots_.size() * sizeof(Slot); }
+
+    /*! Makes sure that n elements can be stored without rehashing */
+    void reserve(size_type const n)
+    {
+        if (gu_likely(n <= max_load(slots_.size()))) return;
+
+        size_type buckets(slots_.size() ? slots_.size() * 2 : MIN_BUCKETS);
+        while (n > max_load(buckets)) buckets *= 2;
+
+        rehash(buckets);
+    }
+
+private:
+
+    slots_type slots_;
+    size_t     mask_;
+    size_t     size_;
+    H          hash_;
+    P          equal_;
+
+    /* maximum load factor 7/8 */
+    static size_type max_load(size_type const buckets)
+    {
+        return buckets - buckets / 8;
+    }
+
+    static bool null(const Slot& s) { return (s.key == K()); }
+
+    const Slot* data() const { return slots_.empty() ? NULL : &slots_[0]; }
+
+    iterator make_iter(size_t const pos) const
+    {
+        return iterator(data() + pos, data() + slots_.size());
+    }
+
+    /* distance of the slot from the element home bucket */
+    size_t distance(size_t const hash, size_t const pos) const
+    {
+        return (pos - (hash & mask_)) & mask_;
+    }
+
+    /* places element which is known not to be in the set yet,
+     * starting from pos at dist from its home bucket */
+    void place(Slot s, size_t pos, size_t dist)
+    {
+        for (;; ++dist, pos = (pos + 1) & mask_)
+        {
+            Slot& t(slots_[pos]);
+
+            if (null(t))
+            {
+                t = s;
+                return;
+            }
+
+            size_t const tdist(distance(t.hash, pos));
+
+            if (tdist < dist)
+            {
+                std::swap(s, t);
+                dist = tdist;
+            }
+        }
+    }
+
+    void rehash(size_type const buckets)
+    {
+        assert(0 == (buckets & (buckets - 1)));
+
+        slots_type old(buckets, Slot(), slots_.get_allocator());
+        old.swap(slots_);
+        mask_ = buckets - 1;
+
+        for (typename slots_type::const_iterator i(old.begin());
+             i != old.end(); ++i)
+        {
+            if (!null(*i)) place(*i, i->hash & mask_, 0);
+        }
+    }
+};
+
+} /* namespace gu */
+
+#endif /* GU_FLAT_HASH_HPP */
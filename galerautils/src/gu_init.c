@@ -8,6 +8,7 @@
 #include "gu_limits.h"
 #include "gu_abort.h"
 #include "gu_crc32c.h"
+#include "gu_vhash.h"
 #include "gu_init.h"
 
 void
@@ -25,4 +26,5 @@ gu_init (gu_log_cb_t log_cb, gu_pfs_instr_cb_t pfs_instr_cb)
     }
 
     gu_crc32c_configure();
+    gu_vhash_configure();
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2016 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -20,6 +20,12 @@
 #include <unistd.h>
 #include "gu_limits.h"
 
+#if defined(__linux__)
+#include <sys/syscall.h> // SYS_mbind, to avoid dependency on libnuma
+#include <sys/vfs.h>     // fstatfs()
+#include <fstream>
+#endif
+
 #if defined(__FreeBSD__) && defined(MAP_NORESERVE)
 /* FreeBSD has never implemented this flags and will deprecate it. */
 #undef MAP_NORESERVE
@@ -34,12 +40,25 @@ extern "C" { static const void* const GU_MAP_FAILED = MAP_FAILED; }
 
 namespace gu
 {
+    static bool
+    on_tmpfs(int const fd)
+    {
+#if defined(__linux__)
+        static long const TMPFS_MAGIC_(0x01021994); // from <linux/magic.h>
+        struct statfs st;
+        return (::fstatfs(fd, &st) == 0 && long(st.f_type) == TMPFS_MAGIC_);
+#else
+        return false;
+#endif
+    }
+
     MMap::MMap (const FileDescriptor& fd, bool const sequential)
         :
         size   (fd.size()),
         ptr    (mmap (NULL, size, PROT_READ|PROT_WRITE,
                       MAP_SHARED|MAP_NORESERVE, fd.get(), 0)),
-        mapped (ptr != GU_MAP_FAILED)
+        mapped (ptr != GU_MAP_FAILED),
+        shmem  (on_tmpfs(fd.get()))
     {
         if (!mapped)
         {
@@ -84,6 +103,113 @@ namespace gu
         }
     }
 
+    bool
+    MMap::huge_pages() const
+    {
+#if defined(MADV_HUGEPAGE)
+        if (!shmem)
+        {
+            log_warn << "Huge pages are only supported for files on tmpfs, "
+                     << ptr << " is backed by a regular file";
+            return false;
+        }
+
+        /* madvise() succeeds regardless, check the current setting, e.g.
+         * "always within_size advise [never] deny force" */
+        std::ifstream thp("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+        std::string setting;
+        while (thp >> setting && setting[0] != '[') {}
+
+        if (setting == "[never]" || setting == "[deny]")
+        {
+            log_warn << "Huge pages for tmpfs are disabled by "
+                     << "/sys/kernel/mm/transparent_hugepage/shmem_enabled: "
+                     << setting;
+            return false;
+        }
+
+        if (::madvise(ptr, size, MADV_HUGEPAGE))
+        {
+            int const err(errno);
+            log_warn << "Failed to set MADV_HUGEPAGE on " << ptr << ": "
+                     << err << " (" << strerror(err) << ')';
+            return false;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool
+    MMap::prefer_node(int const node) const
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+        static int      const MPOL_PREFERRED_(1); // from <numaif.h>
+        static unsigned const MPOL_MF_MOVE_  (1 << 1);
+        static size_t   const ULONG_BITS(sizeof(unsigned long) * 8);
+
+        unsigned long mask[16] = { 0, };
+
+        if (node < 0 || size_t(node) >= sizeof(mask) * 8)
+        {
+            log_warn << "Invalid NUMA node: " << node << ", must be between 0"
+                     << " and " << sizeof(mask) * 8 - 1;
+            return false;
+        }
+
+        mask[node / ULONG_BITS] = 1UL << (node % ULONG_BITS);
+
+        /* Page cache of a regular file ignores the mapping policy: pages are
+         * allocated according to the policy of the thread that reads them
+         * in. And only the pages mapped by this process are moved by
+         * MPOL_MF_MOVE. So read the whole mapping in with this thread
+         * preferring the node, then move what was already elsewhere. */
+        int           old_mode(0);
+        unsigned long old_mask[16] = { 0, };
+        bool const    saved(::syscall(SYS_get_mempolicy, &old_mode, old_mask,
+                                      sizeof(old_mask) * 8 + 1, NULL, 0) == 0);
+
+        if (!saved || ::syscall(SYS_set_mempolicy, MPOL_PREFERRED_, mask,
+                                sizeof(mask) * 8 + 1))
+        {
+            int const err(errno);
+            log_warn << "Failed to prefer NUMA node " << node << ": " << err
+                     << " (" << strerror(err) << ')';
+            return false;
+        }
+
+        const volatile uint8_t* const p(static_cast<uint8_t*>(ptr));
+        for (size_t off(0); off < size; off += GU_PAGE_SIZE) (void)p[off];
+
+        /* MPOL_DEFAULT (0) does not take a mask */
+        if (::syscall(SYS_set_mempolicy, old_mode,
+                      old_mode ? old_mask : NULL,
+                      old_mode ? sizeof(old_mask) * 8 + 1 : 0))
+        {
+            int const err(errno);
+            log_warn << "Failed to restore thread memory policy: " << err
+                     << " (" << strerror(err) << ')';
+        }
+
+        /* maxnode is one more than the number of bits in the mask, see
+         * libnuma */
+        if (::syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_, mask,
+                      sizeof(mask) * 8 + 1, MPOL_MF_MOVE_))
+        {
+            int const err(errno);
+            log_warn << "Failed to bind " << ptr << " to NUMA node " << node
+                     << ": " << err << " (" << strerror(err) << ')';
+            return false;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
     void
     MMap::sync(void* const addr, size_t const length) const
     {
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2016 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -25,6 +25,19 @@ public:
     ~MMap ();
 
     void dont_need() const;
+
+    /* asks for the mapping to be backed by transparent huge pages,
+     * returns false if not supported. Only files on tmpfs can get them,
+     * and only when shmem THP is not disabled system-wide. Page cache of
+     * regular files always uses base pages. */
+    bool huge_pages() const;
+
+    /* sets preferred NUMA node for the mapping memory and reads the whole
+     * mapping in, so that all its pages end up on that node, returns false
+     * if not supported or node is invalid. For regular files, pages evicted
+     * later are read back in according to the faulting thread policy. */
+    bool prefer_node(int node) const;
+
     void sync(void *addr, size_t length) const;
     void sync() const;
     void unmap();
@@ -32,6 +45,7 @@ public:
 private:
 
     bool mapped;
+    bool const shmem; // file is on tmpfs
 
     // This class is definitely non-copyable
     MMap (const MMap&);
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2017 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  *
  */
 
@@ -46,6 +46,11 @@ namespace gu
 
     protected:
 
+        explicit Mutex (const gu_mutexattr_t* const attr) : value()
+        {
+            gu_mutex_init (&value, attr);
+        }
+
         gu_mutex_t mutable value;
 
     private:
@@ -56,6 +61,43 @@ namespace gu
         friend class Lock;
     };
 
+    /* AdaptiveMutex spins for a while before going to sleep when it is
+     * locked by another thread (where supported). It suits short critical
+     * sections taken by many threads, where sleeping and waking up would take
+     * longer than the critical section itself. */
+    class AdaptiveMutex : public Mutex
+    {
+    public:
+
+        AdaptiveMutex () : Mutex(Attr().ptr()) {}
+
+    private:
+
+        class Attr
+        {
+        public:
+
+            Attr() : attr_()
+            {
+                pthread_mutexattr_init(&attr_);
+#ifdef PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP
+                pthread_mutexattr_settype(&attr_, PTHREAD_MUTEX_ADAPTIVE_NP);
+#endif
+            }
+
+            ~Attr() { pthread_mutexattr_destroy(&attr_); }
+
+            const gu_mutexattr_t* ptr() const { return &attr_; }
+
+        private:
+
+            gu_mutexattr_t attr_;
+
+            Attr (const Attr&);
+            Attr& operator= (const Attr&);
+        };
+    };
+
 #ifdef HAVE_PSI_INTERFACE
 
     /* MutexWithPFS can be instrumented with MySQL performance schema.
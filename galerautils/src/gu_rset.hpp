@@ -16,6 +16,7 @@
 #include "gu_vector.hpp"
 #include "gu_alloc.hpp"
 #include "gu_digest.hpp"
+#include "gu_vhash.h"
 
 #include "gu_limits.h" // GU_MIN_ALIGNMENT
 
@@ -46,7 +47,8 @@ public:
         CHECK_NONE   = 0,
         CHECK_MMH32,
         CHECK_MMH64,
-        CHECK_MMH128
+        CHECK_MMH128,
+        CHECK_VHASH64 /* vectorizable, see gu_vhash.h */
     };
 
     static int check_size(CheckType ct);
@@ -105,6 +107,56 @@ protected:
 # pragma GCC diagnostic ignored "-Weffc++"
 #endif
 
+/*! Payload checksum context for a given RecordSet::CheckType.
+ *  CHECK_MMH* results are prefixes of 128-bit MurmurHash3 */
+class RecordSetCheck
+{
+public:
+
+    explicit
+    RecordSetCheck (RecordSet::CheckType const ct) : ct_(ct), ctx_()
+    {
+        if (RecordSet::CHECK_VHASH64 == ct_)
+            gu_vhash_init (&ctx_.vh);
+        else
+            gu_mmh128_init (&ctx_.mmh);
+    }
+
+    void append (const void* const buf, size_t const size)
+    {
+        if (RecordSet::CHECK_VHASH64 == ct_)
+            gu_vhash_append (&ctx_.vh, buf, size);
+        else
+            gu_mmh128_append (&ctx_.mmh, buf, size);
+    }
+
+    /*! writes up to size bytes of the result to buf */
+    void gather (void* const buf, size_t const size) const
+    {
+        if (RecordSet::CHECK_VHASH64 == ct_)
+        {
+            uint64_t const res(htog<uint64_t>(gu_vhash_get64 (&ctx_.vh)));
+            ::memcpy (buf, &res, std::min(size, sizeof(res)));
+        }
+        else
+        {
+            byte_t tmp[16];
+            gu_mmh128_get (&ctx_.mmh, tmp);
+            ::memcpy (buf, tmp, std::min(size, sizeof(tmp)));
+        }
+    }
+
+private:
+
+    RecordSet::CheckType ct_;
+
+    union
+    {
+        gu_mmh128_ctx_t mmh;
+        gu_vhash_ctx_t  vh;
+    } ctx_;
+};
+
 /*! class to store records in buffer(s) to send out */
 class RecordSetOutBase : public RecordSet
 {
@@ -120,7 +172,7 @@ public:
 
 protected:
 
-    RecordSetOutBase() : RecordSet() {}
+    RecordSetOutBase() : RecordSet(), check_(CHECK_NONE) {}
 
     RecordSetOutBase (byte_t*           reserved,
                       size_t            reserved_size,
@@ -214,7 +266,7 @@ private:
     ssize_t const max_size_;
 #endif
     Allocator     alloc_;
-    Hash          check_;
+    RecordSetCheck check_;
     Vector<Buf, Allocator::INITIAL_VECTOR_SIZE> bufs_;
     bool          prev_stored_;
 
@@ -0,0 +1,180 @@
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+
+/**
+ * @file Lock-free single producer single consumer FIFO queue.
+ *
+ * Elements are stored in fixed size segments. The producer appends to the
+ * last segment and links a new one when it is full, the consumer reads from
+ * the first segment and recycles it when it has been read through. One
+ * recycled segment is kept aside for the producer, so that in a steady state
+ * the queue does not allocate memory. The queue is unbounded: push() never
+ * blocks or fails for the lack of space.
+ *
+ * push() may be called from several threads and front()/pop() may be called
+ * from several threads, as long as the calls on each side are serialized by
+ * the caller (e.g. by holding some lock).
+ *
+ * Blocking on empty queue is up to the caller.
+ */
+
+#ifndef GU_SPSC_QUEUE_HPP
+#define GU_SPSC_QUEUE_HPP
+
+#include "gu_atomic.hpp"
+#include "gu_macros.h" // gu_likely()
+
+#include <new>     // placement new, ::operator new()
+#include <cstddef> // size_t
+#include <cassert>
+
+namespace gu
+{
+
+template <typename T, size_t SEGMENT_SIZE = 256>
+class SpscQueue
+{
+public:
+
+    SpscQueue()
+        :
+        head_seg_(new Segment),
+        head_    (0),
+        pad_     (),
+        tail_seg_(head_seg_),
+        spare_   (NULL)
+    { }
+
+    ~SpscQueue()
+    {
+        while (front() != NULL) pop();
+
+        assert(head_seg_ == tail_seg_);
+        delete head_seg_;
+        delete spare_();
+    }
+
+    /*! Producer: appends a copy of val to the queue */
+    void push(const T& val)
+    {
+        Segment* const s(tail_seg_);
+        size_t   const t(s->tail_());
+
+        if (gu_likely(t < SEGMENT_SIZE))
+        {
+            new (s->slots_ + t) T(val);
+            s->tail_ = t + 1; // publish element
+            return;
+        }
+
+        Segment* n(take_spare());
+        if (NULL == n) n = new Segment;
+
+        try
+        {
+            new (n->slots_) T(val);
+        }
+        catch (...)
+        {
+            delete n;
+            throw;
+        }
+
+        n->tail_ = 1;
+        s->next_ = n; // publish segment with the element
+        tail_seg_ = n;
+    }
+
+    /*! Consumer: returns pointer to the first element or NULL if the queue
+     *  is empty. The element stays valid until pop(). */
+    T* front()
+    {
+        Segment* s(head_seg_);
+
+        if (head_ < s->tail_()) return s->slots_ + head_;
+
+        if (head_ < SEGMENT_SIZE) return NULL;
+
+        /* segment is read through, move to the next one if there is any */
+        Segment* const n(s->next_());
+
+        if (NULL == n) return NULL;
+
+        head_seg_ = n;
+        head_     = 0;
+        recycle(s);
+
+        assert(n->tail_() > 0);
+        return n->slots_;
+    }
+
+    /*! Consumer: removes the first element, front() must be non-NULL */
+    void pop()
+    {
+        assert(head_ < head_seg_->tail_());
+
+        head_seg_->slots_[head_].~T();
+        ++head_;
+    }
+
+    bool empty() { return (front() == NULL); }
+
+private:
+
+    struct Segment
+    {
+        Segment()
+            :
+            slots_(static_cast<T*>(::operator new(sizeof(T) * SEGMENT_SIZE))),
+            tail_ (0),
+            next_ (NULL)
+        { }
+
+        ~Segment() { ::operator delete(slots_); }
+
+        T* const             slots_;
+        gu::Atomic<size_t>   tail_; // number of published elements
+        gu::Atomic<Segment*> next_;
+
+    private:
+
+        Segment(const Segment&);
+        Segment& operator=(const Segment&);
+    };
+
+    /* consumer side */
+    void recycle(Segment* const s)
+    {
+        s->tail_ = 0;
+        s->next_ = NULL;
+
+        /* only producer resets spare to NULL, no ABA possible */
+        if (!spare_.compare_and_swap(NULL, s)) delete s;
+    }
+
+    /* producer side */
+    Segment* take_spare()
+    {
+        Segment* const s(spare_());
+
+        /* only consumer sets spare from NULL, no ABA possible */
+        if (s != NULL && spare_.compare_and_swap(s, NULL)) return s;
+
+        return NULL;
+    }
+
+    /* consumer state */
+    Segment*             head_seg_;
+    size_t               head_;
+    char                 pad_[64 - sizeof(Segment*) - sizeof(size_t)];
+
+    /* producer state */
+    Segment*             tail_seg_;
+    gu::Atomic<Segment*> spare_;
+
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+};
+
+} /* namespace gu */
+
+#endif /* GU_SPSC_QUEUE_HPP */
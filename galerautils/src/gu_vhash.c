@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/**
+ * @file Portable part of VHash: stream handling, scrambling, finalization and
+ *       scalar accumulation round.
+ */
+
+#include "gu_vhash.h"
+#include "gu_log.h"
+#include "gu_byteswap.h" // gu_le64()
+
+#include <string.h> // memcpy()
+
+/* splitmix64 sequence seeded with the fractional part of pi */
+const uint64_t gu_vhash_keys[GU_VHASH_LANES + GU_VHASH_BLOCK - 1] =
+{
+    0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL,
+    0xdbafb150deb12800ULL, 0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL,
+    0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL, 0x74cd8258f9520068ULL,
+    0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL, 0xdf98cb79a37b51b9ULL,
+    0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL, 0xa9ffbe6b5104e85aULL,
+    0x6bd0c51b9fd533b3ULL, 0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL,
+    0x768912e3a6bcedc7ULL, 0x50b3e8c9332c7c88ULL, 0xce3bbfe520bd47daULL,
+    0xcba6c8e8e0bb7c4fULL, 0xbf194db8434a346dULL
+};
+
+static const uint64_t vhash_scramble_keys[GU_VHASH_LANES] =
+{
+    0x7d8f2a7b60416d7fULL, 0x0849d1f6e0e10a5eULL, 0x7654b590d064e22fULL,
+    0x16d1da9507df3af2ULL, 0xf63aef1089ea30e4ULL, 0x9ade6673cc6c522bULL,
+    0x4c75bc274e37087cULL, 0xd35e12b49f51f27bULL
+};
+
+static const uint64_t vhash_merge_keys[GU_VHASH_LANES] =
+{
+    0x22ddf2ffcee481eaULL, 0x06007fb13c59a1f1ULL, 0x8966a38c651ea4daULL,
+    0x25242f018fc01ac6ULL, 0xa73ec74fa31b717cULL, 0x7ee0abdd9797d3a2ULL,
+    0x5c06ff7dc4ac1880ULL, 0x8434e41042c28a7dULL
+};
+
+#define VHASH_PRIME32_1 0x9E3779B1U
+#define VHASH_PRIME64_1 0x9E3779B185EBCA87ULL
+
+/* initial accumulator values are taken from XXH3 */
+static const uint64_t vhash_init_acc[GU_VHASH_LANES] =
+{
+    0x00000000C2B2AE3DULL, 0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL,
+    0x165667B19E3779F9ULL, 0x85EBCA77C2B2AE63ULL, 0x0000000085EBCA77ULL,
+    0x27D4EB2F165667C5ULL, 0x000000009E3779B1ULL
+};
+
+void
+gu_vhash_accumulate_scalar(uint64_t* const       acc,
+                           const uint8_t*        stripes,
+                           size_t                n,
+                           const uint64_t*       keys)
+{
+    for (; n > 0; --n, stripes += GU_VHASH_STRIPE, ++keys)
+    {
+        int i;
+        for (i = 0; i < GU_VHASH_LANES; ++i)
+        {
+            uint64_t d;
+            memcpy(&d, stripes + i*sizeof(d), sizeof(d));
+            d = gu_le64(d);
+
+            uint64_t const k = d ^ keys[i];
+
+            acc[i ^ 1] += d;
+            acc[i]     += (k & 0xFFFFFFFFULL) * (k >> 32);
+        }
+    }
+}
+
+static inline void
+vhash_scramble(uint64_t* const acc)
+{
+    int i;
+    for (i = 0; i < GU_VHASH_LANES; ++i)
+    {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= vhash_scramble_keys[i];
+        a *= VHASH_PRIME32_1;
+        acc[i] = a;
+    }
+}
+
+/* consumes n complete stripes, scrambling at block boundaries */
+static inline void
+vhash_consume(gu_vhash_ctx_t* const vh, const uint8_t* ptr, size_t n)
+{
+    while (n > 0)
+    {
+        size_t const room  = GU_VHASH_BLOCK - vh->stripes;
+        size_t const chunk = n < room ? n : room;
+
+        gu_vhash_accumulate_func(vh->acc, ptr, chunk,
+                                 gu_vhash_keys + vh->stripes);
+
+        ptr += chunk * GU_VHASH_STRIPE;
+        n   -= chunk;
+        vh->stripes += chunk;
+
+        if (GU_VHASH_BLOCK == vh->stripes)
+        {
+            vhash_scramble(vh->acc);
+            vh->stripes = 0;
+        }
+    }
+}
+
+void
+gu_vhash_init(gu_vhash_ctx_t* const vh)
+{
+    memcpy(vh->acc, vhash_init_acc, sizeof(vh->acc));
+    vh->length  = 0;
+    vh->stripes = 0;
+}
+
+void
+gu_vhash_append(gu_vhash_ctx_t* const vh, const void* const part, size_t len)
+{
+    const uint8_t* ptr = (const uint8_t*)part;
+    size_t const tail_len = vh->length % GU_VHASH_STRIPE;
+
+    vh->length += len;
+
+    if (tail_len > 0)
+    {
+        size_t const fill = GU_VHASH_STRIPE - tail_len;
+
+        if (len < fill)
+        {
+            memcpy(vh->tail + tail_len, ptr, len);
+            return;
+        }
+
+        memcpy(vh->tail + tail_len, ptr, fill);
+        vhash_consume(vh, vh->tail, 1);
+        ptr += fill;
+        len -= fill;
+    }
+
+    size_t const n = len / GU_VHASH_STRIPE;
+    vhash_consume(vh, ptr, n);
+    ptr += n * GU_VHASH_STRIPE;
+    len -= n * GU_VHASH_STRIPE;
+
+    if (len > 0) memcpy(vh->tail, ptr, len);
+}
+
+static inline uint64_t
+vhash_mul128_fold64(uint64_t const a, uint64_t const b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t const p = (__uint128_t)a * b;
+    return (uint64_t)p ^ (uint64_t)(p >> 64);
+#else
+    uint64_t const lo_lo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    uint64_t const hi_lo = (a >> 32)           * (b & 0xFFFFFFFFULL);
+    uint64_t const lo_hi = (a & 0xFFFFFFFFULL) * (b >> 32);
+    uint64_t const hi_hi = (a >> 32)           * (b >> 32);
+    uint64_t const cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    uint64_t const upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t const lower = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+    return lower ^ upper;
+#endif
+}
+
+uint64_t
+gu_vhash_get64(const gu_vhash_ctx_t* const vh)
+{
+    uint64_t acc[GU_VHASH_LANES];
+    memcpy(acc, vh->acc, sizeof(acc));
+
+    size_t const tail_len = vh->length % GU_VHASH_STRIPE;
+
+    if (tail_len > 0)
+    {
+        /* zero-padded last stripe, length is mixed in below */
+        uint8_t last[GU_VHASH_STRIPE];
+        memcpy(last, vh->tail, tail_len);
+        memset(last + tail_len, 0, sizeof(last) - tail_len);
+        gu_vhash_accumulate_func(acc, last, 1, gu_vhash_keys + vh->stripes);
+    }
+
+    uint64_t h = vh->length * VHASH_PRIME64_1;
+
+    int i;
+    for (i = 0; i < GU_VHASH_LANES; i += 2)
+    {
+        h += vhash_mul128_fold64(acc[i]     ^ vhash_merge_keys[i],
+                                 acc[i + 1] ^ vhash_merge_keys[i + 1]);
+    }
+
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+
+    return h;
+}
+
+uint64_t
+gu_vhash64(const void* const buf, size_t const len)
+{
+    gu_vhash_ctx_t vh;
+    gu_vhash_init(&vh);
+    gu_vhash_append(&vh, buf, len);
+    return gu_vhash_get64(&vh);
+}
+
+gu_vhash_accumulate_t gu_vhash_accumulate_func = gu_vhash_accumulate_scalar;
+
+void
+gu_vhash_configure()
+{
+    gu_vhash_accumulate_t ret = NULL;
+
+#if defined(GU_VHASH_X86_64) || defined(GU_VHASH_ARM64)
+    ret = gu_vhash_hardware();
+#endif
+
+    if (!ret)
+    {
+        gu_info ("VHash: using portable implementation.");
+        ret = gu_vhash_accumulate_scalar;
+    }
+
+    gu_vhash_accumulate_func = ret;
+}
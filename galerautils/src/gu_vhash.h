@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ *
+ * @file Vectorizable 64-bit stream hash for payload checksums
+ *
+ * The algorithm follows the layout of XXH3 long input loop: message is
+ * consumed in 64-byte stripes, each stripe is mixed into 8 independent 64-bit
+ * accumulators by 32x32->64 multiplication of data and key, so that the same
+ * computation maps directly onto SSE2/AVX2/NEON lanes. Accumulators are
+ * scrambled every 16 stripes and merged into 64-bit result at the end.
+ * It is NOT compatible with XXH3 output.
+ *
+ * All implementations of gu_vhash_accumulate_func produce identical results.
+ */
+
+#ifndef _gu_vhash_h_
+#define _gu_vhash_h_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#include <stdint.h> // uint*_t
+#include <stddef.h> // size_t
+
+#define GU_VHASH_LANES  8  /* number of 64-bit accumulators */
+#define GU_VHASH_STRIPE 64 /* bytes consumed by one accumulation round */
+#define GU_VHASH_BLOCK  16 /* stripes between accumulator scrambles */
+
+/*! Keys used by accumulation rounds: stripe N of a block uses
+ *  gu_vhash_keys[N ... N + GU_VHASH_LANES - 1] */
+extern const uint64_t gu_vhash_keys[GU_VHASH_LANES + GU_VHASH_BLOCK - 1];
+
+/*! Accumulates n stripes into acc, stripe i uses keys + i */
+typedef void (*gu_vhash_accumulate_t) (uint64_t*       acc,
+                                       const uint8_t*  stripes,
+                                       size_t          n,
+                                       const uint64_t* keys);
+
+extern gu_vhash_accumulate_t gu_vhash_accumulate_func;
+
+/*! Call this to configure VHash to use the best available implementation */
+extern void
+gu_vhash_configure();
+
+/*! Portable implementation of gu_vhash_accumulate_func */
+extern void
+gu_vhash_accumulate_scalar(uint64_t* acc, const uint8_t* stripes, size_t n,
+                           const uint64_t* keys);
+
+#if defined(__x86_64) || defined(_M_AMD64) || defined(_M_X64)
+#define GU_VHASH_X86_64
+extern void
+gu_vhash_accumulate_sse2(uint64_t* acc, const uint8_t* stripes, size_t n,
+                         const uint64_t* keys);
+extern void
+gu_vhash_accumulate_avx2(uint64_t* acc, const uint8_t* stripes, size_t n,
+                         const uint64_t* keys);
+#endif /* x86_64 */
+
+#if (defined(__aarch64__) || defined(__AARCH64__)) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define GU_VHASH_ARM64
+extern void
+gu_vhash_accumulate_neon(uint64_t* acc, const uint8_t* stripes, size_t n,
+                         const uint64_t* keys);
+#endif /* aarch64 */
+
+#if defined(GU_VHASH_X86_64) || defined(GU_VHASH_ARM64)
+/** Returns the best vectorized implementation available on this CPU */
+extern gu_vhash_accumulate_t gu_vhash_hardware();
+#endif
+
+/*
+ * Functions to hash stream
+ */
+
+typedef struct gu_vhash_ctx
+{
+    uint64_t acc[GU_VHASH_LANES];
+    uint64_t length;                /* total bytes appended */
+    uint8_t  tail[GU_VHASH_STRIPE]; /* incomplete stripe */
+    uint32_t stripes;               /* stripes accumulated in current block */
+} gu_vhash_ctx_t;
+
+extern void
+gu_vhash_init  (gu_vhash_ctx_t* vh);
+
+/*! Append message part to hash context */
+extern void
+gu_vhash_append(gu_vhash_ctx_t* vh, const void* part, size_t len);
+
+/*! Get the accumulated message hash (does not change the context) */
+extern uint64_t
+gu_vhash_get64 (const gu_vhash_ctx_t* vh);
+
+/*! A function to hash buffer in one go */
+extern uint64_t
+gu_vhash64     (const void* buf, size_t len);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _gu_vhash_h_ */
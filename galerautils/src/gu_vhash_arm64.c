@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/**
+ * @file Vectorized VHash accumulation round using ARMv8 NEON instructions.
+ *
+ * Defines gu_vhash_hardware(). NEON is mandatory on AArch64, so no runtime
+ * detection is needed.
+ */
+
+#include "gu_vhash.h"
+
+#if defined(GU_VHASH_ARM64)
+
+#include "gu_log.h"
+
+#include <arm_neon.h>
+
+void
+gu_vhash_accumulate_neon(uint64_t* const       acc,
+                         const uint8_t*        stripes,
+                         size_t                n,
+                         const uint64_t*       keys)
+{
+    uint64x2_t a[GU_VHASH_LANES/2];
+    int j;
+
+    for (j = 0; j < GU_VHASH_LANES/2; ++j)
+        a[j] = vld1q_u64(acc + 2*j);
+
+    for (; n > 0; --n, stripes += GU_VHASH_STRIPE, ++keys)
+    {
+        for (j = 0; j < GU_VHASH_LANES/2; ++j)
+        {
+            uint64x2_t const d =
+                vreinterpretq_u64_u8(vld1q_u8(stripes + 16*j));
+            uint64x2_t const k = veorq_u64(d, vld1q_u64(keys + 2*j));
+            /* low 32 bits of each key lane times its high 32 bits */
+            uint64x2_t const p = vmull_u32(vmovn_u64(k), vshrn_n_u64(k, 32));
+            /* data goes to the neighbour lane */
+            uint64x2_t const s = vextq_u64(d, d, 1);
+
+            a[j] = vaddq_u64(a[j], vaddq_u64(p, s));
+        }
+    }
+
+    for (j = 0; j < GU_VHASH_LANES/2; ++j)
+        vst1q_u64(acc + 2*j, a[j]);
+}
+
+gu_vhash_accumulate_t
+gu_vhash_hardware()
+{
+    gu_info ("VHash: using NEON acceleration.");
+    return gu_vhash_accumulate_neon;
+}
+
+#endif /* GU_VHASH_ARM64 */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/**
+ * @file Vectorized VHash accumulation rounds using x86 SSE2 and AVX2
+ *       instructions.
+ *
+ * Defines gu_vhash_hardware() that returns the best gu_vhash_accumulate_t
+ * available on a given CPU. SSE2 is a part of x86_64 baseline, AVX2 code is
+ * compiled with function-level target attribute and selected at runtime.
+ */
+
+#include "gu_vhash.h"
+
+#if defined(GU_VHASH_X86_64)
+
+#include "gu_log.h"
+
+#include <immintrin.h>
+
+void
+gu_vhash_accumulate_sse2(uint64_t* const       acc,
+                         const uint8_t*        stripes,
+                         size_t                n,
+                         const uint64_t*       keys)
+{
+    __m128i a[GU_VHASH_LANES/2];
+    int j;
+
+    for (j = 0; j < GU_VHASH_LANES/2; ++j)
+        a[j] = _mm_loadu_si128((const __m128i*)acc + j);
+
+    for (; n > 0; --n, stripes += GU_VHASH_STRIPE, ++keys)
+    {
+        for (j = 0; j < GU_VHASH_LANES/2; ++j)
+        {
+            __m128i const d = _mm_loadu_si128((const __m128i*)stripes + j);
+            __m128i const k = _mm_xor_si128(
+                d, _mm_loadu_si128((const __m128i*)keys + j));
+            /* low 32 bits of each key lane times its high 32 bits */
+            __m128i const p = _mm_mul_epu32(
+                k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+            /* data goes to the neighbour lane */
+            __m128i const s = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+
+            a[j] = _mm_add_epi64(a[j], _mm_add_epi64(p, s));
+        }
+    }
+
+    for (j = 0; j < GU_VHASH_LANES/2; ++j)
+        _mm_storeu_si128((__m128i*)acc + j, a[j]);
+}
+
+__attribute__((target("avx2")))
+void
+gu_vhash_accumulate_avx2(uint64_t* const       acc,
+                         const uint8_t*        stripes,
+                         size_t                n,
+                         const uint64_t*       keys)
+{
+    __m256i a[GU_VHASH_LANES/4];
+    int j;
+
+    for (j = 0; j < GU_VHASH_LANES/4; ++j)
+        a[j] = _mm256_loadu_si256((const __m256i*)acc + j);
+
+    for (; n > 0; --n, stripes += GU_VHASH_STRIPE, ++keys)
+    {
+        for (j = 0; j < GU_VHASH_LANES/4; ++j)
+        {
+            __m256i const d = _mm256_loadu_si256((const __m256i*)stripes + j);
+            __m256i const k = _mm256_xor_si256(
+                d, _mm256_loadu_si256((const __m256i*)keys + j));
+            __m256i const p = _mm256_mul_epu32(
+                k, _mm256_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m256i const s = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+
+            a[j] = _mm256_add_epi64(a[j], _mm256_add_epi64(p, s));
+        }
+    }
+
+    for (j = 0; j < GU_VHASH_LANES/4; ++j)
+        _mm256_storeu_si256((__m256i*)acc + j, a[j]);
+}
+
+gu_vhash_accumulate_t
+gu_vhash_hardware()
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        gu_info ("VHash: using AVX2 acceleration.");
+        return gu_vhash_accumulate_avx2;
+    }
+    else
+    {
+        gu_info ("VHash: using SSE2 acceleration.");
+        return gu_vhash_accumulate_sse2;
+    }
+}
+
+#endif /* GU_VHASH_X86_64 */
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Compares gu::FlatHashSet against node based gu::UnorderedSet as a set of
+ * pointers to entries which refer to key data elsewhere in memory, as
+ * certification index does.
+ *
+ * Usage: flat_hash_bench [entries...]
+ *
+ * Default entry counts are 1M, 4M and 16M. Each entry takes additional
+ * 24 bytes outside of the container, so 50M entries need about 4G of RAM.
+ */
+
+#include "../src/gu_flat_hash.hpp"
+#include "../src/gu_unordered.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <stdint.h>
+#include <sys/time.h>
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+/* bytes currently allocated by containers */
+static size_t allocated(0);
+
+template <typename T>
+class CountingAllocator : public std::allocator<T>
+{
+public:
+    typedef typename std::allocator<T>::pointer   pointer;
+    typedef typename std::allocator<T>::size_type size_type;
+
+    template <typename U> struct rebind { typedef CountingAllocator<U> other; };
+
+    CountingAllocator() : std::allocator<T>() {}
+    CountingAllocator(const CountingAllocator& a) : std::allocator<T>(a) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& a) : std::allocator<T>(a) {}
+
+    pointer allocate(size_type n, const void* hint = 0)
+    {
+        allocated += n * sizeof(T);
+        return std::allocator<T>::allocate(n, hint);
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        allocated -= n * sizeof(T);
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+/* Entry refers to key data stored elsewhere: first word is the key hash,
+ * second word is the key itself */
+struct Entry
+{
+    const uint64_t* key;
+};
+
+struct EntryHash
+{
+    size_t operator()(const Entry* const e) const { return e->key[0]; }
+};
+
+struct EntryEqual
+{
+    bool operator()(const Entry* const l, const Entry* const r) const
+    {
+        return (l->key[0] == r->key[0] && l->key[1] == r->key[1]);
+    }
+};
+
+typedef gu::UnorderedSet<Entry*, EntryHash, EntryEqual,
+                         CountingAllocator<Entry*> > NodeSet;
+typedef gu::FlatHashSet<Entry*, EntryHash, EntryEqual,
+                        CountingAllocator<Entry*> > FlatSet;
+
+static uint64_t
+mix(uint64_t x)
+{
+    x += GU_ULONG_LONG(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * GU_ULONG_LONG(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * GU_ULONG_LONG(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
+class Data
+{
+public:
+
+    /* keys [0, n) are inserted, keys [n, 2n) are used for misses */
+    explicit Data(size_t const n)
+        : keys_(4 * n), entries_(n), probes_(std::min<size_t>(n, 1 << 20) * 2)
+    {
+        for (size_t i(0); i < 2 * n; ++i)
+        {
+            keys_[2 * i]     = mix(i);
+            keys_[2 * i + 1] = i;
+        }
+
+        for (size_t i(0); i < n; ++i) entries_[i].key = &keys_[2 * i];
+
+        /* probes are copies of keys in random order, like keys of a write
+         * set being certified: first half hits, second half misses */
+        size_t const half(probes_.size() / 2);
+        for (size_t i(0); i < probes_.size(); ++i)
+        {
+            size_t const k((mix(i + 2 * n) % n) + (i < half ? 0 : n));
+            probe_keys_.push_back(keys_[2 * k]);
+            probe_keys_.push_back(keys_[2 * k + 1]);
+        }
+        for (size_t i(0); i < probes_.size(); ++i)
+        {
+            probes_[i].key = &probe_keys_[2 * i];
+        }
+    }
+
+    size_t size() const { return entries_.size(); }
+    Entry* entry(size_t i) { return &entries_[i]; }
+    size_t probes() const { return probes_.size() / 2; }
+    Entry* hit(size_t i)  { return &probes_[i]; }
+    Entry* miss(size_t i) { return &probes_[probes() + i]; }
+
+private:
+
+    std::vector<uint64_t> keys_;
+    std::vector<Entry>    entries_;
+    std::vector<uint64_t> probe_keys_;
+    std::vector<Entry>    probes_;
+};
+
+template <class Set>
+static void
+run_bench(Data& data, const char* const name)
+{
+    size_t const base(allocated);
+    struct timeval t0, t1, t2, t3;
+
+    {
+        Set set;
+        gettimeofday(&t0, NULL);
+
+        for (size_t i(0); i < data.size(); ++i) set.insert(data.entry(i));
+
+        gettimeofday(&t1, NULL);
+
+        size_t found(0);
+        for (size_t i(0); i < data.probes(); ++i)
+        {
+            found += (set.find(data.hit(i)) != set.end());
+        }
+
+        gettimeofday(&t2, NULL);
+
+        for (size_t i(0); i < data.probes(); ++i)
+        {
+            found += (set.find(data.miss(i)) != set.end());
+        }
+
+        gettimeofday(&t3, NULL);
+
+        if (found != data.probes())
+        {
+            std::cerr << name << ": found " << found << " out of "
+                      << data.probes() << std::endl;
+            ::abort();
+        }
+
+        std::cout << data.size() << '\t' << name << '\t'
+                  << std::fixed << std::setprecision(1)
+                  << time_diff(t1, t0) * 1.0e9 / data.size() << '\t'
+                  << time_diff(t2, t1) * 1.0e9 / data.probes() << '\t'
+                  << time_diff(t3, t2) * 1.0e9 / data.probes() << '\t'
+                  << double(allocated - base) / data.size() << '\n';
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> sizes;
+
+    for (int i(1); i < argc; ++i)
+    {
+        std::istringstream is(argv[i]);
+        size_t n(0);
+        is >> n;
+        if (is.fail() || 0 == n)
+        {
+            std::cerr << "Invalid entry count: '" << argv[i] << "'"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+        sizes.push_back(n);
+    }
+
+    if (sizes.empty())
+    {
+        sizes.push_back(1 << 20);
+        sizes.push_back(1 << 22);
+        sizes.push_back(1 << 24);
+    }
+
+    std::cout << "Entries:\tImpl:\tInsert ns:\tHit ns:\tMiss ns:\tBytes/entry:\n";
+
+    for (size_t i(0); i < sizes.size(); ++i)
+    {
+        Data data(sizes[i]);
+        run_bench<NodeSet>(data, "node");
+        run_bench<FlatSet>(data, "flat");
+    }
+
+    return 0;
+}
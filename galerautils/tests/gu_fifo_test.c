@@ -1,4 +1,4 @@
-// Copyright (C) 2007-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2007-2026 Codership Oy <info@codership.com>
 
 // $Id$
 
@@ -308,6 +308,53 @@ START_TEST(gu_fifo_wrap_around_test)
 }
 END_TEST
 
+START_TEST (gu_fifo_batch_test)
+{
+    gu_fifo_t* fifo;
+    size_t*    items[16];
+    long       i, n, next = 0;
+    int        err;
+
+    /* small rows to have batches cross row boundaries */
+    fifo = gu_fifo_create (FIFO_WRAP_LENGTH, sizeof(size_t));
+    ck_assert(fifo != NULL);
+
+    for (i = 0; i < FIFO_WRAP_LENGTH; i++) {
+        size_t* const item = gu_fifo_get_tail (fifo);
+        ck_assert(item != NULL);
+        *item = i;
+        gu_fifo_push_tail (fifo);
+    }
+
+    /* batches of increasing size, including the ones exceeding queue length */
+    for (i = 1; next < FIFO_WRAP_LENGTH; i = i % 16 + 1) {
+        long const expected = FIFO_WRAP_LENGTH - next < i ?
+            FIFO_WRAP_LENGTH - next : i;
+        long j;
+
+        n = gu_fifo_get_head_n (fifo, (void**)items, i, &err);
+        ck_assert_msg(n == expected, "got %ld items, expected %ld",
+                      n, expected);
+
+        for (j = 0; j < n; j++, next++) {
+            ck_assert_msg(*items[j] == (size_t)next, "got %zu, expected %ld",
+                          *items[j], next);
+        }
+
+        gu_fifo_pop_head_n (fifo, n);
+        ck_assert(gu_fifo_length(fifo) == FIFO_WRAP_LENGTH - next);
+    }
+
+    gu_fifo_close (fifo);
+
+    n = gu_fifo_get_head_n (fifo, (void**)items, 16, &err);
+    ck_assert(n   == 0);
+    ck_assert(err == -ENODATA);
+
+    gu_fifo_destroy (fifo);
+}
+END_TEST
+
 Suite *gu_fifo_suite(void)
 {
     Suite *s  = suite_create("Galera FIFO functions");
@@ -317,6 +364,7 @@ Suite *gu_fifo_suite(void)
     tcase_add_test  (tc, gu_fifo_test);
     tcase_add_test  (tc, gu_fifo_cancel_test);
     tcase_add_test  (tc, gu_fifo_wrap_around_test);
+    tcase_add_test  (tc, gu_fifo_batch_test);
 
     tcase_set_timeout(tc, 60);
 
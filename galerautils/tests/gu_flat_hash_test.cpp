@@ -0,0 +1,161 @@
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+
+#include "../src/gu_flat_hash.hpp"
+
+#include "gu_flat_hash_test.hpp"
+
+#include <set>
+#include <vector>
+#include <cstdlib> // rand()
+
+namespace
+{
+    /* hash by value pointed to, deliberately weak to cause collisions */
+    struct IntPtrHash
+    {
+        size_t operator()(const int* const p) const { return *p % 64; }
+    };
+
+    struct IntPtrEqual
+    {
+        bool operator()(const int* const l, const int* const r) const
+        {
+            return *l == *r;
+        }
+    };
+
+    typedef gu::FlatHashSet<const int*, IntPtrHash, IntPtrEqual> Set;
+}
+
+START_TEST(empty_set)
+{
+    Set s;
+    int const v(1);
+
+    ck_assert(s.empty());
+    ck_assert(s.size() == 0);
+    ck_assert(s.bucket_count() == 0);
+    ck_assert(s.begin() == s.end());
+    ck_assert(s.find(&v) == s.end());
+}
+END_TEST
+
+START_TEST(insert_find_erase)
+{
+    std::vector<int> vals(1000);
+    for (size_t i(0); i < vals.size(); ++i) vals[i] = i;
+
+    Set s;
+
+    for (size_t i(0); i < vals.size(); ++i)
+    {
+        std::pair<Set::iterator, bool> const r(s.insert(&vals[i]));
+        ck_assert(r.second);
+        ck_assert(*r.first == &vals[i]);
+    }
+
+    ck_assert(s.size() == vals.size());
+    ck_assert(s.bucket_count() >= vals.size());
+
+    /* equal element by value must be found and not inserted twice */
+    int const dup(500);
+    ck_assert(*s.find(&dup) == &vals[500]);
+    ck_assert(s.insert(&dup).second == false);
+    ck_assert(s.size() == vals.size());
+
+    size_t count(0);
+    for (Set::iterator i(s.begin()); i != s.end(); ++i) ++count;
+    ck_assert(count == vals.size());
+
+    /* erase every other element */
+    for (size_t i(0); i < vals.size(); i += 2)
+    {
+        Set::iterator const it(s.find(&vals[i]));
+        ck_assert(it != s.end());
+        s.erase(it);
+    }
+
+    ck_assert(s.size() == vals.size() / 2);
+
+    for (size_t i(0); i < vals.size(); ++i)
+    {
+        ck_assert_msg((s.find(&vals[i]) != s.end()) == (i % 2 == 1),
+                      "wrong lookup result for %zu", i);
+    }
+
+    s.clear();
+    ck_assert(s.empty());
+    ck_assert(s.begin() == s.end());
+    ck_assert(s.find(&vals[1]) == s.end());
+
+    /* inserting a duplicate into a full table must not grow it */
+    Set f;
+    for (size_t i(0); i < Set::MIN_BUCKETS - Set::MIN_BUCKETS / 8; ++i)
+    {
+        ck_assert(f.insert(&vals[i]).second);
+    }
+    ck_assert(f.bucket_count() == Set::MIN_BUCKETS);
+    int const first(0);
+    ck_assert(f.insert(&first).second == false);
+    ck_assert(f.bucket_count() == Set::MIN_BUCKETS);
+    ck_assert(f.insert(&vals[Set::MIN_BUCKETS]).second);
+    ck_assert(f.bucket_count() == 2 * Set::MIN_BUCKETS);
+}
+END_TEST
+
+START_TEST(random_test)
+{
+    std::vector<int> vals(1 << 12);
+    for (size_t i(0); i < vals.size(); ++i) vals[i] = i;
+
+    Set s;
+    std::set<int> ref;
+
+    for (int n(0); n < (1 << 18); ++n)
+    {
+        int const v(rand() % vals.size());
+
+        if (rand() % 2)
+        {
+            bool const inserted(s.insert(&vals[v]).second);
+            ck_assert(inserted == ref.insert(v).second);
+        }
+        else
+        {
+            Set::iterator const it(s.find(&vals[v]));
+            bool const found(it != s.end());
+            ck_assert(found == (ref.erase(v) > 0));
+            if (found) s.erase(it);
+        }
+
+        ck_assert(s.size() == ref.size());
+    }
+
+    for (size_t i(0); i < vals.size(); ++i)
+    {
+        ck_assert((s.find(&vals[i]) != s.end()) == (ref.count(i) > 0));
+    }
+}
+END_TEST
+
+Suite*
+gu_flat_hash_suite()
+{
+    Suite* s = suite_create("FlatHashSet");
+    TCase* t;
+
+    t = tcase_create("empty");
+    tcase_add_test(t, empty_set);
+    suite_add_tcase(s, t);
+
+    t = tcase_create("insert_find_erase");
+    tcase_add_test(t, insert_find_erase);
+    suite_add_tcase(s, t);
+
+    t = tcase_create("random");
+    tcase_add_test(t, random_test);
+    tcase_set_timeout(t, 120);
+    suite_add_tcase(s, t);
+
+    return s;
+}
@@ -126,7 +126,8 @@ START_TEST (empty)
 END_TEST
 
 static void
-test_version (gu::RecordSet::Version version)
+test_version (gu::RecordSet::Version version,
+              gu::RecordSet::CheckType const ct = gu::RecordSet::CHECK_MMH64)
 {
     int const alignment(gu::RecordSet::VER2 == version ?
                         gu::RecordSet::VER2_ALIGNMENT : 1);
@@ -155,10 +156,10 @@ test_version (gu::RecordSet::Version version)
     union { gu_word_t align; gu::byte_t buf[1024]; } reserved;
     assert((uintptr_t(reserved.buf) % GU_WORD_BYTES) == 0);
     std::ostringstream os;
-    os << "gu_rset_test_ver" << version;
+    os << "gu_rset_test_ver" << version << "_ct" << ct;
     TestBaseName str(os.str().c_str());
     gu::RecordSetOut<TestRecord> rset_out(reserved.buf, sizeof(reserved), str,
-                                          gu::RecordSet::CHECK_MMH64, version);
+                                          ct, version);
 
     size_t offset(rset_out.size());
     ck_assert(1 == rset_out.page_count());
@@ -424,6 +425,12 @@ START_TEST (ver2)
 }
 END_TEST
 
+START_TEST (ver2_vhash)
+{
+    test_version(gu::RecordSet::VER2, gu::RecordSet::CHECK_VHASH64);
+}
+END_TEST
+
 /* This test is to test how padding mixes with persistent (stored outside)
  * pages. In this case new padding buf needs to be allocated */
 static void
@@ -578,6 +585,14 @@ START_TEST (ver2_sizes)
     es   = 16 + ct_s + GU_ALIGN(c*s, gu::RecordSet::VER2_ALIGNMENT);
     ck_assert(rs == es);
 
+    ct   = gu::RecordSet::CHECK_VHASH64;
+    ct_s = gu::RecordSet::check_size(ct);
+    c  = 1; // record count
+    s  = (1 << 14) - ct_s - 8; // max record size representable in "short" header
+    rs = ver2_size(c, s, ct);
+    es   = 8 + ct_s + GU_ALIGN(c*s, gu::RecordSet::VER2_ALIGNMENT);
+    ck_assert(rs == es);
+
     ct   = gu::RecordSet::CHECK_NONE;
     ct_s = gu::RecordSet::check_size(ct);
     c  = 1023;
@@ -603,6 +618,7 @@ Suite* gu_rset_suite ()
 
     t = tcase_create("RecordSet v2");
     tcase_add_test (t, ver2);
+    tcase_add_test (t, ver2_vhash);
     tcase_add_test (t, ver2_padding);
     tcase_add_test (t, ver2_sizes);
     suite_add_tcase (s, t);
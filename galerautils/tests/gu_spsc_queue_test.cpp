@@ -0,0 +1,127 @@
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+
+#include "../src/gu_spsc_queue.hpp"
+#include "../src/gu_threads.h"
+
+#include "gu_spsc_queue_test.hpp"
+
+namespace
+{
+    /* counts live copies to check that queue destroys what it constructs */
+    class Counted
+    {
+    public:
+        Counted(long v) : v_(v) { ++live; }
+        Counted(const Counted& c) : v_(c.v_) { ++live; }
+        ~Counted() { --live; }
+        long value() const { return v_; }
+        static gu::Atomic<long> live; // updated from both threads
+    private:
+        Counted& operator=(const Counted&);
+        long v_;
+    };
+
+    gu::Atomic<long> Counted::live(0);
+
+    /* small segments to exercise segment switching and recycling */
+    typedef gu::SpscQueue<Counted, 4> Queue;
+}
+
+START_TEST(fifo_order)
+{
+    {
+        Queue q;
+
+        ck_assert(q.empty());
+        ck_assert(q.front() == NULL);
+
+        long pushed(0), popped(0);
+
+        /* keep queue length varying across segment boundaries */
+        for (int round(0); round < 8; ++round)
+        {
+            for (int i(0); i < round * 3 + 1; ++i) q.push(Counted(pushed++));
+
+            for (int i(0); i < round * 2 + 1; ++i)
+            {
+                Counted* const c(q.front());
+                ck_assert(c != NULL);
+                ck_assert_int_eq(c->value(), popped);
+                q.pop();
+                ++popped;
+            }
+        }
+
+        ck_assert_int_eq(Counted::live(), pushed - popped);
+
+        while (q.front() != NULL)
+        {
+            ck_assert_int_eq(q.front()->value(), popped);
+            q.pop();
+            ++popped;
+        }
+
+        ck_assert_int_eq(popped, pushed);
+        ck_assert_int_eq(Counted::live(), 0);
+
+        for (int i(0); i < 10; ++i) q.push(Counted(i));
+    }
+
+    /* destructor releases elements left in the queue */
+    ck_assert_int_eq(Counted::live(), 0);
+}
+END_TEST
+
+namespace
+{
+    long const STRESS_COUNT = 1 << 20;
+
+    extern "C" void* producer_thd(void* arg)
+    {
+        Queue* const q(static_cast<Queue*>(arg));
+
+        for (long i(0); i < STRESS_COUNT; ++i) q->push(Counted(i));
+
+        return NULL;
+    }
+}
+
+START_TEST(producer_consumer)
+{
+    Queue q;
+    gu_thread_t thd;
+
+    ck_assert(0 == gu_thread_create(&thd, NULL, producer_thd, &q));
+
+    for (long i(0); i < STRESS_COUNT; ++i)
+    {
+        Counted* c;
+        while ((c = q.front()) == NULL) { /* spin */ }
+        ck_assert_int_eq(c->value(), i);
+        q.pop();
+    }
+
+    gu_thread_join(thd, NULL);
+
+    ck_assert(q.empty());
+    ck_assert_int_eq(Counted::live(), 0);
+}
+END_TEST
+
+Suite*
+gu_spsc_queue_suite()
+{
+    Suite* s = suite_create("SpscQueue");
+    TCase* t;
+
+    t = tcase_create("fifo_order");
+    tcase_add_test(t, fifo_order);
+    suite_add_tcase(s, t);
+
+    t = tcase_create("producer_consumer");
+    tcase_add_test(t, producer_consumer);
+    tcase_set_timeout(t, 60);
+    suite_add_tcase(s, t);
+
+    return s;
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "../src/gu_vhash.h"
+
+#include "gu_vhash_test.h"
+
+#include <string.h>
+
+#define BUF_SIZE (GU_VHASH_STRIPE * GU_VHASH_BLOCK * 3 + 8)
+
+static uint8_t test_buf[BUF_SIZE];
+
+static void
+fill_buf(void)
+{
+    uint64_t x = 0x2545F4914F6CDD1DULL;
+    size_t i;
+
+    for (i = 0; i < sizeof(test_buf); ++i)
+    {
+        /* xorshift64 */
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        test_buf[i] = (uint8_t)x;
+    }
+}
+
+/* Known answers of the portable implementation. These values are on-wire
+ * checksums, they must never change. */
+struct test_pair
+{
+    size_t   len;
+    uint64_t output;
+};
+
+static struct test_pair const
+test_vector[] =
+{
+    {    0, 0x8cafa377022abdb5ULL },
+    {    1, 0x152261aec8b8266bULL },
+    {    7, 0x33971cefda5abc9aULL },
+    {    8, 0xfa59e469338bf2baULL },
+    {   63, 0x438a070714db9352ULL },
+    {   64, 0xb7434d60fe88971cULL },
+    {   65, 0x81d3f74727f932d2ULL },
+    { 1023, 0x5ac298c69c4009e8ULL },
+    { 1024, 0xd159d61969a4afefULL },
+    { 1025, 0xf316599138310797ULL },
+    { 3000, 0xceb3193ff12b4ec9ULL }
+};
+
+static void
+test_known_answers(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(test_vector)/sizeof(test_vector[0]); ++i)
+    {
+        uint64_t const ret = gu_vhash64(test_buf, test_vector[i].len);
+
+        ck_assert_msg(ret == test_vector[i].output,
+                      "Length %zu resulted in 0x%016llx, expected 0x%016llx",
+                      test_vector[i].len, (unsigned long long)ret,
+                      (unsigned long long)test_vector[i].output);
+    }
+}
+
+/* compares results of the given implementation to the portable one for all
+ * lengths spanning several blocks and unaligned input */
+static void
+test_implementation(gu_vhash_accumulate_t const impl)
+{
+    size_t len, off;
+
+    for (off = 0; off < 8; off += 3)
+    {
+        for (len = 0; len + off <= sizeof(test_buf); ++len)
+        {
+            gu_vhash_accumulate_func = gu_vhash_accumulate_scalar;
+            uint64_t const exp = gu_vhash64(test_buf + off, len);
+
+            gu_vhash_accumulate_func = impl;
+            uint64_t const ret = gu_vhash64(test_buf + off, len);
+
+            ck_assert_msg(ret == exp,
+                          "Offset %zu, length %zu: 0x%016llx, "
+                          "expected 0x%016llx", off, len,
+                          (unsigned long long)ret, (unsigned long long)exp);
+        }
+    }
+
+    gu_vhash_accumulate_func = impl;
+    test_known_answers();
+    gu_vhash_accumulate_func = gu_vhash_accumulate_scalar;
+}
+
+START_TEST(test_gu_vhash_scalar)
+{
+    fill_buf();
+    test_implementation(gu_vhash_accumulate_scalar);
+}
+END_TEST
+
+START_TEST(test_gu_vhash_stream)
+{
+    static size_t const parts[] = { 0, 1, 3, 60, 64, 65, 127, 128, 900, 1 };
+
+    fill_buf();
+
+    gu_vhash_ctx_t vh;
+    gu_vhash_init(&vh);
+
+    size_t offset = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(parts)/sizeof(parts[0]); ++i)
+    {
+        gu_vhash_append(&vh, test_buf + offset, parts[i]);
+        offset += parts[i];
+
+        /* getting result must not affect the context */
+        uint64_t const ret = gu_vhash_get64(&vh);
+        ck_assert(ret == gu_vhash_get64(&vh));
+        ck_assert(ret == gu_vhash64(test_buf, offset));
+    }
+
+    gu_vhash_append(&vh, test_buf + offset, sizeof(test_buf) - offset);
+    ck_assert(gu_vhash_get64(&vh) == gu_vhash64(test_buf, sizeof(test_buf)));
+}
+END_TEST
+
+/* vectorized layout makes lanes independent, make sure that moving data
+ * between lanes and stripes still affects the result */
+START_TEST(test_gu_vhash_sensitivity)
+{
+    uint8_t buf[GU_VHASH_STRIPE * 2];
+    uint8_t tmp[8];
+
+    fill_buf();
+    memcpy(buf, test_buf, sizeof(buf));
+
+    uint64_t const orig = gu_vhash64(buf, sizeof(buf));
+
+    /* swap neighbour lanes */
+    memcpy(tmp, buf, 8); memcpy(buf, buf + 8, 8); memcpy(buf + 8, tmp, 8);
+    ck_assert(gu_vhash64(buf, sizeof(buf)) != orig);
+    memcpy(buf, test_buf, sizeof(buf));
+
+    /* swap stripes */
+    memcpy(buf, test_buf + GU_VHASH_STRIPE, GU_VHASH_STRIPE);
+    memcpy(buf + GU_VHASH_STRIPE, test_buf, GU_VHASH_STRIPE);
+    ck_assert(gu_vhash64(buf, sizeof(buf)) != orig);
+    memcpy(buf, test_buf, sizeof(buf));
+
+    /* zero padding of the tail must not collide with explicit zeroes */
+    memset(buf, 0, sizeof(buf));
+    ck_assert(gu_vhash64(buf, 1) != gu_vhash64(buf, 2));
+    ck_assert(gu_vhash64(buf, 0) != gu_vhash64(buf, 1));
+}
+END_TEST
+
+#if defined(GU_VHASH_X86_64)
+START_TEST(test_gu_vhash_sse2)
+{
+    fill_buf();
+    test_implementation(gu_vhash_accumulate_sse2);
+}
+END_TEST
+
+START_TEST(test_gu_vhash_avx2)
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        fill_buf();
+        test_implementation(gu_vhash_accumulate_avx2);
+    }
+}
+END_TEST
+#endif /* GU_VHASH_X86_64 */
+
+#if defined(GU_VHASH_ARM64)
+START_TEST(test_gu_vhash_neon)
+{
+    fill_buf();
+    test_implementation(gu_vhash_accumulate_neon);
+}
+END_TEST
+#endif /* GU_VHASH_ARM64 */
+
+Suite *gu_vhash_suite(void)
+{
+    Suite *suite = suite_create("VHash implementations");
+    TCase *t;
+
+    t = tcase_create("gu_vhash_sw");
+    suite_add_tcase (suite, t);
+    tcase_add_test  (t, test_gu_vhash_scalar);
+    tcase_add_test  (t, test_gu_vhash_stream);
+    tcase_add_test  (t, test_gu_vhash_sensitivity);
+
+#if defined(GU_VHASH_X86_64)
+    t = tcase_create("gu_vhash_hw_x86_64");
+    suite_add_tcase (suite, t);
+    tcase_add_test  (t, test_gu_vhash_sse2);
+    tcase_add_test  (t, test_gu_vhash_avx2);
+#endif /* GU_VHASH_X86_64 */
+
+#if defined(GU_VHASH_ARM64)
+    t = tcase_create("gu_vhash_hw_arm64");
+    suite_add_tcase (suite, t);
+    tcase_add_test  (t, test_gu_vhash_neon);
+#endif /* GU_VHASH_ARM64 */
+
+    return suite;
+}
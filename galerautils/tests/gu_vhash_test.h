@@ -0,0 +1,12 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#ifndef __gu_vhash_test_h__
+#define __gu_vhash_test_h__
+
+#include <check.h>
+
+Suite* gu_vhash_suite(void);
+
+#endif /* __gu_vhash_test_h__ */
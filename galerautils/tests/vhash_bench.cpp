@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/* Compares RecordSet payload checksum kernels: 128-bit MurmurHash3 used by
+ * CHECK_MMH128 and available VHash implementations used by CHECK_VHASH64 */
+
+#include "../src/gu_vhash.h"
+#include "../src/gu_mmh3.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#if __cplusplus >= 201103L
+#include <chrono>
+#else
+#include <sys/time.h>
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+#endif // C++11
+
+static std::vector<unsigned char> data(1<<21 /* 2M */);
+
+// Initialize data
+static class Setup
+{
+public:
+    Setup()
+    {
+        for (size_t i(0); i < data.size(); ++i)
+        {
+            data[i] = static_cast<unsigned char>(i);
+        }
+    }
+}
+    setup;
+
+static size_t const align_loop(sizeof(uint64_t));
+
+static void
+check_len(size_t const len)
+{
+    if ((data.size() - len) < align_loop)
+        throw std::out_of_range("Too many reps");
+}
+
+static uint64_t
+run_bench_mmh3(size_t const len, size_t const reps)
+{
+    check_len(len);
+
+    gu_mmh128_ctx_t ctx;
+    gu_mmh128_init(&ctx);
+
+    for (size_t r(0); r < reps; ++r)
+        for (size_t i(0); i < align_loop; ++i)
+        {
+            // here we roll data window over the main data buffer to give equal
+            // chance to different alignments
+            gu_mmh128_append(&ctx, &data[i], len);
+        }
+
+    return gu_mmh128_get64(&ctx);
+}
+
+static uint64_t
+run_bench_vhash(size_t const len, size_t const reps)
+{
+    check_len(len);
+
+    gu_vhash_ctx_t ctx;
+    gu_vhash_init(&ctx);
+
+    for (size_t r(0); r < reps; ++r)
+        for (size_t i(0); i < align_loop; ++i)
+        {
+            gu_vhash_append(&ctx, &data[i], len);
+        }
+
+    return gu_vhash_get64(&ctx);
+}
+
+static void
+run_bench_with_impl(gu_vhash_accumulate_t impl,
+                    size_t                len,
+                    size_t                reps,
+                    const char*           comment)
+{
+    gu_vhash_accumulate_func = impl;
+
+#if __cplusplus >= 201103L
+    auto start(std::chrono::steady_clock::now());
+    auto result(impl ? run_bench_vhash(len, reps) : run_bench_mmh3(len, reps));
+    auto stop(std::chrono::steady_clock::now());
+    auto duration(std::chrono::duration<double>(stop - start).count());
+#else
+    struct timeval start, stop;
+    gettimeofday(&start, NULL);
+    uint64_t result(impl ?
+                    run_bench_vhash(len, reps) : run_bench_mmh3(len, reps));
+    gettimeofday(&stop,  NULL);
+    double const duration(time_diff(stop, start));
+#endif // C++11
+
+    std::cout << comment << '\t' << len << '\t'
+              << std::fixed << duration << '\t' << std::hex << result
+              << std::dec << '\n';
+}
+
+static gu_vhash_accumulate_t configured_impl;
+
+static void
+one_length(size_t const len, size_t const reps)
+{
+    std::cout << "\nImpl:   \tBytes:\tDuration:\tResult:\n";
+
+    run_bench_with_impl(NULL,                       len, reps, "GU MMH128  ");
+    run_bench_with_impl(gu_vhash_accumulate_scalar, len, reps, "VH scalar  ");
+#if defined(GU_VHASH_X86_64)
+    run_bench_with_impl(gu_vhash_accumulate_sse2,   len, reps, "VH sse2    ");
+    if (gu_vhash_accumulate_avx2 == configured_impl)
+        run_bench_with_impl(gu_vhash_accumulate_avx2, len, reps, "VH avx2    ");
+#endif /* GU_VHASH_X86_64 */
+
+#if defined(GU_VHASH_ARM64)
+    run_bench_with_impl(gu_vhash_accumulate_neon,   len, reps, "VH neon    ");
+#endif /* GU_VHASH_ARM64 */
+}
+
+int main()
+{
+    gu_vhash_configure();
+
+    configured_impl = gu_vhash_accumulate_func;
+
+    one_length(11,  1<<22 /* 4M   */);
+    one_length(64,  1<<20 /* 1M   */);
+    one_length(512, 1<<17 /* 128K */);
+    one_length(4096, 1<<14 /* 16K */);
+    one_length(1<<20,  64 /* 1M   */);
+}
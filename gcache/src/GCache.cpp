@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "GCache.hpp"
@@ -49,7 +49,8 @@ namespace gcache
         gid       (),
         mem       (params.mem_size(), seqno2ptr, params.debug()),
         rb        (params.rb_name(), params.rb_size(), seqno2ptr, gid,
-                   params.debug(), params.recover()),
+                   params.debug(), params.recover(),
+                   params.recover_threads()),
         ps        (params.dir_name(),
                    params.keep_pages_size(),
                    params.page_size(),
@@ -57,7 +58,8 @@ namespace gcache
                    /* keep last page if PS is the only storage */
                    params.keep_pages_count() ?
                    params.keep_pages_count() :
-                   !((params.mem_size() + params.rb_size()) > 0)),
+                   !((params.mem_size() + params.rb_size()) > 0),
+                   params.spare_pages()),
         mallocs   (0),
         reallocs  (0),
         frees     (0),
@@ -69,7 +71,12 @@ namespace gcache
 #ifndef NDEBUG
         ,buf_tracker()
 #endif
-    {}
+    {
+        if (params.huge_pages() || params.numa_node() >= 0)
+        {
+            rb.set_memory_policy(params.huge_pages(), params.numa_node());
+        }
+    }
 
     GCache::~GCache ()
     {
@@ -87,6 +94,19 @@ namespace gcache
                ps.allocated_pool_size();
     }
 
+    void GCache::page_stats_get (long long& allocs, long long& spares,
+                                 double& avg_ns, long long& max_ns)
+    {
+        gu::Lock lock(mtx);
+        ps.alloc_stats_get(allocs, spares, avg_ns, max_ns);
+    }
+
+    void GCache::page_stats_reset ()
+    {
+        gu::Lock lock(mtx);
+        ps.alloc_stats_reset();
+    }
+
     /*! prints object properties */
     void print (std::ostream& os) {}
 }
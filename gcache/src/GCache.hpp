@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef __GCACHE_H__
@@ -69,8 +69,20 @@ namespace gcache
 
         /*!
          * Release (free) buffers up to seqno
+         * @param max maximum number of seqnos to release in this call,
+         *            0 - no limit
+         * @return true if there is more to release up to seqno
          */
-        void seqno_release (seqno_t seqno);
+        bool seqno_release (seqno_t seqno, size_t max = 0);
+
+        /*!
+         * Returns the seqno up to which buffers have been released
+         */
+        seqno_t seqno_last_released() const
+        {
+            gu::Lock lock(mtx);
+            return seqno_released;
+        }
 
         /*!
          * Returns smallest seqno present in history
@@ -104,6 +116,16 @@ namespace gcache
          */
         size_t allocated_pool_size ();
 
+        /*!
+         * Returns page store allocation statistics: number of pages
+         * allocated, how many of them were spare ones, average and maximum
+         * page allocation time.
+         */
+        void page_stats_get (long long& allocs, long long& spares,
+                             double& avg_ns, long long& max_ns);
+
+        void page_stats_reset ();
+
 
         /*!
          * Implements the cleanup policy test.
@@ -175,6 +197,13 @@ namespace gcache
          */
         size_t seqno_get_buffers (std::vector<Buffer>& v, seqno_t start);
 
+        /*!
+         * Starts asynchronous read-ahead of the first n buffers in v which
+         * are backed by files (ring buffer and page store), so that they are
+         * resident by the time they are read. Buffers must stay seqno locked.
+         */
+        void seqno_prefetch (const std::vector<Buffer>& v, size_t n) const;
+
         /*!
          * Releases any seqno locks present.
          */
@@ -209,8 +238,12 @@ namespace gcache
             size_t page_size()           const { return page_size_;       }
             size_t keep_pages_size()     const { return keep_pages_size_; }
             size_t keep_pages_count()    const { return keep_pages_count_; }
+            size_t spare_pages()         const { return spare_pages_;     }
             int    debug()               const { return debug_;           }
             bool   recover()             const { return recover_;         }
+            int    recover_threads()     const { return recover_threads_; }
+            bool   huge_pages()          const { return huge_pages_;      }
+            int    numa_node()           const { return numa_node_;       }
 
             bool skip_purge(seqno_t seqno)
             {
@@ -222,6 +255,7 @@ namespace gcache
             void page_size       (size_t s) { page_size_       = s; }
             void keep_pages_size (size_t s) { keep_pages_size_ = s; }
             void keep_pages_count (size_t c) { keep_pages_count_ = c; }
+            void spare_pages     (size_t c) { spare_pages_     = c; }
             void freeze_purge_at_seqno(seqno_t s) { freeze_purge_at_seqno_ = s; }
 #ifndef NDEBUG
             void debug           (int    d) { debug_           = d; }
@@ -236,8 +270,12 @@ namespace gcache
             size_t            page_size_;
             size_t            keep_pages_size_;
             size_t            keep_pages_count_;
+            size_t            spare_pages_;
             int               debug_;
             bool        const recover_;
+            int         const recover_threads_;
+            bool        const huge_pages_;
+            int         const numa_node_;
             seqno_t           freeze_purge_at_seqno_;
         }
             params;
@@ -245,7 +283,8 @@ namespace gcache
 #ifdef HAVE_PSI_INTERFACE
         gu::MutexWithPFS mtx;
 #else
-        gu::Mutex       mtx;
+        /* taken briefly by every allocating, committing and purging thread */
+        gu::AdaptiveMutex mtx;
 #endif /* HAVE_PSI_INTERFACE */
         seqno2ptr_t     seqno2ptr;
         gu::UUID        gid;
@@ -1,14 +1,17 @@
 /*
- * Copyright (C) 2009-2021 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "gcache_bh.hpp"
 #include "GCache.hpp"
 
+#include <gu_limits.h> // GU_PAGE_SIZE
+
 #include <cerrno>
 #include <cassert>
 
-#include <sched.h> // sched_yeild()
+#include <sched.h>    // sched_yeild()
+#include <sys/mman.h> // posix_madvise()
 
 namespace gcache
 {
@@ -96,8 +99,8 @@ namespace gcache
         bh->seqno_d = seqno_d;
     }
 
-    void
-    GCache::seqno_release (seqno_t const seqno)
+    bool
+    GCache::seqno_release (seqno_t const seqno, size_t const max)
     {
         assert (seqno > 0);
         /* The number of buffers scheduled for release is unpredictable, so
@@ -116,6 +119,8 @@ namespace gcache
 
         bool   sleep_a_bit(false);
 
+        size_t released(0); // seqnos covered so far
+
         do
         {
             if (sleep_a_bit) {
@@ -154,7 +159,7 @@ namespace gcache
                     log_debug << "Releasing seqno " << seqno << " before "
                               << seqno_released + 1 << " was assigned.";
                 }
-                return;
+                return false;
             }
 
             assert(seqno_max >= seqno_released);
@@ -166,9 +171,11 @@ namespace gcache
             old_gap = new_gap;
 
             seqno_t const start(idx - 1);
-            seqno_t const end  (seqno - start >= 2*batch_size ?
+            seqno_t       end  (seqno - start >= 2*batch_size ?
                                 start + batch_size : seqno);
 
+            if (max > 0) end = std::min(end, start + seqno_t(max - released));
+
             // Just not to overcomplicate the logic here:
             // release only if the whole batch can be released, if not - wait.
             if (seqno_locked != SEQNO_NONE && end >= seqno_locked) {
@@ -217,6 +224,8 @@ namespace gcache
 
             loop = (end < seqno) && loop;
 
+            released += end - start;
+
 #ifndef NDEBUG
             if (params.debug())
             {
@@ -225,8 +234,11 @@ namespace gcache
                          << old_sr << " -> " << seqno_released;
             }
 #endif
+            if (loop && max > 0 && released >= max) return true;
         }
         while(loop);
+
+        return false;
     }
 
     /*!
@@ -320,6 +332,28 @@ namespace gcache
         return found;
     }
 
+    void
+    GCache::seqno_prefetch (const std::vector<Buffer>& v, size_t const n) const
+    {
+        assert (n <= v.size());
+
+        uintptr_t const page_mask(~(uintptr_t(GU_PAGE_SIZE) - 1));
+
+        for (size_t i(0); i < n; ++i)
+        {
+            const BufferHeader* const bh(ptr2BH(v[i].ptr()));
+
+            if (BUFFER_IN_MEM == bh->store) continue;
+
+            uintptr_t const begin(uintptr_t(v[i].ptr()) & page_mask);
+            uintptr_t const end(uintptr_t(v[i].ptr()) + v[i].size());
+
+            /* advisory only, failure just means no read-ahead */
+            (void)posix_madvise(reinterpret_cast<void*>(begin), end - begin,
+                                POSIX_MADV_WILLNEED);
+        }
+    }
+
     /*!
      * Releases any history locks present.
      */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2018 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 /*! @file page file class implementation */
@@ -9,6 +9,7 @@
 
 #include <gu_throw.hpp>
 #include <gu_logger.hpp>
+#include <gu_limits.h> // GU_PAGE_SIZE
 
 // for posix_fadvise()
 #if !defined(_XOPEN_SOURCE)
@@ -48,6 +49,21 @@ gcache::Page::drop_fs_cache() const
 #endif
 }
 
+void
+gcache::Page::prefault()
+{
+    assert(0 == used_);
+
+    uint8_t* const start(static_cast<uint8_t*>(mmap_.ptr));
+
+    for (volatile uint8_t* p(start); p < start + mmap_.size; p += GU_PAGE_SIZE)
+    {
+        *p = 0;
+    }
+
+    reset();
+}
+
 gcache::Page::Page (void* ps, const std::string& name, size_t size, int dbg)
     :
 #ifdef HAVE_PSI_INTERFACE
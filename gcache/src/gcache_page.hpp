@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2018 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 /*! @file page file class */
@@ -61,6 +61,9 @@ namespace gcache
         /* Drop filesystem cache on the file */
         void drop_fs_cache() const;
 
+        /* Fault in the whole page for writing, the page must be unused */
+        void prefault();
+
         void* parent() const { return ps_; }
 
         size_t allocated_pool_size ();
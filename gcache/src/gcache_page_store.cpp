@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2018 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 /*! @file page store implementation */
@@ -10,10 +10,10 @@
 
 #include <gu_logger.hpp>
 #include <gu_throw.hpp>
+#include <gu_time.h>
 
 #include <cstdio>
 #include <cstring>
-#include <pthread.h>
 
 #include <iomanip>
 
@@ -47,11 +47,9 @@ make_page_name (const std::string& base_name, size_t count)
     return os.str();
 }
 
-static void*
-remove_file (void* __restrict__ arg)
+void*
+gcache::PageStore::page_thread (void* arg)
 {
-    char* const file_name (static_cast<char*>(arg));
-
 #ifdef HAVE_PSI_INTERFACE
     pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
                        WSREP_PFS_INSTR_OPS_INIT,
@@ -59,35 +57,132 @@ remove_file (void* __restrict__ arg)
                        NULL, NULL, NULL);
 #endif /* HAVE_PSI_INTERFACE */
 
-    if (NULL != file_name)
+    static_cast<PageStore*>(arg)->manage_pages();
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_GCACHE_REMOVEFILE_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    return NULL;
+}
+
+void
+gcache::PageStore::delete_pages (PageQueue& pages)
+{
+    for (PageQueue::iterator i(pages.begin()); i != pages.end(); ++i)
     {
-        if (remove (file_name))
+        std::string const file_name((*i)->name());
+
+        delete *i;
+
+        if (remove (file_name.c_str()))
         {
             int err = errno;
 
-            log_error << "Failed to remove page file '" << file_name << "': "
-                      << err << " (" << strerror(err) << ")";
+            log_error << "Failed to remove page file '" << file_name
+                      << "': " << err << " (" << strerror(err) << ")";
         }
         else
         {
             log_info << "Deleted page " << file_name;
         }
-
-        free (file_name);
     }
-    else
+
+    pages.clear();
+}
+
+void
+gcache::PageStore::manage_pages ()
+{
+    while (true)
     {
-        log_error << "Null file name in " << __FUNCTION__;
-    }
+        PageQueue   pages;
+        PageQueue   recycle;
+        std::string spare_name;
+        size_t      spare_size(0);
+        int         dbg(0);
 
-#ifdef HAVE_PSI_INTERFACE
-    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
-                       WSREP_PFS_INSTR_OPS_DESTROY,
-                       WSREP_PFS_INSTR_TAG_GCACHE_REMOVEFILE_THREAD,
-                       NULL, NULL, NULL);
-#endif /* HAVE_PSI_INTERFACE */
+        {
+            gu::Lock lock(page_mtx_);
+
+            while (delete_queue_.empty() && recycle_queue_.empty() &&
+                   !spare_needed() && !page_exit_)
+            {
+                lock.wait(page_cond_);
+            }
+
+            pages.swap(delete_queue_);
 
-    pthread_exit(NULL);
+            if (page_exit_)
+            {
+                pages.insert(pages.end(), recycle_queue_.begin(),
+                             recycle_queue_.end());
+                pages.insert(pages.end(), spare_pages_.begin(),
+                             spare_pages_.end());
+                recycle_queue_.clear();
+                spare_pages_.clear();
+
+                if (pages.empty()) break;
+            }
+            else
+            {
+                recycle.swap(recycle_queue_);
+
+                /* recycled pages are put back in the next round */
+                if (recycle.empty() && spare_needed())
+                {
+                    spare_size = spare_size_;
+                    spare_name = make_page_name(base_name_, count_++);
+                    dbg = debug_;
+                }
+            }
+        }
+
+        delete_pages(pages);
+
+        for (PageQueue::iterator i(recycle.begin()); i != recycle.end(); ++i)
+        {
+            log_info << "Recycling page " << (*i)->name() << " as spare";
+            (*i)->prefault();
+        }
+
+        Page* spare(0);
+
+        if (spare_size > 0)
+        {
+            try
+            {
+                spare = new Page(this, spare_name, spare_size, dbg);
+                spare->prefault();
+            }
+            catch (gu::Exception& e)
+            {
+                log_warn << "Failed to create spare page, spare pages are "
+                         << "disabled until they are set again: " << e.what();
+            }
+        }
+
+        gu::Lock lock(page_mtx_);
+
+        if (spare) recycle.push_back(spare);
+        else if (spare_size > 0) spare_count_ = 0;
+
+        for (PageQueue::iterator i(recycle.begin()); i != recycle.end(); ++i)
+        {
+            if ((*i)->size() == spare_size_ &&
+                spare_pages_.size() < spare_count_ && !page_exit_)
+            {
+                spare_pages_.push_back(*i);
+            }
+            else
+            {
+                delete_queue_.push_back(*i);
+            }
+        }
+    }
 }
 
 /*
@@ -106,28 +201,23 @@ gcache::PageStore::delete_page ()
 
     pages_.pop_front();
 
-    char* const file_name(strdup(page->name().c_str()));
-
     total_size_ -= page->size();
 
     if (current_ == page) current_ = 0;
 
-    delete page;
-
-#ifdef GCACHE_DETACH_THREAD
-    pthread_t delete_thr_;
-#else
-    if (delete_thr_ != pthread_t(-1)) pthread_join (delete_thr_, NULL);
-#endif /* GCACHE_DETACH_THERAD */
+    gu::Lock lock(page_mtx_);
 
-    int err = gu_thread_create (&delete_thr_, &delete_page_attr_, remove_file,
-                                file_name);
-    if (0 != err)
+    if (page->size() == spare_size_ && spare_needed() && !page_exit_)
+    {
+        recycle_queue_.push_back(page);
+    }
+    else
     {
-        delete_thr_ = pthread_t(-1);
-        gu_throw_error(err) << "Failed to create page file deletion thread";
+        delete_queue_.push_back(page);
     }
 
+    page_cond_.signal();
+
     return true;
 }
 
@@ -176,20 +266,125 @@ gcache::PageStore::reset ()
 inline void
 gcache::PageStore::new_page (size_type size)
 {
-    Page* const page(new Page
-                     (this, make_page_name (base_name_, count_), size, debug_));
+    long long const start(gu_time_monotonic());
+
+    Page*       page(0);
+    std::string name;
+
+    {
+        gu::Lock lock(page_mtx_);
+
+        if (!spare_pages_.empty() && spare_pages_.front()->size() >= size)
+        {
+            page = spare_pages_.front();
+            spare_pages_.pop_front();
+            page_cond_.signal(); // replenish spare pages
+        }
+        else
+        {
+            name = make_page_name (base_name_, count_++);
+        }
+    }
+
+    if (page)
+    {
+        page->set_debug(debug_);
+        alloc_spares_++;
+    }
+    else
+    {
+        page = new Page(this, name, size, debug_);
+    }
 
     pages_.push_back (page);
     total_size_ += page->size();
     current_ = page;
-    count_++;
+
+    long long const time(gu_time_monotonic() - start);
+    allocs_++;
+    alloc_time_ += time;
+    if (time > alloc_max_) alloc_max_ = time;
+}
+
+void
+gcache::PageStore::set_page_size (size_t const size)
+{
+    page_size_ = size;
+
+    {
+        gu::Lock lock(page_mtx_);
+
+        spare_size_ = page_size_;
+
+        /* spare pages of the old size are not needed any more */
+        delete_queue_.insert(delete_queue_.end(), spare_pages_.begin(),
+                             spare_pages_.end());
+        spare_pages_.clear();
+        page_cond_.signal();
+    }
+
+    cleanup();
+}
+
+void
+gcache::PageStore::set_spare_count (size_t const count)
+{
+    {
+        gu::Lock lock(page_mtx_);
+
+        spare_count_ = count;
+
+        while (spare_pages_.size() > spare_count_)
+        {
+            delete_queue_.push_back(spare_pages_.back());
+            spare_pages_.pop_back();
+        }
+
+        page_cond_.signal();
+    }
+
+    cleanup();
+}
+
+size_t
+gcache::PageStore::count ()
+{
+    gu::Lock lock(page_mtx_);
+    return count_;
+}
+
+size_t
+gcache::PageStore::spare_pages ()
+{
+    gu::Lock lock(page_mtx_);
+    return spare_pages_.size();
+}
+
+void
+gcache::PageStore::alloc_stats_get (long long& allocs, long long& spares,
+                                    double& avg_ns, long long& max_ns) const
+{
+    allocs = allocs_;
+    spares = alloc_spares_;
+    avg_ns = allocs_ > 0 ? double(alloc_time_) / allocs_ : 0.0;
+    max_ns = alloc_max_;
+}
+
+void
+gcache::PageStore::alloc_stats_reset ()
+{
+    allocs_       = 0;
+    alloc_spares_ = 0;
+    alloc_time_   = 0;
+    alloc_max_    = 0;
 }
 
 gcache::PageStore::PageStore (const std::string& dir_name,
                               size_t             keep_size,
                               size_t             page_size,
                               int                dbg,
-                              bool               keep_page)
+                              bool               keep_page,
+                              size_t             spare_count)
     :
     base_name_ (make_base_name(dir_name)),
     keep_size_ (keep_size),
@@ -199,46 +394,48 @@ gcache::PageStore::PageStore (const std::string& dir_name,
     pages_     (),
     current_   (0),
     total_size_(0),
-    delete_page_attr_(),
-    debug_     (dbg & DEBUG)
-#ifndef GCACHE_DETACH_THREAD
-    , delete_thr_(pthread_t(-1))
-#endif /* GCACHE_DETACH_THREAD */
+    debug_     (dbg & DEBUG),
+    allocs_      (0),
+    alloc_spares_(0),
+    alloc_time_  (0),
+    alloc_max_   (0),
+#ifdef HAVE_PSI_INTERFACE
+    page_mtx_    (WSREP_PFS_INSTR_TAG_GCACHE_MUTEX),
+    page_cond_   (WSREP_PFS_INSTR_TAG_SERVICE_THD_CONDVAR),
+#else
+    page_mtx_    (),
+    page_cond_   (),
+#endif /* HAVE_PSI_INTERFACE */
+    delete_queue_(),
+    recycle_queue_(),
+    spare_pages_ (),
+    spare_count_ (spare_count),
+    spare_size_  (page_size),
+    page_exit_   (false),
+    page_thr_    ()
 {
-    int err = pthread_attr_init (&delete_page_attr_);
+    int const err(gu_thread_create (&page_thr_, NULL, page_thread, this));
 
     if (0 != err)
     {
-        gu_throw_error(err) << "Failed to initialize page file deletion "
-                            << "thread attributes";
+        gu_throw_error(err) << "Failed to create page file management thread";
     }
-
-#ifdef GCACHE_DETACH_THREAD
-    err = pthread_attr_setdetachstate (&delete_page_attr_,
-                                       PTHREAD_CREATE_DETACHED);
-    if (0 != err)
-    {
-        pthread_attr_destroy (&delete_page_attr_);
-        gu_throw_error(err) << "Failed to set DETACHED attribute to "
-                            << "page file deletion thread";
-    }
-#endif /* GCACHE_DETACH_THREAD */
 }
 
 gcache::PageStore::~PageStore ()
 {
-    try
-    {
-        while (pages_.size() && delete_page()) {};
-#ifndef GCACHE_DETACH_THREAD
-        if (delete_thr_ != pthread_t(-1)) pthread_join (delete_thr_, NULL);
-#endif /* GCACHE_DETACH_THREAD */
-    }
-    catch (gu::Exception& e)
+    while (pages_.size() && delete_page()) {};
+
     {
-        log_error << e.what() << " in ~PageStore()"; // abort() ?
+        gu::Lock lock(page_mtx_);
+        page_exit_ = true;
+        page_cond_.signal();
     }
 
+    /* page_thr_ works on the queues above, so unlike the old per-file
+     * deletion threads it can never be detached */
+    gu_thread_join (page_thr_, NULL);
+
     if (pages_.size() > 0)
     {
         log_error << "Could not delete " << pages_.size()
@@ -249,8 +446,6 @@ gcache::PageStore::~PageStore ()
                 log_error << *(*i);;
             }
     }
-
-    pthread_attr_destroy (&delete_page_attr_);
 }
 
 inline void*
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2018 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 /*! @file page store class */
@@ -11,6 +11,8 @@
 #include "gcache_page.hpp"
 #include "gcache_seqno.hpp"
 
+#include <gu_lock.hpp>
+
 #include <string>
 #include <deque>
 
@@ -24,7 +26,8 @@ namespace gcache
                    size_t             keep_size,
                    size_t             page_size,
                    int                dbg,
-                   bool               keep_page);
+                   bool               keep_page,
+                   size_t             spare_count = 0);
 
         ~PageStore ();
 
@@ -49,20 +52,29 @@ namespace gcache
         void  reset();
 
 
-        void  set_page_size (size_t size) { page_size_ = size; cleanup();}
+        void  set_page_size (size_t size);
 
         void  set_keep_size (size_t size) { keep_size_ = size; cleanup();}
 
         void  set_keep_count (size_t count) { keep_page_ = count; cleanup();}
 
+        void  set_spare_count (size_t count);
+
         size_t allocated_pool_size ();
 
         void  set_debug(int dbg);
 
         /* for unit tests */
-        size_t count()       const { return count_;        }
+        size_t count();
         size_t total_pages() const { return pages_.size(); }
         size_t total_size()  const { return total_size_;   }
+        size_t spare_pages();
+
+        /* page allocation statistics: number of pages allocated, how many of
+         * them were spare, average and maximum allocation time */
+        void alloc_stats_get(long long& allocs, long long& spares,
+                             double& avg_ns, long long& max_ns) const;
+        void alloc_stats_reset();
 
     private:
 
@@ -72,22 +84,58 @@ namespace gcache
         size_t            keep_size_; /* how much pages to keep after freeing*/
         size_t            page_size_; /* min size of the individual page */
         size_t            keep_page_; /* whether to keep the last page(s) */
-        size_t            count_;
+        size_t            count_;     /* protected by page_mtx_ */
         typedef std::deque<Page*> PageQueue;
         PageQueue         pages_;
         Page*             current_;
         size_t            total_size_;
-        pthread_attr_t    delete_page_attr_;
         int               debug_;
-#ifndef GCACHE_DETACH_THREAD
-        pthread_t         delete_thr_;
-#endif /* GCACHE_DETACH_THREAD */
+        long long         allocs_;
+        long long         alloc_spares_;
+        long long         alloc_time_;
+        long long         alloc_max_;
+        /* creating, unmapping and removing page files can take a while, so it
+         * is done by page_thr_ outside of GCache lock. Pages freed beyond
+         * keep limits are recycled as spare ones instead of being deleted,
+         * and new spares are created ahead of demand, up to spare_count_.
+         * Recycled pages keep their file names, so page file numbers do not
+         * follow the order in which pages are put to use.
+         * There are no dedicated instrumentation tags for these, so the PFS
+         * build reuses the GCache mutex and service thread condvar ones. */
+#ifdef HAVE_PSI_INTERFACE
+        gu::MutexWithPFS  page_mtx_;
+        gu::CondWithPFS   page_cond_;
+#else
+        gu::Mutex         page_mtx_;
+        gu::Cond          page_cond_;
+#endif /* HAVE_PSI_INTERFACE */
+        PageQueue         delete_queue_;
+        PageQueue         recycle_queue_;
+        PageQueue         spare_pages_;
+        size_t            spare_count_;
+        size_t            spare_size_;
+        bool              page_exit_;
+        gu_thread_t       page_thr_;
 
         void new_page    (size_type size);
 
         // returns true if a page could be deleted
         bool delete_page ();
 
+        // page_mtx_ must be locked
+        bool spare_needed () const
+        {
+            return (spare_size_ > 0 &&
+                    spare_pages_.size() + recycle_queue_.size() < spare_count_);
+        }
+
+        static void* page_thread (void* arg);
+
+        // deletes, recycles and creates pages until page_exit_ is set
+        void manage_pages ();
+
+        void delete_pages (PageQueue& pages);
+
         // cleans up extra pages.
         void cleanup     ();
 
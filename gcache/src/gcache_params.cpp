@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2018 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "GCache.hpp"
@@ -18,12 +18,24 @@ static const std::string GCACHE_PARAMS_KEEP_PAGES_SIZE("gcache.keep_pages_size")
 static const std::string GCACHE_PARAMS_KEEP_PAGES_COUNT("gcache.keep_pages_count");
 static const std::string GCACHE_DEFAULT_KEEP_PAGES_SIZE("0");
 static const std::string GCACHE_DEFAULT_KEEP_PAGES_COUNT("0");
+/* Spare pages hold no writesets, so they are not counted against
+ * gcache.keep_pages_size/count: that would evict kept history to make room
+ * for empty files. Disk use on top of the keep limits is bounded separately
+ * by gcache.spare_pages * gcache.page_size. */
+static const std::string GCACHE_PARAMS_SPARE_PAGES("gcache.spare_pages");
+static const std::string GCACHE_DEFAULT_SPARE_PAGES("0");
 #ifndef NDEBUG
 static const std::string GCACHE_PARAMS_DEBUG      ("gcache.debug");
 static const std::string GCACHE_DEFAULT_DEBUG     ("0");
 #endif
 static const std::string GCACHE_PARAMS_RECOVER    ("gcache.recover");
 static const std::string GCACHE_DEFAULT_RECOVER   ("no");
+static const std::string GCACHE_PARAMS_RECOVER_THREADS ("gcache.recover_threads");
+static const std::string GCACHE_DEFAULT_RECOVER_THREADS("0"); // 0 - all CPUs
+static const std::string GCACHE_PARAMS_HUGE_PAGES ("gcache.huge_pages");
+static const std::string GCACHE_DEFAULT_HUGE_PAGES("no");
+static const std::string GCACHE_PARAMS_NUMA_NODE  ("gcache.numa_node");
+static const std::string GCACHE_DEFAULT_NUMA_NODE ("-1"); // -1 - no preference
 static const std::string GCACHE_PARAMS_FREEZE_PURGE_SEQNO("gcache.freeze_purge_at_seqno");
 static const std::string GCACHE_DEFAULT_FREEZE_PURGE_SEQNO("-1");
 
@@ -37,10 +49,14 @@ gcache::GCache::Params::register_params(gu::Config& cfg)
     cfg.add(GCACHE_PARAMS_PAGE_SIZE,       GCACHE_DEFAULT_PAGE_SIZE);
     cfg.add(GCACHE_PARAMS_KEEP_PAGES_SIZE, GCACHE_DEFAULT_KEEP_PAGES_SIZE);
     cfg.add(GCACHE_PARAMS_KEEP_PAGES_COUNT, GCACHE_DEFAULT_KEEP_PAGES_COUNT);
+    cfg.add(GCACHE_PARAMS_SPARE_PAGES,     GCACHE_DEFAULT_SPARE_PAGES);
 #ifndef NDEBUG
     cfg.add(GCACHE_PARAMS_DEBUG,           GCACHE_DEFAULT_DEBUG);
 #endif
     cfg.add(GCACHE_PARAMS_RECOVER,         GCACHE_DEFAULT_RECOVER);
+    cfg.add(GCACHE_PARAMS_RECOVER_THREADS, GCACHE_DEFAULT_RECOVER_THREADS);
+    cfg.add(GCACHE_PARAMS_HUGE_PAGES,      GCACHE_DEFAULT_HUGE_PAGES);
+    cfg.add(GCACHE_PARAMS_NUMA_NODE,       GCACHE_DEFAULT_NUMA_NODE);
     cfg.add(GCACHE_PARAMS_FREEZE_PURGE_SEQNO, GCACHE_DEFAULT_FREEZE_PURGE_SEQNO);
 }
 
@@ -78,12 +94,16 @@ gcache::GCache::Params::Params (gu::Config& cfg, const std::string& data_dir)
     page_size_(cfg.get<size_t>(GCACHE_PARAMS_PAGE_SIZE)),
     keep_pages_size_(cfg.get<size_t>(GCACHE_PARAMS_KEEP_PAGES_SIZE)),
     keep_pages_count_(cfg.get<size_t>(GCACHE_PARAMS_KEEP_PAGES_COUNT)),
+    spare_pages_(cfg.get<size_t>(GCACHE_PARAMS_SPARE_PAGES)),
 #ifndef NDEBUG
     debug_    (cfg.get<int>(GCACHE_PARAMS_DEBUG)),
 #else
     debug_    (0),
 #endif
     recover_  (cfg.get<bool>(GCACHE_PARAMS_RECOVER)),
+    recover_threads_(cfg.get<int>(GCACHE_PARAMS_RECOVER_THREADS)),
+    huge_pages_(cfg.get<bool>(GCACHE_PARAMS_HUGE_PAGES)),
+    numa_node_(cfg.get<int>(GCACHE_PARAMS_NUMA_NODE)),
     freeze_purge_at_seqno_(cfg.get<seqno_t>(GCACHE_PARAMS_FREEZE_PURGE_SEQNO))
 {}
 
@@ -160,7 +180,22 @@ gcache::GCache::param_set (const std::string& key, const std::string& val)
                           params.keep_pages_count() :
                           !((params.mem_size() + params.rb_size()) > 0));
     }
-    else if (key == GCACHE_PARAMS_RECOVER)
+    else if (key == GCACHE_PARAMS_SPARE_PAGES)
+    {
+        size_t tmp_count = gu::Config::from_config<size_t>(val);
+
+        gu::Lock lock(mtx);
+        /* locking here serves two purposes: ensures atomic setting of config
+         * and params and syncs with malloc() method */
+
+        config.set<size_t>(key, tmp_count);
+        params.spare_pages(tmp_count);
+        ps.set_spare_count(params.spare_pages());
+    }
+    else if (key == GCACHE_PARAMS_RECOVER ||
+             key == GCACHE_PARAMS_RECOVER_THREADS ||
+             key == GCACHE_PARAMS_HUGE_PAGES ||
+             key == GCACHE_PARAMS_NUMA_NODE)
     {
         gu_throw_error(EINVAL) << "'" << key
                                << "' has a meaning only on startup.";
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #include "gcache_rb_store.hpp"
@@ -12,9 +12,18 @@
 #include <gu_progress.hpp>
 #include <gu_hexdump.hpp>
 #include <gu_hash.h>
+#include <gu_threads.h>
+#include <gu_time.h>
+#include <gu_atomic.hpp>
+#include <gu_limits.h>
 
 #include <cassert>
 #include <iostream> // std::cerr
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace gcache
 {
@@ -56,7 +65,8 @@ namespace gcache
                             seqno2ptr_t&       seqno2ptr,
                             gu::UUID&          gid,
                             int const          dbg,
-                            bool const         recover)
+                            bool const         recover,
+                            int const          recover_threads)
     :
 #ifdef HAVE_PSI_INTERFACE
         fd_        (name, WSREP_PFS_INSTR_TAG_RINGBUFFER_FILE, check_size(size)),
@@ -79,6 +89,7 @@ namespace gcache
         size_free_ (size_cache_),
         size_used_ (0),
         size_trail_(0),
+        recover_threads_(recover_threads),
 //        mallocs_   (0),
 //        reallocs_  (0),
         debug_     (dbg & DEBUG),
@@ -97,6 +108,33 @@ namespace gcache
         mmap_.sync();
     }
 
+    void
+    RingBuffer::set_memory_policy(bool const huge_pages, int const numa_node)
+    {
+        if (huge_pages && !mmap_.huge_pages())
+        {
+            log_warn << "Transparent huge pages are not available for "
+                     << fd_.name() << ", using base pages";
+        }
+
+        if (numa_node >= 0)
+        {
+            long long const start(gu_time_monotonic());
+
+            if (mmap_.prefer_node(numa_node))
+            {
+                log_info << "Read " << fd_.name() << " into NUMA node "
+                         << numa_node << " in "
+                         << (gu_time_monotonic() - start) / 1000000 << " ms";
+            }
+            else
+            {
+                log_warn << "NUMA node binding is not available for "
+                         << fd_.name();
+            }
+        }
+    }
+
     static inline void
     empty_buffer(BufferHeader* const bh) //mark buffer as empty
     {
@@ -707,6 +745,235 @@ namespace gcache
         write_preamble(true);
     }
 
+    namespace
+    {
+        struct PrefetchSlot
+        {
+            const uint8_t* begin; // slot beginning
+            const uint8_t* end;   // slot end
+        };
+
+        struct PrefetchCtx
+        {
+            const std::vector<PrefetchSlot>* slots; // in the order of scan()
+            const uint8_t*      limit;   // last possible header
+            int                 step;
+            long                budget;  // pages to read in
+            gu::Atomic<size_t>* next;    // next slot to take
+            gu::Atomic<long>*   pages;   // pages read in
+            long                buffers; // buffer headers found
+        };
+
+        size_t const SLOTS(32);             // ring buffer slices to prefetch
+        size_t const RA_LEN(1 << 20);       // prefetch read-ahead window
+        size_t const RA_DENSE(RA_LEN / 32); // max distance between headers
+
+        /* @return size of a buffer with a valid header at ptr, 0 otherwise */
+        inline size_t
+        header_size(const uint8_t* const ptr, const uint8_t* const limit)
+        {
+            const BufferHeader* const bh(BH_const_cast(ptr));
+
+            /* garbage size can overflow pointer arithmetics */
+            if (BH_test(bh) && bh->size > 0 &&
+                bh->size <= size_t(limit - ptr)) return bh->size;
+
+            return 0;
+        }
+
+        /* @return average size of the first buffers in the slot,
+         *         slot size if no buffers could be found */
+        size_t
+        sample_buffer_size(const PrefetchSlot& slot, const uint8_t* const limit,
+                           int const step)
+        {
+            const uint8_t* ptr(slot.begin);
+            const uint8_t* first(NULL);
+            long           count(0);
+
+            while (ptr < slot.end && count < 64)
+            {
+                size_t const size(header_size(ptr, limit));
+
+                if (size > 0)
+                {
+                    if (!first) first = ptr;
+                    count++;
+                    ptr += size;
+                }
+                else
+                {
+                    ptr += step;
+                }
+            }
+
+            return count > 0 ? (ptr - first) / count : slot.end - slot.begin;
+        }
+
+        /* Walks buffer chain through the slots touching only the headers,
+         * probes for the next header when the chain is broken. Where headers
+         * are densely packed reads ahead whole windows instead of pages. */
+        extern "C" void*
+        prefetch_thread(void* arg)
+        {
+            PrefetchCtx& ctx(*static_cast<PrefetchCtx*>(arg));
+            const std::vector<PrefetchSlot>& slots(*ctx.slots);
+            size_t const page_size(GU_PAGE_SIZE);
+
+            for (size_t i(ctx.next->fetch_and_add(1)); i < slots.size() &&
+                     (*ctx.pages)() < ctx.budget;
+                 i = ctx.next->fetch_and_add(1))
+            {
+                const uint8_t* ptr(slots[i].begin);
+                uintptr_t      page(0);
+                const uint8_t* ra_end(NULL);
+                size_t         gap(RA_DENSE); // from the previous header
+                long           pages(0);
+
+                while (ptr < slots[i].end)
+                {
+                    if (uintptr_t(ptr) >= page + page_size)
+                    {
+                        page = uintptr_t(ptr) - uintptr_t(ptr) % page_size;
+
+                        if (ptr < ra_end) {}
+                        else if (gap < RA_DENSE)
+                        {
+                            uint8_t* const ra(reinterpret_cast<uint8_t*>(page));
+                            ra_end = std::min<const uint8_t*>(ra + RA_LEN,
+                                                              ctx.limit);
+                            posix_madvise(ra, ra_end - ra, MADV_WILLNEED);
+                            pages += (ra_end - ra) / page_size;
+                        }
+                        else
+                        {
+                            pages++;
+                        }
+                    }
+
+                    gap = header_size(ptr, ctx.limit);
+
+                    if (gap > 0)
+                    {
+                        ctx.buffers++;
+                    }
+                    else
+                    {
+                        gap = ctx.step;
+                    }
+
+                    ptr += gap;
+                }
+
+                *ctx.pages += pages;
+            }
+
+            return NULL;
+        }
+
+        void
+        advise(const gu::MMap& mmap, int const advice, const char* const name)
+        {
+            if (posix_madvise(mmap.ptr, mmap.size, advice))
+            {
+                log_warn << "Failed to set " << name << " on " << mmap.ptr
+                         << ": " << errno << " (" << ::strerror(errno) << ')';
+            }
+        }
+    }
+
+    /* Serial scan() spends most of the time waiting for the headers to be
+     * paged in, together with the whole buffers around them because of
+     * read-ahead. This reads in only the pages with the headers by parallel
+     * threads beforehand, in the order scan() will need them and as much as
+     * would fit in free memory. */
+    void
+    RingBuffer::prefetch(off_t const offset, int const scan_step)
+    {
+        long threads(recover_threads_ > 0 ? recover_threads_ :
+                     ::sysconf(_SC_NPROCESSORS_ONLN));
+        threads = std::min<long>(threads, SLOTS);
+
+        if (threads <= 1 || scan_step != MemOps::ALIGNMENT) return;
+
+        const uint8_t* const limit(end_ - sizeof(BufferHeader));
+        size_t const slot_size((size_cache_ / SLOTS / MemOps::ALIGNMENT + 1) *
+                               MemOps::ALIGNMENT);
+
+        /* scan() starts either at the first buffer or at start_ */
+        size_t const first_slot(offset > 0 ? offset / slot_size : 0);
+
+        std::vector<PrefetchSlot> slots(SLOTS);
+
+        for (size_t i(0); i < slots.size(); ++i)
+        {
+            size_t const slot((first_slot + i) % slots.size());
+
+            slots[i].begin = std::min<const uint8_t*>(start_ +
+                                                      slot * slot_size, limit);
+            slots[i].end   = std::min(slots[i].begin + slot_size, limit);
+        }
+
+        /* when buffers are small, scan() reads in the whole file anyway and
+         * sequential read-ahead does it best */
+        size_t const buffer_size(sample_buffer_size(slots[0], limit,
+                                                    scan_step));
+        if (buffer_size < RA_DENSE)
+        {
+            log_info << "Skipped GCache ring buffer prefetch: average buffer "
+                "size " << buffer_size << " bytes";
+            return;
+        }
+
+        long long const start(gu_time_monotonic());
+
+        gu::Atomic<size_t> next(0);
+        gu::Atomic<long>   pages(0);
+        long const budget(::sysconf(_SC_AVPHYS_PAGES) / 2);
+
+        std::vector<PrefetchCtx> ctxs(threads);
+        std::vector<gu_thread_t> thds(threads);
+        long started(0);
+
+        for (long i(0); i < threads; ++i)
+        {
+            PrefetchCtx const ctx =
+                { &slots, limit, scan_step, budget, &next, &pages, 0 };
+            ctxs[i] = ctx;
+        }
+
+        /* fault in single pages instead of read-ahead windows */
+        advise(mmap_, MADV_RANDOM, "MADV_RANDOM");
+
+        for (; started < threads; ++started)
+        {
+            int const err(gu_thread_create(&thds[started], NULL,
+                                           prefetch_thread, &ctxs[started]));
+            if (err)
+            {
+                log_warn << "Failed to start GCache ring buffer prefetch "
+                    "thread: " << err << " (" << ::strerror(err) << ')';
+                break;
+            }
+        }
+
+        if (0 == started) prefetch_thread(&ctxs[0]);
+
+        long buffers(0);
+
+        for (long i(0); i < threads; ++i)
+        {
+            if (i < started) gu_thread_join(thds[i], NULL);
+            buffers += ctxs[i].buffers;
+        }
+
+        advise(mmap_, MADV_NORMAL, "MADV_NORMAL");
+
+        log_info << "GCache ring buffer prefetch: " << started << " threads, "
+                 << buffers << " buffers, " << pages() << " pages, "
+                 << (gu_time_monotonic() - start) / 1000000 << " ms";
+    }
+
     seqno_t
     RingBuffer::scan(off_t const offset, int const scan_step)
     {
@@ -992,9 +1259,12 @@ namespace gcache
     {
         static const char* const diag_prefix ="Recovering GCache ring buffer: ";
 
+        int const scan_step(version > 0 ? MemOps::ALIGNMENT : 1);
+
+        prefetch(offset, scan_step);
+
         /* scan the buffer and populate seqno2ptr map */
-        seqno_t const lowest(scan(offset, version > 0 ? MemOps::ALIGNMENT : 1)
-                             + 1);
+        seqno_t const lowest(scan(offset, scan_step) + 1);
         /* lowest is the lowest valid seqno based on collisions during scan */
 
         if (!seqno2ptr_.empty())
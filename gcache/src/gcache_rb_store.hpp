@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 /*! @file ring buffer storage class */
@@ -28,7 +28,8 @@ namespace gcache
                     seqno2ptr_t&       seqno2ptr,
                     gu::UUID&          gid,
                     int                dbg,
-                    bool               recover);
+                    bool               recover,
+                    int                recover_threads);
 
         ~RingBuffer ();
 
@@ -56,6 +57,10 @@ namespace gcache
 
         void  seqno_reset();
 
+        /* places the mapping memory on huge pages and/or preferred NUMA node
+         * (numa_node < 0 means no preference) */
+        void  set_memory_policy(bool huge_pages, int numa_node);
+
         /* returns true when successfully discards all seqnos in range */
         bool  discard_seqnos(seqno2ptr_t::iterator i_begin,
                              seqno2ptr_t::iterator i_end);
@@ -167,6 +172,7 @@ namespace gcache
         size_t             size_free_;
         size_t             size_used_;
         size_t             size_trail_;
+        int          const recover_threads_;
 
         int                debug_;
 
@@ -176,6 +182,8 @@ namespace gcache
 
         void          constructor_common();
 
+        void          prefetch(off_t offset, int scan_step);
+
         /* preamble fields */
         static std::string const PR_KEY_VERSION;
         static std::string const PR_KEY_GID;
@@ -200,6 +208,7 @@ namespace gcache
 #ifdef GCACHE_RB_UNIT_TEST
     public:
         uint8_t* start() const { return start_; }
+        static size_t header_offset() { return PREAMBLE_LEN; }
 #endif
     };
 
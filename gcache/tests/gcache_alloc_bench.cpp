@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Concurrent GCache allocation benchmark.
+ *
+ * Applier threads allocate writesets and assign them seqnos out of order,
+ * local threads allocate and free unordered buffers and a service thread
+ * releases ordered buffers as they become contiguous, all of them contending
+ * for GCache at once. Runs are repeated with increasing number of applier
+ * and local threads. Reported is the number of allocations per second.
+ * Lock contention only shows when the threads really run in parallel, so
+ * the results are meaningful only on a multi-core machine.
+ *
+ * Usage: gcache_alloc_bench [allocations per thread] [max threads] [size]
+ */
+
+#include "GCache.hpp"
+
+#include <gu_atomic.hpp>
+#include <gu_logger.hpp>
+#include <gu_time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace gcache;
+
+namespace
+{
+    struct Params
+    {
+        long   allocs;
+        int    threads;
+        size_t size;
+    };
+
+    struct ThreadArgs
+    {
+        GCache*          gcache;
+        const Params*    params;
+        int              threads; // appliers in this run
+        int              idx;     // applier index
+        seqno_t          base;    // last seqno of the previous run
+        std::vector<gu::Atomic<seqno_t> >* last; // last seqno per applier
+        gu::Atomic<int>* done;    // appliers finished
+    };
+
+    /* applier i assigns seqnos base + i + 1 + k*threads, so everything up to
+     * the minimum of the last assigned seqnos is contiguous */
+    extern "C" void*
+    applier_thd(void* arg)
+    {
+        const ThreadArgs& a(*static_cast<ThreadArgs*>(arg));
+
+        for (long k(0); k < a.params->allocs; ++k)
+        {
+            seqno_t const seqno(a.base + a.idx + 1 + k * a.threads);
+            void* const ptr(a.gcache->malloc(a.params->size));
+
+            if (!ptr) ::abort();
+
+            a.gcache->seqno_assign(ptr, seqno, seqno - 1);
+            (*a.last)[a.idx] = seqno;
+        }
+
+        ++(*a.done);
+
+        return NULL;
+    }
+
+    extern "C" void*
+    local_thd(void* arg)
+    {
+        const ThreadArgs& a(*static_cast<ThreadArgs*>(arg));
+
+        for (long k(0); k < a.params->allocs; ++k)
+        {
+            void* const ptr(a.gcache->malloc(a.params->size));
+
+            if (!ptr) ::abort();
+
+            a.gcache->free(ptr);
+        }
+
+        return NULL;
+    }
+
+    seqno_t
+    contiguous(const std::vector<gu::Atomic<seqno_t> >& last)
+    {
+        seqno_t ret(last[0]());
+
+        for (size_t i(1); i < last.size(); ++i) ret = std::min(ret, last[i]());
+
+        return ret;
+    }
+
+    /* @return last assigned seqno */
+    seqno_t
+    run(GCache& gcache, const Params& p, int const threads, seqno_t const base)
+    {
+        std::vector<gu::Atomic<seqno_t> > last(threads, base);
+        gu::Atomic<int>          done(0);
+        std::vector<ThreadArgs>  args(threads);
+        std::vector<gu_thread_t> appliers(threads);
+        std::vector<gu_thread_t> locals(threads);
+
+        long long const start(gu_time_monotonic());
+
+        for (int i(0); i < threads; ++i)
+        {
+            ThreadArgs const a =
+                { &gcache, &p, threads, i, base, &last, &done };
+            args[i] = a;
+            gu_thread_create(&appliers[i], NULL, applier_thd, &args[i]);
+            gu_thread_create(&locals[i], NULL, local_thd, &args[i]);
+        }
+
+        /* service thread */
+        seqno_t released(base);
+        while (done() < threads)
+        {
+            seqno_t const seqno(contiguous(last));
+            if (seqno > released)
+            {
+                gcache.seqno_release(seqno);
+                released = seqno;
+            }
+            ::usleep(1000);
+        }
+
+        for (int i(0); i < threads; ++i)
+        {
+            gu_thread_join(appliers[i], NULL);
+            gu_thread_join(locals[i], NULL);
+        }
+
+        double const duration((gu_time_monotonic() - start) * 1.0e-9);
+        seqno_t const seqno(base + p.allocs * threads);
+
+        gcache.seqno_release(seqno);
+
+        std::cout << std::setw(8)  << threads
+                  << std::setw(12) << std::fixed << std::setprecision(3)
+                  << duration
+                  << std::setw(12) << long(2 * threads * p.allocs / duration)
+                  << std::endl;
+
+        return seqno;
+    }
+
+    void silent_log(int, const char*) {}
+}
+
+int main(int argc, char* argv[])
+{
+    Params p = { 100000, 8, 1024 };
+
+    if (argc > 1) p.allocs  = ::strtol(argv[1], NULL, 10);
+    if (argc > 2) p.threads = ::atoi(argv[2]);
+    if (argc > 3) p.size    = ::strtoul(argv[3], NULL, 10);
+
+    if (p.allocs <= 0 || p.threads <= 0 || p.size == 0)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [allocations per thread] [max threads] [size]"
+                  << std::endl;
+        return 1;
+    }
+
+    gu_conf_set_log_callback(silent_log);
+
+    std::string const name("gcache_alloc_bench.cache");
+    gu::Config conf;
+    GCache::register_params(conf);
+    conf.set("gcache.name", name);
+    conf.set("gcache.size", "128M");
+
+    {
+        GCache gcache(conf, ".");
+
+        std::cout << "Allocations per thread: " << p.allocs << ", size: "
+                  << p.size << "\n"
+                  << std::setw(8)  << "threads"
+                  << std::setw(12) << "seconds"
+                  << std::setw(12) << "allocs/sec" << std::endl;
+
+        seqno_t seqno(0);
+        for (int threads(1); threads <= p.threads; threads *= 2)
+        {
+            seqno = run(gcache, p, threads, seqno);
+        }
+    }
+
+    ::unlink(name.c_str());
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * GCache memory placement benchmark.
+ *
+ * Creates a fresh ring buffer in the given directory for every memory
+ * configuration (default, transparent huge pages, preferred NUMA node and
+ * both), stores writesets in it until it is 3/4 full and then fetches them
+ * back in batches as IST would, reading every byte. Reported is store and
+ * fetch throughput in MB/s. Huge pages for the ring buffer file are only
+ * available if the directory is on tmpfs with huge pages enabled for shmem.
+ *
+ * Usage: gcache_mem_bench [dir] [size MB] [writeset size] [NUMA node]
+ */
+
+#include "GCache.hpp"
+
+#include <gu_logger.hpp>
+#include <gu_time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace gcache;
+
+namespace
+{
+    struct Params
+    {
+        std::string dir;
+        size_t      size;
+        size_t      ws_size;
+        int         node;
+    };
+
+    seqno_t
+    store(GCache& gcache, const Params& p)
+    {
+        std::vector<uint8_t> ws(p.ws_size);
+        for (size_t i(0); i < ws.size(); ++i) ws[i] = uint8_t(i);
+
+        seqno_t const count(p.size / 4 * 3 / p.ws_size);
+
+        for (seqno_t seqno(1); seqno <= count; ++seqno)
+        {
+            void* const ptr(gcache.malloc(p.ws_size));
+
+            if (!ptr) ::abort();
+
+            ::memcpy(ptr, &ws[0], ws.size());
+            gcache.seqno_assign(ptr, seqno, seqno - 1);
+        }
+
+        return count;
+    }
+
+    /* @return checksum, so that reading can't be optimized out */
+    uint64_t
+    fetch(GCache& gcache, seqno_t const count)
+    {
+        std::vector<GCache::Buffer> v(64);
+        uint64_t sum(0);
+
+        gcache.seqno_lock(1);
+
+        for (seqno_t seqno(1); seqno <= count;)
+        {
+            size_t const n(gcache.seqno_get_buffers(v, seqno));
+
+            if (0 == n) ::abort();
+
+            for (size_t i(0); i < n; ++i)
+            {
+                const uint64_t* const b
+                    (reinterpret_cast<const uint64_t*>(v[i].ptr()));
+
+                for (ssize_t j(0); j < v[i].size() / ssize_t(sizeof(*b)); ++j)
+                {
+                    sum += b[j];
+                }
+            }
+
+            seqno += n;
+        }
+
+        gcache.seqno_unlock();
+
+        return sum;
+    }
+
+    void
+    run(const Params& p, bool const huge_pages, int const node)
+    {
+        std::string const name(p.dir + "/gcache_mem_bench.cache");
+        ::unlink(name.c_str());
+
+        std::ostringstream size;
+        size << p.size;
+
+        gu::Config conf;
+        GCache::register_params(conf);
+        conf.set("gcache.name", name);
+        conf.set("gcache.size", size.str());
+        conf.set("gcache.huge_pages", huge_pages);
+        conf.set("gcache.numa_node", node);
+
+        double   store_time, fetch_time;
+        size_t   bytes;
+        uint64_t sum;
+        {
+            GCache gcache(conf, p.dir);
+
+            long long const start(gu_time_monotonic());
+            seqno_t const count(store(gcache, p));
+            long long const middle(gu_time_monotonic());
+            sum = fetch(gcache, count);
+            long long const end(gu_time_monotonic());
+
+            gcache.seqno_release(count);
+
+            store_time = (middle - start) * 1.0e-9;
+            fetch_time = (end - middle) * 1.0e-9;
+            bytes = count * p.ws_size;
+        }
+
+        ::unlink(name.c_str());
+
+        std::cout << std::setw(12) << (huge_pages ? "yes" : "no")
+                  << std::setw(8)  << node
+                  << std::setw(12) << std::fixed << std::setprecision(1)
+                  << bytes / store_time / (1 << 20)
+                  << std::setw(12) << bytes / fetch_time / (1 << 20)
+                  << std::setw(20) << sum << std::endl;
+    }
+
+    void silent_log(int, const char*) {}
+}
+
+int main(int argc, char* argv[])
+{
+    Params p = { ".", size_t(1) << 30, 4096, 0 };
+
+    if (argc > 1) p.dir     = argv[1];
+    if (argc > 2) p.size    = ::strtoull(argv[2], NULL, 10) << 20;
+    if (argc > 3) p.ws_size = ::strtoull(argv[3], NULL, 10);
+    if (argc > 4) p.node    = ::atoi(argv[4]);
+
+    if (p.size == 0 || p.ws_size == 0 || p.ws_size > p.size / 4 || p.node < 0)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [dir] [size MB] [writeset size] [NUMA node]"
+                  << std::endl;
+        return 1;
+    }
+
+    gu_conf_set_log_callback(silent_log);
+
+    std::cout << "Ring buffer: " << (p.size >> 20) << "MB in " << p.dir
+              << ", writeset size: " << p.ws_size << "\n"
+              << std::setw(12) << "huge pages"
+              << std::setw(8)  << "node"
+              << std::setw(12) << "store MB/s"
+              << std::setw(12) << "fetch MB/s"
+              << std::setw(20) << "checksum" << std::endl;
+
+    run(p, false, -1);
+    run(p, true,  -1);
+    run(p, false, p.node);
+    run(p, true,  p.node);
+
+    return 0;
+}
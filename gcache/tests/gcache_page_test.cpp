@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -8,6 +8,8 @@
 #include "gcache_bh.hpp"
 #include "gcache_page_test.hpp"
 
+#include <unistd.h>
+
 using namespace gcache;
 
 void ps_free (void* ptr)
@@ -115,6 +117,63 @@ START_TEST(test3) // check that all page size is efficiently used
 }
 END_TEST
 
+static bool
+wait_spare_pages (gcache::PageStore& ps, size_t const n)
+{
+    for (int i(0); i < 10000 && ps.spare_pages() != n; ++i) usleep(1000);
+    return (ps.spare_pages() == n);
+}
+
+START_TEST(test4) // spare pages are allocated ahead and recycled
+{
+    const char* const dir_name = "";
+    ssize_t const keep_size = 0;
+    ssize_t const page_size = 1024;
+
+    gcache::PageStore ps (dir_name, keep_size, page_size, 0, false, 1);
+
+    ck_assert(wait_spare_pages(ps, 1));
+    ck_assert_msg(ps.count() == 1, "ps.count() = %zd, expected 1", ps.count());
+
+    void* ptr = ps.malloc (page_size / 2);
+    ck_assert(0 != ptr);
+    ck_assert(ps.total_pages() == 1);
+
+    /* the spare taken by malloc() is replaced by a new one */
+    ck_assert(wait_spare_pages(ps, 1));
+    ck_assert_msg(ps.count() == 2, "ps.count() = %zd, expected 2", ps.count());
+
+    long long allocs, spares, max_ns;
+    double    avg_ns;
+    ps.alloc_stats_get(allocs, spares, avg_ns, max_ns);
+    ck_assert_msg(allocs == 1 && spares == 1, "allocs: %lld, spares: %lld",
+                  allocs, spares);
+    ck_assert(max_ns > 0 && avg_ns == double(max_ns));
+
+    ps_free(ptr); ps.discard(ptr2BH(ptr));
+    ck_assert(ps.total_pages() == 0);
+
+    /* spare page is already there, so the freed one is deleted */
+    ck_assert(wait_spare_pages(ps, 1));
+    ck_assert_msg(ps.count() == 2, "ps.count() = %zd, expected 2", ps.count());
+
+    ptr = ps.malloc (page_size / 2);
+    ck_assert(0 != ptr);
+    ps.alloc_stats_get(allocs, spares, avg_ns, max_ns);
+    ck_assert_msg(allocs == 2 && spares == 2, "allocs: %lld, spares: %lld",
+                  allocs, spares);
+
+    ps.alloc_stats_reset();
+    ps.alloc_stats_get(allocs, spares, avg_ns, max_ns);
+    ck_assert(0 == allocs && 0 == spares && 0 == max_ns && 0.0 == avg_ns);
+
+    ps.set_spare_count(0);
+    ck_assert(wait_spare_pages(ps, 0));
+
+    ps_free(ptr); ps.discard(ptr2BH(ptr));
+}
+END_TEST
+
 Suite* gcache_page_suite()
 {
     Suite* s = suite_create("gcache::PageStore");
@@ -124,6 +183,7 @@ Suite* gcache_page_suite()
     tcase_add_test(tc, test1);
     tcase_add_test(tc, test2);
     tcase_add_test(tc, test3);
+    tcase_add_test(tc, test4);
     suite_add_tcase(s, tc);
 
     return s;
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Ring buffer recovery benchmark.
+ *
+ * Fills a synthetic ring buffer file with ordered writesets going around it
+ * more than once, then measures how long it takes to open it with recovery
+ * with cold page cache: after clean shutdown and after a crash (first buffer
+ * offset unknown), with serial scan (1 thread) and with parallel prefetch.
+ *
+ * Usage: gcache_rb_bench [size MB] [writeset size] [threads] [file]
+ */
+
+#define GCACHE_RB_UNIT_TEST
+
+#include "gcache_rb_store.hpp"
+#include "gcache_bh.hpp"
+
+#include <gu_logger.hpp>
+#include <gu_time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace gcache;
+
+namespace
+{
+    struct Params
+    {
+        size_t      size;
+        size_t      ws_size;
+        int         threads;
+        std::string name;
+    };
+
+    void
+    fill(const Params& p)
+    {
+        seqno2ptr_t s2p(SEQNO_NONE);
+        gu::UUID    gid(NULL, 0);
+        RingBuffer  rb(p.name, p.size, s2p, gid, 0, false, 1);
+
+        size_t   filled(0);
+        seqno_t  seqno(0);
+        uint32_t rnd(1);
+
+        while (filled < p.size + p.size / 2)
+        {
+            rnd = rnd * 1103515245 + 12345;
+            /* writeset sizes uniformly distributed in [ws_size/2, 3*ws_size/2)*/
+            MemOps::size_type const size(MemOps::align_size(
+                sizeof(BufferHeader) + p.ws_size / 2 + (rnd >> 8) % p.ws_size));
+
+            void* const ptr(rb.malloc(size));
+            if (!ptr)
+            {
+                std::cerr << "Failed to allocate " << size << " bytes"
+                          << std::endl;
+                ::exit(EXIT_FAILURE);
+            }
+
+            ++seqno;
+            ::memset(ptr, seqno, size - sizeof(BufferHeader));
+            s2p.insert(seqno, ptr);
+
+            BufferHeader* const bh(ptr2BH(ptr));
+            bh->seqno_g = seqno;
+            bh->seqno_d = seqno - 1;
+            BH_release(bh);
+            rb.free(bh);
+
+            filled += size;
+        }
+    }
+
+    /* Flushes the file and drops it from page cache. Crash is simulated by
+     * hiding the first buffer offset in the preamble. */
+    void
+    prepare(const Params& p, bool const crash)
+    {
+        int const fd(::open(p.name.c_str(), O_RDWR));
+        if (fd < 0)
+        {
+            std::cerr << "Failed to open " << p.name << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+
+        std::vector<char> pad(RingBuffer::pad_size());
+        if (::pread(fd, &pad[0], pad.size(), 0) != ssize_t(pad.size()))
+        {
+            std::cerr << "Failed to read " << p.name << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+
+        char* const offset(::strstr(&pad[0], "offset:"));
+        if (crash && offset) *offset = '#';
+
+        if (::pwrite(fd, &pad[0], pad.size(), 0) != ssize_t(pad.size()) ||
+            ::fsync(fd) ||
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED))
+        {
+            std::cerr << "Failed to prepare " << p.name << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+
+        ::close(fd);
+    }
+
+    void
+    run(const Params& p, bool const crash, int const threads)
+    {
+        prepare(p, crash);
+
+        long long const start(gu_time_monotonic());
+        seqno2ptr_t s2p(SEQNO_NONE);
+        gu::UUID    gid;
+        RingBuffer  rb(p.name, p.size, s2p, gid, 0, true, threads);
+        double const duration((gu_time_monotonic() - start) * 1.0e-9);
+
+        std::cout << std::setw(10) << (crash ? "crash" : "clean")
+                  << std::setw(10) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(3)
+                  << duration
+                  << std::setw(12) << s2p.size() << std::endl;
+    }
+
+    void silent_log(int, const char*) {}
+}
+
+int main(int argc, char* argv[])
+{
+    Params p = { size_t(16) << 30, 4096, 0, "rb_bench.cache" };
+
+    if (argc > 1) p.size    = ::strtoull(argv[1], NULL, 10) << 20;
+    if (argc > 2) p.ws_size = ::strtoull(argv[2], NULL, 10);
+    if (argc > 3) p.threads = ::atoi(argv[3]);
+    if (argc > 4) p.name    = argv[4];
+
+    if (p.size == 0 || p.ws_size == 0 || p.ws_size > p.size / 4 ||
+        p.threads < 0)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [size MB] [writeset size] [threads] [file]"
+                  << std::endl;
+        return 1;
+    }
+
+    gu_conf_set_log_callback(silent_log);
+
+    ::unlink(p.name.c_str());
+
+    long long const start(gu_time_monotonic());
+    fill(p);
+
+    std::cout << "Ring buffer: " << (p.size >> 20) << "MB, writeset size: "
+              << p.ws_size << ", filled in "
+              << (gu_time_monotonic() - start) / 1000000 << " ms\n"
+              << std::setw(10) << "shutdown"
+              << std::setw(10) << "threads"
+              << std::setw(12) << "seconds"
+              << std::setw(12) << "writesets" << std::endl;
+
+    for (int crash(0); crash < 2; ++crash)
+    {
+        run(p, crash, 1);
+        run(p, crash, p.threads);
+    }
+
+    ::unlink(p.name.c_str());
+
+    return 0;
+}
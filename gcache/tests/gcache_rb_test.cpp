@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2011-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2011-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -13,6 +13,9 @@
 #include <gu_logger.hpp>
 #include <gu_throw.hpp>
 
+#include <fstream>
+#include <vector>
+
 using namespace gcache;
 
 static gu::UUID    const GID(NULL, 0);
@@ -34,7 +37,7 @@ START_TEST(test1)
 
     seqno2ptr_t s2p(SEQNO_NONE);
     gu::UUID   gid(GID);
-    RingBuffer rb(RB_NAME, rb_size, s2p, gid, 0, false);
+    RingBuffer rb(RB_NAME, rb_size, s2p, gid, 0, false, 0);
 
     ck_assert_msg(rb.size() == rb_size,
                   "Expected %zd, got %zd", rb_size, rb.size());
@@ -158,7 +161,7 @@ START_TEST(recovery)
 
         rb_ctx(size_t s, bool recover = true) :
             size(s), s2p(SEQNO_NONE), gid(GID),
-            rb(RB_NAME, size, s2p, gid, 0, recover)
+            rb(RB_NAME, size, s2p, gid, 0, recover, 0)
         {}
 
         void seqno_assign (seqno2ptr_t& s2p, void* const ptr,
@@ -506,6 +509,105 @@ START_TEST(recovery)
 }
 END_TEST
 
+/* parallel prefetch must not change recovery results */
+START_TEST(recovery_prefetch)
+{
+    ::unlink(RB_NAME.c_str());
+
+    size_t const rb_size(1 << 20);
+
+    {
+        seqno2ptr_t s2p(SEQNO_NONE);
+        gu::UUID    gid(GID);
+        RingBuffer  rb(RB_NAME, rb_size, s2p, gid, 0, false, 4);
+
+        /* go around several times with buffers large enough for the
+         * prefetch not to be skipped */
+        size_t  filled(0);
+        seqno_t seqno(0);
+        while (filled < 3 * rb_size)
+        {
+            ++seqno;
+            size_type const size(ALLOC_SIZE((32 << 10) + seqno % 16 * 1000));
+            void* const ptr(rb.malloc(size));
+            ck_assert(NULL != ptr);
+
+            ::memset(ptr, seqno, size - BH_SIZE);
+            s2p.insert(seqno, ptr);
+
+            BufferHeader* const bh(ptr2BH(ptr));
+            bh->seqno_g = seqno;
+            bh->seqno_d = seqno - 1;
+            BH_release(bh);
+            rb.free(bh);
+
+            filled += size;
+        }
+    }
+
+    std::vector<char> file;
+    {
+        std::ifstream is(RB_NAME.c_str(), std::ios::binary);
+        file.assign(std::istreambuf_iterator<char>(is),
+                    std::istreambuf_iterator<char>());
+    }
+    ck_assert(file.size() > RingBuffer::pad_size());
+
+    /* file format is unchanged: binary header stays unused */
+    for (size_t i(RingBuffer::header_offset()); i < RingBuffer::pad_size();
+         ++i)
+    {
+        ck_assert_msg(0 == file[i], "binary header byte %zu is set", i);
+    }
+
+    for (int crash(0); crash < 2; ++crash)
+    {
+        std::vector<char> copy(file);
+
+        if (crash)
+        {
+            /* forget the first buffer offset */
+            char* const offset(::strstr(&copy[0], "offset:"));
+            ck_assert(NULL != offset);
+            *offset = '#';
+        }
+
+        seqno_t begin[2], end[2];
+
+        for (int prefetch(0); prefetch < 2; ++prefetch)
+        {
+            {
+                std::ofstream os(RB_NAME.c_str(), std::ios::binary);
+                os.write(&copy[0], copy.size());
+            }
+
+            seqno2ptr_t s2p(SEQNO_NONE);
+            gu::UUID    gid(GID);
+            RingBuffer  rb(RB_NAME, rb_size, s2p, gid, 0, true,
+                           prefetch ? 4 : 1);
+
+            ck_assert(!s2p.empty());
+            begin[prefetch] = s2p.index_begin();
+            end[prefetch]   = s2p.index_end();
+
+            for (seqno2ptr_t::iterator i(s2p.begin()); i != s2p.end(); ++i)
+            {
+                const uint8_t* const ptr(static_cast<const uint8_t*>(*i));
+                ck_assert(ptr[0] == uint8_t(s2p.index(i)));
+            }
+        }
+
+        ck_assert_msg(begin[1] == begin[0] && end[1] == end[0],
+                      "crash %d: recovered [%lld, %lld), expected "
+                      "[%lld, %lld)", crash,
+                      (long long)begin[1], (long long)end[1],
+                      (long long)begin[0], (long long)end[0]);
+    }
+
+    ::unlink(RB_NAME.c_str());
+}
+END_TEST
+
 
 Suite* gcache_rb_suite()
 {
@@ -520,6 +622,7 @@ Suite* gcache_rb_suite()
 
     tcase_set_timeout(tc, 60);
     tcase_add_test(tc, recovery);
+    tcase_add_test(tc, recovery_prefetch);
     suite_add_tcase(ts, tc);
 
     return ts;
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 
@@ -25,13 +25,22 @@ gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
     gcomm::Protonet(conf, "asio", version),
     mutex_(),
     poll_until_(gu::datetime::Date::max()),
+    io_threads_service_(),
     io_service_(),
+    deliver_strand_(io_service_),
     timer_(io_service_),
     ssl_context_(io_service_, asio::ssl::context::sslv23),
     mtu_(1 << 15),
     checksum_(NetHeader::checksum_type(
                   conf.get<int>(gcomm::Conf::SocketChecksum,
-                                NetHeader::CS_CRC32C)))
+                                NetHeader::CS_CRC32C))),
+    io_threads_work_(0),
+    io_threads_(),
+    io_pending_max_(check_range(gcomm::Conf::SocketIoPendingMax,
+                                conf.get<size_t>(
+                                    gcomm::Conf::SocketIoPendingMax,
+                                    size_t(1) << 22),
+                                size_t(1) << 16, size_t(1) << 32))
 {
     conf.set(gcomm::Conf::SocketChecksum, checksum_);
     // use ssl if either private key or cert file is specified
@@ -50,11 +59,90 @@ gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
         log_info << "initializing ssl context";
         gu::ssl_prepare_context(conf_, ssl_context_);
     }
+
+    int const io_threads(check_range(gcomm::Conf::SocketIoThreads,
+                                     conf.get<int>(gcomm::Conf::SocketIoThreads,
+                                                   0),
+                                     0, 1024));
+    conf.set(gcomm::Conf::SocketIoThreads, io_threads);
+    start_io_threads(io_threads);
 }
 
 gcomm::AsioProtonet::~AsioProtonet()
 {
+    stop_io_threads();
+}
+
+// Socket I/O threads do the part of gcomm connection thread work that used
+// to run in it (socket reads and writes), so they are instrumented with the
+// same tag: wsrep API provides no separate one and does not allow adding it.
+extern "C" void* io_thread_run(void* arg)
+{
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_INIT,
+                       WSREP_PFS_INSTR_TAG_GCOMMCONN_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    asio::io_service& io_service(*static_cast<asio::io_service*>(arg));
+
+    while (true)
+    {
+        try
+        {
+            io_service.run();
+            break;
+        }
+        catch (std::exception& e)
+        {
+            log_error << "socket I/O thread: " << e.what();
+        }
+    }
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_GCOMMCONN_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
 
+    return NULL;
+}
+
+void gcomm::AsioProtonet::start_io_threads(int const n)
+{
+    if (n == 0) return;
+
+    io_threads_work_ = new asio::io_service::work(io_threads_service_);
+
+    for (int i(0); i < n; ++i)
+    {
+        gu_thread_t thd;
+        int const err(gu_thread_create(&thd, NULL, io_thread_run,
+                                       &io_threads_service_));
+        if (err != 0)
+        {
+            stop_io_threads();
+            gu_throw_error(err) << "Failed to create socket I/O thread";
+        }
+        io_threads_.push_back(thd);
+    }
+
+    log_info << "started " << n << " socket I/O threads";
+}
+
+void gcomm::AsioProtonet::stop_io_threads()
+{
+    delete io_threads_work_;
+    io_threads_work_ = 0;
+    io_threads_service_.stop();
+
+    for (size_t i(0); i < io_threads_.size(); ++i)
+    {
+        gu_thread_join(io_threads_[i], NULL);
+    }
+    io_threads_.clear();
 }
 
 void gcomm::AsioProtonet::enter()
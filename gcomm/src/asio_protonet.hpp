@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef GCOMM_ASIO_PROTONET_HPP
@@ -10,6 +10,7 @@
 
 #include "gu_monitor.hpp"
 #include "gu_asio.hpp"
+#include "gu_threads.h"
 
 #include <vector>
 #include <deque>
@@ -44,18 +45,38 @@ private:
     friend class AsioTcpSocket;
     friend class AsioTcpAcceptor;
     friend class AsioUdpSocket;
+    friend class AsioDeliverHandler;
     AsioProtonet(const AsioProtonet&);
+    void operator=(const AsioProtonet&);
 
     void handle_wait(const asio::error_code& ec);
 
+    // I/O service for TCP sockets
+    asio::io_service& socket_io_service()
+    {
+        return (io_threads_.empty() ? io_service_ : io_threads_service_);
+    }
+
+    void start_io_threads(int n);
+    void stop_io_threads();
+
     gu::RecursiveMutex          mutex_;
     gu::datetime::Date          poll_until_;
+    // Must outlive io_service_: handlers queued in io_service_ may hold
+    // last references to sockets created on this service.
+    asio::io_service            io_threads_service_;
     asio::io_service            io_service_;
+    // Hands messages read by I/O threads over to protonet thread in order
+    asio::io_service::strand    deliver_strand_;
     asio::deadline_timer        timer_;
     asio::ssl::context          ssl_context_;
     size_t                      mtu_;
 
     NetHeader::checksum_t       checksum_;
+
+    asio::io_service::work*     io_threads_work_;
+    std::vector<gu_thread_t>    io_threads_;
+    size_t                      io_pending_max_;
 };
 
 #endif // GCOMM_ASIO_PROTONET_HPP
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2012-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2012-2026 Codership Oy <info@codership.com>
  */
 
 #include "asio_tcp.hpp"
@@ -67,12 +67,24 @@ gcomm::AsioTcpSocket::AsioTcpSocket(AsioProtonet& net, const gu::URI& uri)
     :
     Socket       (uri),
     net_         (net),
-    socket_      (net.io_service_),
+    socket_      (net.socket_io_service()),
     ssl_socket_  (0),
     send_q_      (),
+    write_bufs_  (),
+    write_segments_(),
+    ssl_write_buf_(),
+    write_bytes_ (0),
+    write_calls_ (0),
+    send_datagrams_(0),
+    send_writes_ (0),
+    send_syscalls_(0),
     last_queued_tstamp_(),
     recv_buf_    (net_.mtu() + NetHeader::serial_size_),
     recv_offset_ (0),
+    strand_      (net.io_threads_.empty() ? 0 :
+                  new asio::io_service::strand(net.io_threads_service_)),
+    recv_pending_(0),
+    recv_paused_ (false),
     last_delivered_tstamp_(),
     state_       (S_CLOSED),
     local_addr_  (),
@@ -87,6 +99,7 @@ gcomm::AsioTcpSocket::~AsioTcpSocket()
     close_socket();
     delete ssl_socket_;
     ssl_socket_ = 0;
+    delete strand_;
 }
 
 void gcomm::AsioTcpSocket::failed_handler(const asio::error_code& ec,
@@ -119,6 +132,8 @@ void gcomm::AsioTcpSocket::failed_handler(const asio::error_code& ec,
 
 void gcomm::AsioTcpSocket::handshake_handler(const asio::error_code& ec)
 {
+    Critical<AsioProtonet> crit(net_);
+
     if (ec)
     {
         if (ec.category() == asio::error::get_ssl_category() &&
@@ -179,12 +194,25 @@ void gcomm::AsioTcpSocket::connect_handler(const asio::error_code& ec)
                 log_debug << "socket " << id() << " connected, remote endpoint "
                           << remote_addr() << " local endpoint "
                           << local_addr();
-                ssl_socket_->async_handshake(
-                    asio::ssl::stream<asio::ip::tcp::socket>::client,
-                    boost::bind(&AsioTcpSocket::handshake_handler,
-                                shared_from_this(),
-                                asio::placeholders::error)
-                    );
+                if (strand_ != 0)
+                {
+                    ssl_socket_->async_handshake(
+                        asio::ssl::stream<asio::ip::tcp::socket>::client,
+                        strand_->wrap(
+                            boost::bind(&AsioTcpSocket::handshake_handler,
+                                        shared_from_this(),
+                                        asio::placeholders::error))
+                        );
+                }
+                else
+                {
+                    ssl_socket_->async_handshake(
+                        asio::ssl::stream<asio::ip::tcp::socket>::client,
+                        boost::bind(&AsioTcpSocket::handshake_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error)
+                        );
+                }
             }
             else
             {
@@ -223,16 +251,28 @@ void gcomm::AsioTcpSocket::connect(const gu::URI& uri)
         if (uri.get_scheme() == gu::scheme::ssl)
         {
             ssl_socket_ = new asio::ssl::stream<asio::ip::tcp::socket>(
-                net_.io_service_, net_.ssl_context_
+                net_.socket_io_service(), net_.ssl_context_
             );
 
             ssl_socket_->lowest_layer().open(i->endpoint().protocol());
             set_buf_sizes(); // Must be done before connect
-            ssl_socket_->lowest_layer().async_connect(
-                *i, boost::bind(&AsioTcpSocket::connect_handler,
-                                shared_from_this(),
-                                asio::placeholders::error)
-            );
+            if (strand_ != 0)
+            {
+                ssl_socket_->lowest_layer().async_connect(
+                    *i, strand_->wrap(
+                        boost::bind(&AsioTcpSocket::connect_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error))
+                );
+            }
+            else
+            {
+                ssl_socket_->lowest_layer().async_connect(
+                    *i, boost::bind(&AsioTcpSocket::connect_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error)
+                );
+            }
         }
         else
         {
@@ -245,9 +285,21 @@ void gcomm::AsioTcpSocket::connect(const gu::URI& uri)
                 socket_.bind(ep);
             }
             set_buf_sizes(); // Must be done before connect
-            socket_.async_connect(*i, boost::bind(&AsioTcpSocket::connect_handler,
-                                                  shared_from_this(),
-                                                  asio::placeholders::error));
+            if (strand_ != 0)
+            {
+                socket_.async_connect(
+                    *i, strand_->wrap(
+                        boost::bind(&AsioTcpSocket::connect_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error)));
+            }
+            else
+            {
+                socket_.async_connect(
+                    *i, boost::bind(&AsioTcpSocket::connect_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error));
+            }
         }
         state_ = S_CONNECTING;
     }
@@ -273,7 +325,16 @@ void gcomm::AsioTcpSocket::close()
 
     if (send_q_.empty() == true || state() != S_CONNECTED)
     {
-        close_socket();
+        if (strand_ != 0)
+        {
+            // socket may be in use by I/O thread
+            strand_->post(boost::bind(&AsioTcpSocket::close_socket,
+                                      shared_from_this()));
+        }
+        else
+        {
+            close_socket();
+        }
         state_ = S_CLOSED;
     }
     else
@@ -296,6 +357,9 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
 
     Critical<AsioProtonet> crit(net_);
 
+    send_syscalls_ += write_calls_;
+    write_calls_ = 0;
+
     if (state() != S_CONNECTED && state() != S_CLOSING)
     {
         log_debug << "write handler for " << id()
@@ -324,7 +388,7 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
             FAILED_HANDLER(asio::error_code(EPROTO,
                                             asio::error::system_category));
         }
-        else if (send_q_.front().len() < bytes_transferred
+        else if (write_bytes_ != bytes_transferred
 #ifdef GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
                  || ::rand() % bytes_transferred_less_than_rate == 0
 #endif // GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
@@ -332,21 +396,21 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
         {
             log_warn << "write_handler() bytes_transferred "
                      << bytes_transferred
-                     << " less than sent "
-                     << send_q_.front().len()
+                     << " differs from sent "
+                     << write_bytes_
                      << ". Transport may not be reliable, closing the socket";
             FAILED_HANDLER(asio::error_code(EPROTO,
                                             asio::error::system_category));
         }
         else
         {
-            while (send_q_.empty() == false &&
-                   bytes_transferred >= send_q_.front().len())
+            // Datagrams pushed during the write may have changed the
+            // round robin order, so pop the ones which were written.
+            for (size_t i(0); i < write_segments_.size(); ++i)
             {
-                const Datagram& dg(send_q_.front());
-                bytes_transferred -= dg.len();
-                send_q_.pop_front();
+                bytes_transferred -= send_q_.pop_front(write_segments_[i]);
             }
+            write_segments_.clear();
             if (bytes_transferred != 0
 #ifdef GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
                 || ::rand() % bytes_transferred_not_zero_rate == 0
@@ -362,14 +426,7 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
             }
             else if (send_q_.empty() == false)
             {
-                const Datagram& dg(send_q_.front());
-                gu::array<asio::const_buffer, 2>::type cbs;
-                cbs[0] = asio::const_buffer(dg.header()
-                                            + dg.header_offset(),
-                                            dg.header_len());
-                cbs[1] = asio::const_buffer(dg.payload().data(),
-                                            dg.payload().size());
-                write_one(cbs);
+                write_queued();
             }
             else if (state_ == S_CLOSING)
             {
@@ -423,14 +480,7 @@ namespace gcomm
                  socket_->state() == gcomm::Socket::S_CLOSING) &&
                 socket_->send_q_.empty() == false)
             {
-                const gcomm::Datagram& dg(socket_->send_q_.front());
-                gu::array<asio::const_buffer, 2>::type cbs;
-                cbs[0] = asio::const_buffer(dg.header()
-                                            + dg.header_offset(),
-                                            dg.header_len());
-                cbs[1] = asio::const_buffer(dg.payload().data(),
-                                            dg.payload().size());
-                socket_->write_one(cbs);
+                socket_->write_queued();
             }
         }
     private:
@@ -471,7 +521,14 @@ int gcomm::AsioTcpSocket::send(int segment, const Datagram& dg)
     send_q_.push_back(segment, priv_dg);
     if (send_q_.size() == 1)
     {
-        net_.io_service_.post(AsioPostForSendHandler(shared_from_this()));
+        if (strand_ != 0)
+        {
+            strand_->post(AsioPostForSendHandler(shared_from_this()));
+        }
+        else
+        {
+            net_.io_service_.post(AsioPostForSendHandler(shared_from_this()));
+        }
     }
     return 0;
 }
@@ -571,10 +628,228 @@ void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
     read_one(mbs);
 }
 
+namespace gcomm
+{
+    class AsioDeliverHandler
+    {
+    public:
+        AsioDeliverHandler(const AsioTcpSocketPtr& socket,
+                           const gu::shared_ptr<std::vector<Datagram> >::type&
+                           dgs,
+                           size_t bytes,
+                           const asio::error_code& ec)
+            :
+            socket_(socket),
+            dgs_   (dgs),
+            bytes_ (bytes),
+            ec_    (ec)
+        { }
+        void operator()()
+        {
+            Critical<AsioProtonet> crit(socket_->net_);
+            socket_->deliver(*dgs_, bytes_, ec_);
+        }
+    private:
+        AsioTcpSocketPtr                                socket_;
+        gu::shared_ptr<std::vector<Datagram> >::type    dgs_;
+        size_t                                          bytes_;
+        asio::error_code                                ec_;
+    };
+}
+
+// Read handler for socket I/O run by I/O threads. Messages are
+// unserialized and checksums verified outside of protonet critical
+// section, protonet thread only dispatches them, see deliver().
+void gcomm::AsioTcpSocket::strand_read_handler(
+    const asio::error_code& ec,
+    const size_t bytes_transferred)
+{
+    {
+        Critical<AsioProtonet> crit(net_);
+
+        if (ec)
+        {
+#ifdef HAVE_ASIO_SSL_HPP
+            if (ec.category() == asio::error::get_ssl_category() &&
+                gu::exclude_ssl_error(ec) == false)
+            {
+                log_warn << "read_handler(): " << ec.message() << " ("
+                         << gu::extra_error_info(ec) << ")";
+            }
+#endif
+            // messages read before the error may still wait for dispatch,
+            // so the error is reported through the same strand after them
+            net_.deliver_strand_.post(
+                AsioDeliverHandler(shared_from_this(),
+                                   gu::shared_ptr<std::vector<Datagram> >::type(
+                                       new std::vector<Datagram>()),
+                                   0, ec));
+            return;
+        }
+
+        if (state() != S_CONNECTED && state() != S_CLOSING)
+        {
+            log_debug << "read handler for " << id()
+                      << " state " << state();
+            return;
+        }
+    }
+
+    recv_offset_ += bytes_transferred;
+
+    gu::shared_ptr<std::vector<Datagram> >::type dgs(
+        new std::vector<Datagram>());
+    size_t bytes(0);
+    asio::error_code err;
+
+    while (recv_offset_ >= NetHeader::serial_size_)
+    {
+        NetHeader hdr;
+        try
+        {
+            unserialize(&recv_buf_[0], recv_buf_.size(), 0, hdr);
+        }
+        catch (gu::Exception& e)
+        {
+            err = asio::error_code(e.get_errno(), asio::error::system_category);
+            break;
+        }
+        if (recv_offset_ >= hdr.len() + NetHeader::serial_size_)
+        {
+            Datagram dg(
+                gu::SharedBuffer(
+                    new gu::Buffer(&recv_buf_[0] + NetHeader::serial_size_,
+                                   &recv_buf_[0] + NetHeader::serial_size_
+                                   + hdr.len())));
+            if (net_.checksum_ != NetHeader::CS_NONE && check_cs(hdr, dg))
+            {
+                log_warn << "checksum failed, hdr: len=" << hdr.len()
+                         << " has_crc32="  << hdr.has_crc32()
+                         << " has_crc32c=" << hdr.has_crc32c()
+                         << " crc32=" << hdr.crc32();
+                err = asio::error_code(EPROTO, asio::error::system_category);
+                break;
+            }
+            dgs->push_back(dg);
+            bytes += hdr.len();
+            recv_offset_ -= NetHeader::serial_size_ + hdr.len();
+
+            if (recv_offset_ > 0)
+            {
+                memmove(&recv_buf_[0],
+                        &recv_buf_[0] + NetHeader::serial_size_ + hdr.len(),
+                        recv_offset_);
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    Critical<AsioProtonet> crit(net_);
+
+    if (dgs->empty() == false || err)
+    {
+        // errors are reported after messages received before them
+        recv_pending_ += bytes;
+        net_.deliver_strand_.post(
+            AsioDeliverHandler(shared_from_this(), dgs, bytes, err));
+        if (err) return;
+    }
+
+    if (recv_pending_ > net_.io_pending_max_)
+    {
+        log_debug << "pausing read for " << id() << ", pending "
+                  << recv_pending_;
+        recv_paused_ = true;
+        return;
+    }
+
+    read_next();
+}
+
+// Starts reading into recv_buf_ after already received recv_offset_
+// bytes. Must be called in socket strand.
+void gcomm::AsioTcpSocket::read_next()
+{
+    Critical<AsioProtonet> crit(net_);
+
+    if (state() != S_CONNECTED && state() != S_CLOSING)
+    {
+        log_debug << "read next for " << id() << " state " << state();
+        return;
+    }
+
+    gu::array<asio::mutable_buffer, 1>::type mbs;
+    mbs[0] = asio::mutable_buffer(&recv_buf_[0] + recv_offset_,
+                                  recv_buf_.size() - recv_offset_);
+    read_one(mbs);
+}
+
+void gcomm::AsioTcpSocket::deliver(const std::vector<Datagram>& dgs,
+                                   size_t const bytes,
+                                   const asio::error_code& ec)
+{
+    assert(recv_pending_ >= bytes);
+    recv_pending_ -= bytes;
+
+    if (state() != S_CONNECTED && state() != S_CLOSING)
+    {
+        log_debug << "deliver for " << id() << " state " << state();
+        return;
+    }
+
+    for (std::vector<Datagram>::const_iterator i(dgs.begin());
+         i != dgs.end(); ++i)
+    {
+        ProtoUpMeta um;
+        last_delivered_tstamp_ = gu::datetime::Date::monotonic();
+        net_.dispatch(id(), *i, um);
+    }
+
+    if (ec)
+    {
+        FAILED_HANDLER(ec);
+    }
+    else if (recv_paused_ == true && recv_pending_ <= net_.io_pending_max_/2)
+    {
+        log_debug << "resuming read for " << id();
+        recv_paused_ = false;
+        strand_->post(boost::bind(&AsioTcpSocket::read_next,
+                                  shared_from_this()));
+    }
+}
+
 size_t gcomm::AsioTcpSocket::read_completion_condition(
     const asio::error_code& ec,
     const size_t bytes_transferred)
 {
+    if (strand_ != 0)
+    {
+        // Called by I/O thread without protonet lock. Socket state,
+        // header and read errors are handled by strand_read_handler().
+        if (ec) return 0;
+        if (recv_offset_ + bytes_transferred >= NetHeader::serial_size_)
+        {
+            NetHeader hdr;
+            try
+            {
+                unserialize(&recv_buf_[0], NetHeader::serial_size_, 0, hdr);
+            }
+            catch (gu::Exception&)
+            {
+                return 0;
+            }
+            if (recv_offset_ + bytes_transferred >=
+                NetHeader::serial_size_ + hdr.len())
+            {
+                return 0;
+            }
+        }
+        return (recv_buf_.size() - recv_offset_);
+    }
+
     Critical<AsioProtonet> crit(net_);
     if (ec)
     {
@@ -627,6 +902,13 @@ void gcomm::AsioTcpSocket::async_receive()
 
     gcomm_assert(state() == S_CONNECTED);
 
+    if (strand_ != 0)
+    {
+        strand_->dispatch(boost::bind(&AsioTcpSocket::read_next,
+                                      shared_from_this()));
+        return;
+    }
+
     gu::array<asio::mutable_buffer, 1>::type mbs;
 
     mbs[0] = asio::mutable_buffer(&recv_buf_[0], recv_buf_.size());
@@ -663,24 +945,27 @@ void gcomm::AsioTcpSocket::set_buf_sizes()
     set_send_buf_size_helper(net_.conf(), socket());
 }
 
+template <class Stream>
 void gcomm::AsioTcpSocket::read_one(
+    Stream& stream,
     gu::array<asio::mutable_buffer, 1>::type& mbs)
 {
-    if (ssl_socket_ != 0)
+    if (strand_ != 0)
     {
-        async_read(*ssl_socket_, mbs,
+        async_read(stream, mbs,
                    boost::bind(&AsioTcpSocket::read_completion_condition,
                                shared_from_this(),
                                asio::placeholders::error,
                                asio::placeholders::bytes_transferred),
-                   boost::bind(&AsioTcpSocket::read_handler,
-                               shared_from_this(),
-                               asio::placeholders::error,
-                               asio::placeholders::bytes_transferred));
+                   strand_->wrap(
+                       boost::bind(&AsioTcpSocket::strand_read_handler,
+                                   shared_from_this(),
+                                   asio::placeholders::error,
+                                   asio::placeholders::bytes_transferred)));
     }
     else
     {
-        async_read(socket_, mbs,
+        async_read(stream, mbs,
                    boost::bind(&AsioTcpSocket::read_completion_condition,
                                shared_from_this(),
                                asio::placeholders::error,
@@ -692,21 +977,45 @@ void gcomm::AsioTcpSocket::read_one(
     }
 }
 
+void gcomm::AsioTcpSocket::read_one(
+    gu::array<asio::mutable_buffer, 1>::type& mbs)
+{
+    if (ssl_socket_ != 0)
+    {
+        read_one(*ssl_socket_, mbs);
+    }
+    else
+    {
+        read_one(socket_, mbs);
+    }
+}
+
 
+template <class Stream>
 void gcomm::AsioTcpSocket::write_one(
-    const gu::array<asio::const_buffer, 2>::type& cbs)
+    Stream& stream,
+    const std::vector<asio::const_buffer>& cbs)
 {
-    if (ssl_socket_ != 0)
+    if (strand_ != 0)
     {
-        async_write(*ssl_socket_, cbs,
-                    boost::bind(&AsioTcpSocket::write_handler,
+        async_write(stream, cbs,
+                    boost::bind(&AsioTcpSocket::write_completion_condition,
                                 shared_from_this(),
                                 asio::placeholders::error,
-                                asio::placeholders::bytes_transferred));
+                                asio::placeholders::bytes_transferred),
+                    strand_->wrap(
+                        boost::bind(&AsioTcpSocket::write_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error,
+                                    asio::placeholders::bytes_transferred)));
     }
     else
     {
-        async_write(socket_, cbs,
+        async_write(stream, cbs,
+                    boost::bind(&AsioTcpSocket::write_completion_condition,
+                                shared_from_this(),
+                                asio::placeholders::error,
+                                asio::placeholders::bytes_transferred),
                     boost::bind(&AsioTcpSocket::write_handler,
                                 shared_from_this(),
                                 asio::placeholders::error,
@@ -714,6 +1023,83 @@ void gcomm::AsioTcpSocket::write_one(
     }
 }
 
+void gcomm::AsioTcpSocket::write_one(
+    const std::vector<asio::const_buffer>& cbs)
+{
+    if (ssl_socket_ != 0)
+    {
+        write_one(*ssl_socket_, cbs);
+    }
+    else
+    {
+        write_one(socket_, cbs);
+    }
+}
+
+
+size_t gcomm::AsioTcpSocket::write_completion_condition(
+    const asio::error_code& ec,
+    const size_t bytes_transferred)
+{
+    // Called once before the first write and then after each write
+    if (ec || bytes_transferred > 0) ++write_calls_;
+
+    if (ec || bytes_transferred >= write_bytes_) return 0;
+
+    return (write_bytes_ - bytes_transferred);
+}
+
+// Writes datagrams from the front of send_q_ in a single batch.
+// Datagrams are popped from send_q_ in write_handler().
+void gcomm::AsioTcpSocket::write_queued()
+{
+    std::vector<const Datagram*> dgs;
+    write_segments_.clear();
+    write_bytes_ = send_q_.front(dgs, write_segments_,
+                                 max_write_batch_datagrams,
+                                 max_write_batch_bytes);
+    assert(dgs.empty() == false);
+
+    write_bufs_.clear();
+
+    if (ssl_socket_ != 0)
+    {
+        ssl_write_buf_.resize(write_bytes_);
+        gu::byte_t* ptr(&ssl_write_buf_[0]);
+        for (size_t i(0); i < dgs.size(); ++i)
+        {
+            const Datagram& dg(*dgs[i]);
+            ptr = std::copy(dg.header() + dg.header_offset(),
+                            dg.header() + dg.header_size(), ptr);
+            ptr = std::copy(dg.payload_data(),
+                            dg.payload_data() + dg.payload_size(), ptr);
+        }
+        assert(ptr == &ssl_write_buf_[0] + write_bytes_);
+        write_bufs_.push_back(asio::const_buffer(&ssl_write_buf_[0],
+                                                 write_bytes_));
+    }
+    else
+    {
+        for (size_t i(0); i < dgs.size(); ++i)
+        {
+            const Datagram& dg(*dgs[i]);
+            write_bufs_.push_back(
+                asio::const_buffer(dg.header() + dg.header_offset(),
+                                   dg.header_len()));
+            if (dg.payload_size() > 0)
+            {
+                write_bufs_.push_back(
+                    asio::const_buffer(dg.payload_data(),
+                                       dg.payload_size()));
+            }
+        }
+    }
+
+    ++send_writes_;
+    send_datagrams_ += dgs.size();
+    write_one(write_bufs_);
+}
+
 
 void gcomm::AsioTcpSocket::close_socket()
 {
@@ -812,6 +1198,9 @@ gcomm::SocketStats gcomm::AsioTcpSocket::stats() const
         ret.send_queue_length = send_q_.size();
         ret.send_queue_bytes = send_q_.queued_bytes();
         ret.send_queue_segments = send_q_.segments();
+        ret.send_datagrams = send_datagrams_;
+        ret.send_writes = send_writes_;
+        ret.send_syscalls = send_syscalls_;
     }
 #endif /* __linux__ || __FreeBSD__ */
     return ret;
@@ -839,6 +1228,7 @@ void gcomm::AsioTcpAcceptor::accept_handler(
 {
     if (!error)
     {
+        Critical<AsioProtonet> crit(net_);
         AsioTcpSocket* s(static_cast<AsioTcpSocket*>(socket.get()));
         try
         {
@@ -851,11 +1241,23 @@ void gcomm::AsioTcpAcceptor::accept_handler(
                           << s->id() << " connected, remote endpoint "
                           << s->remote_addr() << " local endpoint "
                           << s->local_addr();
-                s->ssl_socket_->async_handshake(
-                    asio::ssl::stream<asio::ip::tcp::socket>::server,
-                    boost::bind(&AsioTcpSocket::handshake_handler,
-                                s->shared_from_this(),
-                                asio::placeholders::error));
+                if (s->strand_ != 0)
+                {
+                    s->ssl_socket_->async_handshake(
+                        asio::ssl::stream<asio::ip::tcp::socket>::server,
+                        s->strand_->wrap(
+                            boost::bind(&AsioTcpSocket::handshake_handler,
+                                        s->shared_from_this(),
+                                        asio::placeholders::error)));
+                }
+                else
+                {
+                    s->ssl_socket_->async_handshake(
+                        asio::ssl::stream<asio::ip::tcp::socket>::server,
+                        boost::bind(&AsioTcpSocket::handshake_handler,
+                                    s->shared_from_this(),
+                                    asio::placeholders::error));
+                }
                 s->state_ = Socket::S_CONNECTING;
             }
             else
@@ -877,7 +1279,7 @@ void gcomm::AsioTcpAcceptor::accept_handler(
         {
             new_socket->ssl_socket_ =
                 new asio::ssl::stream<asio::ip::tcp::socket>(
-                    net_.io_service_, net_.ssl_context_);
+                    net_.socket_io_service(), net_.ssl_context_);
         }
         acceptor_.async_accept(new_socket->socket(),
                                boost::bind(&AsioTcpAcceptor::accept_handler,
@@ -920,7 +1322,7 @@ void gcomm::AsioTcpAcceptor::listen(const gu::URI& uri)
         {
             new_socket->ssl_socket_ =
                 new asio::ssl::stream<asio::ip::tcp::socket>(
-                    net_.io_service_, net_.ssl_context_);
+                    net_.socket_io_service(), net_.ssl_context_);
         }
         acceptor_.async_accept(new_socket->socket(),
                                boost::bind(&AsioTcpAcceptor::accept_handler,
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef GCOMM_ASIO_TCP_HPP
@@ -39,6 +39,7 @@ namespace gcomm
     class AsioTcpSocket;
     class AsioTcpAcceptor;
     class AsioPostForSendHandler;
+    class AsioDeliverHandler;
 }
 
 // TCP Socket implementation
@@ -55,6 +56,8 @@ public:
     void connect_handler(const asio::error_code& ec);
     void connect(const gu::URI& uri);
     void close();
+    size_t write_completion_condition(const asio::error_code& ec,
+                                      size_t bytes_transferred);
     void write_handler(const asio::error_code& ec,
                        size_t bytes_transferred);
     void set_option(const std::string& key, const std::string& val);
@@ -64,6 +67,8 @@ public:
         const size_t bytes_transferred);
     void read_handler(const asio::error_code& ec,
                       const size_t bytes_transferred);
+    void strand_read_handler(const asio::error_code& ec,
+                             const size_t bytes_transferred);
     void async_receive();
     size_t mtu() const;
     std::string local_addr() const;
@@ -74,6 +79,7 @@ public:
 private:
     friend class gcomm::AsioTcpAcceptor;
     friend class gcomm::AsioPostForSendHandler;
+    friend class gcomm::AsioDeliverHandler;
 
     AsioTcpSocket(const AsioTcpSocket&);
     void operator=(const AsioTcpSocket&);
@@ -86,7 +92,17 @@ private:
         last_queued_tstamp_ = last_delivered_tstamp_ = now;
     }
     void read_one(gu::array<asio::mutable_buffer, 1>::type& mbs);
-    void write_one(const gu::array<asio::const_buffer, 2>::type& cbs);
+    template <class Stream>
+    void read_one(Stream& stream,
+                  gu::array<asio::mutable_buffer, 1>::type& mbs);
+    void read_next();
+    void write_queued();
+    void write_one(const std::vector<asio::const_buffer>& cbs);
+    template <class Stream>
+    void write_one(Stream& stream,
+                   const std::vector<asio::const_buffer>& cbs);
+    void deliver(const std::vector<Datagram>& dgs, size_t bytes,
+                 const asio::error_code& ec);
     void close_socket();
 
     // call to assign local/remote addresses at the point where it
@@ -111,9 +127,34 @@ private:
     // datagrams with default gcomm MTU 32kB.
     static const size_t                       max_send_q_bytes = (1 << 25);
     gcomm::FairSendQueue                      send_q_;
+    // Limits for datagrams coalesced into single write. The count limit
+    // keeps header and payload buffers of a batch within a single
+    // writev() call (asio passes at most 64 buffers to it).
+    static const size_t                       max_write_batch_datagrams = 32;
+    static const size_t                       max_write_batch_bytes = (1 << 16);
+    std::vector<asio::const_buffer>           write_bufs_;
+    // Segments of the datagrams in the batch being written, in the order
+    // they are written, to pop exactly those once the write completes.
+    std::vector<int>                          write_segments_;
+    // Batch is copied into contiguous buffer for SSL to have it
+    // encrypted in as few records as possible.
+    std::vector<gu::byte_t>                   ssl_write_buf_;
+    size_t                                    write_bytes_;
+    size_t                                    write_calls_;
+    long                                      send_datagrams_;
+    long                                      send_writes_;
+    long                                      send_syscalls_;
     gu::datetime::Date                        last_queued_tstamp_;
     std::vector<gu::byte_t>                   recv_buf_;
     size_t                                    recv_offset_;
+    // Serializes socket handlers when socket I/O is run by protonet
+    // I/O threads, 0 when it is run by protonet thread.
+    asio::io_service::strand*                 strand_;
+    // Bytes read by I/O threads but not yet delivered by protonet thread.
+    // Reading is paused when socket.io_pending_max is exceeded and resumed
+    // when protonet thread catches up.
+    size_t                                    recv_pending_;
+    bool                                      recv_paused_;
     gu::datetime::Date                        last_delivered_tstamp_;
     State                                     state_;
     // Querying addresses from failed socket does not work,
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2017 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #include "asio_udp.hpp"
@@ -147,7 +147,7 @@ int gcomm::AsioUdpSocket::send(int /* segment */, const Datagram& dg)
     cbs[0] = asio::const_buffer(buf, sizeof(buf));
     cbs[1] = asio::const_buffer(dg.header() + dg.header_offset(),
                           dg.header_len());
-    cbs[2] = asio::const_buffer(dg.payload().data(), dg.payload().size());
+    cbs[2] = asio::const_buffer(dg.payload_data(), dg.payload_size());
     try
     {
         socket_.send_to(cbs, target_ep_);
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "gcomm/conf.hpp"
@@ -24,6 +24,10 @@ std::string const gcomm::Conf::SocketRecvBufSize =
     SocketPrefix + "recv_buf_size";
 std::string const gcomm::Conf::SocketSendBufSize =
     SocketPrefix + "send_buf_size";
+std::string const gcomm::Conf::SocketIoThreads =
+    SocketPrefix + "io_threads";
+std::string const gcomm::Conf::SocketIoPendingMax =
+    SocketPrefix + "io_pending_max";
 
 // GMCast
 std::string const gcomm::Conf::GMCastScheme = "gmcast";
@@ -82,6 +86,8 @@ std::string const gcomm::Conf::EvsSendWindow =
     EvsPrefix + "send_window";
 std::string const gcomm::Conf::EvsUserSendWindow =
     EvsPrefix + "user_send_window";
+std::string const gcomm::Conf::EvsAdaptiveSendWindow =
+    EvsPrefix + "adaptive_send_window";
 std::string const gcomm::Conf::EvsUseAggregate =
     EvsPrefix + "use_aggregate";
 std::string const gcomm::Conf::EvsCausalKeepalivePeriod =
@@ -133,6 +139,8 @@ gcomm::Conf::register_params(gu::Config& cnf)
     GCOMM_CONF_ADD_DEFAULT(SocketChecksum);
     GCOMM_CONF_ADD_DEFAULT(SocketRecvBufSize);
     GCOMM_CONF_ADD_DEFAULT(SocketSendBufSize);
+    GCOMM_CONF_ADD_DEFAULT(SocketIoThreads);
+    GCOMM_CONF_ADD_DEFAULT(SocketIoPendingMax);
 
     GCOMM_CONF_ADD_DEFAULT(GMCastVersion);
     GCOMM_CONF_ADD        (GMCastGroup);
@@ -161,6 +169,7 @@ gcomm::Conf::register_params(gu::Config& cnf)
     GCOMM_CONF_ADD        (EvsInfoLogMask);
     GCOMM_CONF_ADD_DEFAULT(EvsSendWindow);
     GCOMM_CONF_ADD_DEFAULT(EvsUserSendWindow);
+    GCOMM_CONF_ADD_DEFAULT(EvsAdaptiveSendWindow);
     GCOMM_CONF_ADD        (EvsUseAggregate);
     GCOMM_CONF_ADD        (EvsCausalKeepalivePeriod);
     GCOMM_CONF_ADD_DEFAULT(EvsMaxInstallTimeouts);
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2013 Codership Oy <info@codership.com>
+ * Copyright (C) 2013-2026 Codership Oy <info@codership.com>
  */
 
 #include "gcomm/datagram.hpp"
@@ -58,8 +58,8 @@ gcomm::crc16(const gcomm::Datagram& dg, size_t offset)
         offset -= dg.header_len();
     }
 
-    crc.process_block(dg.payload_->data() + offset,
-                      dg.payload_->data() + dg.payload_->size());
+    crc.process_block(dg.payload_data() + offset,
+                      dg.payload_data() + dg.payload_size());
 
     return crc.checksum();
 }
@@ -90,8 +90,8 @@ gcomm::crc32(gcomm::NetHeader::checksum_t const type,
             offset -= dg.header_len();
         }
 
-        crc.process_block(dg.payload_->data() + offset,
-                          dg.payload_->data() + dg.payload_->size());
+        crc.process_block(dg.payload_data() + offset,
+                          dg.payload_data() + dg.payload_size());
 
         return crc.checksum();
     }
@@ -112,7 +112,7 @@ gcomm::crc32(gcomm::NetHeader::checksum_t const type,
             offset -= dg.header_len();
         }
 
-        crc.append (dg.payload_->data() + offset, dg.payload_->size() - offset);
+        crc.append (dg.payload_data() + offset, dg.payload_size() - offset);
 
         return crc();
     }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2012-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2012-2026 Codership Oy <info@codership.com>
  */
 
 #include "defaults.hpp"
@@ -21,6 +21,8 @@ namespace gcomm
         GCOMM_ASIO_AUTO_BUF_SIZE;
     std::string const Defaults::SocketSendBufSize       =
         GCOMM_ASIO_AUTO_BUF_SIZE;
+    std::string const Defaults::SocketIoThreads         = "0";
+    std::string const Defaults::SocketIoPendingMax      = "4M";
     std::string const Defaults::GMCastVersion           = "0";
     std::string const Defaults::GMCastTcpPort           = BASE_PORT_DEFAULT;
     std::string const Defaults::GMCastSegment           = "0";
@@ -42,6 +44,7 @@ namespace gcomm
     std::string const Defaults::EvsSendWindowMin        = "1";
     std::string const Defaults::EvsUserSendWindow       = "4";
     std::string const Defaults::EvsUserSendWindowMin    = "1";
+    std::string const Defaults::EvsAdaptiveSendWindow   = "false";
     std::string const Defaults::EvsMaxInstallTimeouts   = "3";
     std::string const Defaults::EvsDelayMargin          = "PT1S";
     std::string const Defaults::EvsDelayedKeepPeriod    = "PT30S";
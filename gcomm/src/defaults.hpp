@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef GCOMM_DEFAULTS_HPP
@@ -16,6 +16,8 @@ namespace gcomm
         static std::string const SocketChecksum           ;
         static std::string const SocketRecvBufSize        ;
         static std::string const SocketSendBufSize        ;
+        static std::string const SocketIoThreads          ;
+        static std::string const SocketIoPendingMax       ;
         static std::string const GMCastVersion            ;
         static std::string const GMCastTcpPort            ;
         static std::string const GMCastSegment            ;
@@ -37,6 +39,7 @@ namespace gcomm
         static std::string const EvsSendWindowMin         ;
         static std::string const EvsUserSendWindow        ;
         static std::string const EvsUserSendWindowMin     ;
+        static std::string const EvsAdaptiveSendWindow    ;
         static std::string const EvsMaxInstallTimeouts    ;
         static std::string const EvsDelayMargin           ;
         static std::string const EvsDelayedKeepPeriod     ;
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 
@@ -10,6 +10,7 @@
 #include "gu_buffer.hpp"
 #include <stdexcept>
 #include <numeric>
+#include <new>
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -90,6 +91,26 @@ std::ostream& gcomm::evs::operator<<(std::ostream& os, const InputMapMsg& m)
 }
 
 
+std::ostream& gcomm::evs::operator<<(std::ostream& os,
+                                     const InputMapMsgIndex& mi)
+{
+    for (size_t r(0); r < mi.rows_; ++r)
+    {
+        const seqno_t seq(mi.base_ + static_cast<seqno_t>(r));
+        for (size_t i(0); i < mi.nodes_; ++i)
+        {
+            const size_t s(mi.slot(seq, i));
+            if (mi.state_[s] == InputMapMsgIndex::S_EMPTY) continue;
+            os << "\t" << InputMapMsgKey(i, seq) << "," << mi.slots_[s]
+               << (mi.state_[s] == InputMapMsgIndex::S_RECOVERY ?
+                   " (recovery)" : "")
+               << "\n";
+        }
+    }
+    return os;
+}
+
+
 std::ostream& gcomm::evs::operator<<(std::ostream& os, const InputMap& im)
 {
     return (os << "evs::input_map: {"
@@ -98,14 +119,313 @@ std::ostream& gcomm::evs::operator<<(std::ostream& os, const InputMap& im)
             << "node_index="     << *im.node_index_
 #ifndef NDEBUG
             << ","
-            << "msg_index="      << *im.msg_index_      << ","
-            << "recovery_index=" << *im.recovery_index_
+            << "msg_index="      << *im.msg_index_
 #endif // !NDEBUG
             << "}");
 }
 
 
 
+//////////////////////////////////////////////////////////////////////////
+//
+// Message index
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+static const size_t input_map_min_rows(16);
+
+
+gcomm::evs::InputMapMsgIndex::InputMapMsgIndex() :
+    nodes_      (0),
+    capacity_   (0),
+    head_       (0),
+    rows_       (0),
+    base_       (0),
+    begin_seq_  (0),
+    cleanup_seq_(-1),
+    n_msgs_     (0),
+    n_recovery_ (0),
+    slots_      (0),
+    state_      (),
+    row_msgs_   (),
+    row_used_   ()
+{ }
+
+
+gcomm::evs::InputMapMsgIndex::~InputMapMsgIndex()
+{
+    clear();
+    ::operator delete(slots_);
+}
+
+
+void gcomm::evs::InputMapMsgIndex::reset(const size_t nodes)
+{
+    gcomm_assert(n_msgs_ == 0 && n_recovery_ == 0);
+    clear();
+
+    if (nodes != nodes_)
+    {
+        ::operator delete(slots_);
+        slots_    = 0;
+        capacity_ = 0;
+        state_.clear();
+        row_msgs_.clear();
+        row_used_.clear();
+        nodes_    = nodes;
+    }
+}
+
+
+gcomm::evs::InputMapMsgIndex::iterator
+gcomm::evs::InputMapMsgIndex::begin() const
+{
+    if (n_msgs_ == 0) return end();
+
+    seqno_t seq(begin_seq_);
+    size_t  index(0);
+    first_msg(seq, index);
+    assert(seq >= 0);
+    begin_seq_ = seq;
+    return iterator(this, seq, index);
+}
+
+
+gcomm::evs::InputMapMsgIndex::iterator
+gcomm::evs::InputMapMsgIndex::find(const InputMapMsgKey& key) const
+{
+    if (key.index() < nodes_ && in_range(key.seq()) &&
+        state_[slot(key.seq(), key.index())] == S_MSG)
+    {
+        return iterator(this, key.seq(), key.index());
+    }
+    return end();
+}
+
+
+gcomm::evs::InputMapMsgIndex::iterator
+gcomm::evs::InputMapMsgIndex::find_recovery(const InputMapMsgKey& key) const
+{
+    if (key.index() < nodes_ && in_range(key.seq()) &&
+        state_[slot(key.seq(), key.index())] == S_RECOVERY)
+    {
+        return iterator(this, key.seq(), key.index());
+    }
+    return end();
+}
+
+
+bool gcomm::evs::InputMapMsgIndex::has(const InputMapMsgKey& key) const
+{
+    return (key.index() < nodes_ && in_range(key.seq()) &&
+            state_[slot(key.seq(), key.index())] != S_EMPTY);
+}
+
+
+void gcomm::evs::InputMapMsgIndex::insert(const InputMapMsgKey& key,
+                                          const InputMapMsg&    msg)
+{
+    gcomm_assert(key.index() < nodes_ && key.seq() >= 0)
+        << "invalid key " << key;
+
+    if (in_range(key.seq()) == false) grow(key.seq());
+
+    const size_t r(row(key.seq()));
+    const size_t s(r*nodes_ + key.index());
+
+    if (state_[s] != S_EMPTY)
+    {
+        gu_throw_fatal << "duplicate entry " << key << " " << msg;
+    }
+
+    new (slots_ + s) InputMapMsg(msg);
+    state_[s] = S_MSG;
+    ++row_msgs_[r];
+    ++row_used_[r];
+    ++n_msgs_;
+
+    if (key.seq() < begin_seq_) begin_seq_ = key.seq();
+}
+
+
+void gcomm::evs::InputMapMsgIndex::erase(iterator i)
+{
+    gcomm_assert(i.idx_ == this && in_range(i.seq_));
+
+    const size_t r(row(i.seq_));
+    const size_t s(r*nodes_ + i.index_);
+
+    gcomm_assert(state_[s] == S_MSG);
+
+    --row_msgs_[r];
+    --n_msgs_;
+
+    if (i.seq_ <= cleanup_seq_)
+    {
+        // Already below recovery cleanup point, drop immediately
+        release_slot(s);
+        --row_used_[r];
+        pop_front();
+    }
+    else
+    {
+        state_[s] = S_RECOVERY;
+        ++n_recovery_;
+    }
+}
+
+
+void gcomm::evs::InputMapMsgIndex::cleanup_recovery(const seqno_t seq)
+{
+    if (seq <= cleanup_seq_) return;
+
+    const seqno_t last(std::min(seq, base_ + static_cast<seqno_t>(rows_) - 1));
+    for (seqno_t sq(std::max(cleanup_seq_ + 1, base_)); sq <= last; ++sq)
+    {
+        const size_t r(row(sq));
+        if (row_used_[r] == row_msgs_[r]) continue;
+
+        for (size_t s(r*nodes_); s < (r + 1)*nodes_; ++s)
+        {
+            if (state_[s] == S_RECOVERY)
+            {
+                release_slot(s);
+                --row_used_[r];
+                --n_recovery_;
+            }
+        }
+    }
+
+    cleanup_seq_ = seq;
+    pop_front();
+}
+
+
+void gcomm::evs::InputMapMsgIndex::clear()
+{
+    for (size_t r(0); r < rows_ && n_msgs_ + n_recovery_ > 0; ++r)
+    {
+        const size_t rr((head_ + r) & (capacity_ - 1));
+        for (size_t s(rr*nodes_); s < (rr + 1)*nodes_; ++s)
+        {
+            if (state_[s] == S_EMPTY) continue;
+            if (state_[s] == S_MSG) --n_msgs_; else --n_recovery_;
+            release_slot(s);
+        }
+        row_msgs_[rr] = 0;
+        row_used_[rr] = 0;
+    }
+    assert(n_msgs_ == 0 && n_recovery_ == 0);
+
+    head_        = 0;
+    rows_        = 0;
+    base_        = 0;
+    begin_seq_   = 0;
+    cleanup_seq_ = -1;
+}
+
+
+void gcomm::evs::InputMapMsgIndex::first_msg(seqno_t& seq, size_t& index) const
+{
+    if (seq < base_)
+    {
+        seq   = base_;
+        index = 0;
+    }
+
+    const seqno_t end(base_ + static_cast<seqno_t>(rows_));
+    for (; seq < end; ++seq, index = 0)
+    {
+        const size_t r(row(seq));
+        if (row_msgs_[r] == 0) continue;
+
+        for (; index < nodes_; ++index)
+        {
+            if (state_[r*nodes_ + index] == S_MSG) return;
+        }
+    }
+
+    seq   = -1;
+    index = 0;
+}
+
+
+void gcomm::evs::InputMapMsgIndex::grow(const seqno_t seq)
+{
+    if (rows_ == 0) base_ = seq;
+
+    const seqno_t first(std::min(base_, seq));
+    const seqno_t last(std::max(base_ + static_cast<seqno_t>(rows_) - 1, seq));
+    const size_t  rows(last - first + 1);
+
+    if (rows > capacity_)
+    {
+        size_t capacity(std::max(capacity_*2, input_map_min_rows));
+        while (capacity < rows) capacity *= 2;
+
+        const size_t offset(base_ - first);
+        InputMapMsg* const slots(static_cast<InputMapMsg*>(
+                                     ::operator new(sizeof(InputMapMsg)*
+                                                    capacity*nodes_)));
+        std::vector<unsigned char> state(capacity*nodes_, S_EMPTY);
+        std::vector<size_t>        row_msgs(capacity, 0);
+        std::vector<size_t>        row_used(capacity, 0);
+
+        for (size_t r(0); r < rows_; ++r)
+        {
+            const size_t from((head_ + r) & (capacity_ - 1));
+            const size_t to(offset + r);
+            for (size_t i(0); i < nodes_; ++i)
+            {
+                const size_t s(from*nodes_ + i);
+                if (state_[s] == S_EMPTY) continue;
+                new (slots + to*nodes_ + i) InputMapMsg(slots_[s]);
+                slots_[s].~InputMapMsg();
+                state[to*nodes_ + i] = state_[s];
+            }
+            row_msgs[to] = row_msgs_[from];
+            row_used[to] = row_used_[from];
+        }
+
+        ::operator delete(slots_);
+        slots_    = slots;
+        capacity_ = capacity;
+        state_.swap(state);
+        row_msgs_.swap(row_msgs);
+        row_used_.swap(row_used);
+        head_     = 0;
+    }
+    else
+    {
+        // Rows outside of the range in use are always empty
+        head_ = (head_ - (base_ - first)) & (capacity_ - 1);
+    }
+
+    base_ = first;
+    rows_ = rows;
+}
+
+
+void gcomm::evs::InputMapMsgIndex::release_slot(const size_t s)
+{
+    slots_[s].~InputMapMsg();
+    state_[s] = S_EMPTY;
+}
+
+
+void gcomm::evs::InputMapMsgIndex::pop_front()
+{
+    while (rows_ > 0 && base_ <= cleanup_seq_ && row_used_[head_] == 0)
+    {
+        head_ = (head_ + 1) & (capacity_ - 1);
+        ++base_;
+        --rows_;
+    }
+}
+
+
+
 //////////////////////////////////////////////////////////////////////////
 //
 // Constructors/destructors
@@ -117,8 +437,7 @@ gcomm::evs::InputMap::InputMap() :
     safe_seq_       (-1),
     aru_seq_        (-1),
     node_index_     (new InputMapNodeIndex()),
-    msg_index_      (new InputMapMsgIndex()),
-    recovery_index_ (new InputMapMsgIndex())
+    msg_index_      (new InputMapMsgIndex())
 { }
 
 
@@ -127,7 +446,6 @@ gcomm::evs::InputMap::~InputMap()
     clear();
     delete node_index_;
     delete msg_index_;
-    delete recovery_index_;
 }
 
 
@@ -142,8 +460,9 @@ gcomm::evs::InputMap::~InputMap()
 void gcomm::evs::InputMap::reset(const size_t nodes)
 {
     gcomm_assert(msg_index_->empty()                           == true &&
-                 recovery_index_->empty()                      == true);
+                 msg_index_->recovery_size()                   == 0);
     node_index_->clear();
+    msg_index_->reset(nodes);
 
     log_debug << " size " << node_index_->size();
     gu_trace(node_index_->resize(nodes, InputMapNode()));
@@ -205,7 +524,7 @@ void gcomm::evs::InputMap::set_safe_seq(const size_t uuid, const seqno_t seq)
     // Global safe seq must always be smaller than equal to aru seq
     gcomm_assert(safe_seq_ <= aru_seq_);
     // Cleanup recovery index
-    cleanup_recovery_index();
+    msg_index_->cleanup_recovery(safe_seq_);
 }
 
 
@@ -216,13 +535,12 @@ void gcomm::evs::InputMap::clear()
         log_warn << "discarding " << msg_index_->size() <<
             " messages from message index";
     }
-    msg_index_->clear();
-    if (recovery_index_->empty() == false)
+    if (msg_index_->recovery_size() > 0)
     {
-        log_debug << "discarding " << recovery_index_->size()
+        log_debug << "discarding " << msg_index_->recovery_size()
                   << " messages from recovery index";
     }
-    recovery_index_->clear();
+    msg_index_->clear();
     node_index_->clear();
     aru_seq_ = -1;
     safe_seq_ = -1;
@@ -260,8 +578,8 @@ gcomm::evs::InputMap::insert(const size_t uuid,
     // Check whether this message has already been seen
     if (msg.seq() < node.range().lu() ||
         (msg.seq() <= node.range().hs() &&
-         recovery_index_->find(InputMapMsgKey(node.index(), msg.seq())) !=
-         recovery_index_->end()))
+         msg_index_->find_recovery(InputMapMsgKey(node.index(), msg.seq())) !=
+         msg_index_->end()))
     {
         return node.range();
     }
@@ -270,35 +588,24 @@ gcomm::evs::InputMap::insert(const size_t uuid,
     // already found
     for (seqno_t s = msg.seq(); s <= msg.seq() + msg.seq_range(); ++s)
     {
-        InputMapMsgIndex::iterator msg_i;
-
-        if (range.hs() < s)
-        {
-            msg_i = msg_index_->end();
-        }
-        else
-        {
-            msg_i = msg_index_->find(InputMapMsgKey(node.index(), s));
-        }
-
-        if (msg_i == msg_index_->end())
+        if (range.hs() < s ||
+            msg_index_->has(InputMapMsgKey(node.index(), s)) == false)
         {
             Datagram ins_dg(s == msg.seq() ?
                                 Datagram(rb)   :
                                 Datagram());
-            gu_trace((void)msg_index_->insert_unique(
-                         std::make_pair(
-                             InputMapMsgKey(node.index(), s),
-                             InputMapMsg(
-                                 (s == msg.seq() ?
-                                  msg :
-                                  UserMessage(msg.version(),
-                                              msg.source(),
-                                              msg.source_view_id(),
-                                              s,
-                                              msg.aru_seq(),
-                                              0,
-                                              O_DROP)), ins_dg))));
+            gu_trace(msg_index_->insert(
+                         InputMapMsgKey(node.index(), s),
+                         InputMapMsg(
+                             (s == msg.seq() ?
+                              msg :
+                              UserMessage(msg.version(),
+                                          msg.source(),
+                                          msg.source_view_id(),
+                                          s,
+                                          msg.aru_seq(),
+                                          0,
+                                          O_DROP)), ins_dg)));
         }
 
         // Update highest seen
@@ -317,10 +624,7 @@ gcomm::evs::InputMap::insert(const size_t uuid,
             }
             while (
                 i <= range.hs() &&
-                (msg_index_->find(InputMapMsgKey(node.index(), i))
-                 != msg_index_->end() ||
-                 recovery_index_->find(InputMapMsgKey(node.index(), i))
-                 != recovery_index_->end()));
+                msg_index_->has(InputMapMsgKey(node.index(), i)));
             range.set_lu(i);
         }
     }
@@ -333,7 +637,6 @@ gcomm::evs::InputMap::insert(const size_t uuid,
 
 void gcomm::evs::InputMap::erase(iterator i)
 {
-    gu_trace(recovery_index_->insert_unique(*i));
     gu_trace(msg_index_->erase(i));
 }
 
@@ -355,7 +658,11 @@ gcomm::evs::InputMap::recover(const size_t uuid, const seqno_t seq) const
     iterator ret;
     const InputMapNode& node(node_index_->at(uuid));
     const InputMapMsgKey key(node.index(), seq);
-    gu_trace(ret = recovery_index_->find_checked(key));
+    gu_trace(ret = msg_index_->find_recovery(key));
+    if (ret == msg_index_->end())
+    {
+        gu_throw_fatal << "element " << key << " not found";
+    }
     return ret;
 }
 
@@ -385,14 +692,7 @@ gcomm::evs::InputMap::gap_range_list(size_t index, const Range& range) const
     std::vector<Range> ret;
     for (seqno_t seq(range.lu()); seq <= range.hs(); ++seq)
     {
-        const InputMapMsgKey key(index, seq);
-        gcomm::evs::InputMap::const_iterator msg_i(msg_index_->find(key));
-        if (msg_i != msg_index_->end())
-        {
-            continue;
-        }
-        msg_i = recovery_index_->find(key);
-        if (msg_i != recovery_index_->end())
+        if (msg_index_->has(InputMapMsgKey(index, seq)))
         {
             continue;
         }
@@ -420,12 +720,3 @@ inline void gcomm::evs::InputMap::update_aru()
     gcomm_assert(minval - 1 >= aru_seq_);
     aru_seq_ = minval - 1;
 }
-
-
-void gcomm::evs::InputMap::cleanup_recovery_index()
-{
-    gcomm_assert(node_index_->size() > 0);
-    InputMapMsgIndex::iterator i = recovery_index_->lower_bound(
-        InputMapMsgKey(0, safe_seq_ + 1));
-    recovery_index_->erase(recovery_index_->begin(), i);
-}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -20,7 +20,6 @@
 #define EVS_INPUT_MAP2_HPP
 
 #include "evs_message2.hpp"
-#include "gcomm/map.hpp"
 #include "gcomm/datagram.hpp"
 
 #include <vector>
@@ -36,6 +35,7 @@ namespace gcomm
         class InputMapMsg;
         std::ostream& operator<<(std::ostream&, const InputMapMsg&);
         class InputMapMsgIndex;
+        std::ostream& operator<<(std::ostream&, const InputMapMsgIndex&);
         class InputMapNode;
         std::ostream& operator<<(std::ostream&, const InputMapNode&);
         typedef std::vector<InputMapNode> InputMapNodeIndex;
@@ -92,31 +92,156 @@ private:
 };
 
 
-#if defined(GALERA_USE_BOOST_POOL_ALLOC)
+/*!
+ * Index of messages in the input map.
+ *
+ * Messages are kept in a ring of rows indexed by seqno, each row having
+ * a slot for every node in the view, so that lookup by (index, seq) key
+ * and insert are O(1) and iteration proceeds through consecutive memory
+ * in (seq, index) order, which is the order of delivery. Erased messages
+ * stay in their slots for recovery until cleaned up by
+ * cleanup_recovery(), rows are released from the front when all their
+ * slots are empty. The ring grows by doubling when a message falls
+ * outside of it.
+ *
+ * Iterators stay valid over insert() and erase() of other messages.
+ */
+class gcomm::evs::InputMapMsgIndex
+{
+public:
+
+    class iterator
+    {
+    public:
+
+        iterator() : idx_(0), seq_(-1), index_(0) { }
+
+        iterator& operator++()
+        {
+            ++index_;
+            idx_->first_msg(seq_, index_);
+            return *this;
+        }
+
+        bool operator==(const iterator& cmp) const
+        {
+            return (seq_ == cmp.seq_ && index_ == cmp.index_);
+        }
+
+        bool operator!=(const iterator& cmp) const
+        {
+            return !(*this == cmp);
+        }
+
+    private:
 
-#include <boost/pool/pool_alloc.hpp>
+        friend class InputMapMsgIndex;
 
-class gcomm::evs::InputMapMsgIndex :
-    public Map<InputMapMsgKey, InputMapMsg,
-               std::map<InputMapMsgKey,
-                        InputMapMsg,
-                        std::less<InputMapMsgKey>,
-                        boost::fast_pool_allocator<
-                            std::pair<const InputMapMsgKey, InputMapMsg>,
-                            boost::default_user_allocator_new_delete,
-                            boost::details::pool::null_mutex
-                            >
-                        >
-               >
-{};
+        iterator(const InputMapMsgIndex* idx, seqno_t seq, size_t index)
+            :
+            idx_  (idx),
+            seq_  (seq),
+            index_(index)
+        { }
 
-#else /* GALERA_USE_BOOST_POOL_ALLOC */
+        const InputMapMsgIndex* idx_;
+        seqno_t                 seq_;   /* -1 for end() */
+        size_t                  index_;
+    };
 
-class gcomm::evs::InputMapMsgIndex :
-    public Map<InputMapMsgKey, InputMapMsg>
-{};
+    typedef iterator const_iterator;
 
-#endif /* GALERA_USE_BOOST_POOL_ALLOC */
+    InputMapMsgIndex();
+    ~InputMapMsgIndex();
+
+    /*! Sets the number of nodes, index must be empty */
+    void reset(size_t nodes);
+
+    iterator begin() const;
+    iterator end  () const { return iterator(); }
+
+    /*! Finds message which has not been erased */
+    iterator find         (const InputMapMsgKey& key) const;
+    /*! Finds message which has been erased but not cleaned up yet */
+    iterator find_recovery(const InputMapMsgKey& key) const;
+    /*! Checks if message has been inserted and not cleaned up yet */
+    bool     has          (const InputMapMsgKey& key) const;
+
+    /*! Inserts message, the slot must be empty */
+    void insert(const InputMapMsgKey& key, const InputMapMsg& msg);
+
+    /*! Moves message to recovery */
+    void erase(iterator i);
+
+    /*! Cleans up erased messages with seqno up to seq */
+    void cleanup_recovery(seqno_t seq);
+
+    size_t size         () const { return n_msgs_;     }
+    size_t recovery_size() const { return n_recovery_; }
+    bool   empty        () const { return (n_msgs_ == 0); }
+
+    /*! Removes all messages */
+    void clear();
+
+    static InputMapMsgKey key(iterator i)
+    {
+        return InputMapMsgKey(i.index_, i.seq_);
+    }
+
+    static const InputMapMsg& value(iterator i)
+    {
+        return i.idx_->slots_[i.idx_->slot(i.seq_, i.index_)];
+    }
+
+private:
+
+    friend std::ostream& operator<<(std::ostream&, const InputMapMsgIndex&);
+
+    enum SlotState
+    {
+        S_EMPTY,
+        S_MSG,
+        S_RECOVERY
+    };
+
+    InputMapMsgIndex(const InputMapMsgIndex&);
+    void operator=(const InputMapMsgIndex&);
+
+    bool in_range(seqno_t seq) const
+    {
+        return (seq >= base_ && seq < base_ + static_cast<seqno_t>(rows_));
+    }
+
+    size_t row(seqno_t seq) const
+    {
+        return ((head_ + (seq - base_)) & (capacity_ - 1));
+    }
+
+    size_t slot(seqno_t seq, size_t index) const
+    {
+        return (row(seq)*nodes_ + index);
+    }
+
+    /* advances (seq, index) to the first message at or past it */
+    void first_msg(seqno_t& seq, size_t& index) const;
+    void grow(seqno_t seq);
+    void release_slot(size_t s);
+    void pop_front();
+
+    size_t                     nodes_;
+    size_t                     capacity_;    /* rows allocated, power of 2 */
+    size_t                     head_;        /* ring position of base_     */
+    size_t                     rows_;        /* rows in use                */
+    seqno_t                    base_;        /* seqno of the first row     */
+    mutable seqno_t            begin_seq_;   /* no messages below this seq */
+    seqno_t                    cleanup_seq_; /* recovery cleaned up to seq */
+    size_t                     n_msgs_;
+    size_t                     n_recovery_;
+    InputMapMsg*               slots_;
+    std::vector<unsigned char> state_;
+    std::vector<size_t>        row_msgs_;    /* messages in row            */
+    std::vector<size_t>        row_used_;    /* non-empty slots in row     */
+};
 
 /* Internal node representation */
 class gcomm::evs::InputMapNode
@@ -353,16 +478,10 @@ private:
      */
     void update_aru();
 
-    /*!
-     * Clean up recovery index. All messages up to safe_seq are removed.
-     */
-    void cleanup_recovery_index();
-
     seqno_t            safe_seq_;       /*!< Safe seqno               */
     seqno_t            aru_seq_;        /*!< All received up to seqno */
     InputMapNodeIndex* node_index_;     /*!< Index of nodes           */
     InputMapMsgIndex*  msg_index_;      /*!< Index of messages        */
-    InputMapMsgIndex*  recovery_index_; /*!< Recovery index           */
 };
 
 #endif // EVS_INPUT_MAP2_HPP
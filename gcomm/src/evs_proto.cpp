@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "evs_proto.hpp"
@@ -155,18 +155,31 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
     install_timeout_count_(0),
     fifo_seq_(-1),
     last_sent_(-1),
+    send_window_min_(gu::from_string<seqno_t>(Defaults::EvsSendWindowMin)),
+    user_send_window_min_(
+        gu::from_string<seqno_t>(Defaults::EvsUserSendWindowMin)),
     send_window_(
         check_range(Conf::EvsSendWindow,
                     param<seqno_t>(conf, uri, Conf::EvsSendWindow,
                                    Defaults::EvsSendWindow),
-                    gu::from_string<seqno_t>(Defaults::EvsSendWindowMin),
+                    send_window_min_,
                     std::numeric_limits<seqno_t>::max())),
     user_send_window_(
         check_range(Conf::EvsUserSendWindow,
                     param<seqno_t>(conf, uri, Conf::EvsUserSendWindow,
                                    Defaults::EvsUserSendWindow),
-                    gu::from_string<seqno_t>(Defaults::EvsUserSendWindowMin),
+                    user_send_window_min_,
                     send_window_ + 1)),
+    adaptive_send_window_(param<bool>(conf, uri, Conf::EvsAdaptiveSendWindow,
+                                      Defaults::EvsAdaptiveSendWindow)),
+    adaptive_win_(send_window_),
+    adaptive_epoch_end_(-1),
+    adaptive_losses_(0),
+    adaptive_limited_(false),
+    adaptive_base_lat_(-1.),
+    adaptive_period_lat_(-1.),
+    adaptive_epochs_(0),
+    adaptive_lat_(-1.),
     bytes_since_request_user_msg_feedback_(),
     output_(),
     send_buf_(),
@@ -198,6 +211,8 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
              gu::to_string(causal_keepalive_period_));
     conf.set(Conf::EvsSendWindow, gu::to_string(send_window_));
     conf.set(Conf::EvsUserSendWindow, gu::to_string(user_send_window_));
+    conf.set(Conf::EvsAdaptiveSendWindow,
+             gu::to_string(adaptive_send_window_));
     conf.set(Conf::EvsUseAggregate, gu::to_string(use_aggregate_));
     conf.set(Conf::EvsDebugLogMask, gu::to_string(debug_mask_, std::hex));
     conf.set(Conf::EvsInfoLogMask, gu::to_string(info_mask_, std::hex));
@@ -257,6 +272,7 @@ gcomm::evs::Proto::set_param(const std::string& key, const std::string& val,
                                    user_send_window_,
                                    std::numeric_limits<seqno_t>::max());
         conf_.set(Conf::EvsSendWindow, gu::to_string(send_window_));
+        adaptive_win_ = std::min(adaptive_win_, send_window_);
         return true;
     }
     else if (key == gcomm::Conf::EvsUserSendWindow)
@@ -264,11 +280,20 @@ gcomm::evs::Proto::set_param(const std::string& key, const std::string& val,
         user_send_window_ = check_range(
             Conf::EvsUserSendWindow,
             gu::from_string<seqno_t>(val),
-            gu::from_string<seqno_t>(Defaults::EvsUserSendWindowMin),
+            user_send_window_min_,
             send_window_ + 1);
         conf_.set(Conf::EvsUserSendWindow, gu::to_string(user_send_window_));
         return true;
     }
+    else if (key == gcomm::Conf::EvsAdaptiveSendWindow)
+    {
+        adaptive_send_window_ = gu::from_string<bool>(val);
+        conf_.set(Conf::EvsAdaptiveSendWindow,
+                  gu::to_string(adaptive_send_window_));
+        adaptive_win_ = send_window_;
+        reset_send_window_epoch();
+        return true;
+    }
     else if (key == gcomm::Conf::EvsMaxInstallTimeouts)
     {
         max_install_timeouts_ = check_range(
@@ -432,6 +457,8 @@ void gcomm::evs::Proto::handle_get_status(gu::Status& status) const
 {
     status.insert("evs_state", to_string(state_));
     status.insert("evs_repl_latency", safe_deliv_latency_.to_string());
+    status.insert("evs_send_window", gu::to_string(send_window()));
+    status.insert("evs_user_send_window", gu::to_string(user_send_window()));
     std::string delayed_list_str;
     for (DelayedList::const_iterator i(delayed_list_.begin());
          i != delayed_list_.end(); ++i)
@@ -1434,6 +1461,20 @@ bool gcomm::evs::Proto::is_flow_control(const seqno_t seq, const seqno_t win) co
     return false;
 }
 
+gcomm::evs::seqno_t gcomm::evs::Proto::send_window() const
+{
+    return (adaptive_send_window_ ? adaptive_win_ : send_window_);
+}
+
+gcomm::evs::seqno_t gcomm::evs::Proto::user_send_window() const
+{
+    if (adaptive_send_window_ == false) return user_send_window_;
+
+    // Scale user send window down with the adaptive window
+    return std::max(user_send_window_ * adaptive_win_ / send_window_,
+                    user_send_window_min_);
+}
+
 bool gcomm::evs::Proto::request_user_msg_feedback(const gcomm::Datagram& dg)
     const
 {
@@ -1471,9 +1512,14 @@ int gcomm::evs::Proto::send_user(Datagram& dg,
     if (win                       != -1   &&
         is_flow_control(seq, win) == true)
     {
+        adaptive_limited_ = true;
         return EAGAIN;
     }
 
+    // Aggregated messages piled up in the output queue while the
+    // window was closed
+    if (n_aggregated > 1) adaptive_limited_ = true;
+
     // seq_range max 0xff because of Message seq_range_ field limitation
     seqno_t seq_range(
         std::min(up_to_seqno == -1 ? 0 : up_to_seqno - seq,
@@ -2139,6 +2185,7 @@ void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
         }
         seq = seq + msg.seq_range() + 1;
         retrans_msgs_++;
+        adaptive_losses_++;
     }
 }
 
@@ -2660,7 +2707,7 @@ int gcomm::evs::Proto::handle_down(Datagram& wb, const ProtoDownMeta& dm)
         err = send_user(wb,
                         dm.user_type(),
                         dm.order(),
-                        user_send_window_,
+                        user_send_window(),
                         -1);
 
         switch (err)
@@ -2925,6 +2972,7 @@ void gcomm::evs::Proto::shift_to(const State s, const bool send_j)
 
         input_map_->reset(current_view_.members().size());
         last_sent_ = -1;
+        reset_send_window_epoch();
         state_ = S_OPERATIONAL;
         deliver_reg_view(*install_message_, previous_view_);
 
@@ -3006,16 +3054,109 @@ void gcomm::evs::Proto::validate_reg_msg(const UserMessage& msg)
                        gu::datetime::Sec);
             if (info_mask_ & I_STATISTICS) hs_safe_.insert(lat);
             safe_deliv_latency_.insert(lat);
+            if (adaptive_send_window_) adjust_send_window(msg, lat);
         }
-        else if (msg.order() == O_AGREED)
+        else
         {
-            if (info_mask_ & I_STATISTICS)
+            if (msg.order() == O_AGREED && (info_mask_ & I_STATISTICS))
             {
                 gu::datetime::Date now(gu::datetime::Date::monotonic());
                 hs_agreed_.insert(double(now.get_utc() - msg.tstamp().get_utc())/gu::datetime::Sec);
             }
+            if (adaptive_send_window_) adjust_send_window(msg, -1.);
+        }
+    }
+}
+
+void gcomm::evs::Proto::adjust_send_window(const UserMessage& msg,
+                                           double const lat)
+{
+    if (lat >= 0.)
+    {
+        adaptive_lat_ = (adaptive_lat_ < 0. ?
+                         lat : adaptive_lat_ + (lat - adaptive_lat_)/8);
+    }
+
+    if (adaptive_epoch_end_ == -1)
+    {
+        // First delivery in the view starts the first epoch
+        adaptive_epoch_end_ = last_sent_ + adaptive_win_;
+        adaptive_losses_    = 0;
+        adaptive_limited_   = false;
+        return;
+    }
+
+    // Epoch ends when one window of own messages sent after its start
+    // has been delivered, which takes about one round trip.
+    if (msg.seq() + msg.seq_range() < adaptive_epoch_end_) return;
+
+    // Base latency is the lowest smoothed latency seen at the end of
+    // epoch, single samples are too noisy for that.
+    if (adaptive_lat_ >= 0.)
+    {
+        if (adaptive_base_lat_ < 0. || adaptive_lat_ < adaptive_base_lat_)
+        {
+            adaptive_base_lat_ = adaptive_lat_;
         }
+        if (adaptive_period_lat_ < 0. || adaptive_lat_ < adaptive_period_lat_)
+        {
+            adaptive_period_lat_ = adaptive_lat_;
+        }
+    }
+
+    const seqno_t prev_win(adaptive_win_);
+
+    // Latency is considered inflated when it grows over twice the base
+    // latency, with 1ms allowance to filter out jitter on fast networks.
+    if (adaptive_losses_ > 0)
+    {
+        adaptive_win_ = std::max(adaptive_win_/2, send_window_min_);
+    }
+    else if (adaptive_base_lat_ >= 0. &&
+             adaptive_lat_ > 2*adaptive_base_lat_ + 0.001)
+    {
+        adaptive_win_ = std::max(adaptive_win_ - std::max(adaptive_win_/8,
+                                                          seqno_t(1)),
+                                 send_window_min_);
+    }
+    else if (adaptive_limited_ == true)
+    {
+        adaptive_win_ = std::min(adaptive_win_ + 1, send_window_);
+    }
+
+    if (adaptive_win_ != prev_win)
+    {
+        evs_log_debug(D_USER_MSGS) << "send window " << prev_win << " -> "
+                                   << adaptive_win_
+                                   << " losses: " << adaptive_losses_
+                                   << " latency: " << adaptive_lat_
+                                   << " base: " << adaptive_base_lat_;
+    }
+
+    static size_t const base_period(32); // epochs
+
+    if (++adaptive_epochs_ >= base_period && adaptive_period_lat_ >= 0.)
+    {
+        adaptive_base_lat_   = adaptive_period_lat_;
+        adaptive_period_lat_ = -1.;
+        adaptive_epochs_     = 0;
     }
+
+    adaptive_epoch_end_ = last_sent_ + adaptive_win_;
+    adaptive_losses_    = 0;
+    adaptive_limited_   = false;
+}
+
+void gcomm::evs::Proto::reset_send_window_epoch()
+{
+    // Seqnos restart and round trip times may change with the membership
+    adaptive_epoch_end_  = -1;
+    adaptive_losses_     = 0;
+    adaptive_limited_    = false;
+    adaptive_base_lat_   = -1.;
+    adaptive_period_lat_ = -1.;
+    adaptive_epochs_     = 0;
+    adaptive_lat_        = -1.;
 }
 
 
@@ -3307,6 +3448,7 @@ void gcomm::evs::Proto::request_retrans(const UUID& target, const UUID& origin,
                                  << input_map_->aru_seq();
         std::vector<Range> gap_ranges(input_map_->gap_range_list(
                                           origin_node.index(), range));
+        adaptive_losses_ += gap_ranges.size();
         for (std::vector<Range>::const_iterator ri(gap_ranges.begin());
              ri != gap_ranges.end(); ++ri)
         {
@@ -3731,7 +3873,7 @@ void gcomm::evs::Proto::handle_user(const UserMessage& msg,
         while (output_.empty() == false)
         {
             int err;
-            gu_trace(err = send_user(send_window_));
+            gu_trace(err = send_user(send_window()));
             if (err != 0)
             {
                 if (err == EAGAIN && n_sent == 0)
@@ -3921,7 +4063,7 @@ void gcomm::evs::Proto::handle_gap(const GapMessage& msg, NodeMap::iterator ii)
             while (output_.empty() == false)
             {
                 int err;
-                gu_trace(err = send_user(send_window_));
+                gu_trace(err = send_user(send_window()));
                 if (err != 0)
                     break;
             }
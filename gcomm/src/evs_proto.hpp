@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 /*!
@@ -152,6 +152,10 @@ public:
     // Return true if the message with seqno and given send window will
     // cause flow control.
     bool is_flow_control(const seqno_t seqno, const seqno_t win) const;
+    // Effective protocol and user send windows. These are the configured
+    // windows unless adaptive send window is enabled.
+    seqno_t send_window() const;
+    seqno_t user_send_window() const;
     // Return true if sending the user message contained in dg
     // should make all nodes to respond to the message. This happens
     // if sending the datagram would cause some predefined (@todo name
@@ -207,6 +211,10 @@ public:
     size_t n_operational() const;
 
     void validate_reg_msg(const UserMessage&);
+    // Adjust adaptive send window after own message with given
+    // safe delivery latency (negative if unknown) has been delivered.
+    void adjust_send_window(const UserMessage&, double lat);
+    void reset_send_window_epoch();
     void deliver_finish(const InputMapMsg&);
     void deliver();
     void deliver_local(bool trans = false);
@@ -508,10 +516,30 @@ private:
     int64_t fifo_seq_;
     // Last sent seq
     seqno_t last_sent_;
+    // Lower bounds for send windows, parsed once from defaults
+    const seqno_t send_window_min_;
+    const seqno_t user_send_window_min_;
     // Protocol send window size
     seqno_t send_window_;
     // User send window size
     seqno_t user_send_window_;
+    // Adaptive send window. The window is halved if message loss was
+    // detected during the last epoch (the time it took to deliver one
+    // window of own messages), decreased by 1/8 if safe delivery latency
+    // has grown to more than twice the base latency and increased by one
+    // if sending was limited by the window. The base latency is the
+    // lowest smoothed latency seen during the previous base period of
+    // epochs, so that the window recovers if the network latency grows
+    // permanently.
+    bool    adaptive_send_window_;
+    seqno_t adaptive_win_;
+    seqno_t adaptive_epoch_end_;  // own seqno which ends the epoch
+    size_t  adaptive_losses_;     // losses detected during the epoch
+    bool    adaptive_limited_;    // sending was window limited during epoch
+    double  adaptive_base_lat_;   // base safe delivery latency
+    double  adaptive_period_lat_; // lowest latency during the base period
+    size_t  adaptive_epochs_;     // epochs in the base period
+    double  adaptive_lat_;        // smoothed safe delivery latency
     // Bytes since the last user msg which will require feedback from
     // other nodes (i.e. sent without F_MSG_MORE)
     size_t bytes_since_request_user_msg_feedback_;
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2019 Codership Oy <info@codership.com>
+// Copyright (C) 2019-2026 Codership Oy <info@codership.com>
 //
 
 /**
@@ -18,6 +18,7 @@
 
 #include <deque>
 #include <map>
+#include <vector>
 
 namespace gcomm
 {
@@ -56,6 +57,56 @@ namespace gcomm
             return i->second.front();
         }
 
+        /* Append to dgs pointers to datagrams from the front of the queue
+         * in the order they would be popped, up to max_count datagrams
+         * and max_bytes bytes, and their segments to segments. At least one
+         * datagram is appended if the queue is not empty. Datagrams stay
+         * in the queue and pointers remain valid until the datagram is
+         * popped. Datagrams pushed in the meantime may change the round
+         * robin order, so the batch must be popped with pop_front(segment).
+         * Return number of bytes in the appended datagrams. */
+        size_t front(std::vector<const gcomm::Datagram*>& dgs,
+                     std::vector<int>& segments,
+                     size_t max_count, size_t max_bytes) const
+        {
+            size_t bytes(0);
+            int segment(current_segment_);
+
+            // Fast path for single segment
+            if (queue_.size() == 1 && segment != -1)
+            {
+                const std::deque<gcomm::Datagram>& dq(queue_.begin()->second);
+                for (std::deque<gcomm::Datagram>::const_iterator
+                         i(dq.begin()); i != dq.end() && max_count > 0;
+                     ++i, --max_count)
+                {
+                    if (bytes > 0 && bytes + i->len() > max_bytes) break;
+                    dgs.push_back(&(*i));
+                    segments.push_back(segment);
+                    bytes += i->len();
+                }
+                return bytes;
+            }
+
+            // Number of datagrams taken from each segment
+            std::map<int, size_t> taken;
+            while (segment != -1 && max_count > 0)
+            {
+                const std::deque<gcomm::Datagram>& dq(
+                    queue_.find(segment)->second);
+                size_t& n(taken[segment]);
+                const gcomm::Datagram& dg(dq[n]);
+                if (bytes > 0 && bytes + dg.len() > max_bytes) break;
+                dgs.push_back(&dg);
+                segments.push_back(segment);
+                bytes += dg.len();
+                ++n;
+                --max_count;
+                segment = get_next_segment(segment, taken);
+            }
+            return bytes;
+        }
+
         /* Return reference to back datagram. */
         const gcomm::Datagram& back() const
         {
@@ -77,6 +128,17 @@ namespace gcomm
             current_segment_ = get_next_segment();
         }
 
+        /* Pop front element of the segment queue, continue round robin
+         * from that segment. Return length of the popped datagram. */
+        size_t pop_front(int segment)
+        {
+            assert(queue_.find(segment) != queue_.end());
+            current_segment_ = segment;
+            size_t const len(queue_[segment].front().len());
+            pop_front();
+            return len;
+        }
+
         /* Return true if queue is empty. */
         bool empty() const
         {
@@ -112,6 +174,25 @@ namespace gcomm
             return ret;
         }
     private:
+        /* Round robin as in get_next_segment(), skipping datagrams
+         * already taken from segment queues. */
+        int get_next_segment(int const current,
+                             std::map<int, size_t>& taken) const
+        {
+            queue_type::const_iterator i(queue_.find(current));
+            assert(i != queue_.end());
+            do
+            {
+                ++i;
+                if (i == queue_.end()) i = queue_.begin();
+
+                if (i->second.size() > taken[i->first]) return i->first;
+            }
+            while (i->first != current);
+
+            return -1;
+        }
+
         int get_next_segment() const
         {
             queue_type::const_iterator i(queue_.find(current_segment_));
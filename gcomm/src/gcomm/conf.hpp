@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 /*!
@@ -73,6 +73,33 @@ namespace gcomm
          */
         static std::string const SocketSendBufSize;
 
+        /*!
+         * @brief Number of threads running socket I/O ("socket.io_threads")
+         *
+         * If greater than zero, reading, decrypting and checksumming of
+         * TCP socket data is done by a pool of I/O threads, with handlers
+         * of each socket serialized by a strand. Received messages are
+         * handed over to the protonet thread for protocol processing.
+         * Zero (default) runs all I/O in the protonet thread.
+         *
+         * The pool pays off only when there are spare cores and per-byte
+         * socket work is heavy (SSL, checksums). On a single core it only
+         * adds a hand-off between threads and lowers throughput, which is
+         * why it is disabled by default.
+         */
+        static std::string const SocketIoThreads;
+
+        /*!
+         * @brief Maximum number of bytes read by socket I/O threads but not
+         *        yet processed by protonet thread, per socket
+         *        ("socket.io_pending_max")
+         *
+         * Reading of a socket pauses when the limit is exceeded and resumes
+         * when less than half of it is pending. Used only if
+         * socket.io_threads is greater than zero. Range [64K, 4G).
+         */
+        static std::string const SocketIoPendingMax;
+
         /*!
          * @brief GMCast scheme for transport URI ("gmcast")
          */
@@ -291,6 +318,16 @@ namespace gcomm
          */
         static std::string const EvsUserSendWindow;
 
+        /*!
+         * @brief EVS adaptive send window ("evs.adaptive_send_window")
+         *
+         * When enabled, the effective send windows are adjusted at runtime
+         * according to observed message loss and safe delivery latency.
+         * Conf::EvsSendWindow and Conf::EvsUserSendWindow then act as
+         * upper limits. Disabled by default.
+         */
+        static std::string const EvsAdaptiveSendWindow;
+
         /*!
          * @brief EVS message aggregation mode ("evs.use_aggregate")
          *
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2013 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef GCOMM_DATAGRAM_HPP
@@ -155,6 +155,7 @@ namespace gcomm
             header_       (),
             header_offset_(header_size_),
             payload_      (new gu::Buffer()),
+            payload_begin_(0),
             offset_       (0)
         { }
         /*!
@@ -171,6 +172,7 @@ namespace gcomm
             header_       (),
             header_offset_(header_size_),
             payload_      (new gu::Buffer(buf)),
+            payload_begin_(0),
             offset_       (offset)
         {
             assert(offset_ <= payload_->size());
@@ -181,6 +183,7 @@ namespace gcomm
             header_       (),
             header_offset_(header_size_),
             payload_      (buf),
+            payload_begin_(0),
             offset_       (offset)
         {
             assert(offset_ <= payload_->size());
@@ -200,6 +203,7 @@ namespace gcomm
             // header_(dgram.header_),
             header_offset_(dgram.header_offset_),
             payload_(dgram.payload_),
+            payload_begin_(dgram.payload_begin_),
             offset_(off == std::numeric_limits<size_t>::max() ? dgram.offset_ : off)
         {
             assert(offset_ <= dgram.len());
@@ -216,8 +220,9 @@ namespace gcomm
         void normalize()
         {
             const gu::SharedBuffer old_payload(payload_);
+            const size_t old_size(payload_size());
             payload_ = gu::SharedBuffer(new gu::Buffer);
-            payload_->reserve(header_len() + old_payload->size() - offset_);
+            payload_->reserve(header_len() + old_size - offset_);
 
             if (header_len() > offset_)
             {
@@ -233,8 +238,26 @@ namespace gcomm
             header_offset_ = header_size_;
             payload_->insert(payload_->end(),
                              old_payload->begin()
-                             + gu::Buffer::difference_type(offset_),
+                             + gu::Buffer::difference_type(payload_begin_ +
+                                                           offset_),
                              old_payload->end());
+            payload_begin_ = 0;
+            offset_ = 0;
+        }
+
+        /*!
+         * @brief Drop the bytes in front of offset() without copying payload.
+         *
+         * Unlike normalize() the payload buffer stays shared, only the part
+         * of it which is sent is narrowed. This allows forwarding received
+         * datagrams with a new header.
+         *
+         * @note Header must be empty.
+         */
+        void trim()
+        {
+            assert(header_len() == 0);
+            payload_begin_ += offset_;
             offset_ = 0;
         }
 
@@ -263,9 +286,20 @@ namespace gcomm
             return *payload_;
         }
 
+        /*! Start of the payload part which is sent, see trim() */
+        const gu::byte_t* payload_data() const
+        {
+            return (payload_->data() + payload_begin_);
+        }
+
+        size_t payload_size() const
+        {
+            return (payload_->size() - payload_begin_);
+        }
+
         size_t len() const
         {
-            return (header_size_ - header_offset_ + payload_->size());
+            return (header_size_ - header_offset_ + payload_size());
         }
 
         size_t offset() const { return offset_; }
@@ -279,6 +313,7 @@ namespace gcomm
         gu::byte_t          header_[header_size_];
         size_t              header_offset_;
         gu::SharedBuffer    payload_;
+        size_t              payload_begin_; // trimmed off payload bytes
         size_t              offset_;
     };
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2012 Codership Oy <info@codership.com>
+ * Copyright (C) 2012-2026 Codership Oy <info@codership.com>
  */
 
 #ifndef _GCOMM_UTIL_HPP_
@@ -80,13 +80,13 @@ namespace gcomm
     {
         return (dg.offset() < dg.header_len() ?
                 dg.header() + dg.header_offset() + dg.offset() :
-                dg.payload().data() + (dg.offset() - dg.header_len()));
+                dg.payload_data() + (dg.offset() - dg.header_len()));
     }
     inline size_t available(const Datagram& dg)
     {
         return (dg.offset() < dg.header_len() ?
                 dg.header_len() - dg.offset() :
-                dg.payload().size() - (dg.offset() - dg.header_len()));
+                dg.payload_size() - (dg.offset() - dg.header_len()));
     }
 
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "gmcast.hpp"
@@ -106,6 +106,7 @@ gcomm::GMCast::GMCast(Protonet& net, const gu::URI& uri,
     proto_map_    (new ProtoMap()),
     relay_set_    (),
     segment_map_  (),
+    relay_stats_  (),
     self_index_   (std::numeric_limits<size_t>::max()),
     time_wait_    (param<gu::datetime::Period>(
                        conf_, uri,
@@ -1312,26 +1313,47 @@ gu::datetime::Date gcomm::GMCast::handle_timers()
 }
 
 
-void gcomm::GMCast::send(const RelayEntry& re, int segment, gcomm::Datagram& dg)
+bool gcomm::GMCast::send(const RelayEntry& re, int segment, gcomm::Datagram& dg)
 {
     int err;
     if ((err = re.socket->send(segment, dg)) != 0)
     {
         log_debug << "failed to send to " << re.socket->remote_addr()
                   << ": (" << err << ") " << strerror(err);
+        return false;
     }
     else if (re.proto)
     {
         re.proto->set_send_tstamp(gu::datetime::Date::monotonic());
     }
+    return true;
 }
 
+void gcomm::GMCast::account_relay(uint8_t const segment,
+                                  size_t const msgs,
+                                  size_t const bytes,
+                                  const gu::datetime::Date& recv_tstamp)
+{
+    if (msgs == 0) return;
+
+    RelayStats& stats(relay_stats_[segment]);
+    stats.msgs  += msgs;
+    stats.bytes += bytes;
+    stats.latency.insert(
+        double((gu::datetime::Date::monotonic() - recv_tstamp).get_nsecs())
+        / gu::datetime::Sec);
+}
+
+// Received payload is forwarded as is without unserializing it, only
+// gmcast header is rewritten. Payload buffer is shared by all the relay
+// targets and local delivery.
 void gcomm::GMCast::relay(const Message& msg,
                           const Datagram& dg,
-                          const void* exclude_id)
+                          const void* exclude_id,
+                          const gu::datetime::Date& recv_tstamp)
 {
     Datagram relay_dg(dg);
-    relay_dg.normalize();
+    relay_dg.trim();
     Message relay_msg(msg);
 
     // reset all relay flags from message to be relayed
@@ -1347,18 +1369,25 @@ void gcomm::GMCast::relay(const Message& msg,
              segment_i != segment_map_.end(); ++segment_i)
         {
             Segment& segment(segment_i->second);
+            size_t sent(0);
             for (Segment::iterator target_i(segment.begin());
                  target_i != segment.end(); ++target_i)
             {
-                if ((*target_i).socket->id() != exclude_id)
+                if ((*target_i).socket->id() != exclude_id &&
+                    send(*target_i, msg.segment_id(), relay_dg))
                 {
-                    send(*target_i, msg.segment_id(), relay_dg);
+                    ++sent;
                 }
             }
+            account_relay(segment_i->first, sent, sent * relay_dg.len(),
+                          recv_tstamp);
         }
     }
     else if (msg.flags() & Message::F_SEGMENT_RELAY)
     {
+        size_t sent(0);
+        size_t bytes(0);
+
         if (relay_set_.empty() == false)
         {
             // send message to all nodes in relay set to reach
@@ -1368,9 +1397,11 @@ void gcomm::GMCast::relay(const Message& msg,
             for (RelaySet::iterator relay_i(relay_set_.begin());
                  relay_i != relay_set_.end(); ++relay_i)
             {
-                if ((*relay_i).socket->id() != exclude_id)
+                if ((*relay_i).socket->id() != exclude_id &&
+                    send(*relay_i, msg.segment_id(), relay_dg))
                 {
-                    send(*relay_i, msg.segment_id(), relay_dg);
+                    ++sent;
+                    bytes += relay_dg.len();
                 }
             }
             gu_trace(pop_header(relay_msg, relay_dg));
@@ -1388,8 +1419,13 @@ void gcomm::GMCast::relay(const Message& msg,
         Segment& segment(segment_map_[segment_]);
         for (Segment::iterator i(segment.begin()); i != segment.end(); ++i)
         {
-            send(*i, msg.segment_id(), relay_dg);
+            if (send(*i, msg.segment_id(), relay_dg))
+            {
+                ++sent;
+                bytes += relay_dg.len();
+            }
         }
+        account_relay(segment_, sent, bytes, recv_tstamp);
     }
     else
     {
@@ -1484,14 +1520,15 @@ void gcomm::GMCast::handle_up(const void*        id,
                 {
                     return;
                 }
+                const gu::datetime::Date now(gu::datetime::Date::monotonic());
                 if (msg.flags() &
                     (Message::F_RELAY | Message::F_SEGMENT_RELAY))
                 {
                     relay(msg,
                           Datagram(dg, dg.offset() + msg.serial_size()),
-                          id);
+                          id, now);
                 }
-                p->set_recv_tstamp(gu::datetime::Date::monotonic());
+                p->set_recv_tstamp(now);
                 send_up(Datagram(dg, dg.offset() + msg.serial_size()),
                         ProtoUpMeta(msg.source_uuid()));
                 return;
@@ -1798,6 +1835,25 @@ std::string gcomm::GMCast::handle_get_address(const UUID& uuid) const
     return (ali == remote_addrs_.end() ? "" : AddrList::key(ali));
 }
 
+// Relay statistics are reported as comma separated segment:value lists,
+// latency as min/avg/max/stddev/count in seconds.
+void gcomm::GMCast::handle_get_status(gu::Status& status) const
+{
+    std::ostringstream msgs, bytes, latency;
+    for (RelayStatsMap::const_iterator i(relay_stats_.begin());
+         i != relay_stats_.end(); ++i)
+    {
+        const char* const sep(i == relay_stats_.begin() ? "" : ",");
+        int const segment(i->first);
+        msgs    << sep << segment << ":" << i->second.msgs;
+        bytes   << sep << segment << ":" << i->second.bytes;
+        latency << sep << segment << ":" << i->second.latency;
+    }
+    status.insert("gmcast_relay_msgs", msgs.str());
+    status.insert("gmcast_relay_bytes", bytes.str());
+    status.insert("gmcast_relay_latency", latency.str());
+}
+
 void gcomm::GMCast::add_or_del_addr(const std::string& val)
 {
     if (val.compare(0, 4, "add:") == 0)
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 /*
@@ -16,6 +16,7 @@
 #include "gcomm/transport.hpp"
 #include "gcomm/types.hpp"
 
+#include "gu_stats.hpp"
 
 #include <set>
 
@@ -45,6 +46,7 @@ namespace gcomm
         void handle_stable_view(const View& view);
         void handle_evict(const UUID& uuid);
         std::string handle_get_address(const UUID& uuid) const;
+        void handle_get_status(gu::Status& status) const;
         bool set_param(const std::string& key, const std::string& val,
                        Protolay::sync_param_cb_t& sync_param_cb);
         // Transport interface
@@ -206,13 +208,27 @@ namespace gcomm
                 return (socket < other.socket);
             }
         };
-        void send(const RelayEntry&, int segment, gcomm::Datagram& dg);
+        // Returns true if datagram was handed over to socket
+        bool send(const RelayEntry&, int segment, gcomm::Datagram& dg);
         typedef std::set<RelayEntry> RelaySet;
         RelaySet relay_set_;
 
         typedef std::vector<RelayEntry> Segment;
         typedef std::map<uint8_t, Segment> SegmentMap;
         SegmentMap segment_map_;
+
+        // Relayed traffic per target segment
+        struct RelayStats
+        {
+            RelayStats() : msgs(0), bytes(0), latency() { }
+            long long msgs;
+            long long bytes;
+            gu::Stats latency; // from receiving to handing over to sockets
+        };
+        typedef std::map<uint8_t, RelayStats> RelayStatsMap;
+        RelayStatsMap relay_stats_;
+        void account_relay(uint8_t segment, size_t msgs, size_t bytes,
+                           const gu::datetime::Date& recv_tstamp);
         // self index in local segment when ordered by UUID
         size_t self_index_;
         gu::datetime::Period time_wait_;
@@ -291,7 +307,8 @@ namespace gcomm
         //
         void check_liveness();
         void relay(const gmcast::Message& msg, const Datagram& dg,
-                   const void* exclude_id);
+                   const void* exclude_id,
+                   const gu::datetime::Date& recv_tstamp);
         // Reconnecting
         void reconnect();
 
@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+// Copyright (C) 2009-2026 Codership Oy <info@codership.com>
 //
 
 //!
@@ -43,13 +43,19 @@ namespace gcomm
         long send_queue_length;    /** Number of messaged pending for send. */
         long send_queue_bytes;     /** Number of bytes in send queue.       */
         std::vector<std::pair<int, size_t> > send_queue_segments;
+        long send_datagrams;       /** Number of datagrams written.         */
+        long send_writes;          /** Number of batched write operations. */
+        long send_syscalls;        /** Number of socket write calls.        */
         socket_stats_st() : rtt(), rttvar(), rto(), lost(), last_data_recv(),
                             cwnd(),
                             last_queued_since(),
                             last_delivered_since(),
                             send_queue_length(),
                             send_queue_bytes(),
-                            send_queue_segments()
+                            send_queue_segments(),
+                            send_datagrams(),
+                            send_writes(),
+                            send_syscalls()
         { }
     } SocketStats;
     static inline
@@ -70,6 +76,12 @@ namespace gcomm
         {
             os << " segment: " << i->first << " messages: " << i->second;
         }
+        os << " send_datagrams: " << stats.send_datagrams
+           << " send_writes: " << stats.send_writes
+           << " send_syscalls: " << stats.send_syscalls
+           << " datagrams_per_write: "
+           << (stats.send_writes > 0 ?
+               double(stats.send_datagrams) / stats.send_writes : 0.0);
         return os;
     }
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 /*!
@@ -331,6 +331,84 @@ START_TEST(test_input_map_overwrap)
 END_TEST
 
 
+START_TEST(test_input_map_recovery)
+{
+    log_info << "START";
+    InputMap im;
+    const size_t n_nodes(3);
+    ViewId view(V_REG, UUID(1), 1);
+    vector<UUID> uuids;
+    for (size_t n = 0; n < n_nodes; ++n)
+    {
+        uuids.push_back(UUID(static_cast<int32_t>(n + 1)));
+    }
+
+    im.reset(n_nodes);
+
+    // Fill enough seqnos to make the index grow several times, erase
+    // messages of node 1 while iterating
+    const seqno_t n_seqnos(1000);
+    for (seqno_t seq = 0; seq < n_seqnos; ++seq)
+    {
+        for (size_t i = 0; i < n_nodes; ++i)
+        {
+            (void)im.insert(i, UserMessage(0, uuids[i], view, seq));
+        }
+    }
+
+    InputMap::iterator i, i_next;
+    size_t n(0);
+    for (i = im.begin(); i != im.end(); i = i_next)
+    {
+        i_next = i;
+        ++i_next;
+        ck_assert(InputMapMsgIndex::key(i).seq() == seqno_t(n / n_nodes));
+        ck_assert(InputMapMsgIndex::key(i).index() == n % n_nodes);
+        if (InputMapMsgIndex::key(i).index() == 1) im.erase(i);
+        ++n;
+    }
+    ck_assert(n == n_seqnos*n_nodes);
+
+    // Erased messages can be recovered until they become safe
+    for (size_t j = 0; j < n_nodes; ++j)
+    {
+        im.set_safe_seq(j, n_seqnos/2 - 1);
+    }
+
+    for (seqno_t seq = 0; seq < n_seqnos; ++seq)
+    {
+        ck_assert(im.find(1, seq) == im.end());
+        try
+        {
+            i = im.recover(1, seq);
+            ck_assert_msg(seq >= n_seqnos/2, "recovered safe seq %lld",
+                          static_cast<long long>(seq));
+            ck_assert(InputMapMsgIndex::value(i).msg().seq() == seq);
+        }
+        catch (gu::Exception&)
+        {
+            ck_assert_msg(seq < n_seqnos/2, "failed to recover seq %lld",
+                          static_cast<long long>(seq));
+        }
+        ck_assert(im.find(0, seq) != im.end());
+        ck_assert(im.find(2, seq) != im.end());
+    }
+
+    // Delivering the rest keeps seqnos of other nodes in order
+    seqno_t prev(-1);
+    while ((i = im.begin()) != im.end() && im.is_safe(i) == true)
+    {
+        ck_assert(InputMapMsgIndex::key(i).seq() >= prev);
+        prev = InputMapMsgIndex::key(i).seq();
+        im.erase(i);
+    }
+    ck_assert(prev == n_seqnos/2 - 1);
+    ck_assert(i != im.end());
+    ck_assert(InputMapMsgIndex::key(i).seq() == n_seqnos/2);
+}
+END_TEST
+
+
 class InputMapInserter
 {
 public:
@@ -2508,6 +2586,154 @@ START_TEST(test_out_queue_limit)
 }
 END_TEST
 
+//
+// Adaptive send window simulation. Each propagation step takes one
+// millisecond of simulated time, so that channel latency and queueing
+// translate to safe delivery latency.
+//
+
+static void adaptive_send_round(PropagationMatrix& prop,
+                                const vector<DummyNode*>& dn,
+                                size_t const n_msgs,
+                                size_t const n_steps)
+{
+    for (size_t i(0); i < dn.size(); ++i)
+    {
+        gu_trace(send_n(dn[i], n_msgs));
+    }
+    for (size_t i(0); i < n_steps; ++i)
+    {
+        gu_trace(prop.propagate_n(1));
+        gu::datetime::SimClock::inc_time(gu::datetime::MSec);
+    }
+    gu_trace(prop.propagate_until_empty());
+    // Retransmission timers recover lost messages
+    for (size_t i(0); i < dn.size(); ++i)
+    {
+        gu_trace(dn[i]->handle_timers());
+    }
+    gu_trace(prop.propagate_until_empty());
+}
+
+// Keep sending faster than the window allows until the window has grown
+// to maximum. Messages are delivered without delay to avoid queueing
+// latency, time passes between rounds to let the lost messages to be
+// requested again.
+static void adaptive_grow_window(PropagationMatrix& prop,
+                                 const vector<DummyNode*>& dn,
+                                 seqno_t const max_win)
+{
+    Proto* evs0(evs_from_dummy(dn[0]));
+    for (size_t i(0); i < 200 && evs0->send_window() < max_win; ++i)
+    {
+        gu_trace(adaptive_send_round(prop, dn, 16, 0));
+        gu::datetime::SimClock::inc_time(100*gu::datetime::MSec);
+    }
+    ck_assert_msg(evs0->send_window() == max_win, "window %lld",
+                  static_cast<long long>(evs0->send_window()));
+}
+
+static void set_adaptive_latency(PropagationMatrix& prop, size_t n_nodes,
+                                 size_t latency)
+{
+    for (size_t i(1); i <= n_nodes; ++i)
+    {
+        for (size_t j(1); j <= n_nodes; ++j)
+        {
+            if (i != j) prop.set_latency(i, j, latency);
+        }
+    }
+}
+
+START_TEST(test_adaptive_send_window)
+{
+    log_info << "START (adaptive_send_window)";
+    init_rand();
+
+    const size_t n_nodes(3);
+    PropagationMatrix prop;
+    vector<DummyNode*> dn;
+    Protolay::sync_param_cb_t sync_param_cb;
+
+    for (size_t i = 1; i <= n_nodes; ++i)
+    {
+        gu_trace(dn.push_back(create_dummy_node(i, 0, "PT10S", "PT20S",
+                                                "PT0.1S")));
+    }
+
+    for (size_t i = 0; i < n_nodes; ++i)
+    {
+        gu_trace(join_node(&prop, dn[i], i == 0 ? true : false));
+        set_cvi(dn, 0, i, i + 1);
+        gu_trace(prop.propagate_until_cvi(false));
+    }
+
+    for (size_t i = 0; i < n_nodes; ++i)
+    {
+        ck_assert(evs_from_dummy(dn[i])->set_param(
+                      Conf::EvsAdaptiveSendWindow, "true", sync_param_cb));
+    }
+    Proto* evs0(evs_from_dummy(dn[0]));
+    const seqno_t max_win(gu::from_string<seqno_t>(
+                              gu_conf.get(Conf::EvsSendWindow)));
+    ck_assert(evs0->send_window() == max_win);
+
+    // Light load with stable latency keeps the window at maximum
+    for (size_t i(0); i < 50; ++i)
+    {
+        gu_trace(adaptive_send_round(prop, dn, 2, 20));
+    }
+    ck_assert_msg(evs0->send_window() == max_win, "window %lld",
+                  static_cast<long long>(evs0->send_window()));
+
+    // Tenfold latency must shrink the window
+    set_adaptive_latency(prop, n_nodes, 10);
+    seqno_t min_seen(max_win);
+    for (size_t i(0); i < 20; ++i)
+    {
+        gu_trace(adaptive_send_round(prop, dn, 2, 100));
+        min_seen = std::min(min_seen, evs0->send_window());
+    }
+    ck_assert_msg(min_seen < max_win, "window %lld",
+                  static_cast<long long>(min_seen));
+    set_adaptive_latency(prop, n_nodes, 1);
+    gu_trace(adaptive_grow_window(prop, dn, max_win));
+
+    // Message loss must shrink the window
+    prop.set_loss(1, 2, 0.8);
+    prop.set_loss(1, 3, 0.8);
+    min_seen = max_win;
+    for (size_t i(0); i < 20; ++i)
+    {
+        gu_trace(adaptive_send_round(prop, dn, 2, 20));
+        min_seen = std::min(min_seen, evs0->send_window());
+    }
+    ck_assert_msg(min_seen <= max_win / 2, "window %lld",
+                  static_cast<long long>(min_seen));
+    prop.set_loss(1, 2, 1.);
+    prop.set_loss(1, 3, 1.);
+
+    // Window grows back when loss goes away
+    gu_trace(adaptive_grow_window(prop, dn, max_win));
+
+    gu::Status status;
+    evs0->handle_get_status(status);
+    bool found(false);
+    for (gu::Status::const_iterator i(status.begin()); i != status.end(); ++i)
+    {
+        if (i->first == "evs_send_window")
+        {
+            ck_assert(i->second == gu::to_string(max_win));
+            found = true;
+        }
+    }
+    ck_assert(found);
+
+    gu_trace(check_trace(dn));
+    for_each(dn.begin(), dn.end(), DeleteObject());
+}
+END_TEST
+
 Suite* evs2_suite()
 {
     Suite* s = suite_create("gcomm::evs");
@@ -2542,6 +2768,10 @@ Suite* evs2_suite()
     tcase_set_timeout(tc, 60);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_input_map_recovery");
+    tcase_add_test(tc, test_input_map_recovery);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("test_input_map_random_insert");
     tcase_add_test(tc, test_input_map_random_insert);
     suite_add_tcase(s, tc);
@@ -2695,5 +2925,10 @@ Suite* evs2_suite()
     tcase_add_test(tc, test_out_queue_limit);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_adaptive_send_window");
+    tcase_add_test(tc, test_adaptive_send_window);
+    tcase_set_timeout(tc, 30);
+    suite_add_tcase(s, tc);
+
     return s;
 }
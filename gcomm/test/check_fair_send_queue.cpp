@@ -1,5 +1,5 @@
 //
-// Copyright (C) 2019-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2019-2026 Codership Oy <info@codership.com>
 //
 
 #include "check_gcomm.hpp"
@@ -164,6 +164,85 @@ START_TEST(test_queued_bytes)
 }
 END_TEST
 
+START_TEST(test_front_batch)
+{
+    gcomm::FairSendQueue fsq;
+    std::vector<const gcomm::Datagram*> dgs;
+    std::vector<int> segs;
+    ck_assert(fsq.front(dgs, segs, 10, 100) == 0);
+    ck_assert(dgs.empty());
+
+    fsq.push_back(0, make_datagram(1));
+    fsq.push_back(0, make_datagram(2));
+    fsq.push_back(0, make_datagram(3));
+
+    // single segment, limited by count
+    ck_assert(fsq.front(dgs, segs, 2, 100) == 4);
+    ck_assert(dgs.size() == 2);
+    ck_assert(get_header(*dgs[0]) == 1);
+    ck_assert(get_header(*dgs[1]) == 2);
+
+    // limited by bytes, but at least one datagram
+    dgs.clear();
+    segs.clear();
+    ck_assert(fsq.front(dgs, segs, 10, 1) == 2);
+    ck_assert(dgs.size() == 1);
+    ck_assert(get_header(*dgs[0]) == 1);
+
+    // segments are taken in the same order as popped
+    fsq.push_back(1, make_datagram(4));
+    fsq.push_back(1, make_datagram(5));
+    fsq.push_back(2, make_datagram(6));
+    dgs.clear();
+    segs.clear();
+    ck_assert(fsq.front(dgs, segs, 10, 100) == 12);
+    ck_assert(dgs.size() == 6);
+    ck_assert(segs.size() == 6);
+    ck_assert(fsq.size() == 6);
+    for (size_t i(0); i < dgs.size(); ++i)
+    {
+        ck_assert(get_header(*dgs[i]) == get_header(fsq.front()));
+        fsq.pop_front();
+    }
+    ck_assert(fsq.empty());
+}
+END_TEST
+
+// Datagrams pushed to a new segment while a batch is being written
+// must not change which datagrams get popped for the batch.
+START_TEST(test_front_batch_push_in_flight)
+{
+    gcomm::FairSendQueue fsq;
+    fsq.push_back(0, make_datagram(1));
+    fsq.push_back(0, make_datagram(2));
+    fsq.push_back(2, make_datagram(3));
+    fsq.push_back(2, make_datagram(4));
+
+    std::vector<const gcomm::Datagram*> dgs;
+    std::vector<int> segs;
+    ck_assert(fsq.front(dgs, segs, 10, 100) == 8);
+    ck_assert(dgs.size() == 4);
+    ck_assert(get_header(*dgs[0]) == 1);
+    ck_assert(get_header(*dgs[1]) == 3);
+    ck_assert(get_header(*dgs[2]) == 2);
+    ck_assert(get_header(*dgs[3]) == 4);
+
+    // segment 1 gets between segments 0 and 2 in round robin order
+    fsq.push_back(1, make_datagram(5));
+
+    for (size_t i(0); i < segs.size(); ++i)
+    {
+        ck_assert(fsq.pop_front(segs[i]) == 2);
+    }
+
+    ck_assert(fsq.size() == 1);
+    ck_assert(fsq.queued_bytes() == 2);
+    ck_assert(get_header(fsq.front()) == 5);
+    fsq.pop_front();
+    ck_assert(fsq.empty());
+}
+END_TEST
+
 
 Suite* fair_send_queue_suite()
 {
@@ -210,6 +289,14 @@ Suite* fair_send_queue_suite()
     tcase_add_test(tc, test_push_pop_interleaving);
     suite_add_tcase(ret, tc);
 
+    tc = tcase_create("test_front_batch");
+    tcase_add_test(tc, test_front_batch);
+    suite_add_tcase(ret, tc);
+
+    tc = tcase_create("test_front_batch_push_in_flight");
+    tcase_add_test(tc, test_front_batch_push_in_flight);
+    suite_add_tcase(ret, tc);
+
     tc = tcase_create("test_queued_bytes");
     tcase_add_test(tc, test_queued_bytes);
     suite_add_tcase(ret, tc);
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "check_gcomm.hpp"
@@ -43,7 +43,7 @@ START_TEST(test_gmcast_multicast)
 END_TEST
 
 
-START_TEST(test_gmcast_w_user_messages)
+static void gmcast_w_user_messages(int const io_threads)
 {
     class User : public Toplay
     {
@@ -156,6 +156,9 @@ START_TEST(test_gmcast_w_user_messages)
     gu::Config conf;
     gu::ssl_register_params(conf);
     gcomm::Conf::register_params(conf);
+    conf.set(gcomm::Conf::SocketIoThreads, io_threads);
+    // smallest limit to have reading paused and resumed more often
+    conf.set(gcomm::Conf::SocketIoPendingMax, "64K");
     mark_point();
     auto_ptr<Protonet> pnet(Protonet::create(conf));
     mark_point();
@@ -247,7 +250,186 @@ START_TEST(test_gmcast_w_user_messages)
     u4.stop();
 
     pnet->event_loop(0);
+}
+
+START_TEST(test_gmcast_w_user_messages)
+{
+    gmcast_w_user_messages(0);
+}
+END_TEST
+
+START_TEST(test_gmcast_w_user_messages_io_threads)
+{
+    gmcast_w_user_messages(2);
+}
+END_TEST
+
+
+// Sender in segment 0, two receivers in segment 1: messages reach
+// segment 1 via a single F_SEGMENT_RELAY target which forwards them
+// to the other receiver.
+class RelayUser : public Toplay
+{
+    Transport* tp_;
+    size_t     recvd_;
+    uint32_t   seq_;
+    Protostack pstack_;
+    RelayUser(const RelayUser&);
+    void operator=(const RelayUser&);
+
+public:
+
+    static size_t const payload_len = 64;
+
+    RelayUser(Protonet& pnet, int const segment,
+              const std::string& remote_addr) :
+        Toplay(pnet.conf()),
+        tp_(0),
+        recvd_(0),
+        seq_(0),
+        pstack_()
+    {
+        std::ostringstream uri;
+        uri << "gmcast://" << remote_addr
+            << "?tcp.non_blocking=1"
+            << "&gmcast.group=testgrp"
+            << "&gmcast.time_wait=PT0.5S"
+            << "&gmcast.segment=" << segment
+            << "&gmcast.listen_addr=tcp://127.0.0.1:0";
+        tp_ = Transport::create(pnet, uri.str());
+    }
+
+    ~RelayUser() { delete tp_; }
+
+    void start()
+    {
+        tp_->connect();
+        pstack_.push_proto(tp_);
+        pstack_.push_proto(this);
+    }
+
+    void stop()
+    {
+        pstack_.pop_proto(this);
+        pstack_.pop_proto(tp_);
+        tp_->close();
+    }
+
+    void send()
+    {
+        byte_t buf[payload_len];
+        memcpy(buf, &seq_, sizeof(seq_));
+        for (size_t i(sizeof(seq_)); i < payload_len; ++i)
+        {
+            buf[i] = static_cast<byte_t>(seq_ + i);
+        }
+        ++seq_;
+        Datagram dg(Buffer(buf, buf + sizeof(buf)));
+        send_down(dg, ProtoDownMeta());
+    }
+
+    void handle_up(const void* cid, const Datagram& rb,
+                   const ProtoUpMeta& um)
+    {
+        ck_assert_msg(rb.len() - rb.offset() == payload_len,
+                      "payload length %zu", rb.len() - rb.offset());
+        const byte_t* const p(&rb.payload()[0] + rb.offset());
+        uint32_t seq;
+        memcpy(&seq, p, sizeof(seq));
+        for (size_t i(sizeof(seq)); i < payload_len; ++i)
+        {
+            ck_assert_msg(p[i] == static_cast<byte_t>(seq + i),
+                          "content mismatch in message %u at %zu", seq, i);
+        }
+        recvd_++;
+    }
+
+    size_t recvd() const { return recvd_; }
+
+    Protostack& pstack() { return pstack_; }
+
+    std::string listen_addr() const
+    {
+        return tp_->listen_addr().erase(0, strlen("tcp://"));
+    }
+
+    // Returns status variable value, empty if not found
+    std::string status(const std::string& key) const
+    {
+        gu::Status status;
+        tp_->get_status(status);
+        for (gu::Status::const_iterator i(status.begin());
+             i != status.end(); ++i)
+        {
+            if (i->first == key) return i->second;
+        }
+        ck_abort_msg("status variable %s not found", key.c_str());
+        return "";
+    }
+
+    // Parses "segment:value" from relay statistics, 0 if segment not found
+    size_t relay_stat(const std::string& key, int const segment) const
+    {
+        std::string const val(status(key));
+        std::ostringstream prefix;
+        prefix << segment << ":";
+        size_t const pos(val.find(prefix.str()));
+        if (pos == std::string::npos) return 0;
+        return gu::from_string<size_t>(
+            val.substr(pos + prefix.str().size(),
+                       val.find(',', pos) - pos - prefix.str().size()));
+    }
+};
+
+START_TEST(test_gmcast_segment_relay)
+{
+    log_info << "START test_gmcast_segment_relay";
+    gu::Config conf;
+    gu::ssl_register_params(conf);
+    gcomm::Conf::register_params(conf);
+    auto_ptr<Protonet> pnet(Protonet::create(conf));
+
+    RelayUser u1(*pnet, 0, "");
+    pnet->insert(&u1.pstack());
+    u1.start();
+    RelayUser u2(*pnet, 1, u1.listen_addr());
+    pnet->insert(&u2.pstack());
+    u2.start();
+    RelayUser u3(*pnet, 1, u1.listen_addr());
+    pnet->insert(&u3.pstack());
+    u3.start();
 
+    // let the mesh form before counting
+    pnet->event_loop(Sec);
+
+    for (size_t i(0); i < 100 && (u2.recvd() < 50 || u3.recvd() < 50); ++i)
+    {
+        u1.send();
+        pnet->event_loop(Sec/10);
+    }
+    ck_assert_msg(u2.recvd() >= 50 && u3.recvd() >= 50,
+                  "recvd u2: %zu u3: %zu", u2.recvd(), u3.recvd());
+
+    // only segment 1 relays, within its own segment
+    ck_assert(u1.status("gmcast_relay_msgs") == "");
+    size_t const msgs(u2.relay_stat("gmcast_relay_msgs", 1) +
+                      u3.relay_stat("gmcast_relay_msgs", 1));
+    size_t const bytes(u2.relay_stat("gmcast_relay_bytes", 1) +
+                       u3.relay_stat("gmcast_relay_bytes", 1));
+    ck_assert_msg(msgs > 0, "no relayed messages");
+    // every relayed datagram carries the full payload plus gmcast header
+    ck_assert_msg(bytes % msgs == 0 && bytes / msgs > RelayUser::payload_len,
+                  "relayed msgs: %zu bytes: %zu", msgs, bytes);
+    ck_assert(u2.status("gmcast_relay_latency") != "" ||
+              u3.status("gmcast_relay_latency") != "");
+
+    pnet->erase(&u3.pstack());
+    pnet->erase(&u2.pstack());
+    pnet->erase(&u1.pstack());
+    u1.stop();
+    u2.stop();
+    u3.stop();
+    pnet->event_loop(0);
 }
 END_TEST
 
@@ -496,6 +678,16 @@ Suite* gmcast_suite()
     tcase_set_timeout(tc, 30);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_gmcast_w_user_messages_io_threads");
+    tcase_add_test(tc, test_gmcast_w_user_messages_io_threads);
+    tcase_set_timeout(tc, 30);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_gmcast_segment_relay");
+    tcase_add_test(tc, test_gmcast_segment_relay);
+    tcase_set_timeout(tc, 30);
+    suite_add_tcase(s, tc);
+
     // not run by default, hard coded port
     tc = tcase_create("test_gmcast_auto_addr");
     tcase_add_test(tc, test_gmcast_auto_addr);
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "gcomm/util.hpp"
@@ -85,6 +85,27 @@ START_TEST(test_datagram)
         ck_assert(dg16.payload()[i + dg16.offset()] == i + 16);
     }
 
+    // Trimming drops data in front of offset without copying payload,
+    // header pushed after that is followed by the rest of the payload
+    gcomm::Datagram dgtrim(dg, 16);
+    dgtrim.trim();
+    ck_assert(dgtrim.offset() == 0);
+    ck_assert(dgtrim.len() == sizeof(b) - 16);
+    ck_assert(&dgtrim.payload() == &dg.payload());
+    ck_assert(dgtrim.payload_data()[0] == 16);
+    dgtrim.set_header_offset(dgtrim.header_size() - 4);
+    memset(dgtrim.header() + dgtrim.header_offset(), 0xff, 4);
+    ck_assert(dgtrim.len() == sizeof(b) - 16 + 4);
+
+    gcomm::Datagram dgnorm(dgtrim);
+    dgnorm.normalize();
+    ck_assert(dgnorm.len() == dgtrim.len());
+    ck_assert(dgnorm.payload()[3] == 0xff);
+    ck_assert(dgnorm.payload()[4] == 16);
+    ck_assert(gcomm::crc32(gcomm::NetHeader::CS_CRC32, dgnorm) ==
+              gcomm::crc32(gcomm::NetHeader::CS_CRC32, dgtrim));
+    ck_assert(dg.len() == sizeof(b));
+
 #if 0
     // Normalize datagram, all data is moved into payload, data from
     // beginning to offset is discarded. Normalization must not change
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2009-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 #include "gcomm/util.hpp"
@@ -21,6 +21,7 @@
 #include <limits>
 #include <cstdlib>
 #include <check.h>
+#include <unistd.h>
 
 using std::vector;
 using std::numeric_limits;
@@ -68,6 +69,89 @@ START_TEST(test_asio)
 
 }
 END_TEST
+
+// Messages received by I/O threads before the peer closes the connection
+// must be dispatched before the socket failure is reported.
+START_TEST(test_asio_close_after_burst)
+{
+    class Counter : public Protolay
+    {
+    public:
+        Counter(gu::Config& conf) : Protolay(conf), msgs_(0), errors_(0) { }
+
+        void handle_up(const void*, const Datagram& dg, const ProtoUpMeta& um)
+        {
+            if (um.err_no() != 0)
+            {
+                ++errors_;
+            }
+            else if (dg.len() > 0) // skip connection notifications
+            {
+                ck_assert_msg(errors_ == 0, "message after socket error");
+                ++msgs_;
+            }
+        }
+
+        int handle_down(Datagram&, const ProtoDownMeta&) { return 0; }
+
+        size_t msgs_;
+        size_t errors_;
+    };
+
+    gu::Config conf;
+    gu::ssl_register_params(conf);
+    gcomm::Conf::register_params(conf);
+    conf.set(gcomm::Conf::SocketIoThreads, 2);
+    AsioProtonet pn(conf);
+
+    Counter counter(conf);
+    Protostack pstack;
+    pstack.push_proto(&counter);
+    pn.insert(&pstack);
+
+    string uri_str("tcp://127.0.0.1:0");
+    Acceptor* acc = pn.acceptor(uri_str);
+    acc->listen(uri_str);
+    uri_str = acc->listen_addr();
+
+    SocketPtr cl = pn.socket(uri_str);
+    cl->connect(uri_str);
+    pn.event_loop(gu::datetime::Sec);
+
+    SocketPtr sr = acc->accept();
+    ck_assert(sr->state() == Socket::S_CONNECTED);
+
+    vector<byte_t> buf(1024, 'x');
+    size_t const burst(1000);
+    for (size_t i = 0; i < burst; ++i)
+    {
+        Datagram dg(Buffer(&buf[0], &buf[0] + buf.size()));
+        cl->send(0, dg);
+    }
+    // closes the connection once the send queue is flushed
+    cl->close();
+    // let I/O threads read the burst and the EOF before anything is
+    // dispatched by the event loop
+    ::usleep(500000);
+
+    for (int i(0); i < 100 && counter.errors_ == 0; ++i)
+    {
+        pn.event_loop(gu::datetime::Sec/10);
+    }
+
+    ck_assert_msg(counter.msgs_ == burst, "received %zu of %zu messages",
+                  counter.msgs_, burst);
+    ck_assert(counter.errors_ == 1);
+    ck_assert(sr->state() == Socket::S_FAILED);
+
+    pn.erase(&pstack);
+    pstack.pop_proto(&counter);
+    sr->close();
+    cl.reset();
+    sr.reset();
+    delete acc;
+}
+END_TEST
 #endif // HAVE_ASIO_HPP
 
 START_TEST(test_protonet)
@@ -94,6 +178,11 @@ Suite* util_nondet_suite()
     tc = tcase_create("test_asio");
     tcase_add_test(tc, test_asio);
     suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_asio_close_after_burst");
+    tcase_add_test(tc, test_asio_close_after_burst);
+    tcase_set_timeout(tc, 30);
+    suite_add_tcase(s, tc);
 #endif // HAVE_ASIO_HPP
 
     tc = tcase_create("test_protonet");
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * EVS input map throughput benchmark.
+ *
+ * Feeds user messages of a view of given size through evs::InputMap the way
+ * evs::Proto does in operational state: nodes take turns in sending and each
+ * message completes the seqnos of its source up to the next turn, so that
+ * every seqno has one message with payload and dropped placeholders from
+ * all other nodes. Safe seqnos trail the received messages by a few rounds,
+ * safe messages are delivered and erased and gap ranges are scanned for
+ * each incoming message. Reported is the number of messages delivered per
+ * second.
+ *
+ * Usage: input_map_bench [messages] [nodes]
+ *
+ * If the number of nodes is not given, the benchmark is run with 3, 8, 16
+ * and 32 nodes.
+ */
+
+#include "evs_input_map2.hpp"
+
+#include "gu_time.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+using namespace gcomm;
+using namespace gcomm::evs;
+
+namespace
+{
+    int const SAFE_LAG = 4; // rounds
+
+    struct Params
+    {
+        long   messages;
+        size_t payload;
+    };
+
+    void
+    run_bench(const Params& p, size_t const n_nodes)
+    {
+        std::vector<UUID> uuids;
+        for (size_t i(0); i < n_nodes; ++i)
+        {
+            uuids.push_back(UUID(static_cast<int32_t>(i + 1)));
+        }
+        ViewId const view(V_REG, uuids[0], 1);
+
+        gu::SharedBuffer const payload(new gu::Buffer(p.payload));
+        Datagram const dg(payload);
+
+        InputMap im;
+        im.reset(n_nodes);
+
+        long delivered(0);
+        long gaps(0);
+        seqno_t seq(0);
+
+        long long const start(gu_time_monotonic());
+
+        while (delivered < p.messages)
+        {
+            for (size_t i(0); i < n_nodes; ++i, ++seq)
+            {
+                /* first message of each node starts from seqno 0 */
+                seqno_t const first(seq < seqno_t(n_nodes) ? 0 : seq);
+                UserMessage const um(0, uuids[i], view, first, im.aru_seq(),
+                                     seq - first + n_nodes - 1, O_SAFE);
+                Range const range(im.insert(i, um, dg));
+                gaps += im.gap_range_list(i, range).size();
+            }
+
+            seqno_t const safe(im.aru_seq() - SAFE_LAG * n_nodes);
+            if (safe < 0) continue;
+
+            for (size_t i(0); i < n_nodes; ++i)
+            {
+                im.set_safe_seq(i, safe);
+            }
+
+            InputMap::iterator i;
+            while ((i = im.begin()) != im.end() && im.is_safe(i))
+            {
+                if (InputMapMsgIndex::value(i).msg().order() != O_DROP)
+                {
+                    ++delivered;
+                }
+                im.erase(i);
+            }
+        }
+
+        double const duration((gu_time_monotonic() - start) * 1.0e-9);
+
+        std::cout << n_nodes << '\t'
+                  << std::fixed << std::setprecision(3) << duration << '\t'
+                  << long(delivered / duration) << '\t'
+                  << gaps << '\n';
+
+        /* deliver the rest to avoid warnings about discarded messages */
+        for (size_t i(0); i < n_nodes; ++i)
+        {
+            im.set_safe_seq(i, im.aru_seq());
+        }
+        InputMap::iterator i;
+        while ((i = im.begin()) != im.end()) im.erase(i);
+    }
+
+    template <typename T>
+    void
+    read_arg(char* argv[], int position, T& var)
+    {
+        std::istringstream is(argv[position]);
+        is >> var;
+        if (is.fail() || var < 1)
+        {
+            std::cerr << "Invalid argument " << position << ": '"
+                      << argv[position] << "'" << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p;
+    p.messages = 1000000;
+    p.payload  = 256;
+    size_t nodes(0);
+
+    if (argc >= 2) read_arg(argv, 1, p.messages);
+    if (argc >= 3) read_arg(argv, 2, nodes);
+
+    if (nodes > 0xff)
+    {
+        std::cerr << "At most 255 nodes are supported" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Messages: " << p.messages << ", payload: " << p.payload
+              << "\n\nNodes:\tDuration:\tMsgs/sec:\tGaps:\n";
+
+    if (nodes > 0)
+    {
+        run_bench(p, nodes);
+    }
+    else
+    {
+        size_t const views[] = { 3, 8, 16, 32 };
+        for (size_t i(0); i < sizeof(views)/sizeof(views[0]); ++i)
+        {
+            run_bench(p, views[i]);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Protonet loopback throughput benchmark.
+ *
+ * Starts three in-process nodes, each with its own protonet and event loop
+ * thread, connected in GMCast full mesh over loopback TCP. Each node sends
+ * the given number of messages to the group from a separate thread, and
+ * the time for all nodes to receive all messages from their peers is
+ * measured. Sending is paced by a window of messages not yet received by
+ * all peers, so that socket send queues do not overflow.
+ *
+ * Usage: protonet_bench [messages] [message size] [io threads]
+ *
+ * If the number of socket I/O threads (socket.io_threads) is not given,
+ * the benchmark is run with 0 (all I/O in event loop thread), 1, 2 and 4
+ * I/O threads per node.
+ */
+
+#include "gcomm/protonet.hpp"
+#include "gcomm/transport.hpp"
+#include "gcomm/conf.hpp"
+#include "gcomm/util.hpp"
+
+#include "gu_asio.hpp" // gu::ssl_register_params()
+#include "gu_atomic.hpp"
+#include "gu_threads.h"
+#include "gu_time.h"
+#include "gu_conf.h"
+#include "gu_crc32c.h" // gu_crc32c_configure()
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace
+{
+    int  const NODES  = 3;
+    long const WINDOW = 64; // messages in flight per node
+
+    struct Params
+    {
+        long   messages;
+        size_t msg_size;
+    };
+
+    class Node : public gcomm::Toplay
+    {
+    public:
+
+        Node(gcomm::Protonet& pnet, int const idx, size_t const msg_size,
+             const std::string& peer)
+            :
+            gcomm::Toplay(pnet.conf()),
+            pnet_   (pnet),
+            idx_    (idx),
+            tp_     (gcomm::Transport::create(
+                         pnet, "gmcast://" + peer +
+                         "?gmcast.group=bench"
+                         "&gmcast.listen_addr=tcp://127.0.0.1:0")),
+            pstack_ (),
+            payload_(new gu::Buffer(msg_size)),
+            running_(1),
+            thd_    ()
+        {
+            for (int i(0); i < NODES; ++i) recvd_[i] = 0;
+            std::fill(payload_->begin(), payload_->end(), gu::byte_t(idx));
+
+            tp_->connect();
+            pstack_.push_proto(tp_);
+            pstack_.push_proto(this);
+            pnet_.insert(&pstack_);
+
+            gu_thread_create(&thd_, NULL, event_loop_thd, this);
+        }
+
+        ~Node()
+        {
+            running_ = 0;
+            pnet_.interrupt();
+            gu_thread_join(thd_, NULL);
+
+            pnet_.erase(&pstack_);
+            pstack_.pop_proto(this);
+            pstack_.pop_proto(tp_);
+            tp_->close();
+            pnet_.event_loop(0);
+            delete tp_;
+        }
+
+        void handle_up(const void*, const gcomm::Datagram& dg,
+                       const gcomm::ProtoUpMeta&)
+        {
+            if (dg.len() > dg.offset())
+            {
+                int const src(*(gcomm::begin(dg)));
+                if (src >= 0 && src < NODES) ++recvd_[src];
+            }
+        }
+
+        void send()
+        {
+            gcomm::Critical<gcomm::Protonet> crit(pnet_);
+            gcomm::Datagram dg(payload_);
+            send_down(dg, gcomm::ProtoDownMeta());
+        }
+
+        long recvd(int const src) { return recvd_[src](); }
+        void reset()
+        {
+            for (int i(0); i < NODES; ++i) recvd_[i] = 0;
+        }
+
+        std::string listen_addr() const
+        {
+            return tp_->listen_addr().erase(0, strlen("tcp://"));
+        }
+
+        int idx() const { return idx_; }
+
+    private:
+
+        Node(const Node&);
+        void operator=(const Node&);
+
+        static void* event_loop_thd(void* arg)
+        {
+            Node* const node(static_cast<Node*>(arg));
+            while (node->running_())
+            {
+                node->pnet_.event_loop(gu::datetime::Sec/10);
+            }
+            return NULL;
+        }
+
+        gcomm::Protonet&     pnet_;
+        int const            idx_;
+        gcomm::Transport*    tp_;
+        gcomm::Protostack    pstack_;
+        gu::SharedBuffer     payload_;
+        gu::Atomic<long>     recvd_[NODES];
+        gu::Atomic<int>      running_;
+        gu_thread_t          thd_;
+    };
+
+    /* minimum number of own messages received by peers */
+    long
+    min_recvd(Node* const nodes[], int const src)
+    {
+        long ret(-1);
+        for (int i(0); i < NODES; ++i)
+        {
+            if (i == src) continue;
+            long const r(nodes[i]->recvd(src));
+            if (ret < 0 || r < ret) ret = r;
+        }
+        return ret;
+    }
+
+    struct SenderArgs
+    {
+        Node* const* nodes;
+        int          idx;
+        long         messages;
+    };
+
+    extern "C" void*
+    sender_thd(void* arg)
+    {
+        const SenderArgs& a(*static_cast<SenderArgs*>(arg));
+        Node* const node(a.nodes[a.idx]);
+
+        for (long sent(0); sent < a.messages; ++sent)
+        {
+            while (sent - min_recvd(a.nodes, a.idx) >= WINDOW) ::usleep(20);
+            node->send();
+        }
+
+        return NULL;
+    }
+
+    void silent_log(int, const char*) {}
+
+    bool
+    all_recvd(Node* const nodes[], long const n)
+    {
+        for (int i(0); i < NODES; ++i)
+        {
+            if (min_recvd(nodes, i) < n) return false;
+        }
+        return true;
+    }
+
+    int
+    run_bench(const Params& p, int const io_threads)
+    {
+        gu::Config* conf[NODES];
+        gcomm::Protonet* pnet[NODES];
+        Node* nodes[NODES];
+
+        for (int i(0); i < NODES; ++i)
+        {
+            conf[i] = new gu::Config;
+            gu::ssl_register_params(*conf[i]);
+            gcomm::Conf::register_params(*conf[i]);
+            conf[i]->set(gcomm::Conf::SocketIoThreads, io_threads);
+            pnet[i] = gcomm::Protonet::create(*conf[i]);
+            nodes[i] = new Node(*pnet[i], i, p.msg_size,
+                                i == 0 ? "" : nodes[0]->listen_addr());
+        }
+
+        /* wait for full mesh */
+        for (int n(0); !all_recvd(nodes, 1); ++n)
+        {
+            if (n > 300)
+            {
+                std::cerr << "Nodes failed to connect" << std::endl;
+                return 1;
+            }
+            for (int i(0); i < NODES; ++i) nodes[i]->send();
+            ::usleep(100000);
+        }
+        ::usleep(500000);
+        for (int i(0); i < NODES; ++i) nodes[i]->reset();
+
+        long long const start(gu_time_monotonic());
+
+        SenderArgs args[NODES];
+        gu_thread_t senders[NODES];
+        for (int i(0); i < NODES; ++i)
+        {
+            SenderArgs const a = { nodes, i, p.messages };
+            args[i] = a;
+            gu_thread_create(&senders[i], NULL, sender_thd, &args[i]);
+        }
+
+        for (int i(0); i < NODES; ++i) gu_thread_join(senders[i], NULL);
+
+        while (!all_recvd(nodes, p.messages)) ::usleep(100);
+
+        double const duration((gu_time_monotonic() - start) * 1.0e-9);
+
+        for (int i(NODES - 1); i >= 0; --i)
+        {
+            delete nodes[i];
+            delete pnet[i];
+            delete conf[i];
+        }
+
+        long long const recvd(p.messages * NODES * (NODES - 1));
+        std::cout << io_threads << '\t'
+                  << std::fixed << std::setprecision(3) << duration << '\t'
+                  << long(recvd / duration) << '\t'
+                  << std::setprecision(1)
+                  << recvd * p.msg_size / duration / (1 << 20) << '\n';
+
+        return 0;
+    }
+
+    template <typename T>
+    void
+    read_arg(char* argv[], int position, T& var)
+    {
+        std::istringstream is(argv[position]);
+        is >> var;
+        if (is.fail() || var < 0)
+        {
+            std::cerr << "Invalid argument " << position << ": '"
+                      << argv[position] << "'" << std::endl;
+            ::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p;
+    p.messages = 20000;
+    p.msg_size = 16 << 10;
+    int io_threads(-1);
+
+    if (argc >= 2) read_arg(argv, 1, p.messages);
+    if (argc >= 3) read_arg(argv, 2, p.msg_size);
+    if (argc >= 4) read_arg(argv, 3, io_threads);
+
+    if (p.messages < 1 || p.msg_size < 1)
+    {
+        std::cerr << "At least one message of one byte is required"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /* gcomm is chatty about connections */
+    gu_conf_set_log_callback(silent_log);
+    gu_crc32c_configure();
+
+    std::cout << "Nodes: " << NODES << ", messages per node: " << p.messages
+              << ", message size: " << p.msg_size << "\n\n"
+              << "I/O threads:\tDuration:\tMsgs/sec:\tMB/sec:\n";
+
+    if (io_threads >= 0)
+    {
+        return run_bench(p, io_threads);
+    }
+
+    int ret(0);
+    int const threads[] = { 0, 1, 2, 4 };
+    for (size_t i(0); i < sizeof(threads)/sizeof(threads[0]) && !ret; ++i)
+    {
+        ret = run_bench(p, threads[i]);
+    }
+
+    return ret;
+}
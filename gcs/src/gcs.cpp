@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2021 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -97,11 +97,32 @@ static bool const GCS_FC_CONT = false;
 /** Flow control message */
 struct gcs_fc_event
 {
-    uint32_t conf_id; // least significant part of configuraiton seqno
-    uint32_t stop;    // boolean value
+    uint32_t conf_id; // least significant part of configuration seqno
+    uint32_t stop;    // boolean value or GCS_FC_RATE_TYPE
 }
 __attribute__((__packed__));
 
+/** Value of gcs_fc_event::stop which marks rate flow control message.
+ *  STOP/CONT senders put there a boolean, so it can't be taken for it. */
+static uint32_t const GCS_FC_RATE_TYPE = 0x46435254; // "FCRT"
+
+/** Rate flow control message, begins with gcs_fc_event header */
+struct gcs_fc_rate_event
+{
+    uint32_t conf_id;   // least significant part of configuration seqno
+    uint32_t type;      // GCS_FC_RATE_TYPE
+    uint32_t version;   // message format version, GCS_FC_RATE_VER
+    uint32_t rate;      // sustainable replication rate (actions/s), 0 - any
+    uint32_t queue_len; // slave queue length of the sender
+}
+__attribute__((__packed__));
+
+/** Rate message format version. Later versions may only append fields. */
+static uint32_t const GCS_FC_RATE_VER = 0;
+
+/** First GCS protocol version where rate FC messages are understood */
+static int const GCS_FC_RATE_PROTO_VER = 1;
+
 struct gcs_conn
 {
     long  my_idx;
@@ -128,6 +149,12 @@ struct gcs_conn
     gcs_fifo_lite_t* repl_q;
     gu_thread_t      send_thread;
 
+    /* Replicated actions waiting to be sent in one batch,
+     * accessed only from within send monitor */
+    struct gcs_repl_act* batch[GCS_CORE_BATCH_MAX];
+    int                  batch_len;
+    size_t               batch_bytes;
+
     /* A queue for threads waiting for received actions */
     gu_fifo_t*   recv_q;
     ssize_t      recv_q_size;
@@ -169,12 +196,24 @@ struct gcs_conn
     long         upper_limit;         // upper slave queue limit
     long         lower_limit;         // lower slave queue limit
     long         fc_offset;           // offset for catchup phase
+    ssize_t      queue_size;          // slave queue size (bytes)
+    ssize_t      upper_size_limit;    // upper slave queue size limit, 0 - none
+    ssize_t      lower_size_limit;    // lower slave queue size limit
+    ssize_t      fc_size_offset;      // size offset for catchup phase
+    gcs_fc_reason_t fc_reason;        // why FC_STOP was sent, under fc_lock
     gcs_conn_state_t max_fc_state;    // maximum state when FC is enabled
     long         stats_fc_stop_sent;  // FC stats counters
     long         stats_fc_cont_sent;  //
     long         stats_fc_received;   //
     gcs_fc_t     stfc; // state transfer FC object
 
+    /* Rate flow control (gcs.fc_pacing) */
+    gcs_fc_rate_t    fc_rate;        // own apply rate, under recv_q lock
+    gcs_fc_bucket_t  fc_bucket;      // pacing of own actions, under fc_lock
+    double*          fc_memb_rate;   // rates advertised by members, 0 - any
+    long             fc_memb_num;    // size of fc_memb_rate array
+    long long        stats_fc_paced_ns; // total pacing delay, under fc_lock
+
     /* #603, #606 join control */
     gcs_seqno_t volatile join_seqno;
     bool        volatile need_to_join;
@@ -227,10 +266,16 @@ struct gcs_repl_act
     struct gcs_action*   action;
     gu_mutex_t           wait_mutex;
     gu_cond_t            wait_cond;
+    long                 batch_ret; // error sending the batch with action
+    bool                 delivered; // signalled by recv thread or close
+    bool                 batched;   // in conn->batch, protected by sm
     gcs_repl_act(const struct gu_buf* a_act_in, struct gcs_action* a_action)
       :
         act_in(a_act_in),
-        action(a_action)
+        action(a_action),
+        batch_ret(0),
+        delivered(false),
+        batched(false)
     { }
 };
 
@@ -353,6 +398,7 @@ gcs_create (gu_config_t* const conf, gcache_t* const gcache,
         GCS_CONN_DONOR : GCS_CONN_JOINED;
 
     gu_mutex_init (&conn->fc_lock, NULL);
+    gcs_fc_rate_reset (&conn->fc_rate, gu_time_monotonic());
 
     return conn; // success
 
@@ -431,15 +477,38 @@ gcs_send_fc_event (gcs_conn_t* conn, bool stop)
     return gcs_core_send_fc (conn->core, &fc, sizeof(fc));
 }
 
+/* To be called under slave queue lock. Returns which of the upper slave queue
+ * limits is exceeded, if any */
+static inline gcs_fc_reason_t
+gcs_fc_conn_over_limit (const gcs_conn_t* conn)
+{
+    return gcs_fc_over_limit (conn->queue_len,
+                              conn->upper_limit + conn->fc_offset,
+                              conn->queue_size, conn->upper_size_limit,
+                              conn->fc_size_offset);
+}
+
+/* To be called under slave queue lock. Returns true if the slave queue is
+ * within both lower limits */
+static inline bool
+gcs_fc_conn_under_limit (const gcs_conn_t* conn)
+{
+    return gcs_fc_under_limit (conn->queue_len, conn->lower_limit,
+                               conn->queue_size, conn->upper_size_limit,
+                               conn->lower_size_limit);
+}
+
 /* To be called under slave queue lock. Returns true if FC_STOP must be sent */
 static inline bool
 gcs_fc_stop_begin (gcs_conn_t* conn)
 {
     long err = 0;
+    gcs_fc_reason_t reason(GCS_FC_REASON_NONE);
 
     bool ret = (conn->stop_count <= 0                                     &&
                 conn->stop_sent_ <= 0                                     &&
-                conn->queue_len  >  (conn->upper_limit + conn->fc_offset) &&
+                GCS_FC_REASON_NONE !=
+                (reason = gcs_fc_conn_over_limit(conn))                   &&
                 conn->state      <= conn->max_fc_state                    &&
                 !(err = gu_mutex_lock (&conn->fc_lock)));
 
@@ -448,6 +517,8 @@ gcs_fc_stop_begin (gcs_conn_t* conn)
             abort();
     }
 
+    if (ret) conn->fc_reason = reason;
+
     return ret;
 }
 
@@ -477,10 +548,12 @@ gcs_fc_stop_end (gcs_conn_t* conn)
             assert (conn->stop_sent() > 0);
             /* restore counter */
             conn->stop_sent_dec(1);
+            conn->fc_reason = GCS_FC_REASON_NONE;
         }
 
-        gu_debug ("SENDING FC_STOP (local seqno: %lld, fc_offset: %ld): %d",
-                 conn->local_act_id, conn->fc_offset, ret);
+        gu_debug ("SENDING FC_STOP (local seqno: %lld, fc_offset: %ld, "
+                  "reason: %s): %d", conn->local_act_id, conn->fc_offset,
+                  gcs_fc_reason_str[conn->fc_reason], ret);
     }
     else
     {
@@ -503,8 +576,13 @@ gcs_fc_cont_begin (gcs_conn_t* conn)
     bool queue_decreased = (conn->fc_offset > conn->queue_len &&
                             (conn->fc_offset = conn->queue_len, true));
 
+    if (conn->fc_size_offset > conn->queue_size) {
+        queue_decreased = true;
+        conn->fc_size_offset = conn->queue_size;
+    }
+
     bool ret = (conn->stop_sent_  >  0                                    &&
-                (conn->lower_limit >= conn->queue_len || queue_decreased) &&
+                (gcs_fc_conn_under_limit(conn) || queue_decreased)        &&
                 conn->state        <= conn->max_fc_state                  &&
                 !(err = gu_mutex_lock (&conn->fc_lock)));
 
@@ -535,6 +613,7 @@ gcs_fc_cont_end (gcs_conn_t* conn)
         if (gu_likely (ret >= 0)) {
             ret = 0;
             conn->stats_fc_cont_sent++;
+            if (0 == conn->stop_sent()) conn->fc_reason = GCS_FC_REASON_NONE;
         }
         else {
             /* restore counter */
@@ -556,6 +635,65 @@ gcs_fc_cont_end (gcs_conn_t* conn)
     return ret;
 }
 
+/* To be called under slave queue lock. Returns true if the rate this node can
+ * sustain must be advertised to the group. */
+static inline bool
+gcs_fc_rate_begin (gcs_conn_t* conn, double* rate)
+{
+    return (conn->params.fc_pacing                              &&
+            conn->state <= conn->max_fc_state                   &&
+            gcs_core_group_protocol_version(conn->core) >=
+            GCS_FC_RATE_PROTO_VER                               &&
+            gcs_fc_rate_check (&conn->fc_rate, conn->queue_len,
+                               conn->upper_limit + conn->fc_offset,
+                               gu_time_monotonic(), rate));
+}
+
+/* Complement to gcs_fc_rate_begin() */
+static inline void
+gcs_fc_rate_end (gcs_conn_t* conn, double rate)
+{
+    long const queue_len(conn->queue_len);
+    struct gcs_fc_rate_event const fc = {
+        htogl(conn->conf_id),
+        htogl(GCS_FC_RATE_TYPE),
+        htogl(GCS_FC_RATE_VER),
+        htogl(uint32_t(rate + .5)),
+        htogl(uint32_t(queue_len))
+    };
+
+    long ret = gcs_core_send_fc (conn->core, &fc, sizeof(fc));
+    if (ret >= 0) ret = 0;
+
+    gu_debug ("SENDING FC rate %.1f (queue: %ld): %ld", rate, queue_len, ret);
+
+    if ((ret = gcs_check_error (ret, "Failed to send FC rate"))) {
+        gu_warn ("Failed to send FC rate: %ld (%s)", ret, strerror(-ret));
+    }
+}
+
+/* Paces ordered actions to this node's share of the group rate limit.
+ * To be called before entering send monitor. */
+static inline void
+gcs_fc_pace (gcs_conn_t* conn)
+{
+    /* read without fc_lock to keep it off the path when pacing is off */
+    if (gu_likely(!gu_atomic_get_n(&conn->params.fc_pacing))) return;
+
+    long long wait;
+
+    gu_mutex_lock (&conn->fc_lock);
+    wait = gcs_fc_bucket_take (&conn->fc_bucket, gu_time_monotonic());
+    conn->stats_fc_paced_ns += wait;
+    gu_mutex_unlock (&conn->fc_lock);
+
+    if (wait > 0) {
+        struct timespec const ts = { time_t(wait / 1000000000LL),
+                                     long(wait % 1000000000LL) };
+        nanosleep (&ts, NULL);
+    }
+}
+
 /* To be called under slave queue lock. Returns true if SYNC must be sent */
 static inline bool
 gcs_send_sync_begin (gcs_conn_t* conn)
@@ -829,6 +967,7 @@ gcs_become_joined (gcs_conn_t* conn)
     /* See also gcs_handle_act_conf () for a case of cluster bootstrapping */
     if (gcs_shift_state (conn, GCS_CONN_JOINED)) {
         conn->fc_offset    = conn->queue_len;
+        conn->fc_size_offset = conn->queue_size;
         conn->join_seqno   = GCS_SEQNO_NIL;
         conn->need_to_join = false;
         gu_debug("Become joined, FC offset %ld", conn->fc_offset);
@@ -853,6 +992,7 @@ gcs_become_synced (gcs_conn_t* conn)
     gu_fifo_release(conn->recv_q);
     gu_debug("Become synced, FC offset %ld", conn->fc_offset);
     conn->fc_offset = 0;
+    conn->fc_size_offset = 0;
 }
 
 /* to be called under protection of both recv_q and fc_lock */
@@ -872,8 +1012,19 @@ _set_fc_limits (gcs_conn_t* conn)
     conn->upper_limit = std::min(conn->upper_limit, gu_fifo_max_length(conn->recv_q));
     conn->lower_limit = std::min(conn->lower_limit, gu_fifo_max_length(conn->recv_q));
 
+    /* Size limit bounds memory taken by the queue on this node, so it is not
+     * scaled with the group size. */
+    conn->upper_size_limit = conn->params.fc_size_limit;
+    conn->lower_size_limit =
+        conn->upper_size_limit * conn->params.fc_resume_factor + .5;
+
     gu_info ("Flow-control interval: [%ld, %ld]",
              conn->lower_limit, conn->upper_limit);
+
+    if (conn->upper_size_limit > 0) {
+        gu_info ("Flow-control size interval: [%zd, %zd]",
+                 conn->lower_size_limit, conn->upper_size_limit);
+    }
 }
 
 /*! Handles flow control events
@@ -900,6 +1051,48 @@ gcs_handle_flow_control (gcs_conn_t*                conn,
     return;
 }
 
+/*! Handles rate flow control events: paces own replication to the share of
+ *  the lowest rate advertised by group members */
+static void
+gcs_handle_flow_control_rate (gcs_conn_t*                     conn,
+                              const struct gcs_fc_rate_event* fc,
+                              int const                       sender_idx)
+{
+    if (gtohl(fc->conf_id) != (uint32_t)conn->conf_id) {
+        // obsolete fc request
+        return;
+    }
+
+    if (gu_unlikely(gu_mutex_lock (&conn->fc_lock))) {
+        gu_fatal ("Failed to lock mutex.");
+        abort();
+    }
+
+    /* fc_pacing is changed under fc_lock */
+    if (conn->params.fc_pacing &&
+        sender_idx >= 0 && sender_idx < conn->fc_memb_num) {
+        conn->fc_memb_rate[sender_idx] = gtohl(fc->rate);
+
+        double min_rate(0.0);
+        for (long i(0); i < conn->fc_memb_num; ++i) {
+            double const r(conn->fc_memb_rate[i]);
+            if (r > 0.0 && (0.0 == min_rate || r < min_rate)) min_rate = r;
+        }
+
+        double const senders(conn->params.fc_master_slave ? 1.0 :
+                             std::max(1L, conn->non_arb_memb_count));
+
+        gcs_fc_bucket_set_rate (&conn->fc_bucket, min_rate / senders,
+                                gu_time_monotonic());
+
+        gu_debug ("FC rate %u from member %d (queue: %u), pacing at %.1f",
+                  gtohl(fc->rate), sender_idx, gtohl(fc->queue_len),
+                  conn->fc_bucket.rate);
+    }
+
+    gu_mutex_unlock (&conn->fc_lock);
+}
+
 static void
 _reset_pkt_size(gcs_conn_t* conn)
 {
@@ -955,6 +1148,7 @@ gcs_handle_act_conf (gcs_conn_t* conn, const void* action)
 
             conn->stop_sent_  = 0;
             conn->stop_count  = 0;
+            conn->fc_reason   = GCS_FC_REASON_NONE;
             conn->conf_id     = conf->conf_id;
             conn->memb_num    = conf->memb_num;
 
@@ -975,6 +1169,22 @@ gcs_handle_act_conf (gcs_conn_t* conn, const void* action)
 
             _set_fc_limits (conn);
 
+            /* rates advertised in the previous configuration are void */
+            if (conn->fc_memb_num != conf->memb_num) {
+                double* const r(conf->memb_num > 0 ?
+                                GU_REALLOC(conn->fc_memb_rate, conf->memb_num,
+                                           double) : NULL);
+                if (NULL == r) gu_free (conn->fc_memb_rate);
+                conn->fc_memb_rate = r;
+                conn->fc_memb_num  = r ? conf->memb_num : 0;
+            }
+            for (long i(0); i < conn->fc_memb_num; ++i) {
+                conn->fc_memb_rate[i] = 0.0;
+            }
+            gcs_fc_bucket_set_rate (&conn->fc_bucket, 0.0,
+                                    gu_time_monotonic());
+            conn->fc_rate.advertised = 0.0;
+
             gu_mutex_unlock (&conn->fc_lock);
         }
         else {
@@ -1128,9 +1338,27 @@ gcs_handle_actions (gcs_conn_t*          conn,
 
     switch (rcvd->act.type) {
     case GCS_ACT_FLOW:
+    {
+        const struct gcs_fc_event* const fc
+            ((const gcs_fc_event*)rcvd->act.buf);
+
+        assert (rcvd->act.buf_len >= ssize_t(sizeof(*fc)));
+
+        if (gu_unlikely(GCS_FC_RATE_TYPE == gtohl(fc->stop))) {
+            if (rcvd->act.buf_len >= ssize_t(sizeof(gcs_fc_rate_event))) {
+                gcs_handle_flow_control_rate (
+                    conn, (const gcs_fc_rate_event*)fc, rcvd->sender_idx);
+            }
+            else {
+                gu_warn ("Ignoring short FC rate message: %zd bytes",
+                         rcvd->act.buf_len);
+            }
+            break;
+        }
         assert (sizeof(struct gcs_fc_event) == rcvd->act.buf_len);
-        gcs_handle_flow_control (conn, (const gcs_fc_event*)rcvd->act.buf);
+        gcs_handle_flow_control (conn, fc);
         break;
+    }
     case GCS_ACT_CONF:
         gcs_handle_act_conf (conn, rcvd->act.buf);
         ret = 1;
@@ -1179,6 +1407,14 @@ GCS_FIFO_POP_HEAD (gcs_conn_t* conn, ssize_t size)
     gu_fifo_pop_head (conn->recv_q);
 }
 
+static inline void
+GCS_FIFO_POP_HEAD_N (gcs_conn_t* conn, long n, ssize_t size)
+{
+    assert (conn->recv_q_size >= size);
+    conn->recv_q_size -= size;
+    gu_fifo_pop_head_n (conn->recv_q, n);
+}
+
 /* Returns true if timeout was handled and false otherwise */
 static bool
 _handle_timeout (gcs_conn_t* conn)
@@ -1215,6 +1451,7 @@ _check_recv_queue_growth (gcs_conn_t* conn, ssize_t size)
         /* replication needs throttling */
         ret = gu_mutex_lock(&conn->fc_lock);
         if (!ret) {
+            conn->fc_reason = GCS_FC_REASON_SST;
             ret = gcs_fc_stop_end(conn);
             gu_info("SST entering flow control");
         }
@@ -1261,6 +1498,11 @@ _close(gcs_conn_t* conn, bool join_recv_thread)
     }
 
     if (!(ret = gcs_sm_close (conn->sm))) {
+        /* nobody is going to send what is left in the batch, the actions
+         * are in repl_q and their threads will be released below */
+        conn->batch_len   = 0;
+        conn->batch_bytes = 0;
+
         // we ignore return value on purpose. the reason is
         // we can not tell why self-leave message is generated.
         // there are two possible reasons.
@@ -1298,6 +1540,7 @@ _close(gcs_conn_t* conn, bool join_recv_thread)
              * they'll quit on their own,
              * they don't depend on the conn object after waking */
             gu_mutex_lock   (&act->wait_mutex);
+            act->delivered = true;
             gu_cond_signal  (&act->wait_cond);
             gu_mutex_unlock (&act->wait_mutex);
         }
@@ -1336,6 +1579,9 @@ _close(gcs_conn_t* conn, bool join_recv_thread)
     return ret;
 }
 
+static long
+_batch_flush (gcs_conn_t* conn, const struct gcs_repl_act* self);
+
 /*
  * gcs_recv_thread() receives whatever actions arrive from group,
  * and performs necessary actions based on action type.
@@ -1356,8 +1602,11 @@ static void *gcs_recv_thread (void *arg)
     // To avoid race between gcs_open() and the following state check in while()
     gu_cond_t tmp_cond; /* TODO: rework when concurrency in SM is allowed */
     gu_cond_init (&tmp_cond, NULL);
-    gcs_sm_enter(conn->sm, &tmp_cond, false, true);
-    gcs_sm_leave(conn->sm);
+    if (!gcs_sm_enter(conn->sm, &tmp_cond, false, true))
+    {
+        _batch_flush (conn, NULL); // batch may be waiting for this thread
+        gcs_sm_leave(conn->sm);
+    }
     gu_cond_destroy (&tmp_cond);
 
     while (conn->state < GCS_CONN_CLOSED)
@@ -1445,6 +1694,7 @@ static void *gcs_recv_thread (void *arg)
             repl_act->action->seqno_l = this_act_id;
 
             gu_mutex_lock   (&repl_act->wait_mutex);
+            repl_act->delivered = true;
             gu_cond_signal  (&repl_act->wait_cond);
             gu_mutex_unlock (&repl_act->wait_mutex);
         }
@@ -1459,12 +1709,17 @@ static void *gcs_recv_thread (void *arg)
                 recv_act->rcvd     = rcvd;
                 recv_act->local_id = this_act_id;
 
-                conn->queue_len = gu_fifo_length (conn->recv_q) + 1;
+                conn->queue_len  = gu_fifo_length (conn->recv_q) + 1;
+                conn->queue_size = conn->recv_q_size + rcvd.act.buf_len;
                 bool const send_stop(gcs_fc_stop_begin(conn));
+                double     fc_rate;
+                bool const send_rate(gcs_fc_rate_begin(conn, &fc_rate));
 
                 // release queue
                 GCS_FIFO_PUSH_TAIL (conn, rcvd.act.buf_len);
 
+                if (gu_unlikely(send_rate)) gcs_fc_rate_end (conn, fc_rate);
+
                 if (gu_unlikely(GCS_CONN_JOINER == conn->state && !send_stop)) {
                     ret = _check_recv_queue_growth (conn, rcvd.act.buf_len);
                     assert (ret <= 0);
@@ -1551,6 +1806,8 @@ long gcs_open (gcs_conn_t* conn, const char* channel, const char* url,
         return ret;
     }
 
+    _batch_flush (conn, NULL); // batch may be waiting for this thread
+
     if (GCS_CONN_CLOSED == conn->state) {
 
         if (!(ret = gcs_core_open (conn->core, channel, url, bootstrap))) {
@@ -1684,6 +1941,8 @@ long gcs_destroy (gcs_conn_t *conn)
     /* This must not last for long */
     while (gu_mutex_destroy (&conn->fc_lock));
 
+    gu_free (conn->fc_memb_rate);
+
     _cleanup_params (conn);
 
     gu_free (conn);
@@ -1691,6 +1950,191 @@ long gcs_destroy (gcs_conn_t *conn)
     return err;
 }
 
+/*!
+ * Sends replicated actions accumulated in conn->batch. Must be called from
+ * within send monitor. Threads of the actions which failed to be sent are
+ * woken up with the error, except for the calling one (self).
+ *
+ * @return error sending self action or 0
+ */
+static long
+_batch_flush (gcs_conn_t* const conn, const struct gcs_repl_act* const self)
+{
+    int const n(conn->batch_len);
+
+    if (0 == n) return 0;
+
+    struct gcs_repl_act* const* const acts(conn->batch);
+
+    conn->batch_len   = 0;
+    conn->batch_bytes = 0;
+
+    /* sent actions may be delivered and their threads gone before send
+     * returns, so the flags must be cleared before sending */
+    for (int i = 0; i < n; i++) acts[i]->batched = false;
+
+    long ret(-EPROTONOSUPPORT);
+    int  sent(0);
+
+    if (n > 1) {
+        struct gcs_core_batch_act bacts[GCS_CORE_BATCH_MAX];
+
+        for (int i = 0; i < n; i++) {
+            assert (GCS_ACT_TORDERED == acts[i]->action->type);
+            bacts[i].act  = acts[i]->act_in;
+            bacts[i].size = acts[i]->action->size;
+        }
+
+        while ((ret = gcs_core_send_batch (conn->core, bacts, n))
+               == -ERESTART) {}
+
+        if (ret >= 0) sent = n;
+    }
+
+    if (-EPROTONOSUPPORT == ret) {
+        /* single action or group does not support batching */
+        for (; sent < n; sent++) {
+            const struct gcs_repl_act* const act(acts[sent]);
+
+            while ((ret = gcs_core_send (conn->core, act->act_in,
+                                         act->action->size,
+                                         act->action->type)) == -ERESTART) {}
+
+            if (ret < 0) break;
+        }
+    }
+
+    if (gu_likely(sent == n)) return 0;
+
+    assert (ret < 0);
+
+    gu_warn ("Send batch of %d actions returned %ld (%s)",
+             n - sent, ret, strerror(-ret));
+
+    /* unsent actions are at the tail of repl_q and will never be delivered */
+    for (int i = sent; i < n; i++) {
+        if (!gcs_fifo_lite_remove (conn->repl_q)) {
+            gu_fatal ("Failed to remove unsent item from repl_q");
+            assert(0);
+            ret = -ENOTRECOVERABLE;
+        }
+    }
+
+    long self_ret(0);
+
+    for (int i = sent; i < n; i++) {
+        struct gcs_repl_act* const act(acts[i]);
+
+        if (act == self) {
+            self_ret = ret;
+            continue;
+        }
+
+        gu_mutex_lock   (&act->wait_mutex);
+        act->batch_ret = ret;
+        gu_cond_signal  (&act->wait_cond);
+        gu_mutex_unlock (&act->wait_mutex);
+    }
+
+    return self_ret;
+}
+
+/*! Whether action can be sent in a batch with others */
+static inline bool
+_batch_accepts (const gcs_conn_t* const conn, const struct gcs_action* const act)
+{
+    return (GCS_ACT_TORDERED == act->type &&
+            act->size <= conn->params.batch_size);
+}
+
+/*!
+ * Adds replicated action to the batch. Must be called from within send
+ * monitor after the action was put in repl_q. The batch is sent right away
+ * if it is full or if there is nobody waiting in send monitor to add more
+ * to it. Otherwise sending is deferred to the next thread in send monitor.
+ *
+ * @param deferred set to true if the action was left in the batch
+ * @return action size or negative error code
+ */
+static long
+_batch_add (gcs_conn_t*                const conn,
+            struct gcs_repl_act*       const repl_act,
+            bool&                            deferred)
+{
+    ssize_t const size(repl_act->action->size);
+
+    assert (conn->batch_len < GCS_CORE_BATCH_MAX);
+
+    repl_act->batched = true;
+    conn->batch[conn->batch_len++] = repl_act;
+    conn->batch_bytes += size;
+
+    if (conn->batch_len < GCS_CORE_BATCH_MAX                     &&
+        conn->batch_bytes < size_t(conn->params.batch_size)      &&
+        gcs_sm_has_waiters (conn->sm))
+    {
+        deferred = true;
+        return size;
+    }
+
+    long const ret(_batch_flush (conn, repl_act));
+
+    return (ret < 0 ? ret : size);
+}
+
+/*!
+ * Waits until replicated action is delivered by recv thread or its batch
+ * fails to be sent. If the action was deferred in the batch and nobody sent
+ * it within batch window, sends the batch itself.
+ * Must be called with repl_act->wait_mutex locked.
+ */
+static void
+_repl_wait (gcs_conn_t* const conn, struct gcs_repl_act* const repl_act,
+            bool deferred)
+{
+    gu::datetime::Date deadline(gu::datetime::Date::calendar());
+
+    if (deferred) {
+        deadline = deadline + gu::datetime::Period(conn->params.batch_window *
+                                                   gu::datetime::USec);
+    }
+
+    while (!repl_act->delivered && 0 == repl_act->batch_ret) {
+
+        if (!deferred) {
+            gu_cond_wait (&repl_act->wait_cond, &repl_act->wait_mutex);
+            continue;
+        }
+
+        struct timespec ts;
+        deadline._timespec(ts);
+
+        if (ETIMEDOUT != gu_cond_timedwait (&repl_act->wait_cond,
+                                            &repl_act->wait_mutex, &ts))
+            continue;
+
+        /* Batch window is over. Whoever sends the batch may need to lock
+         * wait_mutex, so it can't be held while in send monitor. */
+        deferred = false;
+        gu_mutex_unlock (&repl_act->wait_mutex);
+
+        long ret(0);
+        gu_cond_t tmp_cond;
+        gu_cond_init (&tmp_cond, NULL);
+
+        if (!gcs_sm_enter (conn->sm, &tmp_cond, false, true)) {
+            if (repl_act->batched) ret = _batch_flush (conn, repl_act);
+            gcs_sm_leave (conn->sm);
+        }
+        /* else monitor is closed, action will be released by _close() */
+
+        gu_cond_destroy (&tmp_cond);
+        gu_mutex_lock (&repl_act->wait_mutex);
+
+        if (ret < 0) repl_act->batch_ret = ret;
+    }
+}
+
 /* Puts action in the send queue and returns */
 long gcs_sendv (gcs_conn_t*          const conn,
                 const struct gu_buf* const act_bufs,
@@ -1702,6 +2146,8 @@ long gcs_sendv (gcs_conn_t*          const conn,
 
     long ret = -ENOTCONN;
 
+    if (GCS_ACT_TORDERED == act_type) gcs_fc_pace (conn);
+
     /*! locking connection here to avoid race with gcs_close()
      *  @note: gcs_repl() and gcs_recv() cannot lock connection
      *         because they block indefinitely waiting for actions */
@@ -1710,6 +2156,8 @@ long gcs_sendv (gcs_conn_t*          const conn,
 
     if (!(ret = gcs_sm_enter (conn->sm, &tmp_cond, scheduled, true)))
     {
+        _batch_flush (conn, NULL); // keep the order of entering the monitor
+
         while ((GCS_CONN_OPEN >= conn->state) &&
                (ret = gcs_core_send (conn->core, act_bufs,
                                      act_size, act_type)) == -ERESTART);
@@ -1757,6 +2205,8 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
     act->seqno_l = GCS_SEQNO_ILL;
     act->seqno_g = GCS_SEQNO_ILL;
 
+    if (GCS_ACT_TORDERED == act->type) gcs_fc_pace (conn);
+
     /* This is good - we don't have to do a copy because we wait */
     struct gcs_repl_act repl_act(act_in, act);
 
@@ -1778,6 +2228,15 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
 //#ifndef NDEBUG
             const void* const orig_buf = act->buf;
 //#endif
+            bool const batch(_batch_accepts(conn, act));
+            bool       deferred(false);
+
+            // actions must be sent in the order of repl_q, so the batch goes
+            // before the action unless the action joins it
+            if (!batch || conn->batch_bytes + act->size >
+                size_t(conn->params.batch_size)) {
+                _batch_flush (conn, NULL);
+            }
 
             // some hack here to achieve one if() instead of two:
             // ret = -EAGAIN part is a workaround for #569
@@ -1791,24 +2250,34 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
                 *act_ptr = &repl_act;
                 gcs_fifo_lite_push_tail (conn->repl_q);
 
-                // Keep on trying until something else comes out
-                while ((ret = gcs_core_send (conn->core, act_in, act->size,
-                                             act->type)) == -ERESTART) {}
-
-                if (ret < 0) {
-                    /* remove item from the queue, it will never be delivered */
-                    gu_warn ("Send action {%p, %zd, %s} returned %d (%s)",
-                             act->buf, act->size,gcs_act_type_to_str(act->type),
-                             ret, strerror(-ret));
-
-                    if (!gcs_fifo_lite_remove (conn->repl_q)) {
-                        gu_fatal ("Failed to remove unsent item from repl_q");
-                        assert(0);
-                        ret = -ENOTRECOVERABLE;
-                    }
+                if (batch) {
+                    /* unsent action is removed from repl_q by flush */
+                    ret = _batch_add (conn, &repl_act, deferred);
+                    assert (ret < 0 || ret == (ssize_t)act->size);
                 }
                 else {
-                    assert (ret == (ssize_t)act->size);
+                    // Keep on trying until something else comes out
+                    while ((ret = gcs_core_send (conn->core, act_in, act->size,
+                                                 act->type)) == -ERESTART) {}
+
+                    if (ret < 0) {
+                        /* remove item from the queue, it will never be
+                         * delivered */
+                        gu_warn ("Send action {%p, %zd, %s} returned %d (%s)",
+                                 act->buf, act->size,
+                                 gcs_act_type_to_str(act->type),
+                                 ret, strerror(-ret));
+
+                        if (!gcs_fifo_lite_remove (conn->repl_q)) {
+                            gu_fatal ("Failed to remove unsent item from "
+                                      "repl_q");
+                            assert(0);
+                            ret = -ENOTRECOVERABLE;
+                        }
+                    }
+                    else {
+                        assert (ret == (ssize_t)act->size);
+                    }
                 }
             }
 
@@ -1818,7 +2287,13 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
 
             /* now we can go waiting for action delivery */
             if (ret >= 0) {
-                gu_cond_wait (&repl_act.wait_cond, &repl_act.wait_mutex);
+                _repl_wait (conn, &repl_act, deferred);
+
+                if (gu_unlikely(repl_act.batch_ret < 0)) {
+                    /* batch with the action failed to be sent */
+                    ret = repl_act.batch_ret;
+                    goto out;
+                }
 #ifndef GCS_FOR_GARB
                 /* assert (act->buf != 0); */
                 if (act->buf == 0)
@@ -1857,9 +2332,7 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
                 }
             }
         }
-#ifndef GCS_FOR_GARB
     out:
-#endif /* GCS_FOR_GARB */
         gu_mutex_unlock  (&repl_act.wait_mutex);
     }
     gu_mutex_destroy (&repl_act.wait_mutex);
@@ -1982,35 +2455,69 @@ long gcs_desync (gcs_conn_t* conn, gcs_seqno_t* local)
     }
 }
 
-/* Returns when an action from another process is received */
-long gcs_recv (gcs_conn_t*        conn,
-               struct gcs_action* action)
+/* Copies received action from slave queue item */
+static inline void
+_copy_recv_act (struct gcs_action* const action,
+                const struct gcs_recv_act* const recv_act)
+{
+    action->buf     = (void*)recv_act->rcvd.act.buf;
+    action->size    = recv_act->rcvd.act.buf_len;
+    action->type    = recv_act->rcvd.act.type;
+    action->seqno_g = recv_act->rcvd.id;
+    action->seqno_l = recv_act->local_id;
+
+    if (gu_likely(recv_act->rcvd.sender_id[0] == 0)) {
+        action->sender_id[0] = 0;
+    } else {
+        memcpy(action->sender_id, recv_act->rcvd.sender_id, GU_UUID_STR_LEN);
+        action->sender_id[GU_UUID_STR_LEN] = 0;
+    }
+}
+
+/* Returns when actions from another process are received */
+long gcs_recv_batch (gcs_conn_t*        conn,
+                     struct gcs_action* actions,
+                     long               max)
 {
-    int                  err;
-    struct gcs_recv_act* recv_act = NULL;
+    int   err;
+    void* items[GCS_RECV_BATCH_MAX];
+    long  num;
 
-    assert (action);
+    assert (actions);
+    assert (max > 0);
 
-    if ((recv_act = (struct gcs_recv_act*)gu_fifo_get_head (conn->recv_q, &err)))
+    max = std::min(max, long(GCS_RECV_BATCH_MAX));
+
+    if ((num = gu_fifo_get_head_n (conn->recv_q, items, max, &err)) > 0)
     {
-        conn->queue_len = gu_fifo_length (conn->recv_q) - 1;
-        bool send_cont  = gcs_fc_cont_begin   (conn);
-        bool send_sync  = gcs_send_sync_begin (conn);
+        ssize_t size(0);
+        long    n(0);
 
-        action->buf     = (void*)recv_act->rcvd.act.buf;
-        action->size    = recv_act->rcvd.act.buf_len;
-        action->type    = recv_act->rcvd.act.type;
-        action->seqno_g = recv_act->rcvd.id;
-        action->seqno_l = recv_act->local_id;
+        /* Error actions carry no payload and are returned alone, as well as
+         * configuration change which must be processed before any further
+         * actions are taken off the queue. */
+        while (n < num) {
+            const struct gcs_recv_act* const recv_act
+                (static_cast<const struct gcs_recv_act*>(items[n]));
 
-        if (gu_likely(recv_act->rcvd.sender_id[0] == 0)) {
-            action->sender_id[0] = 0;
-        } else {
-            memcpy(action->sender_id, recv_act->rcvd.sender_id, GU_UUID_STR_LEN);
-            action->sender_id[GU_UUID_STR_LEN] = 0;
+            if (n > 0 && 0 == recv_act->rcvd.act.buf_len) break;
+
+            _copy_recv_act (&actions[n], recv_act);
+            size += actions[n].size;
+            gcs_fc_rate_dequeue (&conn->fc_rate);
+
+            if (gu_unlikely (GCS_ACT_CONF    == actions[n++].type ||
+                             0 == recv_act->rcvd.act.buf_len)) break;
         }
 
-        if (gu_unlikely (GCS_ACT_CONF == action->type)) {
+        conn->queue_len  = gu_fifo_length (conn->recv_q) - n;
+        conn->queue_size = conn->recv_q_size - size;
+        bool send_cont  = gcs_fc_cont_begin   (conn);
+        bool send_sync  = gcs_send_sync_begin (conn);
+        double fc_rate;
+        bool send_rate  = gcs_fc_rate_begin   (conn, &fc_rate);
+
+        if (gu_unlikely (GCS_ACT_CONF == actions[n - 1].type)) {
             err = gu_fifo_cancel_gets (conn->recv_q);
             if (err) {
                 gu_fatal ("Internal logic error: failed to cancel recv_q "
@@ -2020,7 +2527,9 @@ long gcs_recv (gcs_conn_t*        conn,
             }
         }
 
-        GCS_FIFO_POP_HEAD (conn, action->size); // release the queue
+        GCS_FIFO_POP_HEAD_N (conn, n, size); // release the queue
+
+        if (gu_unlikely(send_rate)) gcs_fc_rate_end (conn, fc_rate);
 
         if (gu_unlikely(send_cont) && (err = gcs_fc_cont_end(conn))) {
             // We have successfully received an action, but failed to send
@@ -2046,14 +2555,14 @@ long gcs_recv (gcs_conn_t*        conn,
                      err, strerror(-err));
         }
 
-        return action->size;
+        return (0 == actions[0].size ? 0 : n);
     }
     else {
-        action->buf     = NULL;
-        action->size    = 0;
-        action->type    = GCS_ACT_ERROR;
-        action->seqno_g = GCS_SEQNO_ILL;
-        action->seqno_l = GCS_SEQNO_ILL;
+        actions[0].buf     = NULL;
+        actions[0].size    = 0;
+        actions[0].type    = GCS_ACT_ERROR;
+        actions[0].seqno_g = GCS_SEQNO_ILL;
+        actions[0].seqno_l = GCS_SEQNO_ILL;
 
         switch (err) {
         case -ENODATA:
@@ -2065,6 +2574,15 @@ long gcs_recv (gcs_conn_t*        conn,
     }
 }
 
+/* Returns when an action from another process is received */
+long gcs_recv (gcs_conn_t*        conn,
+               struct gcs_action* action)
+{
+    long const ret(gcs_recv_batch (conn, action, 1));
+
+    return (ret > 0 ? action->size : ret);
+}
+
 long
 gcs_resume_recv (gcs_conn_t* conn)
 {
@@ -2091,7 +2609,9 @@ long
 gcs_wait (gcs_conn_t* conn)
 {
     if (gu_likely(GCS_CONN_SYNCED == conn->state)) {
-       return (conn->stop_count > 0 || (conn->queue_len > conn->upper_limit));
+       return (conn->stop_count > 0 || (conn->queue_len > conn->upper_limit) ||
+               (conn->upper_size_limit > 0 &&
+                conn->queue_size > conn->upper_size_limit));
     }
     else {
         switch (conn->state) {
@@ -2123,6 +2643,7 @@ gcs_set_last_applied (gcs_conn_t* conn, gcs_seqno_t seqno)
     long ret = gcs_sm_enter (conn->sm, &cond, false, false);
 
     if (!ret) {
+        _batch_flush (conn, NULL); // keep the order of entering the monitor
         ret = gcs_core_set_last_applied (conn->core, seqno);
         gcs_sm_leave (conn->sm);
     }
@@ -2203,10 +2724,18 @@ gcs_get_stats (gcs_conn_t* conn, struct gcs_stats* stats)
 
     stats->fc_lower_limit = conn->lower_limit;
     stats->fc_upper_limit = conn->upper_limit;
+    stats->fc_lower_size_limit = conn->lower_size_limit;
+    stats->fc_upper_size_limit = conn->upper_size_limit;
 
     stats->fc_status = conn->stop_sent() > 0 ? 1 : 0;
     stats->fc_active   = fc_active(conn);
     stats->fc_requested= conn->stop_sent_ > 0;
+
+    gu_mutex_lock (&conn->fc_lock);
+    stats->fc_paced_ns    = conn->stats_fc_paced_ns;
+    stats->fc_pacing_rate = conn->fc_bucket.rate;
+    stats->fc_reason      = gcs_fc_reason_str[conn->fc_reason];
+    gu_mutex_unlock (&conn->fc_lock);
 }
 
 void
@@ -2272,6 +2801,39 @@ _set_fc_limit (gcs_conn_t* conn, const char* value)
     }
 }
 
+static long
+_set_fc_size_limit (gcs_conn_t* conn, const char* value)
+{
+    long long limit;
+    const char* const endptr = gu_str2ll(value, &limit);
+
+    if (limit >= 0LL && *endptr == '\0') {
+
+        if (limit > SSIZE_MAX) limit = SSIZE_MAX;
+
+        gu_fifo_lock(conn->recv_q);
+        {
+            if (!gu_mutex_lock (&conn->fc_lock)) {
+                conn->params.fc_size_limit = limit;
+                _set_fc_limits (conn);
+                gu_config_set_int64 (conn->config, GCS_PARAMS_FC_SIZE_LIMIT,
+                                     conn->params.fc_size_limit);
+                gu_mutex_unlock (&conn->fc_lock);
+            }
+            else {
+                gu_fatal ("Failed to lock mutex.");
+                abort();
+            }
+        }
+        gu_fifo_release (conn->recv_q);
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
 static long
 _set_fc_factor (gcs_conn_t* conn, const char* value)
 {
@@ -2326,6 +2888,44 @@ _set_fc_debug (gcs_conn_t* conn, const char* value)
     }
 }
 
+static long
+_set_fc_pacing (gcs_conn_t* conn, const char* value)
+{
+    bool pacing;
+    const char* const endptr = gu_str2bool (value, &pacing);
+
+    if (endptr[0] != '\0') return -EINVAL;
+
+    if (gu_atomic_get_n(&conn->params.fc_pacing) == pacing) return 0;
+
+    bool withdraw(false); // withdraw rate limit advertised by this node
+
+    gu_fifo_lock(conn->recv_q);
+    {
+        if (!gu_mutex_lock (&conn->fc_lock)) {
+            withdraw = (conn->fc_rate.advertised > 0.0);
+            gu_atomic_set_n(&conn->params.fc_pacing, pacing);
+            gcs_fc_rate_reset (&conn->fc_rate, gu_time_monotonic());
+            for (long i(0); i < conn->fc_memb_num; ++i) {
+                conn->fc_memb_rate[i] = 0.0;
+            }
+            gcs_fc_bucket_set_rate (&conn->fc_bucket, 0.0,
+                                    gu_time_monotonic());
+            gu_config_set_bool (conn->config, GCS_PARAMS_FC_PACING, pacing);
+            gu_mutex_unlock (&conn->fc_lock);
+        }
+        else {
+            gu_fatal ("Failed to lock mutex.");
+            abort();
+        }
+    }
+    gu_fifo_release (conn->recv_q);
+
+    if (withdraw) gcs_fc_rate_end (conn, 0.0);
+
+    return 0;
+}
+
 static long
 _set_sync_donor (gcs_conn_t* conn, const char* value)
 {
@@ -2435,6 +3035,46 @@ _set_max_throttle (gcs_conn_t* conn, const char* value)
     }
 }
 
+static long
+_set_batch_size (gcs_conn_t* conn, const char* value)
+{
+    long long size;
+    const char* const endptr = gu_str2ll (value, &size);
+
+    if (size >= 0 && size <= GCS_PARAMS_BATCH_SIZE_MAX && *endptr == '\0') {
+
+        if (conn->params.batch_size == size) return 0;
+
+        gu_config_set_int64 (conn->config, GCS_PARAMS_BATCH_SIZE, size);
+        conn->params.batch_size = size;
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
+static long
+_set_batch_window (gcs_conn_t* conn, const char* value)
+{
+    long long usec;
+    const char* const endptr = gu_str2ll (value, &usec);
+
+    if (usec >= 0 && usec <= GCS_PARAMS_BATCH_WINDOW_MAX && *endptr == '\0') {
+
+        if (conn->params.batch_window == usec) return 0;
+
+        gu_config_set_int64 (conn->config, GCS_PARAMS_BATCH_WINDOW, usec);
+        conn->params.batch_window = usec;
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
 bool gcs_register_params (gu_config_t* const conf)
 {
     return (gcs_params_register (conf) | gcs_core_register (conf));
@@ -2445,12 +3085,18 @@ long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
     if (!strcmp (key, GCS_PARAMS_FC_LIMIT)) {
         return _set_fc_limit (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_FC_SIZE_LIMIT)) {
+        return _set_fc_size_limit (conn, value);
+    }
     else if (!strcmp (key, GCS_PARAMS_FC_FACTOR)) {
         return _set_fc_factor (conn, value);
     }
     else if (!strcmp (key, GCS_PARAMS_FC_DEBUG)) {
         return _set_fc_debug (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_FC_PACING)) {
+        return _set_fc_pacing (conn, value);
+    }
     else if (!strcmp (key, GCS_PARAMS_SYNC_DONOR)) {
         return _set_sync_donor (conn, value);
     }
@@ -2466,6 +3112,12 @@ long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
     else if (!strcmp (key, GCS_PARAMS_MAX_THROTTLE)) {
         return _set_max_throttle (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_BATCH_SIZE)) {
+        return _set_batch_size (conn, value);
+    }
+    else if (!strcmp (key, GCS_PARAMS_BATCH_WINDOW)) {
+        return _set_batch_window (conn, value);
+    }
 #ifdef GCS_SM_DEBUG
     else if (!strcmp (key, GCS_PARAMS_SM_DUMP)) {
         gcs_sm_dump_state(conn->sm, stderr);
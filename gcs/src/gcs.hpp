@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -253,6 +253,25 @@ static inline long gcs_repl (gcs_conn_t*        const conn,
 extern long gcs_recv (gcs_conn_t*        conn,
                       struct gcs_action* action);
 
+/*! Maximum number of actions returned by gcs_recv_batch() */
+#define GCS_RECV_BATCH_MAX 64
+
+/*! @brief Receives up to max actions from group.
+ * Same as gcs_recv(), but takes all actions ready in the slave queue (up to
+ * max) at once. Configuration change is always the last action in a batch.
+ *
+ * @param conn    group connection handle
+ * @param actions array of at least max action objects
+ * @param max     maximum number of actions to receive
+ * @return        negative error code, number of actions received in case of
+ *                success
+ * @retval 0      on connection close, or an error action in actions[0],
+ *                as with gcs_recv() returning 0
+ */
+extern long gcs_recv_batch (gcs_conn_t*        conn,
+                            struct gcs_action* actions,
+                            long               max);
+
 /*!
  * @brief Schedules entry to CGS send monitor.
  * Locks send monitor and should be quickly followed by gcs_repl()/gcs_send()
@@ -446,9 +465,15 @@ struct gcs_stats
     int       send_q_len_min; //! minimum send queue length
     long      fc_lower_limit; //! Flow-control interval lower limit
     long      fc_upper_limit; //! Flow-control interval upper limit
+    ssize_t   fc_lower_size_limit; //! Flow-control size interval lower limit
+    ssize_t   fc_upper_size_limit; //! Flow-control size interval upper limit
     int       fc_status;      //! Flow-control status (ON=1/OFF=0)
     bool      fc_active;      //! flow control is currently active
     bool      fc_requested;   //! flow control is requested by this node
+    long long fc_paced_ns;    //! total nanoseconds replication was paced
+    double    fc_pacing_rate; //! current pacing rate (actions/s), 0 - none
+    const char* fc_reason;    //! why flow control is requested by this node,
+                              //! reasons of other members are not known
 };
 
 /*! Fills stats struct */
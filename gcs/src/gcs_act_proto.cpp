@@ -1,11 +1,11 @@
 /*
- * Copyright (C) 2008-2013 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
 /*
  * Interface to action protocol
- * (to be extended to support protocol versions, currently supports only v0)
+ * (supports v0 and v1)
  */
 #include <errno.h>
 #include "gcs_act_proto.hpp"
@@ -22,10 +22,22 @@ bytes: 00 01                07 08       11 12       15 16       19 20
 PV - protocol version
 AT - action type
 
+  Version 1 header structure
+
+bytes: 00 01                07 08       11 12       15 16 17 18 19 20
+      +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+---
+      |PV|      act_id        |  act_size |  frag_no  |AT|rs|  AC |  data...
+      +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+---
+
+AC - action count: number of TORDERED actions batched in this one. Batched
+     action payload is a sequence of |size(4 bytes)|data| records, one for
+     each action, and each of them gets its own global seqno.
+
 */
 
 static const size_t PROTO_PV_OFFSET       = 0;
 static const size_t PROTO_AT_OFFSET       = 16;
+static const size_t PROTO_AC_OFFSET       = 18;
 static const size_t PROTO_DATA_OFFSET     = 20;
 // static const size_t PROTO_ACT_ID_OFFSET   = 0;
 // static const size_t PROTO_ACT_SIZE_OFFSET = 8;
@@ -58,7 +70,9 @@ gcs_act_proto_write (gcs_act_frag_t* frag, void* buf, size_t buf_len)
                   frag->act_type, PROTO_AT_MAX);
         return -EOVERFLOW;
     }
-    if (frag->proto_ver != PROTO_VERSION) return -EPROTO;
+    if (frag->proto_ver > PROTO_VERSION) return -EPROTO;
+    if (frag->proto_ver < GCS_ACT_PROTO_BATCH && frag->act_count != 1)
+        return -EPROTO;
     if (buf_len      < PROTO_DATA_OFFSET) return -EMSGSIZE;
 #endif
 
@@ -71,6 +85,12 @@ gcs_act_proto_write (gcs_act_frag_t* frag, void* buf, size_t buf_len)
     ((uint8_t *)buf)[PROTO_PV_OFFSET] = frag->proto_ver;
     ((uint8_t *)buf)[PROTO_AT_OFFSET] = frag->act_type;
 
+    if (frag->proto_ver >= GCS_ACT_PROTO_BATCH) {
+        assert (frag->act_count > 0 && frag->act_count <= 0xffff);
+        *(uint16_t*)((uint8_t*)buf + PROTO_AC_OFFSET) =
+            htogs((uint16_t)frag->act_count);
+    }
+
     frag->frag     = (uint8_t*)buf + PROTO_DATA_OFFSET;
     frag->frag_len = buf_len - PROTO_DATA_OFFSET;
 
@@ -107,6 +127,19 @@ gcs_act_proto_read (gcs_act_frag_t* frag, const void* buf, size_t buf_len)
     frag->frag     = ((uint8_t*)buf) + PROTO_DATA_OFFSET;
     frag->frag_len = buf_len - PROTO_DATA_OFFSET;
 
+    if (frag->proto_ver >= GCS_ACT_PROTO_BATCH) {
+        frag->act_count =
+            gtohs(*(uint16_t*)((uint8_t*)buf + PROTO_AC_OFFSET));
+
+        if (gu_unlikely(0 == frag->act_count)) {
+            gu_error ("Bad action count 0 in action message");
+            return -EBADMSG;
+        }
+    }
+    else {
+        frag->act_count = 1;
+    }
+
     /* return 0 or -EMSGSIZE */
     return ((frag->act_size > GCS_MAX_ACT_SIZE) * -EMSGSIZE);
 }
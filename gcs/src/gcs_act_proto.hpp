@@ -1,11 +1,11 @@
 /*
- * Copyright (C) 2008-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
 /*
  * Interface to action protocol
- * (to be extended to support protocol versions, currently supports only v0)
+ * (supports v0 and v1, the latter can carry several actions in one)
  */
 
 #ifndef _gcs_act_proto_h_
@@ -17,8 +17,11 @@
 #include <stdint.h>
 typedef uint8_t gcs_proto_t;
 
-/*! Supported protocol range (for now only version 0 is supported) */
-#define GCS_ACT_PROTO_MAX 0
+/*! Supported protocol range */
+#define GCS_ACT_PROTO_MAX 1
+
+/*! First protocol version which supports batched actions */
+#define GCS_ACT_PROTO_BATCH 1
 
 /*! Internal action fragment data representation */
 typedef struct gcs_act_frag
@@ -30,6 +33,7 @@ typedef struct gcs_act_frag
     unsigned long  frag_no;
     gcs_act_type_t act_type;
     int            proto_ver;
+    int            act_count; // number of actions batched in this one (v1+)
 }
 gcs_act_frag_t;
 
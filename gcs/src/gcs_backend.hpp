@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -73,6 +73,30 @@ long fn (gcs_backend_t* const backend,    \
          size_t         const len,        \
          gcs_msg_type_t const msg_type)
 
+/*!
+ * Send a message composed of several buffers from the backend (optional,
+ * send() is used if this is NULL).
+ *
+ * @param backend
+ *        a pointer to the backend handle
+ * @param bufs
+ *        message parts to be sent in a single message
+ * @param count
+ *        number of message parts
+ * @param len
+ *        total length of the message
+ * @param msg_type
+ *        type of the message
+ * @return
+ *        same as for send()
+ */
+#define GCS_BACKEND_SENDV_FN(fn)                \
+long fn (gcs_backend_t*       const backend,    \
+         const struct gu_buf* const bufs,       \
+         int                  const count,      \
+         size_t               const len,        \
+         gcs_msg_type_t       const msg_type)
+
 /*!
  * Receive a message from the backend.
  *
@@ -167,6 +191,7 @@ typedef GCS_BACKEND_DESTROY_FN   ((*gcs_backend_destroy_t));
 typedef GCS_BACKEND_OPEN_FN      ((*gcs_backend_open_t));
 typedef GCS_BACKEND_CLOSE_FN     ((*gcs_backend_close_t));
 typedef GCS_BACKEND_SEND_FN      ((*gcs_backend_send_t));
+typedef GCS_BACKEND_SENDV_FN     ((*gcs_backend_sendv_t));
 typedef GCS_BACKEND_RECV_FN      ((*gcs_backend_recv_t));
 typedef GCS_BACKEND_NAME_FN      ((*gcs_backend_name_t));
 typedef GCS_BACKEND_MSG_SIZE_FN  ((*gcs_backend_msg_size_t));
@@ -181,6 +206,7 @@ struct gcs_backend
     gcs_backend_close_t     close;
     gcs_backend_destroy_t   destroy;
     gcs_backend_send_t      send;
+    gcs_backend_sendv_t     sendv;
     gcs_backend_recv_t      recv;
     gcs_backend_name_t      name;
     gcs_backend_msg_size_t  msg_size;
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  *
@@ -25,6 +25,8 @@
 #include <string.h> // for mempcpy
 #include <errno.h>
 
+#include <vector>
+
 bool
 gcs_core_register (gu_config_t* conf)
 {
@@ -33,6 +35,7 @@ gcs_core_register (gu_config_t* conf)
 
 const size_t CORE_FIFO_LEN = (1 << 10); // 1024 elements (no need to have more)
 const size_t CORE_INIT_BUF_SIZE = (1 << 16); // 65K - IP packet size
+const int    CORE_FRAG_BUFS_MAX = 16; // max pieces in scatter-gather fragment
 
 typedef enum core_state
 {
@@ -44,6 +47,30 @@ typedef enum core_state
 }
 core_state_t;
 
+// this is to pass local action info from send to recv thread.
+typedef struct core_act
+{
+    gcs_seqno_t sent_act_id;
+    const void* action;
+    size_t      action_size;
+}
+core_act_t;
+
+// batched action being delivered one action at a time
+typedef struct core_batch
+{
+    const void*    buf;        // batch buffer (NULL in arbitrator)
+    const uint8_t* ptr;        // next action record in buf
+    size_t         left;       // bytes left in buf
+    size_t         size;       // nominal action size if buf is NULL
+    gcs_seqno_t    sent_act_id;
+    gcs_seqno_t    id;         // global seqno of next action or error code
+    int            count;      // actions left to deliver
+    int            sender_idx;
+    bool           local;
+}
+core_batch_t;
+
 struct gcs_core
 {
     gu_config_t*    config;
@@ -65,9 +92,11 @@ struct gcs_core
     void*           send_buf;
     size_t          send_buf_len;
     gcs_seqno_t     send_act_no;
+    long long       send_copied; // action bytes gathered into send_buf
 
     /* recv part */
     gcs_recv_msg_t  recv_msg;
+    core_batch_t    batch;
 
     /* local action FIFO */
     gcs_fifo_lite_t* fifo;
@@ -85,15 +114,6 @@ struct gcs_core
 #endif
 };
 
-// this is to pass local action info from send to recv thread.
-typedef struct core_act
-{
-    gcs_seqno_t sent_act_id;
-    const void* action;
-    size_t      action_size;
-}
-core_act_t;
-
 typedef struct causal_act
 {
     gcs_seqno_t* act_id;
@@ -102,7 +122,7 @@ typedef struct causal_act
     gu_cond_t*   cond;
 } causal_act_t;
 
-static int const GCS_PROTO_MAX = 0;
+static int const GCS_PROTO_MAX = 1;
 
 gcs_core_t*
 gcs_core_create (gu_config_t* const conf,
@@ -241,10 +261,12 @@ core_error (core_state_t state)
  * actions.
  */
 static inline ssize_t
-core_msg_send (gcs_core_t*    core,
-               const void*    msg,
-               size_t         msg_len,
-               gcs_msg_type_t msg_type)
+core_msg_sendv (gcs_core_t*          core,
+                const void*          msg,
+                const struct gu_buf* msg_bufs,
+                int                  msg_bufs_num,
+                size_t               msg_len,
+                gcs_msg_type_t       msg_type)
 {
     ssize_t ret;
 
@@ -254,7 +276,15 @@ core_msg_send (gcs_core_t*    core,
                       (CORE_EXCHANGE == core->state && GCS_MSG_STATE_MSG ==
                        msg_type))) {
 
-            ret = core->backend.send (&core->backend, msg, msg_len, msg_type);
+            if (NULL == msg_bufs) {
+                ret = core->backend.send (&core->backend, msg, msg_len,
+                                          msg_type);
+            }
+            else {
+                assert (core->backend.sendv);
+                ret = core->backend.sendv (&core->backend, msg_bufs,
+                                           msg_bufs_num, msg_len, msg_type);
+            }
 
             if (ret > 0 && ret != (ssize_t)msg_len &&
                 GCS_MSG_ACTION != msg_type) {
@@ -280,18 +310,30 @@ core_msg_send (gcs_core_t*    core,
     return ret;
 }
 
+static inline ssize_t
+core_msg_send (gcs_core_t*    core,
+               const void*    msg,
+               size_t         msg_len,
+               gcs_msg_type_t msg_type)
+{
+    return core_msg_sendv (core, msg, NULL, 0, msg_len, msg_type);
+}
+
 /*!
  * Repeats attempt at sending the message if -EAGAIN was returned
  * by core_msg_send()
  */
 static inline ssize_t
-core_msg_send_retry (gcs_core_t*    core,
-                     const void*    buf,
-                     size_t         buf_len,
-                     gcs_msg_type_t type)
+core_msg_sendv_retry (gcs_core_t*          core,
+                      const void*          buf,
+                      const struct gu_buf* bufs,
+                      int                  bufs_num,
+                      size_t               buf_len,
+                      gcs_msg_type_t       type)
 {
     ssize_t ret;
-    while ((ret = core_msg_send (core, buf, buf_len, type)) == -EAGAIN) {
+    while ((ret = core_msg_sendv (core, buf, bufs, bufs_num, buf_len, type))
+           == -EAGAIN) {
         /* wait for primary configuration - sleep 0.01 sec */
         gu_debug ("Backend requested wait");
         usleep (10000);
@@ -300,11 +342,25 @@ core_msg_send_retry (gcs_core_t*    core,
     return ret;
 }
 
-ssize_t
-gcs_core_send (gcs_core_t*          const conn,
-               const struct gu_buf* const action,
-               size_t                     act_size,
-               gcs_act_type_t       const act_type)
+static inline ssize_t
+core_msg_send_retry (gcs_core_t*    core,
+                     const void*    buf,
+                     size_t         buf_len,
+                     gcs_msg_type_t type)
+{
+    return core_msg_sendv_retry (core, buf, NULL, 0, buf_len, type);
+}
+
+/*!
+ * Sends action fragments. Local action(s) must already be in core FIFO
+ * and shall be removed from it by the caller in case of failure.
+ */
+static ssize_t
+core_send_action (gcs_core_t*          const conn,
+                  const struct gu_buf* const action,
+                  size_t                     act_size,
+                  gcs_act_type_t       const act_type,
+                  int                  const act_count)
 {
     ssize_t        ret  = 0;
     ssize_t        sent = 0;
@@ -313,8 +369,6 @@ gcs_core_send (gcs_core_t*          const conn,
     const unsigned char proto_ver = conn->proto_ver;
     const ssize_t  hdr_size       = gcs_act_proto_hdr_size (proto_ver);
 
-    core_act_t*    local_act;
-
     assert (action != NULL);
     assert (act_size > 0);
 
@@ -330,43 +384,61 @@ gcs_core_send (gcs_core_t*          const conn,
     frg.act_id    = conn->send_act_no; /* incremented for every new action */
     frg.frag_no   = 0;
     frg.proto_ver = proto_ver;
+    frg.act_count = act_count;
 
     if ((ret = gcs_act_proto_write (&frg, conn->send_buf, conn->send_buf_len)))
         return ret;
 
-    if ((local_act = (core_act_t*)gcs_fifo_lite_get_tail (conn->fifo))) {
-        *local_act = (core_act_t){ conn->send_act_no, action, act_size };
-        gcs_fifo_lite_push_tail (conn->fifo);
-    }
-    else {
-        ret = core_error (conn->state);
-        gu_error ("Failed to access core FIFO: %d (%s)", ret, strerror (-ret));
-        return ret;
-    }
-
     int            idx  = 0;
     const uint8_t* ptr  = (const uint8_t*)action[idx].ptr;
     size_t         left = action[idx].size;
 
+    /* fragment header followed by pieces of action buffers, to be passed
+     * to backend as is if it supports scatter-gather send */
+    struct gu_buf  frag_bufs[CORE_FRAG_BUFS_MAX];
+    frag_bufs[0].ptr  = conn->send_buf;
+    frag_bufs[0].size = hdr_size;
+
     do {
         const size_t chunk_size =
             act_size < frg.frag_len ? act_size : frg.frag_len;
 
         /* Here is the only time we have to cast frg.frag */
-        char* dst = (char*)frg.frag;
-        size_t to_copy = chunk_size;
+        char*  dst       = (char*)frg.frag;
+        size_t to_copy   = chunk_size;
+        int    bufs_num  = 1;
+        bool   gather    = (NULL == conn->backend.sendv);
 
         while (to_copy > 0) {        // gather action bufs into one
-            if (to_copy <= left) {
-                memcpy (dst, ptr, to_copy);
-                ptr     += to_copy;
-                left    -= to_copy;
-                to_copy = 0;
+            size_t const piece = to_copy <= left ? to_copy : left;
+
+            if (!gather && piece > 0) {
+                if (gu_likely(bufs_num < CORE_FRAG_BUFS_MAX)) {
+                    frag_bufs[bufs_num].ptr  = ptr;
+                    frag_bufs[bufs_num].size = piece;
+                    bufs_num++;
+                }
+                else {
+                    /* too fragmented, copy what was collected so far */
+                    for (int i = 1; i < bufs_num; i++) {
+                        memcpy (dst, frag_bufs[i].ptr, frag_bufs[i].size);
+                        dst += frag_bufs[i].size;
+                    }
+                    gather = true;
+                }
             }
-            else {
-                memcpy (dst, ptr, left);
-                dst     += left;
-                to_copy -= left;
+
+            if (gather) {
+                memcpy (dst, ptr, piece);
+                dst += piece;
+            }
+
+            ptr     += piece;
+            left    -= piece;
+            to_copy -= piece;
+
+            if (to_copy > 0) {
+                assert (0 == left);
                 idx++;
                 ptr  = (const uint8_t*)action[idx].ptr;
                 left = action[idx].size;
@@ -375,13 +447,16 @@ gcs_core_send (gcs_core_t*          const conn,
 
         send_size = hdr_size + chunk_size;
 
+        if (gather) conn->send_copied += chunk_size;
+
 #ifdef GCS_CORE_TESTING
         gu_lock_step_wait (&conn->ls); // pause after every fragment
         gu_info ("Sent %p of size %zu. Total sent: %zu, left: %zu",
                  (char*)conn->send_buf + hdr_size, chunk_size, sent, act_size);
 #endif
-        ret = core_msg_send_retry (conn, conn->send_buf, send_size,
-                                   GCS_MSG_ACTION);
+        ret = core_msg_sendv_retry (conn, conn->send_buf,
+                                    gather ? NULL : frag_bufs, bufs_num,
+                                    send_size, GCS_MSG_ACTION);
         GU_DBUG_SYNC_WAIT("gcs_core_after_frag_send");
 #ifdef GCS_CORE_TESTING
 //        gu_lock_step_wait (&conn->ls); // pause after every fragment
@@ -435,9 +510,9 @@ gcs_core_send (gcs_core_t*          const conn,
              *  so that there is nothing to remove, but we cannot know for sure)
              *
              * 1. Action will never be received completely by this node. Hence
-             *    action must be removed from fifo on behalf of sending thr.: */
-            gcs_fifo_lite_remove (conn->fifo);
-            /* 2. Members will have to discard received fragments.
+             *    action must be removed from fifo on behalf of sending thr.
+             *    (done by the caller)
+             * 2. Members will have to discard received fragments.
              * Two reasons could lead us here: new member(s) in configuration
              * change or broken connection (leave group). In both cases other
              * members discard fragments */
@@ -457,6 +532,106 @@ out:
     return ret;
 }
 
+ssize_t
+gcs_core_send (gcs_core_t*          const conn,
+               const struct gu_buf* const action,
+               size_t                     act_size,
+               gcs_act_type_t       const act_type)
+{
+    core_act_t* local_act;
+
+    assert (action != NULL);
+    assert (act_size > 0);
+
+    if ((local_act = (core_act_t*)gcs_fifo_lite_get_tail (conn->fifo))) {
+        *local_act = (core_act_t){ conn->send_act_no, action, act_size };
+        gcs_fifo_lite_push_tail (conn->fifo);
+    }
+    else {
+        ssize_t const ret(core_error (conn->state));
+        gu_error ("Failed to access core FIFO: %d (%s)", ret, strerror (-ret));
+        return ret;
+    }
+
+    ssize_t const ret(core_send_action (conn, action, act_size, act_type, 1));
+
+    if (ret < 0) {
+        /* action will never be received by this node */
+        gcs_fifo_lite_remove (conn->fifo);
+    }
+
+    return ret;
+}
+
+ssize_t
+gcs_core_send_batch (gcs_core_t*                      const conn,
+                     const struct gcs_core_batch_act* const acts,
+                     int                              const acts_num)
+{
+    assert (acts_num > 0 && acts_num <= GCS_CORE_BATCH_MAX);
+
+    if (gu_unlikely(conn->proto_ver < GCS_ACT_PROTO_BATCH))
+        return -EPROTONOSUPPORT;
+
+    /* batch payload is a sequence of |size|data| records, action buffers
+     * are sent as is, interleaved with size headers */
+    std::vector<uint32_t>      sizes(acts_num);
+    std::vector<struct gu_buf> bufs;
+    bufs.reserve(acts_num * 2);
+
+    size_t batch_size(0);
+
+    for (int i = 0; i < acts_num; i++) {
+        assert (acts[i].size > 0);
+
+        sizes[i] = htogl(uint32_t(acts[i].size));
+        struct gu_buf const hdr = { &sizes[i], sizeof(sizes[i]) };
+        bufs.push_back(hdr);
+
+        size_t left(acts[i].size);
+        for (const struct gu_buf* b = acts[i].act; left > 0; b++) {
+            assert (size_t(b->size) <= left);
+            bufs.push_back(*b);
+            left -= b->size;
+        }
+
+        batch_size += sizeof(sizes[i]) + acts[i].size;
+    }
+
+    if (gu_unlikely(batch_size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
+
+    int pushed(0);
+
+    for (; pushed < acts_num; pushed++) {
+        core_act_t* const local_act
+            ((core_act_t*)gcs_fifo_lite_get_tail (conn->fifo));
+
+        if (gu_unlikely(NULL == local_act)) break;
+
+        *local_act = (core_act_t){ conn->send_act_no, acts[pushed].act,
+                                   acts[pushed].size };
+        gcs_fifo_lite_push_tail (conn->fifo);
+    }
+
+    ssize_t ret;
+
+    if (gu_likely(pushed == acts_num)) {
+        ret = core_send_action (conn, &bufs[0], batch_size, GCS_ACT_TORDERED,
+                                acts_num);
+    }
+    else {
+        ret = core_error (conn->state);
+        gu_error ("Failed to access core FIFO: %d (%s)", ret, strerror (-ret));
+    }
+
+    if (ret < 0) {
+        /* none of the actions will be received by this node */
+        while (pushed--) gcs_fifo_lite_remove (conn->fifo);
+    }
+
+    return ret;
+}
+
 /* A helper for gcs_core_recv().
  * Deals with fetching complete message from backend
  * and reallocates recv buf if needed */
@@ -500,6 +675,160 @@ core_msg_recv (gcs_backend_t* backend, gcs_recv_msg_t* recv_msg,
     return ret;
 }
 
+/*!
+ * Helper for gcs_core_recv(). Delivers next action from received batch.
+ *
+ * @return action size or negative error code.
+ */
+static ssize_t
+core_batch_next (gcs_core_t* core, struct gcs_act_rcvd* act)
+{
+    core_batch_t* const batch = &core->batch;
+    void*   buf  = NULL;
+    size_t  size;
+    ssize_t ret;
+
+    assert (batch->count > 0);
+
+#ifndef GCS_FOR_GARB
+    uint32_t hdr;
+
+    if (gu_unlikely(batch->left < sizeof(hdr))) goto malformed;
+
+    memcpy (&hdr, batch->ptr, sizeof(hdr));
+    size = gtohl(hdr);
+    batch->ptr  += sizeof(hdr);
+    batch->left -= sizeof(hdr);
+
+    if (gu_unlikely(size > batch->left)) goto malformed;
+
+    buf = gcs_gcache_malloc (core->cache, size);
+    if (gu_unlikely(NULL == buf)) {
+        gu_fatal ("Failed to allocate %zu bytes for batched action", size);
+        ret = -ENOMEM;
+        goto error;
+    }
+
+    memcpy (buf, batch->ptr, size);
+    batch->ptr  += size;
+    batch->left -= size;
+#else
+    /* action contents is not allocated, only sizes matter */
+    size = batch->count > 1 ? batch->size : batch->left;
+    batch->left -= size;
+#endif /* GCS_FOR_GARB */
+
+    act->act.buf     = buf;
+    act->act.buf_len = size;
+    act->act.type    = GCS_ACT_TORDERED;
+    act->sender_idx  = batch->sender_idx;
+    act->id          = batch->id;
+    ret              = size;
+
+    if (batch->id > 0) batch->id++; // otherwise an error code for all
+
+    if (batch->local) {
+        /* local actions were put in FIFO in the order of the batch */
+        core_act_t* const local_act
+            ((core_act_t*)gcs_fifo_lite_get_head (core->fifo));
+
+        if (gu_likely(NULL != local_act)) {
+            act->local = (const struct gu_buf*)local_act->action;
+            size_t      const local_size  = local_act->action_size;
+            gcs_seqno_t const sent_act_id = local_act->sent_act_id;
+            gcs_fifo_lite_pop_head (core->fifo);
+
+            if (gu_unlikely(sent_act_id != batch->sent_act_id)) {
+                gu_fatal ("FIFO violation: expected sent_act_id %lld "
+                          "found %lld", sent_act_id, batch->sent_act_id);
+                ret = -ENOTRECOVERABLE;
+            }
+#ifndef GCS_FOR_GARB
+            if (gu_unlikely(local_size != size)) {
+                gu_fatal ("Send/recv batched action size mismatch: %zu/%zu",
+                          local_size, size);
+                ret = -ENOTRECOVERABLE;
+            }
+#else
+            act->act.buf_len = ret = local_size;
+#endif /* GCS_FOR_GARB */
+        }
+        else {
+            gu_fatal ("FIFO violation: queue empty when local action "
+                      "received");
+            ret = -ENOTRECOVERABLE;
+        }
+    }
+
+    if (gu_unlikely(ret < 0)) goto error;
+
+    if (0 == --batch->count) {
+        if (gu_unlikely(batch->left > 0)) goto malformed;
+        if (batch->buf) gcs_gcache_free (core->cache, batch->buf);
+        memset (batch, 0, sizeof(*batch));
+    }
+
+    return ret;
+
+malformed:
+    gu_fatal ("Malformed batched action from member %d: %d actions left, "
+              "%zu bytes left", batch->sender_idx, batch->count, batch->left);
+    ret = -ENOTRECOVERABLE;
+
+error:
+    if (buf) gcs_gcache_free (core->cache, buf);
+    act->act.buf     = NULL;
+    act->act.buf_len = 0;
+    act->act.type    = GCS_ACT_ERROR;
+    act->id          = GCS_SEQNO_ILL;
+    act->sender_idx  = -1;
+    act->local       = NULL;
+
+    return ret;
+}
+
+/*!
+ * Helper for core_handle_act_msg(). Sets up delivery of the complete
+ * batched action received in act and delivers the first action of it.
+ */
+static ssize_t
+core_batch_start (gcs_core_t*           core,
+                  const gcs_act_frag_t* frg,
+                  struct gcs_act_rcvd*  act,
+                  bool                  local)
+{
+    core_batch_t* const batch = &core->batch;
+
+    assert (0 == batch->count);
+
+    batch->buf         = act->act.buf;
+    batch->ptr         = (const uint8_t*)act->act.buf;
+    batch->left        = act->act.buf_len;
+    batch->size        = act->act.buf_len / frg->act_count;
+    batch->sent_act_id = frg->act_id;
+    batch->id          = act->id;
+    batch->count       = frg->act_count;
+    batch->sender_idx  = act->sender_idx;
+    batch->local       = local;
+
+    if (gu_unlikely(GCS_ACT_TORDERED != act->act.type)) {
+        gu_fatal ("Protocol violation: batched action of type %s",
+                  gcs_act_type_to_str(act->act.type));
+        batch->count = 0;
+        return -ENOTRECOVERABLE;
+    }
+
+    if (local && gu_unlikely(CORE_PRIMARY != core->state)) {
+        assert (batch->id < 0);
+        if (batch->id < 0) batch->id = core_error (core->state);
+    }
+
+    act->act.buf     = NULL;
+    act->act.buf_len = 0;
+
+    return core_batch_next (core, act);
+}
+
 /*!
  * Helper for gcs_core_recv(). Handles GCS_MSG_ACTION.
  *
@@ -557,6 +886,11 @@ core_handle_act_msg (gcs_core_t*          core,
 #endif
             assert(act->sender_idx == msg->sender_idx);
 
+            if (gu_unlikely(frg.act_count > 1)) {
+                /* actions will be delivered one by one */
+                return core_batch_start (core, &frg, act, my_msg);
+            }
+
             if (gu_likely(!my_msg)) {
                 /* foreign action, must be passed from gcs_group */
                 assert (GCS_ACT_TORDERED != act->act.type || act->id > 0);
@@ -1096,6 +1430,12 @@ ssize_t gcs_core_recv (gcs_core_t*          conn,
 
     *recv_act = zero_act;
 
+    if (gu_unlikely(conn->batch.count > 0)) {
+        /* deliver the rest of the last received batch first */
+        ret = core_batch_next (conn, recv_act);
+        goto out;
+    }
+
     /* receive messages from group and demultiplex them
      * until finally some complete action is ready */
     do
@@ -1244,6 +1584,8 @@ long gcs_core_destroy (gcs_core_t* core)
     gcs_fifo_lite_destroy (core->fifo);
     gcs_group_free (&core->group);
 
+    if (core->batch.buf) gcs_gcache_free (core->cache, core->batch.buf);
+
     /* free buffers */
     gu_free (core->recv_msg.buf);
     gu_free (core->send_buf);
@@ -1460,6 +1802,12 @@ gcs_core_get_backend (gcs_core_t* core)
     return &core->backend;
 }
 
+long long
+gcs_core_send_copied (const gcs_core_t* core)
+{
+    return core->send_copied;
+}
+
 void
 gcs_core_send_lock_step (gcs_core_t* core, bool enable)
 {
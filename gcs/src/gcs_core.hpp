@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -105,6 +105,35 @@ gcs_core_send (gcs_core_t*          core,
                size_t               act_size,
                gcs_act_type_t       act_type);
 
+/*! Maximum number of actions in a batch */
+#define GCS_CORE_BATCH_MAX 256
+
+/*! An action to be sent in a batch: scatter-gather buffers and total size */
+struct gcs_core_batch_act
+{
+    const struct gu_buf* act;
+    size_t               size;
+};
+
+/*
+ * gcs_core_send_batch() atomically sends several TORDERED actions to group
+ * in one message. Receivers get them from gcs_core_recv() one by one, with
+ * consecutive global seqnos. Local actions are matched in the order given.
+ *
+ * NOT THREAD SAFE! Access should be serialized.
+ *
+ * Return values:
+ * non-negative - amount of batch bytes sent (sans headers)
+ * negative     - error code, as in gcs_core_send(), none of the actions
+ *                was sent.
+ *                -EPROTONOSUPPORT - group protocol does not support batching,
+ *                                   actions should be sent one by one
+ */
+extern ssize_t
+gcs_core_send_batch (gcs_core_t*                      core,
+                     const struct gcs_core_batch_act* acts,
+                     int                              acts_num);
+
 /*
  * gcs_core_recv() blocks until some action is received from group.
  *
@@ -187,6 +216,10 @@ gcs_core_get_group (const gcs_core_t* core);
 extern gcs_backend_t*
 gcs_core_get_backend (gcs_core_t* core);
 
+// number of action bytes copied into the send buffer so far
+extern long long
+gcs_core_send_copied (const gcs_core_t* core);
+
 // switches lock-step mode on/off
 extern void
 gcs_core_send_lock_step (gcs_core_t* core, bool enable);
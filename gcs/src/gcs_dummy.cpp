@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -35,16 +35,14 @@ typedef struct dummy_msg
 dummy_msg_t;
 
 static inline dummy_msg_t*
-dummy_msg_create (gcs_msg_type_t const type,
-                  size_t         const len,
-                  long           const sender,
-                  const void*    const buf)
+dummy_msg_alloc (gcs_msg_type_t const type,
+                 size_t         const len,
+                 long           const sender)
 {
     dummy_msg_t *msg = NULL;
 
     if ((msg = static_cast<dummy_msg_t*>(gu_malloc (sizeof(dummy_msg_t) + len))))
     {
-        memcpy (msg->buf, buf, len);
         msg->len        = len;
         msg->type       = type;
         msg->sender_idx = sender;
@@ -53,6 +51,19 @@ dummy_msg_create (gcs_msg_type_t const type,
     return msg;
 }
 
+static inline dummy_msg_t*
+dummy_msg_create (gcs_msg_type_t const type,
+                  size_t         const len,
+                  long           const sender,
+                  const void*    const buf)
+{
+    dummy_msg_t *msg = dummy_msg_alloc (type, len, sender);
+
+    if (msg) memcpy (msg->buf, buf, len);
+
+    return msg;
+}
+
 static inline long
 dummy_msg_destroy (dummy_msg_t *msg)
 {
@@ -124,6 +135,44 @@ GCS_BACKEND_SEND_FN(dummy_send)
     return err;
 }
 
+static long
+dummy_msg_queue (gcs_backend_t* const backend,
+                 dummy_msg_t*   const msg);
+
+static
+GCS_BACKEND_SENDV_FN(dummy_sendv)
+{
+    dummy_t* dummy = backend->conn;
+
+    if (gu_unlikely(NULL == dummy)) return -EBADFD;
+
+    if (gu_likely(DUMMY_PRIM == dummy->state))
+    {
+        size_t const send_size = len < dummy->max_send_size ?
+                                 len : dummy->max_send_size;
+        dummy_msg_t* const msg = dummy_msg_alloc (msg_type, send_size,
+                                                  dummy->my_idx);
+        if (!msg) return -ENOMEM;
+
+        size_t copied = 0;
+        for (int i = 0; i < count && copied < send_size; i++)
+        {
+            size_t const chunk = send_size - copied < size_t(bufs[i].size) ?
+                                 send_size - copied : bufs[i].size;
+            memcpy (msg->buf + copied, bufs[i].ptr, chunk);
+            copied += chunk;
+        }
+        assert (copied == send_size);
+
+        return dummy_msg_queue (backend, msg);
+    }
+    else {
+        static long send_error[DUMMY_PRIM] =
+            { -EBADFD, -EBADFD, -ENOTCONN, -EAGAIN };
+        return send_error[dummy->state];
+    }
+}
+
 static
 GCS_BACKEND_RECV_FN(dummy_recv)
 {
@@ -298,6 +347,7 @@ GCS_BACKEND_CREATE_FN(gcs_dummy_create)
     backend->close     = dummy_close;
     backend->destroy   = dummy_destroy;
     backend->send      = dummy_send;
+    backend->sendv     = dummy_sendv;
     backend->recv      = dummy_recv;
     backend->name      = dummy_name;
     backend->msg_size  = dummy_msg_size;
@@ -326,28 +376,36 @@ gcs_dummy_inject_msg (gcs_backend_t* backend,
                       gcs_msg_type_t type,
                       long           sender_idx)
 {
-    long         ret;
     size_t       send_size = buf_len < backend->conn->max_send_size ?
                              buf_len : backend->conn->max_send_size;
     dummy_msg_t* msg = dummy_msg_create (type, send_size, sender_idx, buf);
 
     if (msg)
     {
-        dummy_msg_t** ptr = static_cast<dummy_msg_t**>(
-            gu_fifo_get_tail (backend->conn->gc_q));
+        return dummy_msg_queue (backend, msg);
+    }
+    else {
+        return -ENOMEM;
+    }
+}
 
-        if (gu_likely(ptr != NULL)) {
-            *ptr = msg;
-            gu_fifo_push_tail (backend->conn->gc_q);
-            ret = send_size;
-        }
-        else {
-            dummy_msg_destroy (msg);
-            ret = -EBADFD; // closed
-        }
+/*! Puts message into the "serializator", returns message length */
+static long
+dummy_msg_queue (gcs_backend_t* const backend,
+                 dummy_msg_t*   const msg)
+{
+    long ret;
+    dummy_msg_t** ptr = static_cast<dummy_msg_t**>(
+        gu_fifo_get_tail (backend->conn->gc_q));
+
+    if (gu_likely(ptr != NULL)) {
+        ret  = msg->len; // msg may be gone after push
+        *ptr = msg;
+        gu_fifo_push_tail (backend->conn->gc_q);
     }
     else {
-        ret = -ENOMEM;
+        dummy_msg_destroy (msg);
+        ret = -EBADFD; // closed
     }
 
     return ret;
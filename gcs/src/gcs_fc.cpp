@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -11,6 +11,9 @@
 
 #include <galerautils.h>
 #include <string.h>
+#include <math.h>
+
+#include <algorithm>
 
 double const gcs_fc_hard_limit_fix = 0.9; //! allow for some overhead
 
@@ -204,3 +207,144 @@ gcs_fc_process (gcs_fc_t* fc, ssize_t act_size)
 }
 
 void gcs_fc_debug (gcs_fc_t* fc, long debug_level) { fc->debug = debug_level; }
+
+double const gcs_fc_rate_min = 0.25;
+
+const char* const gcs_fc_reason_str[GCS_FC_REASON_MAX] =
+{
+    "none",
+    "queue length",
+    "queue size",
+    "state transfer"
+};
+
+static long long const rate_interval = 100000000LL; //! measurement period
+static long long const rate_min_interval = 1000000LL; //! shortest period
+static long long const rate_min_gap  = 10000000LL; //! between advertisements
+static double    const rate_change   = 0.1; //! relative change to advertise
+static double    const burst_time    = 0.01; //! bucket capacity (s)
+static long long const max_wait      = 1000000000LL; //! 1s
+
+void
+gcs_fc_rate_reset (gcs_fc_rate_t* const fr, long long const now)
+{
+    fr->apply_rate = 0.0;
+    fr->advertised = 0.0;
+    fr->count      = 0;
+    fr->start      = now;
+    fr->last       = now;
+}
+
+/*
+ *   advertised
+ *      rate
+ *       ^
+ *  1.375|    +
+ *       |    |  \
+ *       |    |     \
+ *   1.0 |    |        +           advertised = apply_rate *
+ *       |    |        |  \         (1 - 0.75 * (len - limit/2) / (limit/2))
+ *       |    |        |     \
+ *  0.25 |    |        |        +---
+ *       |    |        |        |
+ *       +----+--------+--------+---> slave queue length
+ *          limit/4  limit/2  limit
+ *
+ * Pacing starts when the queue grows over limit/2 and stops when it drains
+ * below limit/4, in between the rate is advertised as a fraction of the
+ * measured apply rate.
+ */
+bool
+gcs_fc_rate_check (gcs_fc_rate_t* const fr, long const queue_len,
+                   long const limit, long long const now, double* const rate)
+{
+    long const      start(limit / 2);
+    long const      stop (limit / 4);
+    bool const      limited(fr->advertised > 0.0);
+    long long const interval(now - fr->start);
+
+    if (!limited && queue_len <= start && interval < rate_interval) {
+        return false;
+    }
+
+    if (interval >= rate_interval ||
+        (!limited && queue_len > start && interval >= rate_min_interval)) {
+        /* exponential smoothing with the previous measurement */
+        double const measured(fr->count * 1.0e9 / interval);
+        fr->apply_rate = fr->apply_rate > 0.0 ?
+            (fr->apply_rate + measured) * 0.5 : measured;
+        fr->count = 0;
+        fr->start = now;
+    }
+
+    double desired(0.0); // unlimited
+
+    if (queue_len > stop && (limited || queue_len > start) &&
+        fr->apply_rate > 0.0) {
+        double const fill(double(queue_len - start) /
+                          std::max(1L, limit - start));
+        desired = fr->apply_rate *
+            std::max(gcs_fc_rate_min, 1.0 - (1.0 - gcs_fc_rate_min) * fill);
+        desired = std::max(desired, 1.0); // 0 means unlimited
+    }
+
+    if (limited == (desired > 0.0)) {
+        /* no transition, only considerable changes are worth advertising */
+        if (!limited || now - fr->last < rate_min_gap ||
+            ::fabs(desired - fr->advertised) <= fr->advertised * rate_change) {
+            return false;
+        }
+    }
+
+    fr->advertised = desired;
+    fr->last       = now;
+    *rate          = desired;
+
+    return true;
+}
+
+void
+gcs_fc_bucket_set_rate (gcs_fc_bucket_t* const fb, double const rate,
+                        long long const now)
+{
+    assert (rate >= 0.0);
+
+    if (0.0 == fb->rate || 0.0 == rate) {
+        fb->tokens = 0.0;
+        fb->last   = now;
+    }
+    else if (fb->tokens < 0.0) {
+        /* reservations made at the old rate are repaid at the new one */
+        fb->tokens = std::max(fb->tokens, -rate * max_wait * 1.0e-9);
+    }
+
+    fb->rate = rate;
+}
+
+long long
+gcs_fc_bucket_take (gcs_fc_bucket_t* const fb, long long const now)
+{
+    if (0.0 == fb->rate) return 0;
+
+    double const burst(std::max(1.0, fb->rate * burst_time));
+
+    if (now > fb->last) {
+        fb->tokens = std::min(burst,
+                              fb->tokens + (now - fb->last) * 1.0e-9 * fb->rate);
+        fb->last   = now;
+    }
+
+    fb->tokens -= 1.0;
+
+    if (fb->tokens >= 0.0) return 0;
+
+    long long const wait(-fb->tokens / fb->rate * 1.0e9);
+
+    if (wait > max_wait) {
+        /* don't let the debt grow beyond max_wait */
+        fb->tokens += 1.0;
+        return max_wait;
+    }
+
+    return wait;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -56,4 +56,115 @@ gcs_fc_process (gcs_fc_t* fc, ssize_t act_size);
 extern void
 gcs_fc_debug (gcs_fc_t* fc, long debug_level);
 
+/*
+ * Rate based flow control (gcs.fc_pacing).
+ *
+ * Instead of stopping replication when slave queue grows over the limit each
+ * node measures the rate at which it takes actions off its slave queue and,
+ * once the queue is more than half full, advertises the replication rate it
+ * can sustain. The rate is scaled in proportion to the distance of the queue
+ * length from the half of the limit, so that the queue settles there instead
+ * of oscillating between the limits. The limit is lifted when the queue
+ * drains below a quarter. Senders pace replication with a token bucket
+ * filled at their share of the rate advertised by the slowest member.
+ *
+ * gcs.fc_pacing must be enabled on every node: a node without it neither
+ * advertises its rate nor paces to the rates of others, so the group falls
+ * back to FC_STOP/FC_CONT, which stay in effect in either case.
+ */
+
+/*! Rate advertised at the upper queue limit as a fraction of the measured
+ *  apply rate */
+extern double const gcs_fc_rate_min;
+
+typedef struct gcs_fc_rate
+{
+    double    apply_rate; // smoothed rate of taking actions off the queue
+    double    advertised; // last advertised rate (actions/s), 0 - unlimited
+    long      count;      // actions taken off the queue in current interval
+    long long start;      // beginning of the interval (nanosec, monotonic)
+    long long last;       // time of the last advertisement
+}
+gcs_fc_rate_t;
+
+/*! Resets apply rate measurement */
+extern void
+gcs_fc_rate_reset (gcs_fc_rate_t* fr, long long now);
+
+/*! Accounts for an action taken off the slave queue */
+static inline void
+gcs_fc_rate_dequeue (gcs_fc_rate_t* fr) { fr->count++; }
+
+/*! Updates apply rate measurement if the measurement interval has passed
+ *  and decides whether the rate to advertise has changed.
+ *  @param queue_len current slave queue length
+ *  @param limit     upper slave queue limit
+ *  @param rate      rate to advertise (actions/s), 0 - unlimited
+ *  @return true if the new rate should be advertised to the group */
+extern bool
+gcs_fc_rate_check (gcs_fc_rate_t* fr, long queue_len, long limit,
+                   long long now, double* rate);
+
+typedef struct gcs_fc_bucket
+{
+    double    rate;   // refill rate (tokens/s), 0 - unlimited
+    double    tokens; // tokens available, negative when reserved in advance
+    long long last;   // time of the last refill (nanosec, monotonic)
+}
+gcs_fc_bucket_t;
+
+/*! Sets refill rate, 0 disables pacing */
+extern void
+gcs_fc_bucket_set_rate (gcs_fc_bucket_t* fb, double rate, long long now);
+
+/*! Takes a token for sending an action.
+ *  @return nanoseconds to wait before sending */
+extern long long
+gcs_fc_bucket_take (gcs_fc_bucket_t* fb, long long now);
+
+/*
+ * Slave queue limits for FC_STOP/FC_CONT, by length and by size in bytes.
+ */
+
+/*! Reasons for this node to request flow control */
+typedef enum gcs_fc_reason
+{
+    GCS_FC_REASON_NONE,
+    GCS_FC_REASON_LENGTH, // slave queue length over the limit
+    GCS_FC_REASON_SIZE,   // slave queue size over the limit
+    GCS_FC_REASON_SST,    // state transfer throttling (stfc)
+    GCS_FC_REASON_MAX
+}
+gcs_fc_reason_t;
+
+extern const char* const gcs_fc_reason_str[GCS_FC_REASON_MAX];
+
+/*! Returns which of the upper slave queue limits is exceeded, if any.
+ *  @param size_limit  upper size limit, 0 - size is not limited
+ *  @param size_offset allowance over the size limit (catch-up phase) */
+static inline gcs_fc_reason_t
+gcs_fc_over_limit (long    const len,  long    const len_limit,
+                   ssize_t const size, ssize_t const size_limit,
+                   ssize_t const size_offset)
+{
+    if (len > len_limit) return GCS_FC_REASON_LENGTH;
+
+    if (size_limit > 0 && size > size_limit + size_offset)
+    {
+        return GCS_FC_REASON_SIZE;
+    }
+
+    return GCS_FC_REASON_NONE;
+}
+
+/*! Returns true if slave queue is within both lower limits
+ *  @param size_limit upper size limit, 0 - size is not limited */
+static inline bool
+gcs_fc_under_limit (long    const len,  long    const len_lower,
+                    ssize_t const size, ssize_t const size_limit,
+                    ssize_t const size_lower)
+{
+    return (len_lower >= len && (size_limit <= 0 || size_lower >= size));
+}
+
 #endif /* _gcs_fc_h_ */
@@ -1,13 +1,9 @@
 /*
- * Copyright (C) 2009-2019 Codership Oy <info@codership.com>
+ * Copyright (C) 2009-2026 Codership Oy <info@codership.com>
  */
 
 /*!
  * @file GComm GCS Backend implementation
- *
- * @todo Figure out if there is lock-free way to handle RecvBuf
- *       push/pop operations.
- *
  */
 
 
@@ -26,8 +22,9 @@
 #include <gu_logger.hpp>
 #include <gu_barrier.hpp>
 #include <gu_thread.hpp>
+#include <gu_spsc_queue.hpp>
 
-#include <deque>
+#include <unistd.h> // sysconf()
 
 using namespace std;
 using namespace gu;
@@ -57,25 +54,14 @@ private:
     ProtoUpMeta um_;
 };
 
-#if defined(GALERA_USE_BOOST_POOL_ALLOC)
-
-#include <boost/pool/pool_alloc.hpp>
-
-typedef deque<RecvBufData,
-              boost::fast_pool_allocator<
-                  RecvBufData,
-                  boost::default_user_allocator_new_delete,
-                  boost::details::pool::null_mutex
-                  >
-              >
-#else
-
-typedef deque<RecvBufData>
-
-#endif /* GALERA_USE_BOOST_POOL_ALLOC */
-
-RecvBufQueue;
-
+/*
+ * Hands datagrams over from gcomm thread to GCS receiving thread.
+ *
+ * Pushes happen under Protonet lock and reading is done by a single GCS
+ * receiving thread, so the queue is accessed without locking. Receiving
+ * thread spins for a while on empty queue before parking on the condition,
+ * producer takes the mutex only if the consumer is parked.
+ */
 class RecvBuf
 {
 private:
@@ -83,10 +69,10 @@ private:
     class Waiting
     {
     public:
-        Waiting (bool& w) : w_(w) { w_ = true;  }
-        ~Waiting()                { w_ = false; }
+        Waiting (gu::Atomic<int>& w) : w_(w) { w_ = 1; }
+        ~Waiting()                           { w_ = 0; }
     private:
-        bool& w_;
+        gu::Atomic<int>& w_;
     };
 
 public:
@@ -100,24 +86,44 @@ public:
         mutex_(),
         cond_(),
 #endif /* HAVE_PSI_INTERFACE */
-        queue_(), waiting_(false) { }
+        queue_(), waiting_(0),
+        // spinning on uniprocessor only delays the producer
+        spin_limit_(sysconf(_SC_NPROCESSORS_ONLN) > 1 ? spin_max_ : 0)
+    { }
 
     void push_back(const RecvBufData& p)
     {
-        Lock lock(mutex_);
-
-        queue_.push_back(p);
+        queue_.push(p);
 
-        if (waiting_ == true) { cond_.signal(); }
+        // consumer sets waiting_ before checking the queue under the mutex,
+        // so either it sees the datagram or we see it waiting
+        if (waiting_() != 0)
+        {
+            Lock lock(mutex_);
+            cond_.signal();
+        }
     }
 
     const RecvBufData& front(const Date& timeout)
     {
+        RecvBufData* ret(queue_.front());
+
+        for (int i(0); ret == 0 && i < spin_limit_; ++i)
+        {
+            cpu_relax();
+            ret = queue_.front();
+        }
+
+        if (ret != 0) return *ret;
+
         Lock lock(mutex_);
 
-        while (queue_.empty())
+        while (true)
         {
             Waiting w(waiting_);
+
+            if ((ret = queue_.front()) != 0) break;
+
             if (gu_likely (timeout == GU_TIME_ETERNITY))
             {
                 lock.wait(cond_);
@@ -127,20 +133,31 @@ public:
                 lock.wait(cond_, timeout);
             }
         }
-        assert (false == waiting_);
+        assert (0 == waiting_());
 
-        return queue_.front();
+        return *ret;
     }
 
     void pop_front()
     {
-        Lock lock(mutex_);
-        assert(queue_.empty() == false);
-        queue_.pop_front();
+        assert(queue_.front() != 0);
+        queue_.pop();
     }
 
 private:
 
+    static void cpu_relax()
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    // number of queue polls before parking on multiprocessor
+    static const int spin_max_ = 512;
+
 #ifdef HAVE_PSI_INTERFACE
     gu::MutexWithPFS mutex_;
     gu::CondWithPFS cond_;
@@ -148,8 +165,9 @@ private:
     gu::Mutex mutex_;
     gu::Cond cond_;
 #endif /* HAVE_PSI_INTERFACE */
-    RecvBufQueue queue_;
-    bool waiting_;
+    gu::SpscQueue<RecvBufData> queue_;
+    gu::Atomic<int> waiting_;
+    int const spin_limit_;
 };
 
 class GCommConn : public Toplay
@@ -568,22 +586,11 @@ static GCS_BACKEND_MSG_SIZE_FN(gcomm_msg_size)
 }
 
 
-static GCS_BACKEND_SEND_FN(gcomm_send)
+static long gcomm_send_dg(GCommConn&           conn,
+                          Datagram&            dg,
+                          size_t         const len,
+                          gcs_msg_type_t const msg_type)
 {
-    GCommConn::Ref ref(backend);
-
-    if (gu_unlikely(ref.get() == 0))
-    {
-        return -EBADFD;
-    }
-
-    GCommConn& conn(*ref.get());
-
-    Datagram dg(
-        SharedBuffer(
-            new Buffer(reinterpret_cast<const byte_t*>(buf),
-                       reinterpret_cast<const byte_t*>(buf) + len)));
-
     int err;
     // Set thread scheduling params if gcomm thread runs with
     // non-default params
@@ -632,6 +639,50 @@ static GCS_BACKEND_SEND_FN(gcomm_send)
     return (err == 0 ? len : -err);
 }
 
+static GCS_BACKEND_SEND_FN(gcomm_send)
+{
+    GCommConn::Ref ref(backend);
+
+    if (gu_unlikely(ref.get() == 0))
+    {
+        return -EBADFD;
+    }
+
+    Datagram dg(
+        SharedBuffer(
+            new Buffer(reinterpret_cast<const byte_t*>(buf),
+                       reinterpret_cast<const byte_t*>(buf) + len)));
+
+    return gcomm_send_dg(*ref.get(), dg, len, msg_type);
+}
+
+static GCS_BACKEND_SENDV_FN(gcomm_sendv)
+{
+    GCommConn::Ref ref(backend);
+
+    if (gu_unlikely(ref.get() == 0))
+    {
+        return -EBADFD;
+    }
+
+    /* gather message parts directly into the datagram buffer */
+    Buffer* const buffer(new Buffer());
+    SharedBuffer sb(buffer);
+    buffer->reserve(len);
+
+    for (int i(0); i < count; ++i)
+    {
+        const byte_t* const ptr(static_cast<const byte_t*>(bufs[i].ptr));
+        buffer->insert(buffer->end(), ptr, ptr + bufs[i].size);
+    }
+
+    assert(buffer->size() == len);
+
+    Datagram dg(sb);
+
+    return gcomm_send_dg(*ref.get(), dg, len, msg_type);
+}
+
 
 static void fill_cmp_msg(const View& view, const gcomm::UUID& my_uuid,
                          gcs_comp_msg_t* cm)
@@ -989,6 +1040,7 @@ GCS_BACKEND_CREATE_FN(gcs_gcomm_create)
     backend->close     = gcomm_close;
     backend->destroy   = gcomm_destroy;
     backend->send      = gcomm_send;
+    backend->sendv     = gcomm_sendv;
     backend->recv      = gcomm_recv;
     backend->name      = gcomm_name;
     backend->msg_size  = gcomm_msg_size;
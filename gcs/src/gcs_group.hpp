@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -190,8 +190,11 @@ gcs_group_handle_act_msg (gcs_group_t*          const group,
                       commonly_supported_version)) {
             /* Common situation -
              * increment and assign act_id only for totally ordered actions
-             * and only in PRIM (skip messages while in state exchange) */
-            rcvd->id = ++group->act_id_;
+             * and only in PRIM (skip messages while in state exchange).
+             * Batched actions take act_count consecutive seqnos starting
+             * from the assigned one. */
+            rcvd->id = group->act_id_ + 1;
+            group->act_id_ += frg->act_count;
         }
         else if (GCS_ACT_TORDERED  == rcvd->act.type) {
             /* Rare situations */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2017 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -13,26 +13,35 @@
 
 const char* const GCS_PARAMS_FC_FACTOR         = "gcs.fc_factor";
 const char* const GCS_PARAMS_FC_LIMIT          = "gcs.fc_limit";
+const char* const GCS_PARAMS_FC_SIZE_LIMIT     = "gcs.fc_size_limit";
 const char* const GCS_PARAMS_FC_MASTER_SLAVE   = "gcs.fc_master_slave";
 const char* const GCS_PARAMS_FC_DEBUG          = "gcs.fc_debug";
+/* rate based flow control, must be set on every node, see gcs_fc.hpp */
+const char* const GCS_PARAMS_FC_PACING         = "gcs.fc_pacing";
 const char* const GCS_PARAMS_SYNC_DONOR        = "gcs.sync_donor";
 const char* const GCS_PARAMS_MAX_PKT_SIZE      = "gcs.max_packet_size";
 const char* const GCS_PARAMS_RECV_Q_HARD_LIMIT = "gcs.recv_q_hard_limit";
 const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT = "gcs.recv_q_soft_limit";
 const char* const GCS_PARAMS_MAX_THROTTLE      = "gcs.max_throttle";
+const char* const GCS_PARAMS_BATCH_SIZE        = "gcs.batch_size";
+const char* const GCS_PARAMS_BATCH_WINDOW      = "gcs.batch_window";
 #ifdef GCS_SM_DEBUG
 const char* const GCS_PARAMS_SM_DUMP           = "gcs.sm_dump";
 #endif /* GCS_SM_DEBUG */
 
 static const char* const GCS_PARAMS_FC_FACTOR_DEFAULT         = "1";
 static const char* const GCS_PARAMS_FC_LIMIT_DEFAULT          = "100";
+static const char* const GCS_PARAMS_FC_SIZE_LIMIT_DEFAULT     = "0";
 static const char* const GCS_PARAMS_FC_MASTER_SLAVE_DEFAULT   = "no";
 static const char* const GCS_PARAMS_FC_DEBUG_DEFAULT          = "0";
+static const char* const GCS_PARAMS_FC_PACING_DEFAULT         = "no";
 static const char* const GCS_PARAMS_SYNC_DONOR_DEFAULT        = "no";
 static const char* const GCS_PARAMS_MAX_PKT_SIZE_DEFAULT      = "64500";
 static ssize_t const GCS_PARAMS_RECV_Q_HARD_LIMIT_DEFAULT     = SSIZE_MAX;
 static const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT_DEFAULT = "0.25";
 static const char* const GCS_PARAMS_MAX_THROTTLE_DEFAULT      = "0.25";
+static const char* const GCS_PARAMS_BATCH_SIZE_DEFAULT        = "0";
+static const char* const GCS_PARAMS_BATCH_WINDOW_DEFAULT      = "1000";
 
 bool
 gcs_params_register(gu_config_t* conf)
@@ -43,10 +52,14 @@ gcs_params_register(gu_config_t* conf)
                           GCS_PARAMS_FC_FACTOR_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_LIMIT,
                           GCS_PARAMS_FC_LIMIT_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_FC_SIZE_LIMIT,
+                          GCS_PARAMS_FC_SIZE_LIMIT_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_MASTER_SLAVE,
                           GCS_PARAMS_FC_MASTER_SLAVE_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_DEBUG,
                           GCS_PARAMS_FC_DEBUG_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_FC_PACING,
+                          GCS_PARAMS_FC_PACING_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_SYNC_DONOR,
                           GCS_PARAMS_SYNC_DONOR_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_MAX_PKT_SIZE,
@@ -61,6 +74,10 @@ gcs_params_register(gu_config_t* conf)
                           GCS_PARAMS_RECV_Q_SOFT_LIMIT_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_MAX_THROTTLE,
                           GCS_PARAMS_MAX_THROTTLE_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_BATCH_SIZE,
+                          GCS_PARAMS_BATCH_SIZE_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_BATCH_WINDOW,
+                          GCS_PARAMS_BATCH_WINDOW_DEFAULT);
 #ifdef GCS_SM_DEBUG
     ret |= gu_config_add (conf, GCS_PARAMS_SM_DUMP, "0");
 #endif /* GCS_SM_DEBUG */
@@ -192,6 +209,14 @@ gcs_params_init (struct gcs_params* params, gu_config_t* config)
     if ((ret = params_init_long (config, GCS_PARAMS_MAX_PKT_SIZE, 0,LONG_MAX,
                                  &params->max_packet_size))) return ret;
 
+    if ((ret = params_init_long (config, GCS_PARAMS_BATCH_SIZE, 0,
+                                 GCS_PARAMS_BATCH_SIZE_MAX,
+                                 &params->batch_size))) return ret;
+
+    if ((ret = params_init_long (config, GCS_PARAMS_BATCH_WINDOW, 0,
+                                 GCS_PARAMS_BATCH_WINDOW_MAX,
+                                 &params->batch_window))) return ret;
+
     if ((ret = params_init_double (config, GCS_PARAMS_FC_FACTOR, 0.0, 1.0,
                                    &params->fc_resume_factor))) return ret;
 
@@ -209,9 +234,16 @@ gcs_params_init (struct gcs_params* params, gu_config_t* config)
     params->recv_q_hard_limit = tmp * gcs_fc_hard_limit_fix;
     // allow for some meta overhead
 
+    if ((ret = params_init_int64 (config, GCS_PARAMS_FC_SIZE_LIMIT, 0,
+                                  SSIZE_MAX, &tmp))) return ret;
+    params->fc_size_limit = tmp;
+
     if ((ret = params_init_bool (config, GCS_PARAMS_FC_MASTER_SLAVE,
                                  &params->fc_master_slave))) return ret;
 
+    if ((ret = params_init_bool (config, GCS_PARAMS_FC_PACING,
+                                 &params->fc_pacing))) return ret;
+
     if ((ret = params_init_bool (config, GCS_PARAMS_SYNC_DONOR,
                                  &params->sync_donor))) return ret;
     return 0;
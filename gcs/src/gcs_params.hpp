@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -14,22 +14,35 @@ struct gcs_params
     double  recv_q_soft_limit;
     double  max_throttle;
     ssize_t recv_q_hard_limit;
+    ssize_t fc_size_limit;
     long    fc_base_limit;
     long    max_packet_size;
     long    fc_debug;
+    long    batch_size;
+    long    batch_window;
     bool    fc_master_slave;
+    bool    fc_pacing;
     bool    sync_donor;
 };
 
 extern const char* const GCS_PARAMS_FC_FACTOR;
 extern const char* const GCS_PARAMS_FC_LIMIT;
+extern const char* const GCS_PARAMS_FC_SIZE_LIMIT;
 extern const char* const GCS_PARAMS_FC_MASTER_SLAVE;
 extern const char* const GCS_PARAMS_FC_DEBUG;
+extern const char* const GCS_PARAMS_FC_PACING;
 extern const char* const GCS_PARAMS_SYNC_DONOR;
 extern const char* const GCS_PARAMS_MAX_PKT_SIZE;
 extern const char* const GCS_PARAMS_RECV_Q_HARD_LIMIT;
 extern const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT;
 extern const char* const GCS_PARAMS_MAX_THROTTLE;
+extern const char* const GCS_PARAMS_BATCH_SIZE;
+extern const char* const GCS_PARAMS_BATCH_WINDOW;
+
+/*! Upper limits of batching parameters: bytes and microseconds */
+#define GCS_PARAMS_BATCH_SIZE_MAX   (1L << 24)
+#define GCS_PARAMS_BATCH_WINDOW_MAX 1000000L
+
 #ifdef GCS_SM_DEBUG
 extern const char* const GCS_PARAMS_SM_DUMP;
 #endif /* GCS_SM_DEBUG */
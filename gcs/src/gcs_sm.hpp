@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2013 Codership Oy <info@codership.com>
+ * Copyright (C) 2010-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -416,6 +416,22 @@ gcs_sm_leave (gcs_sm_t* sm)
     gu_mutex_unlock (&sm->lock);
 }
 
+/*!
+ * Returns true if there are other users waiting to enter the monitor.
+ * Meant to be called by a user that has entered it.
+ */
+static inline bool
+gcs_sm_has_waiters (gcs_sm_t* sm)
+{
+    if (gu_unlikely(gu_mutex_lock (&sm->lock))) abort();
+
+    bool const ret(sm->users > sm->entered);
+
+    gu_mutex_unlock (&sm->lock);
+
+    return ret;
+}
+
 static inline void
 gcs_sm_pause (gcs_sm_t* sm)
 {
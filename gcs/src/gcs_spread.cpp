@@ -714,6 +714,7 @@ GCS_BACKEND_CREATE_FN(gcs_spread_create)
     backend->open     = spread_open;
     backend->close    = spread_close;
     backend->send     = spread_send;
+    backend->sendv    = NULL;
     backend->recv     = spread_recv;
     backend->name     = spread_name;
     backend->msg_size = spread_msg_size;
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2014 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -21,6 +21,8 @@
 
 #include "gcs.hpp"
 #include "gcs_test.hpp"
+#include "GCache.hpp"
+#include "gu_asio.hpp" // gu::ssl_register_params()
 
 #define USE_WAIT
 
@@ -28,7 +30,7 @@
 
 static pthread_mutex_t gcs_test_lock = PTHREAD_MUTEX_INITIALIZER;
 
-static gcache_t* gcache = NULL;
+static gcache_t* cache = NULL;
 
 typedef struct gcs_test_log
 {
@@ -44,6 +46,7 @@ static gcs_test_log_t *send_log, *recv_log;
 
 static bool throughput = true; // bench for throughput
 static bool total      = true; // also enable TO locking
+static bool load       = false; // non-interactive load mode, fixed msg size
 
 typedef enum
 {
@@ -61,6 +64,7 @@ typedef struct gcs_test_thread
     long              n_tries;
     void*             msg;
     char*             log_msg;
+    long              n_repld;
 }
 gcs_test_thread_t;
 
@@ -76,6 +80,7 @@ static long gcs_test_thread_create (gcs_test_thread_t *t, long id, long n_tries)
     t->act.seqno_l  = GCS_SEQNO_ILL;
     t->act.type     = GCS_ACT_TORDERED;
     t->n_tries      = n_tries;
+    t->n_repld      = 0;
 
     if (t->msg)
     {
@@ -184,6 +189,9 @@ test_make_msg (char* msg, const long mlen)
         len = snprintf (msg, mlen, "%10d %9llu %s",
                         rand(), (unsigned long long)count++, gcs_test_data);
     }
+    else if (load) {
+        len = mlen;
+    }
     else {
         len = rand() % mlen + 1; // just random length, we don't care about
                                  // contents
@@ -308,10 +316,10 @@ test_send_last_applied (gcs_conn_t* gcs, gcs_seqno_t my_seqno)
                 fprintf (stderr,"gcs_set_last_applied(%lld) returned %ld\n",
                          (long long)my_seqno, ret);
             }
-//            if (!throughput) {
+            if (!load) {
                 fprintf (stdout, "Last applied: my = %lld, group = %lld\n",
                          (long long)my_seqno, (long long)group_seqno);
-//            }
+            }
     }
     return ret;
 }
@@ -361,7 +369,7 @@ test_after_recv (gcs_test_thread_t* thread)
 //    fprintf (stdout, "SEQNO applied %lld", thread->local_act_id);
 
     if (thread->act.type == GCS_ACT_TORDERED)
-        gcache_free (gcache, thread->act.buf);
+        gcache_free (cache, thread->act.buf);
 
     return ret;
 }
@@ -390,6 +398,7 @@ void *gcs_test_repl (void *arg)
         }
 
         msg_repld++;
+        thread->n_repld++;
         size_repld += thread->act.size;
 //      usleep ((rand() & 1) << 1);
         test_after_recv (thread);
@@ -576,10 +585,12 @@ static long gcs_test_thread_pool_start (gcs_test_thread_pool_t *pool)
     }
     pool->n_started = i;
 
-    printf ("Started %ld threads of %s type (pool: %p)\n",
-            pool->n_started,
-            GCS_TEST_REPL == pool->type ? "REPL" :
-            (GCS_TEST_SEND == pool->type ? "SEND" :"RECV"), (void*)pool);
+    if (!load) {
+        printf ("Started %ld threads of %s type (pool: %p)\n",
+                pool->n_started,
+                GCS_TEST_REPL == pool->type ? "REPL" :
+                (GCS_TEST_SEND == pool->type ? "SEND" :"RECV"), (void*)pool);
+    }
 
     return 0;
 }
@@ -685,6 +696,126 @@ test_print_stat (long msgs, size_t size, double interval)
             size >> 10, (double)(size >> 10)/interval);
 }
 
+static gu_config_t*
+gcs_test_config_create ()
+{
+    gu_config_t* const gconf = gu_config_create ();
+    if (!gconf) return NULL;
+
+    gu::ssl_register_params(*reinterpret_cast<gu::Config*>(gconf));
+    gcache::GCache::register_params(*reinterpret_cast<gu::Config*>(gconf));
+    if (gcs_register_params (gconf)) {
+        gu_config_destroy (gconf);
+        return NULL;
+    }
+
+    gu_config_set_string (gconf, "gcache.size", "0");
+    gu_config_set_string (gconf, "gcache.page_size", "1M");
+
+    return gconf;
+}
+
+/* Non-interactive load: REPL threads replicate actions of fixed size for
+ * n_tries seconds, actions replicated per second are reported for each size
+ * with GCS batching off and on (gcs.batch_size). Needs real group
+ * communication backend, e.g.
+ * gcs_test load gcomm://0.0.0.0?gmcast.listen_addr=tcp://127.0.0.1:4567 */
+
+#define LOAD_BATCH_SIZE "65536"
+
+static long
+gcs_test_load_run (const gcs_test_conf_t* conf, long size,
+                   const char* batch_size)
+{
+    long err = -ENOMEM;
+    long i, repld = 0;
+    gcs_test_thread_pool_t repl_pool, recv_pool;
+    struct timeval t_begin, t_end;
+    double interval;
+    gu_config_t* gconf;
+
+    if (!(to = gu_to_create ((conf->n_repl + conf->n_recv + 1)*2,
+                             GCS_SEQNO_FIRST))) goto out;
+    if (!(gconf = gcs_test_config_create ())) goto out;
+
+    gu_config_set_string (gconf, "gcs.batch_size", batch_size);
+
+    if (!(cache = gcache_create (gconf, ""))) goto out;
+    if (!(gcs = gcs_create (gconf, cache, NULL, NULL, 0, 0))) goto out;
+    if ((err = gcs_open (gcs, "load_channel", conf->backend,
+                         NULL != strstr(conf->backend, "0.0.0.0")))) goto out;
+
+    msg_len = size;
+
+    if ((err = gcs_test_thread_pool_create
+         (&repl_pool, GCS_TEST_REPL, conf->n_repl, 1))) goto out;
+    if ((err = gcs_test_thread_pool_create
+         (&recv_pool, GCS_TEST_RECV, conf->n_recv, 1))) goto out;
+
+    pthread_mutex_lock (&gcs_test_lock);
+    gcs_test_thread_pool_start (&recv_pool);
+    gcs_test_thread_pool_start (&repl_pool);
+
+    sleep (1); // let the node join the group
+
+    gettimeofday (&t_begin, NULL);
+    pthread_mutex_unlock (&gcs_test_lock);
+
+    usleep (conf->n_tries*1000000);
+
+    gcs_test_thread_pool_stop (&repl_pool);
+    gcs_test_thread_pool_join (&repl_pool);
+    gettimeofday (&t_end, NULL);
+
+    if ((err = gcs_close (gcs))) goto out;
+    gcs_test_thread_pool_join (&recv_pool);
+
+    for (i = 0; i < repl_pool.n_threads; i++) {
+        repld += repl_pool.threads[i].n_repld;
+    }
+
+    interval = (t_end.tv_sec - t_begin.tv_sec) +
+        0.000001*t_end.tv_usec - 0.000001*t_begin.tv_usec;
+
+    printf ("%7ld %10s %12.1f %12.1f\n", size, batch_size,
+            (double)repld/interval, (double)(repld*size >> 10)/interval);
+    fflush (stdout);
+
+    gcs_destroy (gcs);
+    gcs = NULL;
+    gcache_destroy (cache);
+    cache = NULL;
+    gu_config_destroy (gconf);
+
+    gcs_test_thread_pool_destroy (&repl_pool);
+    gcs_test_thread_pool_destroy (&recv_pool);
+
+    gu_to_destroy (&to);
+
+out:
+    return err;
+}
+
+static int
+gcs_test_load (const gcs_test_conf_t* conf)
+{
+    static const long sizes[] = { 100, 1000, 10000 };
+    size_t i;
+    long err = 0;
+
+    printf ("%7s %10s %12s %12s\n",
+            "Size:", "Batch:", "Actions/s:", "Kb/s:");
+
+    for (i = 0; i < sizeof(sizes)/sizeof(sizes[0]) && !err; i++) {
+        err = gcs_test_load_run (conf, sizes[i], "0");
+        if (!err) err = gcs_test_load_run (conf, sizes[i], LOAD_BATCH_SIZE);
+    }
+
+    if (err) printf ("Error: %ld (%s)\n", err, strerror (-err));
+
+    return err;
+}
+
 int main (int argc, char *argv[])
 {
     long err = 0;
@@ -695,6 +826,12 @@ int main (int argc, char *argv[])
     gu_config_t* gconf;
     bool bstrap;
 
+    if (argc > 1 && !strcmp (argv[1], "load")) {
+        load = true;
+        if ((err = gcs_test_conf (&conf, argc - 1, argv + 1))) goto out;
+        return gcs_test_load (&conf);
+    }
+
     gcs_conf_debug_on(); // turn on debug messages
 
     if ((err = gcs_test_conf     (&conf, argc, argv)))   goto out;
@@ -710,14 +847,11 @@ int main (int argc, char *argv[])
     printf ("Opening connection: channel = %s, backend = %s\n",
              channel, conf.backend);
 
-    gconf = gu_config_create ();
+    gconf = gcs_test_config_create ();
     if (!gconf) goto out;
 
-    if (gu_config_add(gconf, "gcache.size", "0")) goto out;
-    if (gu_config_add(gconf, "gcache.page_size", "1M")) goto out;
-
-    if (!(gcache = gcache_create (gconf, ""))) goto out;
-    if (!(gcs = gcs_create (gconf, gcache, NULL, NULL, 0, 0))) goto out;
+    if (!(cache = gcache_create (gconf, ""))) goto out;
+    if (!(gcs = gcs_create (gconf, cache, NULL, NULL, 0, 0))) goto out;
     puts ("debug"); fflush(stdout);
     /* the following hack won't work if there is 0.0.0.0 in URL options */
     bstrap = (NULL != strstr(conf.backend, "0.0.0.0"));
@@ -799,7 +933,7 @@ int main (int argc, char *argv[])
     printf ("done\n"); fflush (stdout);
 
     printf ("Destroying GCache object:\n");
-    gcache_destroy (gcache);
+    gcache_destroy (cache);
 
     gcs_test_thread_pool_destroy (&repl_pool);
     gcs_test_thread_pool_destroy (&send_pool);
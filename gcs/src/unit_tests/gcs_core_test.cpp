@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -38,6 +38,7 @@
 
 #define GCS_STATE_MSG_ACCESS
 #include "../gcs_core.hpp"
+#include "../gcs_act_proto.hpp"
 #include "../gcs_dummy.hpp"
 #include "../gcs_seqno.hpp"
 #include "../gcs_state_msg.hpp"
@@ -489,6 +490,131 @@ START_TEST (gcs_core_test_api)
 }
 END_TEST
 
+// checks that action buffers are passed to backend as is if it supports
+// scatter-gather send and are gathered into send buffer otherwise
+START_TEST (gcs_core_test_sendv)
+{
+    gu::Config config;
+    core_test_init (&config);
+
+    const struct gu_buf* act = act3;
+    const void* act_buf  = act3_str;
+    size_t      act_size = sizeof(act3_str);
+
+    action_t act_s(act, NULL, NULL, act_size, GCS_ACT_TORDERED, -1, (gu_thread_t)-1);
+    action_t act_r(act, NULL, NULL, -1, (gcs_act_type_t)-1, -1, (gu_thread_t)-1);
+
+    ck_assert(NULL != Backend->sendv);
+    gcs_backend_sendv_t const sendv(Backend->sendv);
+
+    ck_assert_msg(0 == gcs_core_send_copied(Core),
+                  "Expected no bytes copied, got %lld",
+                  gcs_core_send_copied(Core));
+
+    for (int i = 0; i < 2; i++)
+    {
+        Backend->sendv = (0 == i ? sendv : NULL);
+
+        long ret;
+        ck_assert(!CORE_SEND_START (&act_s));
+        while ((ret = gcs_core_send_step (Core, 1000)) > 0) {}
+        ck_assert_msg(ret == 0, "gcs_core_send_step() returned: %ld (%s)",
+                      ret, strerror(-ret));
+        ck_assert(!CORE_SEND_END (&act_s, act_size));
+        ck_assert(!CORE_RECV_ACT (&act_r, act_buf, act_size, GCS_ACT_TORDERED));
+        free (act_r.out);
+
+        long long const expected(0 == i ? 0 : act_size);
+        ck_assert_msg(expected == gcs_core_send_copied(Core),
+                      "Expected %lld bytes copied, got %lld",
+                      expected, gcs_core_send_copied(Core));
+    }
+
+    Backend->sendv = sendv;
+
+    core_test_cleanup ();
+}
+END_TEST
+
+struct batch_send
+{
+    const struct gcs_core_batch_act* acts;
+    int                              acts_num;
+    ssize_t                          ret;
+};
+
+static void*
+core_send_batch_thread (void* arg)
+{
+    struct batch_send* const b = (struct batch_send*)arg;
+
+    b->ret = gcs_core_send_batch (Core, b->acts, b->acts_num);
+
+    return (NULL);
+}
+
+// checks that actions sent in one batch are received one by one with
+// consecutive seqnos and matched with local action buffers
+START_TEST (gcs_core_test_batch)
+{
+    gu::Config config;
+    core_test_init (&config);
+
+    const struct gcs_core_batch_act acts[] = {
+        { act1, sizeof(act1_str) },
+        { act2, sizeof(act2_str) },
+        { act3, sizeof(act3_str) }
+    };
+    const char* const strs[] = { act1_str, act2_str, act3_str };
+    int const acts_num = sizeof(acts)/sizeof(acts[0]);
+
+    ck_assert(gcs_core_group_protocol_version(Core) >= GCS_ACT_PROTO_BATCH);
+
+    ssize_t batch_size = 0;
+    for (int i = 0; i < acts_num; i++) {
+        batch_size += sizeof(uint32_t) + acts[i].size;
+    }
+
+    struct batch_send b = { acts, acts_num, 0 };
+    gu_thread_t thread;
+    ck_assert(0 == gu_thread_create (&thread, NULL, core_send_batch_thread,
+                                     &b));
+
+    long ret;
+    long frags = (batch_size - 1)/FRAG_SIZE + 1;
+    while ((ret = gcs_core_send_step (Core, 1000)) > 0) { frags--; }
+    ck_assert_msg(ret == 0, "gcs_core_send_step() returned: %ld (%s)",
+                  ret, strerror(-ret));
+    ck_assert_msg(frags == 0, "frags = %ld, instead of 0", frags);
+
+    ck_assert(0 == gu_thread_join (thread, NULL));
+    ck_assert_msg(batch_size == b.ret, "Expected %zd, got %zd (%s)",
+                  batch_size, b.ret, strerror(-b.ret));
+
+    for (int i = 0; i < acts_num; i++) {
+        action_t act_r(acts[i].act, NULL, NULL, -1, (gcs_act_type_t)-1, -1,
+                       (gu_thread_t)-1);
+        ck_assert(!CORE_RECV_ACT (&act_r, strs[i], acts[i].size,
+                                  GCS_ACT_TORDERED));
+        free (act_r.out);
+    }
+
+    // the next action gets the next seqno after the batch
+    action_t act_s(act2, NULL, NULL, sizeof(act2_str), GCS_ACT_TORDERED, -1,
+                   (gu_thread_t)-1);
+    action_t act_r(act2, NULL, NULL, -1, (gcs_act_type_t)-1, -1,
+                   (gu_thread_t)-1);
+    ck_assert(!CORE_SEND_START (&act_s));
+    while ((ret = gcs_core_send_step (Core, 1000)) > 0) {}
+    ck_assert(!CORE_SEND_END (&act_s, sizeof(act2_str)));
+    ck_assert(!CORE_RECV_ACT (&act_r, act2_str, sizeof(act2_str),
+                              GCS_ACT_TORDERED));
+    free (act_r.out);
+
+    core_test_cleanup ();
+}
+END_TEST
+
 // do a single send step, compare with the expected result
 static inline bool
 CORE_SEND_STEP (gcs_core_t* core, long timeout, long ret)
@@ -747,6 +873,7 @@ START_TEST (gcs_core_test_gh74)
     frg.act_id = 1;
     frg.act_size = act_size;
     frg.act_type = GCS_ACT_STATE_REQ;
+    frg.act_count = 1;
     char msg_buf[1024];
     ck_assert(!gcs_act_proto_write(&frg, msg_buf, sizeof(msg_buf)));
     memcpy(const_cast<void*>(frg.frag), act_ptr, act_size);
@@ -971,6 +1098,8 @@ Suite *gcs_core_suite(void)
   if (skip == false) {
       tcase_add_test  (tcase, gcs_core_test_api);
       tcase_add_test  (tcase, gcs_core_test_own);
+      tcase_add_test  (tcase, gcs_core_test_sendv);
+      tcase_add_test  (tcase, gcs_core_test_batch);
 #ifdef GCS_ALLOW_GH74
       tcase_add_test  (tcase, gcs_core_test_gh74);
 #endif /* GCS_ALLOW_GH74 */
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2020 Codership Oy <info@codership.com>
+// Copyright (C) 2010-2026 Codership Oy <info@codership.com>
 
 // $Id$
 
@@ -121,6 +121,187 @@ START_TEST(gcs_fc_test_precise)
 }
 END_TEST
 
+START_TEST(gcs_fc_test_bucket)
+{
+    gcs_fc_bucket_t fb;
+    memset (&fb, 0, sizeof(fb));
+    long long const sec = 1000000000LL;
+
+    // unlimited
+    for (int i = 0; i < 1000; i++) ck_assert(0 == gcs_fc_bucket_take(&fb, 0));
+
+    // 100 actions/s: bucket starts empty, actions are sent 10ms apart
+    gcs_fc_bucket_set_rate (&fb, 100.0, sec);
+    long long ret = gcs_fc_bucket_take(&fb, sec);
+    ck_assert_msg(ret == sec/100, "Expected 10ms wait, got %lld", ret);
+    ret = gcs_fc_bucket_take(&fb, sec);
+    ck_assert_msg(ret == sec/50, "Expected 20ms wait, got %lld", ret);
+
+    // debt repaid, idle time accumulates no more than a burst
+    ck_assert(0 == gcs_fc_bucket_take(&fb, 3*sec));
+    ck_assert(gcs_fc_bucket_take(&fb, 3*sec) > 0);
+
+    // wait does not exceed 1 second
+    for (int i = 0; i < 1000; i++) ret = gcs_fc_bucket_take(&fb, 3*sec);
+    ck_assert_msg(ret == sec, "Expected 1s wait, got %lld", ret);
+
+    gcs_fc_bucket_set_rate (&fb, 0.0, 3*sec);
+    ck_assert(0 == gcs_fc_bucket_take(&fb, 3*sec));
+}
+END_TEST
+
+/* Virtual time simulation of a sender replicating to a node that applies
+ * actions at a fixed rate. The node advertises the rate it can sustain and
+ * the sender paces itself, so the slave queue should never reach the limit
+ * (where STOP would be sent) and should never drain empty either. */
+START_TEST(gcs_fc_test_pacing)
+{
+    long long const tick     = 50000;       // 50us
+    long long const delay    = 2000000;     // FC message delivery: 2ms
+    long long const duration = 20000000000LL; // 20s
+    long long const warmup   = 5000000000LL;  // 5s
+    long   const limit       = 100;
+    double const apply_rate  = 1000.0;
+    long long const send_interval = 200000; // sender alone: 5000/s
+
+    gcs_fc_rate_t   fr;
+    gcs_fc_bucket_t fb;
+    gcs_fc_rate_reset (&fr, 0);
+    memset (&fb, 0, sizeof(fb));
+
+    long long next_send  = 0;  // when sender has next action ready
+    long long sent_at    = -1; // when action holding a token is sent
+    long long fc_at      = -1; // when advertised rate reaches sender
+    double    fc_rate    = 0.0;
+    double    apply_credit = 0.0;
+    long      queue      = 0;
+    long      max_queue  = 0;
+    long      min_queue  = limit;
+    long      applied    = 0;
+    long      fc_msgs    = 0;
+    double    rate;
+
+    for (long long now = 0; now < duration; now += tick)
+    {
+        if (fc_at >= 0 && now >= fc_at)
+        {
+            gcs_fc_bucket_set_rate (&fb, fc_rate, now);
+            fc_at = -1;
+        }
+
+        if (sent_at < 0 && now >= next_send)
+        {
+            sent_at = next_send + gcs_fc_bucket_take (&fb, next_send);
+        }
+
+        if (sent_at >= 0 && now >= sent_at)
+        {
+            queue++;
+            if (gcs_fc_rate_check (&fr, queue, limit, now, &rate))
+            {
+                fc_rate = rate; fc_at = now + delay; fc_msgs++;
+            }
+            next_send = sent_at + send_interval;
+            sent_at   = -1;
+        }
+
+        apply_credit += apply_rate * tick * 1.0e-9;
+        if (0 == queue && apply_credit > 1.0) apply_credit = 1.0; // idle
+
+        while (apply_credit >= 1.0 && queue > 0)
+        {
+            apply_credit -= 1.0;
+            queue--;
+            if (now >= warmup) applied++;
+            gcs_fc_rate_dequeue (&fr);
+            if (gcs_fc_rate_check (&fr, queue, limit, now, &rate))
+            {
+                fc_rate = rate; fc_at = now + delay; fc_msgs++;
+            }
+        }
+
+        if (queue > max_queue) max_queue = queue;
+        if (now >= warmup && queue < min_queue) min_queue = queue;
+    }
+
+    double const throughput(applied * 1.0e9 / (duration - warmup));
+
+    ck_assert_msg(max_queue < limit, "Max queue length %ld reached limit %ld",
+                  max_queue, limit);
+    ck_assert_msg(min_queue > 0, "Slave queue drained");
+    ck_assert_msg(throughput > 0.99 * apply_rate,
+                  "Throughput %f, expected %f", throughput, apply_rate);
+    ck_assert_msg(fc_msgs < duration / 10000000LL,
+                  "Too many FC messages: %ld", fc_msgs);
+}
+END_TEST
+
+/* Queue of 1000 byte actions growing over the byte limit and draining back,
+ * limits as set by gcs.fc_limit=16, gcs.fc_size_limit=4000, fc_factor=0.5 */
+START_TEST(gcs_fc_test_queue_limits)
+{
+    long    const len_upper  = 16;
+    long    const len_lower  = 8;
+    ssize_t const size_upper = 4000;
+    ssize_t const size_lower = 2000;
+    ssize_t const act_size   = 1000;
+
+    long    len  = 0;
+    ssize_t size = 0;
+
+    /* FC_STOP only once the byte limit is exceeded */
+    for (len = 1; len <= 4; ++len)
+    {
+        size = len * act_size;
+        ck_assert_msg(GCS_FC_REASON_NONE == gcs_fc_over_limit
+                      (len, len_upper, size, size_upper, 0),
+                      "FC_STOP at %ld actions, %zd bytes", len, size);
+    }
+
+    size = len * act_size;
+    gcs_fc_reason_t const reason
+        (gcs_fc_over_limit (len, len_upper, size, size_upper, 0));
+    ck_assert(GCS_FC_REASON_SIZE == reason);
+    ck_assert(!strcmp("queue size", gcs_fc_reason_str[reason]));
+
+    /* FC_CONT only once the queue is under the lower byte limit */
+    for (; len > 2; --len)
+    {
+        size = len * act_size;
+        ck_assert_msg(!gcs_fc_under_limit (len, len_lower, size, size_upper,
+                                           size_lower),
+                      "FC_CONT at %ld actions, %zd bytes", len, size);
+    }
+
+    size = len * act_size;
+    ck_assert(gcs_fc_under_limit (len, len_lower, size, size_upper,
+                                  size_lower));
+
+    /* length limit is checked first */
+    ck_assert(GCS_FC_REASON_LENGTH == gcs_fc_over_limit
+              (len_upper + 1, len_upper, 2 * size_upper, size_upper, 0));
+    ck_assert(!strcmp("queue length",
+                      gcs_fc_reason_str[GCS_FC_REASON_LENGTH]));
+    ck_assert(!gcs_fc_under_limit (len_lower + 1, len_lower, 0, size_upper,
+                                   size_lower));
+
+    /* catch-up offset lifts the byte limit */
+    ck_assert(GCS_FC_REASON_NONE == gcs_fc_over_limit
+              (5, len_upper, 5000, size_upper, 2000));
+    ck_assert(GCS_FC_REASON_SIZE == gcs_fc_over_limit
+              (7, len_upper, 7000, size_upper, 2000));
+
+    /* zero byte limit disables it */
+    ck_assert(GCS_FC_REASON_NONE == gcs_fc_over_limit
+              (len_upper, len_upper, 1 << 30, 0, 0));
+    ck_assert(gcs_fc_under_limit (len_lower, len_lower, 1 << 30, 0, 0));
+
+    ck_assert(!strcmp("none", gcs_fc_reason_str[GCS_FC_REASON_NONE]));
+    ck_assert(!strcmp("state transfer",
+                      gcs_fc_reason_str[GCS_FC_REASON_SST]));
+}
+END_TEST
+
 Suite *gcs_fc_suite(void)
 {
     Suite *s  = suite_create("GCS state transfer FC");
@@ -130,6 +311,9 @@ Suite *gcs_fc_suite(void)
     tcase_add_test  (tc, gcs_fc_test_limits);
     tcase_add_test  (tc, gcs_fc_test_basic);
     tcase_add_test  (tc, gcs_fc_test_precise);
+    tcase_add_test  (tc, gcs_fc_test_bucket);
+    tcase_add_test  (tc, gcs_fc_test_pacing);
+    tcase_add_test  (tc, gcs_fc_test_queue_limits);
 
     return s;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2008-2020 Codership Oy <info@codership.com>
+ * Copyright (C) 2008-2026 Codership Oy <info@codership.com>
  *
  * $Id$
  */
@@ -44,6 +44,7 @@ START_TEST (gcs_proto_test)
     frg_send.frag_no   = 0;
     frg_send.act_type  = (gcs_act_type_t)0;
     frg_send.proto_ver = 0;
+    frg_send.act_count = 1;
 
     // set up action header
     ret = gcs_act_proto_write (&frg_send, buf, buf_len);
@@ -105,6 +106,51 @@ START_TEST (gcs_proto_test)
 }
 END_TEST
 
+START_TEST (gcs_proto_test_batch)
+{
+    const size_t   buf_len = 32;
+    char           buf[buf_len];
+    gcs_act_frag_t frg_send, frg_recv;
+    long           ret;
+
+    frg_send.act_id    = getpid();
+    frg_send.act_size  = 100;
+    frg_send.frag      = NULL;
+    frg_send.frag_len  = 0;
+    frg_send.frag_no   = 0;
+    frg_send.act_type  = GCS_ACT_TORDERED;
+    frg_send.proto_ver = GCS_ACT_PROTO_BATCH;
+    frg_send.act_count = 300; // does not fit in one byte
+
+    ret = gcs_act_proto_write (&frg_send, buf, buf_len);
+    ck_assert_msg(0 == ret, "error code: %ld", ret);
+    ck_assert(gcs_act_proto_hdr_size(GCS_ACT_PROTO_BATCH) ==
+              gcs_act_proto_hdr_size(0));
+
+    gcs_act_proto_inc (buf);
+
+    ret = gcs_act_proto_read (&frg_recv, buf, buf_len);
+    ck_assert_msg(0 == ret, "error code: %ld", ret);
+    ck_assert_msg(!frgcmp(&frg_send, &frg_recv),
+                  "Sent and recvd headers are not identical");
+    ck_assert(1 == frg_recv.frag_no);
+    ck_assert(GCS_ACT_PROTO_BATCH == frg_recv.proto_ver);
+    ck_assert_msg(300 == frg_recv.act_count, "act_count: %d",
+                  frg_recv.act_count);
+
+    // v0 header carries no action count
+    frg_send.proto_ver = 0;
+    frg_send.act_count = 1;
+    buf[18] = buf[19] = 0x55;
+    ret = gcs_act_proto_write (&frg_send, buf, buf_len);
+    ck_assert_msg(0 == ret, "error code: %ld", ret);
+    ret = gcs_act_proto_read (&frg_recv, buf, buf_len);
+    ck_assert_msg(0 == ret, "error code: %ld", ret);
+    ck_assert(0 == frg_recv.proto_ver);
+    ck_assert(1 == frg_recv.act_count);
+}
+END_TEST
+
 Suite *gcs_proto_suite(void)
 {
   Suite *suite = suite_create("GCS core protocol");
@@ -112,6 +158,7 @@ Suite *gcs_proto_suite(void)
 
   suite_add_tcase (suite, tcase);
   tcase_add_test  (tcase, gcs_proto_test);
+  tcase_add_test  (tcase, gcs_proto_test_batch);
   return suite;
 }
 
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Slave queue dequeue benchmark.
+ *
+ * Opens a single node group over the dummy backend and fills the slave queue
+ * with the given number of actions sent by this node, then receiver threads
+ * take them off the queue with gcs_recv() and with gcs_recv_batch() of
+ * increasing size. Reported is the number of actions received per second.
+ *
+ * Usage: gcs_recv_bench [actions] [receivers]
+ */
+
+#include "../gcs.hpp"
+
+#include <galerautils.h>
+#include "gu_config.hpp"
+#include "gu_atomic.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <climits>
+#include <unistd.h>
+
+namespace
+{
+    size_t const ACT_SIZE = 64;
+
+    struct Params
+    {
+        long actions;
+        int  receivers;
+    };
+
+    struct ReceiverArgs
+    {
+        gcs_conn_t*       conn;
+        long              batch;
+        long              actions;
+        gu::Atomic<long>* received;
+        gu::Atomic<int>*  done;
+    };
+
+    /* returns true if receiving should stop */
+    bool
+    receive(const ReceiverArgs& a, std::vector<struct gcs_action>& acts)
+    {
+        long const ret(1 == a.batch ?
+                       (gcs_recv(a.conn, &acts[0]) > 0 ? 1 : -1) :
+                       gcs_recv_batch(a.conn, &acts[0], a.batch));
+        if (ret <= 0) return true;
+
+        bool conf(false);
+        for (long i(0); i < ret; ++i)
+        {
+            ::free(const_cast<void*>(acts[i].buf));
+            if (GCS_ACT_TORDERED == acts[i].type) ++(*a.received);
+            if (GCS_ACT_CONF == acts[i].type) conf = true;
+        }
+
+        return conf;
+    }
+
+    extern "C" void*
+    receiver_thd(void* arg)
+    {
+        const ReceiverArgs& a(*static_cast<ReceiverArgs*>(arg));
+        std::vector<struct gcs_action> acts(a.batch);
+
+        while ((*a.received)() < a.actions && !receive(a, acts)) {}
+
+        ++(*a.done);
+
+        return NULL;
+    }
+
+    int
+    send(gcs_conn_t* const conn, long const actions)
+    {
+        std::vector<char> buf(ACT_SIZE, 'x');
+        struct gu_buf const act = { &buf[0], ssize_t(buf.size()) };
+
+        for (long i(0); i < actions; ++i)
+        {
+            long const ret(gcs_sendv(conn, &act, act.size, GCS_ACT_TORDERED,
+                                     false));
+            if (ret != act.size)
+            {
+                std::cerr << "gcs_sendv() failed: " << ret << std::endl;
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    int
+    fill(gcs_conn_t* const conn, long const actions)
+    {
+        if (send(conn, actions)) return 1;
+
+        struct gcs_stats stats;
+        do
+        {
+            ::usleep(1000);
+            gcs_get_stats(conn, &stats);
+        }
+        while (stats.recv_q_len < actions);
+
+        return 0;
+    }
+
+    int
+    run(gcs_conn_t* const conn, const Params& p, long const batch)
+    {
+        if (fill(conn, p.actions)) return 1;
+
+        gu::Atomic<long> received(0);
+        gu::Atomic<int>  done(0);
+        std::vector<ReceiverArgs> args(p.receivers);
+        std::vector<gu_thread_t> thds(p.receivers);
+
+        long long const start(gu_time_monotonic());
+
+        for (int i(0); i < p.receivers; ++i)
+        {
+            ReceiverArgs const a =
+                { conn, batch, p.actions, &received, &done };
+            args[i] = a;
+            gu_thread_create(&thds[i], NULL, receiver_thd, &args[i]);
+        }
+
+        while (received() < p.actions) ::usleep(100);
+
+        double const duration((gu_time_monotonic() - start) * 1.0e-9);
+
+        /* receivers left waiting on empty queue are woken up by actions
+         * sent to them one at a time, since a batch can take several of them.
+         * The ones left unreceived are counted in the next run. */
+        while (done() < p.receivers)
+        {
+            if (send(conn, 1)) return 1;
+            ::usleep(100);
+        }
+
+        for (int i(0); i < p.receivers; ++i) gu_thread_join(thds[i], NULL);
+
+        std::cout << std::setw(8) << batch
+                  << std::setw(12) << std::fixed << std::setprecision(3)
+                  << duration
+                  << std::setw(12) << long(p.actions / duration) << std::endl;
+
+        return 0;
+    }
+
+    void silent_log(int, const char*) {}
+}
+
+int main(int argc, char* argv[])
+{
+    Params p = { 1000000, 1 };
+
+    if (argc > 1) p.actions   = ::strtol(argv[1], NULL, 10);
+    if (argc > 2) p.receivers = ::atoi(argv[2]);
+
+    if (p.actions <= 0 || p.receivers <= 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [actions] [receivers]"
+                  << std::endl;
+        return 1;
+    }
+
+    gu_conf_set_log_callback(silent_log);
+
+    gu::Config config;
+    gu_config_t* const conf(reinterpret_cast<gu_config_t*>(&config));
+    gcs_register_params(conf);
+
+    /* let the whole load sit in the slave queue */
+    config.set("gcs.fc_limit", p.actions * 2 + p.receivers * 2);
+    config.set("gcs.fc_master_slave", true);
+
+    gcs_conn_t* const conn(gcs_create(conf, NULL, "recv_bench", "", 0, 0));
+    struct gcs_action act;
+
+    if (!conn || gcs_open(conn, "recv_bench", "dummy://", true) ||
+        gcs_recv(conn, &act) <= 0 || GCS_ACT_CONF != act.type)
+    {
+        std::cerr << "Failed to open gcs connection" << std::endl;
+        return 1;
+    }
+
+    ::free(const_cast<void*>(act.buf));
+    gcs_resume_recv(conn);
+
+    std::cout << "Actions: " << p.actions << ", size: " << ACT_SIZE
+              << ", receivers: " << p.receivers << "\n"
+              << std::setw(8)  << "batch"
+              << std::setw(12) << "seconds"
+              << std::setw(12) << "acts/sec" << std::endl;
+
+    int ret(0);
+    long const batches[] = { 1, 4, 16, GCS_RECV_BATCH_MAX };
+    for (size_t i(0); i < sizeof(batches)/sizeof(batches[0]) && !ret; ++i)
+    {
+        ret = run(conn, p, batches[i]);
+    }
+
+    /* closing connection needs the rest of the queue to be received up to
+     * self-leave configuration */
+    gu::Atomic<long> received(0);
+    gu::Atomic<int>  done(0);
+    ReceiverArgs drain = { conn, 1, LONG_MAX, &received, &done };
+    gu_thread_t drain_thd;
+    gu_thread_create(&drain_thd, NULL, receiver_thd, &drain);
+
+    gcs_close(conn);
+    gu_thread_join(drain_thd, NULL);
+
+    /* gcs_destroy() is not called: with GCS_CORE_TESTING it would wait for
+     * lock step which is never enabled here. */
+
+    return ret;
+}
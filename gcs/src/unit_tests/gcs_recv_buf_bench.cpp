@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * GComm backend receive hand-off latency benchmark.
+ *
+ * A producer thread plays the part of gcomm thread and pushes datagrams into
+ * RecvBuf of the gcomm backend, the main thread takes them out the way
+ * gcomm_recv() does. Each datagram carries the time it was pushed at, the
+ * time between push and front() returning it is the hand-off latency.
+ *
+ * The same is done for the mutex protected deque which RecvBuf used before,
+ * both with back-to-back messages and with messages paced apart, the latter
+ * making the receiving thread find the queue empty and wait.
+ *
+ * Usage: gcs_recv_buf_bench [messages] [pace usec]
+ */
+
+/* RecvBuf is private to the backend implementation */
+#include "../gcs_gcomm.cpp"
+
+#include <gu_time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    /* former RecvBuf implementation: mutex protected deque */
+    class LockedRecvBuf
+    {
+    public:
+
+        LockedRecvBuf() : mutex_(), cond_(), queue_(), waiting_(false) { }
+
+        void push_back(const RecvBufData& p)
+        {
+            Lock lock(mutex_);
+            queue_.push_back(p);
+            if (waiting_ == true) { cond_.signal(); }
+        }
+
+        const RecvBufData& front(const Date& timeout)
+        {
+            Lock lock(mutex_);
+            while (queue_.empty())
+            {
+                waiting_ = true;
+                lock.wait(cond_);
+                waiting_ = false;
+            }
+            return queue_.front();
+        }
+
+        void pop_front()
+        {
+            Lock lock(mutex_);
+            queue_.pop_front();
+        }
+
+    private:
+
+        gu::Mutex                mutex_;
+        gu::Cond                 cond_;
+        std::deque<RecvBufData>  queue_;
+        bool                     waiting_;
+    };
+
+    struct Params
+    {
+        long messages;
+        long pace_usec;
+    };
+
+    template <class Buf>
+    struct ProducerArgs
+    {
+        Buf*          buf;
+        const Params* params;
+        long          pace_usec;
+    };
+
+    template <class Buf>
+    void* producer_thd(void* arg)
+    {
+        const ProducerArgs<Buf>& a(*static_cast<ProducerArgs<Buf>*>(arg));
+        long long const pace(a.pace_usec * 1000LL);
+
+        for (long i(0); i < a.params->messages; ++i)
+        {
+            long long now(gu_time_monotonic());
+
+            if (pace > 0)
+            {
+                long long const until(now + pace);
+                while ((now = gu_time_monotonic()) < until) { }
+            }
+
+            const byte_t* const p(reinterpret_cast<const byte_t*>(&now));
+            Datagram dg(SharedBuffer(new Buffer(p, p + sizeof(now))));
+            a.buf->push_back(RecvBufData(0, dg, ProtoUpMeta()));
+        }
+
+        return NULL;
+    }
+
+    template <class Buf>
+    void
+    run(const char* const name, const Params& p, long const pace_usec)
+    {
+        Buf buf;
+        ProducerArgs<Buf> args = { &buf, &p, pace_usec };
+        std::vector<long long> lat;
+        lat.reserve(p.messages);
+
+        long long const start(gu_time_monotonic());
+
+        gu_thread_t thd;
+        gu_thread_create(&thd, NULL, producer_thd<Buf>, &args);
+
+        for (long i(0); i < p.messages; ++i)
+        {
+            const RecvBufData& d(buf.front(GU_TIME_ETERNITY));
+            long long const now(gu_time_monotonic());
+            long long sent;
+            ::memcpy(&sent, gcomm::begin(d.get_dgram()), sizeof(sent));
+            lat.push_back(now - sent);
+            buf.pop_front();
+        }
+
+        long long const duration(gu_time_monotonic() - start);
+
+        gu_thread_join(thd, NULL);
+
+        std::sort(lat.begin(), lat.end());
+
+        size_t const n(lat.size());
+        std::cout << std::setw(8) << name
+                  << std::setw(8) << pace_usec
+                  << std::setw(12) << long(p.messages * 1.0e9 / duration)
+                  << std::setw(10) << lat[n / 2]
+                  << std::setw(10) << lat[n * 9 / 10]
+                  << std::setw(10) << lat[n * 99 / 100]
+                  << std::setw(10) << lat[n * 999 / 1000]
+                  << std::setw(10) << lat[n - 1] << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p = { 1000000, 20 };
+
+    if (argc > 1) p.messages  = ::strtol(argv[1], NULL, 10);
+    if (argc > 2) p.pace_usec = ::strtol(argv[2], NULL, 10);
+
+    if (p.messages <= 0 || p.pace_usec < 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [messages] [pace usec]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << "Messages: " << p.messages
+              << "\nHand-off latency, ns:\n"
+              << std::setw(8)  << "queue"
+              << std::setw(8)  << "pace"
+              << std::setw(12) << "msg/sec"
+              << std::setw(10) << "p50"
+              << std::setw(10) << "p90"
+              << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9"
+              << std::setw(10) << "max" << std::endl;
+
+    run<LockedRecvBuf>("mutex", p, 0);
+    run<RecvBuf>      ("spsc",  p, 0);
+
+    /* paced runs take long, fewer messages are enough */
+    Params paced(p);
+    paced.messages = std::max(1L, p.messages / 10);
+
+    if (p.pace_usec > 0)
+    {
+        run<LockedRecvBuf>("mutex", paced, p.pace_usec);
+        run<RecvBuf>      ("spsc",  paced, p.pace_usec);
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*
+ * Write set send path copy benchmark.
+ *
+ * Replicates write sets composed of several buffers (as produced by
+ * WriteSetOut::gather()) through gcs_core and a dummy backend and reports
+ * how many bytes are memcpy'd per write set on the local node:
+ *
+ *  - gather:  copies of action buffers into gcs_core send buffer
+ *  - network: copies of fragments into backend messages
+ *  - defrag:  reassembly of own action into the receive (GCache) buffer
+ *
+ * Each write set is sent with and without scatter-gather backend send.
+ *
+ * Usage: gcs_send_bench [write sets] [write set size] [buffers]
+ */
+
+#include "../gcs_core.hpp"
+#include "../gcs_act_proto.hpp"
+
+#include <galerautils.h>
+#include "gu_config.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct Params
+    {
+        long   write_sets;
+        size_t ws_size;
+        int    bufs;
+    };
+
+    void silent_log(int, const char*) {}
+
+    long
+    recv_act(gcs_core_t* const core, gcs_act_type_t const type)
+    {
+        struct gcs_act_rcvd rcvd;
+        long ret;
+
+        do
+        {
+            ret = gcs_core_recv(core, &rcvd, GU_TIME_ETERNITY);
+            if (ret < 0) return ret;
+            ::free(const_cast<void*>(rcvd.act.buf));
+        }
+        while (rcvd.act.type != type);
+
+        return ret;
+    }
+
+    int
+    run(gcs_core_t* const core, const Params& p, bool const sendv,
+        long const frag_size)
+    {
+        gcs_backend_t* const backend(gcs_core_get_backend(core));
+        gcs_backend_sendv_t const orig(backend->sendv);
+        if (!sendv) backend->sendv = NULL;
+
+        /* buffers of uneven size, like record set pages */
+        std::vector<gu::byte_t> data(p.ws_size, 'x');
+        std::vector<struct gu_buf> bufs(p.bufs);
+        size_t offset(0);
+        for (int i(0); i < p.bufs; ++i)
+        {
+            size_t const size(i + 1 < p.bufs ?
+                              p.ws_size / p.bufs + i % 3 * 7 :
+                              p.ws_size - offset);
+            bufs[i].ptr  = &data[offset];
+            bufs[i].size = size;
+            offset += size;
+        }
+
+        long long const copied_before(gcs_core_send_copied(core));
+
+        for (long n(0); n < p.write_sets; ++n)
+        {
+            long ret(gcs_core_send(core, &bufs[0], p.ws_size,
+                                   GCS_ACT_TORDERED));
+            if (ret != long(p.ws_size))
+            {
+                std::cerr << "gcs_core_send() failed: " << ret << std::endl;
+                return 1;
+            }
+
+            ret = recv_act(core, GCS_ACT_TORDERED);
+            if (ret != long(p.ws_size))
+            {
+                std::cerr << "gcs_core_recv() failed: " << ret << std::endl;
+                return 1;
+            }
+        }
+
+        backend->sendv = orig;
+
+        long long const frags((p.ws_size + frag_size - 1) / frag_size);
+        long long const hdr(gcs_act_proto_hdr_size(GCS_ACT_PROTO_MAX));
+        long long const gather((gcs_core_send_copied(core) - copied_before)
+                               / p.write_sets);
+        long long const network(p.ws_size + frags * hdr);
+        long long const defrag(p.ws_size);
+
+        std::cout << std::setw(16) << (sendv ? "scatter-gather" : "gather")
+                  << std::setw(12) << gather
+                  << std::setw(12) << network
+                  << std::setw(12) << defrag
+                  << std::setw(12) << gather + network + defrag
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << double(gather + network + defrag) / p.ws_size
+                  << std::endl;
+
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Params p = { 1000, 1 << 16, 8 };
+
+    if (argc > 1) p.write_sets = ::strtol(argv[1], NULL, 10);
+    if (argc > 2) p.ws_size    = ::strtoul(argv[2], NULL, 10);
+    if (argc > 3) p.bufs       = ::atoi(argv[3]);
+
+    if (p.write_sets <= 0 || p.bufs <= 0 || p.ws_size < size_t(p.bufs * 16))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [write sets] [write set size] [buffers]" << std::endl;
+        return 1;
+    }
+
+    /* core logs every fragment in testing mode */
+    gu_conf_set_log_callback(silent_log);
+
+    gu::Config config;
+    gcs_core_t* const core(gcs_core_create(
+                               reinterpret_cast<gu_config_t*>(&config), NULL,
+                               "send_bench", "127.0.0.1:0", 0, 0));
+
+    if (!core || gcs_core_open(core, "send_bench", "dummy://", true) ||
+        recv_act(core, GCS_ACT_CONF) < 0)
+    {
+        std::cerr << "Failed to open gcs core" << std::endl;
+        return 1;
+    }
+
+    long const frag_size(gcs_core_set_pkt_size(core, 1 << 16));
+    if (frag_size <= 0)
+    {
+        std::cerr << "Failed to set packet size: " << frag_size << std::endl;
+        return 1;
+    }
+
+    std::cout << "Write sets: " << p.write_sets << ", size: " << p.ws_size
+              << ", buffers: " << p.bufs << ", fragment: " << frag_size
+              << "\nBytes copied per write set:\n"
+              << std::setw(16) << "send"
+              << std::setw(12) << "gather"
+              << std::setw(12) << "network"
+              << std::setw(12) << "defrag"
+              << std::setw(12) << "total"
+              << std::setw(10) << "x size" << std::endl;
+
+    int ret(run(core, p, false, frag_size) || run(core, p, true, frag_size));
+
+    gcs_core_close(core);
+    recv_act(core, GCS_ACT_CONF);
+    gcs_core_destroy(core);
+
+    return ret;
+}